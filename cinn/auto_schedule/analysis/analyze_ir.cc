@@ -17,6 +17,7 @@
 #include <glog/logging.h>
 
 #include <algorithm>
+#include <map>
 #include <string>
 #include <unordered_set>
 
@@ -92,5 +93,61 @@ std::unordered_set<std::string> GetOutputNamesFromLoweredFunc(const std::vector<
   return result;
 }
 
+bool IsSpatialLoop(const ir::Expr& loop) {
+  const ir::For* for_node = loop.As<ir::For>();
+  CHECK(for_node) << "loop param must be For node! Please check.";
+  const std::string& loop_var_name = for_node->loop_var->name;
+
+  std::set<ir::Expr> reduce_bindings = ir::CollectIRNodesWithoutTensor(for_node->body, [&](const Expr* x) {
+    const ir::ScheduleBlockRealize* block_realize = x->As<ir::ScheduleBlockRealize>();
+    if (block_realize == nullptr) {
+      return false;
+    }
+    const ir::ScheduleBlock* sche_block = block_realize->schedule_block.As<ir::ScheduleBlock>();
+    for (size_t i = 0; i < block_realize->iter_values.size(); ++i) {
+      if (!sche_block->iter_vars[i]->is_reduce_axis) {
+        continue;
+      }
+      const ir::Expr& iter_value        = block_realize->iter_values[i];
+      std::set<ir::Expr> used_loop_vars = ir::CollectIRNodesWithoutTensor(
+          iter_value, [&](const Expr* v) { return v->as_var() && v->as_var()->name == loop_var_name; });
+      if (!used_loop_vars.empty()) {
+        return true;
+      }
+    }
+    return false;
+  });
+  return reduce_bindings.empty();
+}
+
+void UpdateTempBuffers(ir::LoweredFunc func) {
+  std::unordered_set<std::string> buffer_names;
+  for (const ir::Argument& arg : func->args) {
+    if (arg.is_buffer()) {
+      buffer_names.insert(arg.name());
+    }
+  }
+  for (const ir::Buffer& buffer : func->temp_bufs) {
+    buffer_names.insert(buffer->name);
+  }
+
+  // sorted by name to keep the order of allocations stable
+  std::map<std::string, ir::Buffer> new_buffers;
+  ir::CollectIRNodesWithoutTensor(func->body, [&](const Expr* x) {
+    const ir::_Tensor_* tensor = x->as_tensor();
+    if (tensor != nullptr && tensor->buffer.defined() && !buffer_names.count(tensor->buffer->name)) {
+      new_buffers.emplace(tensor->buffer->name, tensor->buffer);
+    }
+    return false;
+  });
+  if (new_buffers.empty()) {
+    return;
+  }
+  for (auto& name_and_buffer : new_buffers) {
+    func->temp_bufs.push_back(name_and_buffer.second);
+  }
+  func->PrepareBufferCastExprs();
+}
+
 }  // namespace auto_schedule
 }  // namespace cinn
@@ -34,5 +34,18 @@ bool ContainsNodeType(ir::Expr expr, const std::unordered_set<ir::IrNodeTy>& nod
  */
 std::unordered_set<std::string> GetOutputNamesFromLoweredFunc(const std::vector<ir::LoweredFunc>& lowered_funcs);
 
+/**
+ * Returns true if the loop variable of the For is not bound to any reduce iter var
+ * of the schedule blocks under it, so the iterations of the loop are independent
+ */
+bool IsSpatialLoop(const ir::Expr& loop);
+
+/**
+ * Appends the buffers of the tensors created by schedule primitives such as CacheWrite
+ * and Rfactor to the temporary buffers of the function, so they are allocated when the
+ * function is built with a scheduled body
+ */
+void UpdateTempBuffers(ir::LoweredFunc func);
+
 }  // namespace auto_schedule
 }  // namespace cinn
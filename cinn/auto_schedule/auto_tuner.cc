@@ -18,9 +18,15 @@
 #include <pybind11/embed.h>
 
 #include <algorithm>
+#include <map>
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include <utility>
 
+#include "cinn/auto_schedule/analysis/analyze_ir.h"
+#include "cinn/auto_schedule/database/jsonfile_database.h"
+#include "cinn/auto_schedule/graph_tuner/graph_tuner.h"
 #include "cinn/auto_schedule/measure/schedule_measurer.h"
 #include "cinn/auto_schedule/measure/simple_builder.h"
 #include "cinn/auto_schedule/measure/simple_runner.h"
@@ -28,53 +34,151 @@
 #include "cinn/auto_schedule/task/tune_task.h"
 #include "cinn/auto_schedule/task_scheduler/task_scheduler.h"
 #include "cinn/common/type.h"
+#include "cinn/ir/ir_schedule.h"
+#include "cinn/optim/ir_copy.h"
+
+DECLARE_bool(auto_schedule_use_cost_model);
 
 namespace cinn {
 namespace auto_schedule {
 
+namespace {
+
+// Rebuild the schedule of task by replaying trace on its un-optimized LoweredFuncs,
+// return false and keep the un-optimized ones if the trace can't be replayed
+bool ReplayTrace(const TuneTask& task, const ir::ScheduleTrace& trace, TuningResult::OptimizedComputeExpr* result) {
+  result->lowered_funcs.clear();
+  result->lowered_funcs.emplace_back(optim::IRCopy(task.lowered_funcs));
+  std::vector<ir::Expr> exprs;
+  for (auto&& func : result->lowered_funcs[0]) {
+    exprs.emplace_back(func->body);
+  }
+  ir::ModuleExpr mod_expr(exprs);
+  ir::IRSchedule ir_sch(mod_expr);
+  if (!trace.Replay(&ir_sch)) {
+    result->lowered_funcs[0] = optim::IRCopy(task.lowered_funcs);
+    return false;
+  }
+  std::vector<ir::Expr> best_exprs = ir_sch.GetModule().GetExprs();
+  CHECK_EQ(best_exprs.size(), result->lowered_funcs[0].size())
+      << "RuntimeError: Expr size is not equal to LoweredFunc size in AutoTuner";
+  for (size_t j = 0; j < best_exprs.size(); ++j) {
+    result->lowered_funcs[0][j]->body = best_exprs[j];
+    UpdateTempBuffers(result->lowered_funcs[0][j]);
+    if (task.target == common::DefaultNVGPUTarget()) {
+      result->lowered_funcs[0][j]->PrepareCudaAxisInfoFromBody();
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
 AutoTuner::AutoTuner(const common::Target& target, hlir::framework::Graph* graph) : target_(target), graph_(graph) {}
 
 void AutoTuner::Initialize(const Config& config, hlir::framework::GraphCompiler* graph_compiler) {
+  config_         = config;
+  graph_compiler_ = graph_compiler;
   // create builder, runner, and schedule measurer
-  builder_           = std::make_unique<SimpleBuilder>(graph_compiler);
-  runner_            = std::make_unique<SimpleRunner>(config.runner_repeat_times);
-  schedule_measurer_ = std::make_unique<ScheduleMeasurer>(builder_.get(), runner_.get());
+  SimpleRunner::Options runner_options;
+  runner_options.repeat_times     = config.runner_repeat_times;
+  runner_options.warmup_times     = config.runner_warmup_times;
+  runner_options.min_run_duration = config.runner_min_run_duration;
+  runner_options.num_trials       = config.runner_num_trials;
+  runner_options.flush_cache      = config.runner_flush_cache;
+  runner_options.early_stop_ratio = config.runner_early_stop_ratio;
+  builder_                        = std::make_unique<SimpleBuilder>(graph_compiler);
+  runner_                         = std::make_unique<SimpleRunner>(runner_options);
+  schedule_measurer_              = std::make_unique<ScheduleMeasurer>(
+      builder_.get(), runner_.get(), config.num_build_threads, config.runner_cpu_id);
+  if (!config.tuning_record_path.empty()) {
+    database_ =
+        std::make_unique<JSONFileDatabase>(config.tuning_record_capacity_per_task, config.tuning_record_path, true);
+  }
+  if (!config.feature_store_path.empty()) {
+    feature_store_ = std::make_unique<FeatureStore>(config.feature_store_path, true);
+    LOG_IF(INFO, !FLAGS_auto_schedule_use_cost_model)
+        << "The features are saved into " << config.feature_store_path
+        << ", but the cost models are pre-trained only if FLAGS_auto_schedule_use_cost_model is true";
+  }
 
   // create tasks
   TaskCreator task_creator;
-  tasks_ = task_creator.CreateTuneTaskOpLevel(graph_);
-  for (TuneTask& task : tasks_) {
-    task.SetGraphCompiler(graph_compiler);
+  InitializeTasks(task_creator.CreateTuneTaskOpLevel(graph_));
+}
+
+void AutoTuner::InitializeTasks(std::vector<TuneTask>&& tasks) {
+  group_tasks_ = std::move(tasks);
+  tasks_.clear();
+  tuned_task_ids_.clear();
+  std::unordered_map<std::string, int> key_to_task_id;
+  for (TuneTask& task : group_tasks_) {
+    task.SetGraphCompiler(graph_compiler_);
     task.TaskGraphToUnoptLoweredFunc();
     task.SerializeToString(graph_->GetAttrs<absl::flat_hash_map<std::string, hlir::framework::shape_t>>("infershape"),
                            graph_->GetAttrs<absl::flat_hash_map<std::string, common::Type>>("inferdtype"));
+    // the groups with the same serialized_key are tuned once, and the weight counts them
+    auto it = key_to_task_id.find(task.serialized_key);
+    if (it != key_to_task_id.end()) {
+      ++tasks_.at(it->second).weight;
+      tuned_task_ids_.push_back(it->second);
+      continue;
+    }
     VLOG(3) << "Add a task with serialized_key:\n" << task.serialized_key;
+    key_to_task_id.emplace(task.serialized_key, tasks_.size());
+    tuned_task_ids_.push_back(tasks_.size());
+    tasks_.push_back(task);
   }
+  VLOG(3) << "Create " << tasks_.size() << " tasks for " << group_tasks_.size() << " groups";
 
   // create task optimizers
+  task_optimizers_.clear();
   task_optimizers_.resize(tasks_.size());
   std::transform(tasks_.begin(), tasks_.end(), task_optimizers_.begin(), [&](const TuneTask& task) {
-    return std::make_unique<TaskOptimizer>(task, schedule_measurer_.get());
+    return std::make_unique<TaskOptimizer>(task, schedule_measurer_.get(), database_.get(), feature_store_.get());
   });
 
   // create task scheduler
-  task_scheduler_ = TaskScheduler::Make(tasks_, config.task_schedule_config, config.task_schedule_strategy);
+  task_scheduler_ = TaskScheduler::Make(tasks_, config_.task_schedule_config, config_.task_schedule_strategy);
+}
+
+void AutoTuner::TuneGraph(const TuningOptions& options) {
+  std::vector<std::vector<hlir::framework::Node*>> groups;
+  for (const TuneTask& task : group_tasks_) {
+    groups.insert(groups.end(), task.task_graph.begin(), task.task_graph.end());
+  }
+
+  GraphTuner::Config graph_tuner_config;
+  graph_tuner_config.num_expensive_groups = options.graph_tuning_expensive_groups;
+  graph_tuner_config.min_improvement      = options.graph_tuning_min_improvement;
+  GraphTuner graph_tuner(graph_, graph_compiler_, schedule_measurer_.get(), graph_tuner_config);
+  auto tuned_groups = graph_tuner.Tune(groups);
+  if (tuned_groups == groups) {
+    return;
+  }
+
+  LOG(INFO) << "Graph tuning changed " << groups.size() << " groups into " << tuned_groups.size() << " groups";
+  TaskCreator task_creator;
+  InitializeTasks(task_creator.CreateTuneTaskOpLevel(tuned_groups, target_));
 }
 
 TuningResult AutoTuner::Tune(const TuningOptions& options) {
   CHECK_GT(options.num_tuning_rounds, 0) << "Invalid config";
 
+  if (options.graph_tuning_expensive_groups > 0) {
+    TuneGraph(options);
+  }
+
   TuningResult result;
-  result.tuned_graph.resize(tasks_.size());
-  result.optimized_exprs.resize(tasks_.size());
-  // A task only tunes schedule now, so we populate its sub_graph
-  // as default result of graph tuning, and that should be updated
-  // once we support graph tuning.
-  for (auto i = 0; i < tasks_.size(); ++i) {
-    auto&& task                  = tasks_.at(i);
+  result.tuned_graph.resize(group_tasks_.size());
+  result.optimized_exprs.resize(group_tasks_.size());
+  // the groups of the tasks have been tuned above if graph tuning is enabled
+  for (auto i = 0; i < group_tasks_.size(); ++i) {
+    auto&& task                  = group_tasks_.at(i);
     result.tuned_graph[i].groups = task.task_graph;
   }
 
+  std::vector<TuningResult::OptimizedComputeExpr> tuned_exprs(tasks_.size());
   for (int r = 0; r < options.num_tuning_rounds; ++r) {
     int run_id = -1;
     task_scheduler_->Reset();
@@ -83,10 +187,66 @@ TuningResult AutoTuner::Tune(const TuningOptions& options) {
       auto* opt           = task_optimizers_.at(run_id).get();
       auto optimized_expr = opt->Optimize(options);
       // update the best schedules searched so far.
-      result.optimized_exprs.at(run_id) = std::move(optimized_expr);
+      tuned_exprs.at(run_id) = std::move(optimized_expr);
+      task_scheduler_->UpdateTaskResult(run_id, opt->BestCost());
+    }
+    LOG(INFO) << "Tuning round " << r << " done, predicted latency: " << task_scheduler_->PredictedLatency()
+              << "us, achieved latency: " << task_scheduler_->EstimatedLatency() << "us";
+  }
+
+  // the first group of a task takes the tuned schedule, and the others with different
+  // names rebuild it by replaying the trace of the schedule
+  std::vector<bool> taken(tasks_.size(), false);
+  for (auto i = 0; i < group_tasks_.size(); ++i) {
+    int task_id = tuned_task_ids_.at(i);
+    if (!taken[task_id]) {
+      taken[task_id]            = true;
+      result.optimized_exprs[i] = tuned_exprs[task_id];
+      continue;
+    }
+    if (tuned_exprs[task_id].lowered_funcs.empty()) {
+      continue;
+    }
+    ir::ScheduleTrace trace = task_optimizers_.at(task_id)->BestTrace();
+    if (!trace.RenameBlocks(tasks_.at(task_id).GetBlockNames(), group_tasks_.at(i).GetBlockNames()) ||
+        !ReplayTrace(group_tasks_.at(i), trace, &result.optimized_exprs[i])) {
+      LOG(WARNING) << "The schedule of task " << task_id << " can't be replayed on group " << i
+                   << ", use the un-optimized LoweredFuncs";
+      result.optimized_exprs[i].lowered_funcs.assign(1, optim::IRCopy(group_tasks_.at(i).lowered_funcs));
     }
   }
 
+  const auto& statistics = schedule_measurer_->GetStatistics();
+  LOG(INFO) << "Measured " << statistics.num_candidates << " candidates, builder utilization: "
+            << statistics.BuilderUtilization(schedule_measurer_->NumThreads())
+            << ", runner utilization: " << statistics.RunnerUtilization();
+  return result;
+}
+
+TuningResult AutoTuner::LoadFromDatabase(Database* database) {
+  TuningResult result;
+  result.tuned_graph.resize(group_tasks_.size());
+  result.optimized_exprs.resize(group_tasks_.size());
+  for (auto i = 0; i < group_tasks_.size(); ++i) {
+    auto&& task                  = group_tasks_.at(i);
+    result.tuned_graph[i].groups = task.task_graph;
+
+    std::vector<TuningRecord> records = database->LookUp(task.serialized_key);
+    if (records.empty()) {
+      VLOG(3) << "No record of group " << i << ", use the un-optimized LoweredFuncs";
+      result.optimized_exprs[i].lowered_funcs.emplace_back(optim::IRCopy(task.lowered_funcs));
+      continue;
+    }
+    // the record may be measured on a group with other names, the old records without
+    // the names of their blocks are taken as measured on the first group of the task
+    ir::ScheduleTrace trace = records[0].state.trace;
+    const std::vector<std::string>& names =
+        records[0].block_names.empty() ? tasks_.at(tuned_task_ids_.at(i)).GetBlockNames() : records[0].block_names;
+    if (!trace.RenameBlocks(names, task.GetBlockNames()) || !ReplayTrace(task, trace, &result.optimized_exprs[i])) {
+      LOG(WARNING) << "The best record of group " << i << " can't be replayed, use the un-optimized LoweredFuncs";
+      result.optimized_exprs[i].lowered_funcs.assign(1, optim::IRCopy(task.lowered_funcs));
+    }
+  }
   return result;
 }
 
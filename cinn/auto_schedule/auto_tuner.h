@@ -18,6 +18,8 @@
 #include <string>
 #include <vector>
 
+#include "cinn/auto_schedule/database/database.h"
+#include "cinn/auto_schedule/database/feature_store.h"
 #include "cinn/auto_schedule/measure/schedule_measurer.h"
 #include "cinn/auto_schedule/task/task_optimizer.h"
 #include "cinn/auto_schedule/task/tune_task.h"
@@ -31,7 +33,7 @@ namespace cinn {
 namespace auto_schedule {
 
 // This class is entrance of auto-tune, users can use it
-// to tune graph (not supported yet) and search a series of schedules
+// to tune the fusion groups of graph and search a series of schedules
 // that maybe more likely to obtain better performance.
 // Internally, it creates necessary components and use them to finish tuning.
 class AutoTuner {
@@ -42,6 +44,25 @@ class AutoTuner {
     std::string task_schedule_strategy = "round_robin";
     TaskScheduler::Config task_schedule_config;
     int runner_repeat_times = 1;
+    // the protocol of timing a candidate, see SimpleRunner::Options
+    int runner_warmup_times        = 1;
+    double runner_min_run_duration = 0.0;
+    int runner_num_trials          = 1;
+    bool runner_flush_cache        = false;
+    double runner_early_stop_ratio = 0.0;
+    // the number of threads to build candidates in measurement
+    int num_build_threads = 1;
+    // the cpu to bind the thread running candidates to, and the builder threads
+    // are kept off it, so compiling doesn't disturb the timings. -1 means not binding
+    int runner_cpu_id = 0;
+    // the json file to save the measured candidates, nothing is saved if it is empty
+    std::string tuning_record_path = "";
+    // the max number of candidates saved for a task
+    int tuning_record_capacity_per_task = 2;
+    // the json file to save the features of the measured candidates, which pre-train
+    // the cost models of related tasks when FLAGS_auto_schedule_use_cost_model is true,
+    // nothing is saved if it is empty
+    std::string feature_store_path = "";
   };
 
   AutoTuner(const common::Target& target, hlir::framework::Graph* graph);
@@ -49,14 +70,35 @@ class AutoTuner {
   // Initialize tuner with specific config and auxiliary objects.
   void Initialize(const Config& config, hlir::framework::GraphCompiler* graph_compiler);
 
-  // Perform the tuning process and return the final result
+  // Perform the tuning process and return the final result, the graph is
+  // tuned firstly if TuningOptions.graph_tuning_expensive_groups > 0
   TuningResult Tune(const TuningOptions& options);
 
+  // Restore the result from the best records in the database without tuning,
+  // the schedule of a task is rebuilt by replaying the trace of its best
+  // record on the un-optimized LoweredFuncs, and the task without replayable
+  // record keeps the un-optimized ones.
+  TuningResult LoadFromDatabase(Database* database);
+
  private:
+  // Prepare the tasks and create the optimizers and scheduler of them
+  void InitializeTasks(std::vector<TuneTask>&& tasks);
+
+  // Revisit the fusion groups of the tasks by GraphTuner,
+  // and the tasks are re-created if the groups are changed
+  void TuneGraph(const TuningOptions& options);
+
   const common::Target& target_;
   hlir::framework::Graph* graph_;
+  hlir::framework::GraphCompiler* graph_compiler_ = nullptr;
+  Config config_;
 
-  // Tasks to tune
+  // Tasks of the fusion groups in order
+  std::vector<TuneTask> group_tasks_;
+  // The index in tasks_ of the task tuned for each of group_tasks_
+  std::vector<int> tuned_task_ids_;
+  // Tasks to tune, the groups with the same serialized_key are tuned once by
+  // the task of the first one, whose weight is the number of these groups
   std::vector<TuneTask> tasks_;
   // Scheduler that select a task to tune at every turn.
   std::unique_ptr<TaskScheduler> task_scheduler_;
@@ -67,6 +109,11 @@ class AutoTuner {
   std::unique_ptr<ScheduleBuilder> builder_;
   std::unique_ptr<ScheduleRunner> runner_;
   std::unique_ptr<ScheduleMeasurer> schedule_measurer_;
+
+  // Database to save the measured candidates
+  std::unique_ptr<Database> database_;
+  // Store to save the features of the measured candidates
+  std::unique_ptr<FeatureStore> feature_store_;
 };
 
 }  // namespace auto_schedule
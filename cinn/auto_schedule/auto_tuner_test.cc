@@ -17,8 +17,11 @@
 #include <glog/logging.h>
 #include <gtest/gtest.h>
 
+#include <cstdio>
 #include <iostream>
+#include <string>
 
+#include "cinn/auto_schedule/database/jsonfile_database.h"
 #include "cinn/common/target.h"
 #include "cinn/frontend/net_builder.h"
 #include "cinn/frontend/syntax.h"
@@ -117,6 +120,39 @@ class TestAutoTuner : public ::testing::Test {
     BasicCheckResult(result);
     ApplyTunedAndRun(result);
   }
+
+  void LoadFromRecords() {
+    // save the measured candidates into a json file
+    std::string record_file_path = "/tmp/test_auto_tuner_record.json";
+    std::remove(record_file_path.c_str());
+    AutoTuner::Config tuning_config;
+    tuning_config.tuning_record_path = record_file_path;
+
+    TuningOptions tuning_options;
+    tuning_options.num_measure_trials        = 4;
+    tuning_options.num_samples_per_iteration = 2;
+    InitializeAndTune(tuning_config, tuning_options);
+
+    // restore the schedules by replaying the best records offline
+    JSONFileDatabase database(tuning_config.tuning_record_capacity_per_task, record_file_path, false);
+    ASSERT_EQ(database.Size(), 4UL);
+    auto result = tuner->LoadFromDatabase(&database);
+    BasicCheckResult(result);
+    ApplyTunedAndRun(result);
+
+    // build the graph from the saved records by a new compiler as a later compilation does
+    auto new_scope          = BuildScope(target, graph);
+    auto new_graph_compiler = std::make_unique<GraphCompiler>(target, new_scope, graph);
+    GraphCompiler::CompileOptions compile_options;
+    compile_options.with_instantiate_variables = true;
+    compile_options.ApplyTuningRecords(record_file_path, new_graph_compiler.get());
+    ASSERT_EQ(2, compile_options.groups.size());
+    ASSERT_EQ(2, compile_options.lowered_funcs.size());
+    auto runtime_program = new_graph_compiler->Build(compile_options).runtime_program;
+    ASSERT_EQ(2, runtime_program->size());
+    runtime_program->Execute();
+    std::remove(record_file_path.c_str());
+  }
 };
 
 frontend::Program TestAutoTuner::CreateAddReluProgram() {
@@ -150,5 +186,10 @@ TEST_F(TestAutoTuner, NonZeroMeasure_EnableCostModel) {
   NonZeroMeasure();
 }
 
+TEST_F(TestAutoTuner, LoadFromRecords) {
+  FLAGS_auto_schedule_use_cost_model = false;
+  LoadFromRecords();
+}
+
 }  // namespace auto_schedule
 }  // namespace cinn
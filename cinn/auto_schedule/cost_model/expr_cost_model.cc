@@ -17,6 +17,7 @@
 #include <glog/logging.h>
 
 #include <atomic>
+#include <memory>
 #include <vector>
 
 #include "cinn/auto_schedule/cost_model/feature.h"
@@ -35,42 +36,58 @@ float ExprCostModel::Predict(const ir::ModuleExpr& sample, const common::Target&
   FeatureExtractor extractor;
   Feature feature                    = extractor.Extract(sample, target);
   std::vector<float> feature_numbers = feature.ToFixedSizeVector();
-  std::vector<float> pred            = XgbCostModel::Predict({feature_numbers});
+  std::vector<float> pred            = GbdtCostModel::Predict({feature_numbers});
   return pred[0];
 }
 
 void ExprCostModel::Train(const std::vector<const ir::ModuleExpr*>& samples,
                           const std::vector<float>& labels,
                           const common::Target& target) {
-  trained_times_.store(1);
-  size_t total_size = samples.size();
-  CHECK_EQ(total_size, labels.size()) << "Samples must have same size as labels";
-  std::vector<std::vector<float>> train_feature_numbers(total_size);
-  FeatureExtractor extractor;
-  for (size_t i = 0; i < total_size; ++i) {
-    CHECK(samples[i] != nullptr) << "Train samples cannot be nullptr";
-    Feature feature          = extractor.Extract(*samples[i], target);
-    train_feature_numbers[i] = feature.ToFixedSizeVector();
-  }
-
-  XgbCostModel::Train(train_feature_numbers, labels);
+  CHECK_EQ(samples.size(), labels.size()) << "Samples must have same size as labels";
+  Train(ExtractFeatures(samples, target), labels);
 }
 
 void ExprCostModel::Update(const std::vector<const ir::ModuleExpr*>& samples,
                            const std::vector<float>& labels,
                            const common::Target& target) {
+  CHECK_EQ(samples.size(), labels.size()) << "Samples must have same size as labels";
+  Update(ExtractFeatures(samples, target), labels);
+}
+
+void ExprCostModel::Train(const std::vector<std::vector<float>>& samples, const std::vector<float>& labels) {
+  trained_times_.store(1);
+  GbdtCostModel::Train(samples, labels);
+}
+
+void ExprCostModel::Update(const std::vector<std::vector<float>>& samples, const std::vector<float>& labels) {
   ++trained_times_;
-  size_t total_size = samples.size();
-  CHECK_EQ(total_size, labels.size()) << "Samples must have same size as labels";
-  std::vector<std::vector<float>> train_feature_numbers(total_size);
+  GbdtCostModel::Update(samples, labels);
+}
+
+void ExprCostModel::Pretrain(const std::vector<std::vector<float>>& samples, const std::vector<float>& labels) {
+  if (samples.empty()) {
+    return;
+  }
+  auto base_model = std::make_shared<GbdtCostModel>();
+  base_model->Train(samples, labels);
+  SetBaseModel(base_model);
+  // the base model can predict before any training on this task
+  if (trained_times_.load() == 0) {
+    trained_times_.store(1);
+  }
+  VLOG(4) << "ExprCostModel is pre-trained with " << samples.size() << " samples";
+}
+
+std::vector<std::vector<float>> ExprCostModel::ExtractFeatures(const std::vector<const ir::ModuleExpr*>& samples,
+                                                               const common::Target& target) {
+  std::vector<std::vector<float>> feature_numbers(samples.size());
   FeatureExtractor extractor;
-  for (size_t i = 0; i < total_size; ++i) {
+  for (size_t i = 0; i < samples.size(); ++i) {
     CHECK(samples[i] != nullptr) << "Train samples cannot be nullptr";
-    Feature feature          = extractor.Extract(*samples[i], target);
-    train_feature_numbers[i] = feature.ToFixedSizeVector();
+    Feature feature    = extractor.Extract(*samples[i], target);
+    feature_numbers[i] = feature.ToFixedSizeVector();
   }
-
-  XgbCostModel::Update(train_feature_numbers, labels);
+  return feature_numbers;
 }
 
 }  // namespace auto_schedule
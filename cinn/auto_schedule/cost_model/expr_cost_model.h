@@ -17,7 +17,7 @@
 #include <atomic>
 #include <vector>
 
-#include "cinn/auto_schedule/cost_model/xgb_cost_model.h"
+#include "cinn/auto_schedule/cost_model/gbdt_cost_model.h"
 #include "cinn/ir/ir_schedule.h"
 
 namespace cinn {
@@ -27,7 +27,7 @@ namespace auto_schedule {
  * A C++ cost model which trains and predicts on ir::Expr
  *
  */
-class ExprCostModel : public XgbCostModel {
+class ExprCostModel : public GbdtCostModel {
  public:
   float Predict(const ir::ModuleExpr& sample, const common::Target& target) const;
   void Train(const std::vector<const ir::ModuleExpr*>& samples,
@@ -37,6 +37,18 @@ class ExprCostModel : public XgbCostModel {
               const std::vector<float>& labels,
               const common::Target& target);
 
+  // Train or update with the features extracted by ExtractFeatures
+  void Train(const std::vector<std::vector<float>>& samples, const std::vector<float>& labels) override;
+  void Update(const std::vector<std::vector<float>>& samples, const std::vector<float>& labels) override;
+
+  // Pre-train a base model with the samples of related tasks, and the
+  // following training fine-tunes on it with the samples of this task.
+  void Pretrain(const std::vector<std::vector<float>>& samples, const std::vector<float>& labels);
+
+  // Extract the fixed size feature vectors of the samples
+  static std::vector<std::vector<float>> ExtractFeatures(const std::vector<const ir::ModuleExpr*>& samples,
+                                                         const common::Target& target);
+
  private:
   std::atomic<int> trained_times_{0};
 };
@@ -29,6 +29,7 @@
 
 #include <glog/logging.h>
 
+#include <algorithm>
 #include <vector>
 
 #include "cinn/common/target.h"
@@ -36,6 +37,8 @@
 namespace cinn {
 namespace auto_schedule {
 
+constexpr int Feature::kFixedSize;
+
 Feature::Feature()
     : target_(common::UnkTarget()),
       stack_encoded_feature_(1),  // initialze a LoopBlockFeature as root block
@@ -49,7 +52,7 @@ Feature::Feature(const common::Target& target)
       parent_indices_(1, -1) {}
 
 std::vector<float> Feature::ToFixedSizeVector() {
-  std::vector<float> ret(LoopBlockFeature::kTotalSize + 1, 0);  // LoopBlockFeature::kTotalSize plus 1 for target
+  std::vector<float> ret(kFixedSize, 0);
 
   if (target_ == common::DefaultNVGPUTarget()) {
     ret[0] = 1;
@@ -149,6 +152,30 @@ std::vector<float> Feature::ToFixedSizeVector() {
     ++j;
     ret[j] += (loop_feature.vectorize_factor * parent_prod);
     ++j;
+
+    ret[j] += (loop_feature.contiguous_access * loop_prod);
+    ++j;
+    ret[j] += (loop_feature.strided_access * loop_prod);
+    ++j;
+    ret[j] += (loop_feature.invariant_access * loop_prod);
+    ++j;
+    ret[j] += (loop_feature.aligned_vector_access * loop_prod);
+    ++j;
+
+    // the loop runs parent_prod times, so the sum is the memory traffic
+    // if nothing touched by the loop is kept in cache between the runs
+    ret[j] += (static_cast<float>(loop_feature.bytes_touched) * parent_prod);
+    ++j;
+    // distances and sizes are not accumulative, take the maximum among loops
+    ret[j] = std::max(ret[j], static_cast<float>(loop_feature.reuse_distance));
+    ++j;
+    ret[j] = std::max(ret[j], static_cast<float>(loop_feature.parallel_grain_size));
+    ++j;
+
+    if (loop_feature.cache_fit_level >= 0) {
+      ret[j + loop_feature.cache_fit_level] += 1;
+    }
+    j += LoopBlockFeature::kCacheFitSize;
   }
 
   for (size_t i = 0; i < ret.size(); ++i) {
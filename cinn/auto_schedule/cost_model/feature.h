@@ -15,6 +15,7 @@
 #pragma once
 
 #include <cmath>
+#include <cstdint>
 #include <vector>
 
 #include "cinn/common/target.h"
@@ -106,7 +107,39 @@ class LoopBlockFeature {
 
   static constexpr int kThreadFeatureSize = 8;
 
-  static constexpr int kTotalSize = kArithSize + kMemSize + kReduceBroadcastSize + kOptApplySize + kThreadFeatureSize;
+  /**
+   * Memory access features. The loads and stores directly in the loop are
+   * classified by the stride of their flattened index on the loop variable.
+   */
+  int contiguous_access = 0;  // stride is 1
+  int strided_access    = 0;  // stride is larger than 1 or unknown
+  int invariant_access  = 0;  // stride is 0, the same element is accessed by all iterations
+  // contiguous or invariant accesses in a vectorized loop whose start addresses
+  // are multiples of the vectorize factor in all iterations
+  int aligned_vector_access = 0;
+
+  static constexpr int kMemAccessSize = 4;
+
+  /* Working set features, estimated from the strides of the accesses in the loop and its sub-loops */
+
+  // Bytes of the distinct elements touched by the whole loop
+  int64_t bytes_touched = 0;
+  // Bytes touched by one iteration if the loop carries reuse, that is some
+  // elements are accessed by all its iterations, otherwise 0
+  int64_t reuse_distance = 0;
+  // Number of the innermost iterations executed by one iteration of a parallel loop
+  int64_t parallel_grain_size = 0;
+
+  static constexpr int kWorkingSetSize = 3;
+
+  // The fastest cache level that can hold bytes_touched, one of L1, L2, last
+  // level cache and memory, -1 represents the loop touches no memory
+  int cache_fit_level = -1;
+
+  static constexpr int kCacheFitSize = 4;
+
+  static constexpr int kTotalSize = kArithSize + kMemSize + kReduceBroadcastSize + kOptApplySize + kThreadFeatureSize +
+                                    kMemAccessSize + kWorkingSetSize + kCacheFitSize;
 
   /* Non-feature attributes, used to maintain during feature_extractor */
 
@@ -129,6 +162,9 @@ class Feature {
   // Convert the various-length loop block features to fixed-size vector
   std::vector<float> ToFixedSizeVector();
 
+  // The size of the vector returned by ToFixedSizeVector, LoopBlockFeature::kTotalSize plus 1 for target
+  static constexpr int kFixedSize = LoopBlockFeature::kTotalSize + 1;
+
   // Call when visit into a loop block to collect LoopBlockFeature
   void IntoLoopBlock();
   // Call when exit a loop block to collect LoopBlockFeature
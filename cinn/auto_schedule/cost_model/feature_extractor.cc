@@ -27,10 +27,14 @@
 
 #include "cinn/auto_schedule/cost_model/feature_extractor.h"
 
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "cinn/common/target.h"
 #include "cinn/common/type.h"
+#include "cinn/ir/collect_ir_nodes.h"
 #include "cinn/ir/ir.h"
 #include "cinn/ir/ir_base.h"
 #include "cinn/ir/ir_printer.h"
@@ -43,12 +47,111 @@ namespace auto_schedule {
 
 using namespace ::cinn::ir;
 
+namespace {
+
+using IterVarValues = std::unordered_map<std::string, Expr>;
+
+// An index in the form of sum(coefficients[var] * var) + constant. The
+// variables in nonlinear_vars appear in the index in a nonlinear way, such as
+// divided by a constant, so their coefficients are unknown.
+struct LinearForm {
+  std::unordered_map<std::string, int64_t> coefficients;
+  std::unordered_set<std::string> nonlinear_vars;
+  int64_t constant    = 0;
+  bool constant_known = true;
+
+  bool IsConstant() const { return coefficients.empty() && nonlinear_vars.empty() && constant_known; }
+
+  void Add(const LinearForm &other, int64_t scale) {
+    for (const auto &var2coef : other.coefficients) {
+      coefficients[var2coef.first] += var2coef.second * scale;
+    }
+    nonlinear_vars.insert(other.nonlinear_vars.begin(), other.nonlinear_vars.end());
+    constant += other.constant * scale;
+    constant_known = constant_known && other.constant_known;
+  }
+};
+
+// Collect the loop variables an expression depends on, the iter vars of
+// schedule blocks are replaced with their bound values
+void CollectLoopVars(const Expr &expr, const IterVarValues &iter_var_values, std::unordered_set<std::string> *vars) {
+  ir::CollectIRNodesWithoutTensor(expr, [&](const Expr *x) {
+    const _Var_ *var = x->As<_Var_>();
+    if (var != nullptr) {
+      auto it = iter_var_values.find(var->name);
+      if (it == iter_var_values.end()) {
+        vars->insert(var->name);
+      } else {
+        CollectLoopVars(it->second, iter_var_values, vars);
+      }
+    }
+    return false;
+  });
+}
+
+LinearForm ToLinearForm(const Expr &expr, const IterVarValues &iter_var_values) {
+  LinearForm form;
+  if (expr.As<IntImm>()) {
+    form.constant = expr.As<IntImm>()->value;
+  } else if (expr.As<_Var_>()) {
+    const std::string &name = expr.As<_Var_>()->name;
+    auto it                 = iter_var_values.find(name);
+    if (it == iter_var_values.end()) {
+      form.coefficients[name] = 1;
+    } else {
+      return ToLinearForm(it->second, iter_var_values);
+    }
+  } else if (expr.As<Add>()) {
+    form = ToLinearForm(expr.As<Add>()->a(), iter_var_values);
+    form.Add(ToLinearForm(expr.As<Add>()->b(), iter_var_values), 1);
+  } else if (expr.As<Sub>()) {
+    form = ToLinearForm(expr.As<Sub>()->a(), iter_var_values);
+    form.Add(ToLinearForm(expr.As<Sub>()->b(), iter_var_values), -1);
+  } else if (expr.As<Minus>()) {
+    form.Add(ToLinearForm(expr.As<Minus>()->v(), iter_var_values), -1);
+  } else if (expr.As<Sum>()) {
+    for (const Expr &operand : expr.As<Sum>()->operands()) {
+      form.Add(ToLinearForm(operand, iter_var_values), 1);
+    }
+  } else if (expr.As<Cast>()) {
+    return ToLinearForm(expr.As<Cast>()->v(), iter_var_values);
+  } else if (expr.As<Ramp>()) {
+    return ToLinearForm(expr.As<Ramp>()->base, iter_var_values);
+  } else if (expr.As<Mul>()) {
+    LinearForm lhs = ToLinearForm(expr.As<Mul>()->a(), iter_var_values);
+    LinearForm rhs = ToLinearForm(expr.As<Mul>()->b(), iter_var_values);
+    if (lhs.IsConstant()) {
+      form.Add(rhs, lhs.constant);
+    } else if (rhs.IsConstant()) {
+      form.Add(lhs, rhs.constant);
+    } else {
+      CollectLoopVars(expr, iter_var_values, &form.nonlinear_vars);
+      form.constant_known = false;
+    }
+  } else {
+    CollectLoopVars(expr, iter_var_values, &form.nonlinear_vars);
+    form.constant_known = form.nonlinear_vars.empty() && expr.is_constant();
+    if (form.constant_known) {
+      form.constant = static_cast<int64_t>(expr.get_constant());
+    }
+  }
+  return form;
+}
+
+}  // namespace
+
+constexpr int64_t FeatureExtractor::kUnknownStride;
+
 FeatureExtractor::FeatureExtractor() {}
 
 void FeatureExtractor::Visit(const Expr *x) { IRVisitor::Visit(x); }
 
 Feature FeatureExtractor::Extract(const ir::ModuleExpr &mod_expr, const common::Target &target) {
-  feature_ = Feature(target);
+  feature_     = Feature(target);
+  cache_sizes_ = target.cache_sizes();
+  loops_.clear();
+  accesses_.clear();
+  iter_var_values_.clear();
   for (const ir::Expr &e : mod_expr.GetExprs()) {
     Visit(&e);
   }
@@ -73,7 +176,6 @@ VisitDoNothing(_Module_);
 VisitDoNothing(_Var_);
 VisitDoNothing(_LoweredFunc_);
 VisitDoNothing(ScheduleBlock);
-VisitDoNothing(ScheduleBlockRealize);
 VisitDoNothing(Ramp);
 VisitDoNothing(_Buffer_);
 VisitDoNothing(_BufferRange_);
@@ -149,8 +251,159 @@ VisitCountMemberPattern(IfThenElse, select_op);
 VisitCountMemberPattern(Select, select_op);
 VisitCountMemberPattern(Alloc, mem_alloc);
 VisitCountMemberPattern(Free, mem_free);
-VisitCountMemberPattern(Load, mem_read);
-VisitCountMemberPattern(Store, mem_write);
+
+/* Visit for memory accesses */
+
+void FeatureExtractor::Visit(const Load *x) {
+  feature_.CurrentLoopBlock().mem_read += 1;
+  RecordAccess(x->tensor, x->indices, x->type());
+  std::vector<const Expr *> sub_exprs = x->expr_fields();
+  for (const Expr *e : sub_exprs) {
+    Visit(e);
+  }
+}
+
+void FeatureExtractor::Visit(const Store *x) {
+  feature_.CurrentLoopBlock().mem_write += 1;
+  RecordAccess(x->tensor, x->indices, x->type());
+  std::vector<const Expr *> sub_exprs = x->expr_fields();
+  for (const Expr *e : sub_exprs) {
+    Visit(e);
+  }
+}
+
+void FeatureExtractor::Visit(const ScheduleBlockRealize *x) {
+  // the indices in the block are expressed by its iter vars, record
+  // their bound values to analyze the strides on the loops
+  const ScheduleBlock *block = x->schedule_block.As<ScheduleBlock>();
+  if (block != nullptr) {
+    for (size_t i = 0; i < block->iter_vars.size() && i < x->iter_values.size(); ++i) {
+      const Expr &value = x->iter_values[i];
+      if (!(value.As<_Var_>() && value.As<_Var_>()->name == block->iter_vars[i]->name)) {
+        iter_var_values_[block->iter_vars[i]->name] = value;
+      }
+    }
+  }
+  std::vector<const Expr *> sub_exprs = x->expr_fields();
+  for (const Expr *e : sub_exprs) {
+    Visit(e);
+  }
+}
+
+void FeatureExtractor::RecordAccess(const Expr &tensor, const std::vector<Expr> &indices, const common::Type &type) {
+  const _Tensor_ *tensor_node = tensor.As<_Tensor_>();
+  if (tensor_node == nullptr || loops_.empty()) {
+    return;
+  }
+  AccessInfo access;
+  // tensors sharing a buffer, like the reduce init tensor, access the same memory
+  access.buffer_name   = tensor_node->buffer.defined() ? tensor_node->buffer->name : tensor_node->name;
+  access.element_bytes = std::max(type.ElementOf().bytes(), 1);
+  access.buffer_bytes  = 0;
+  access.offset        = kUnknownStride;
+
+  // flatten the indices in row-major order if the shape is constant
+  LinearForm flattened;
+  bool shape_known = indices.size() == tensor_node->shape.size();
+  int64_t numel    = 1;
+  for (int d = static_cast<int>(indices.size()) - 1; d >= 0 && shape_known; --d) {
+    flattened.Add(ToLinearForm(indices[d], iter_var_values_), numel);
+    if (tensor_node->shape[d].is_constant()) {
+      numel *= static_cast<int64_t>(tensor_node->shape[d].get_constant());
+    } else {
+      shape_known = false;
+    }
+  }
+  if (shape_known) {
+    access.buffer_bytes = numel * access.element_bytes;
+    if (flattened.constant_known) {
+      access.offset = flattened.constant;
+    }
+  }
+  for (const LoopInfo &loop : loops_) {
+    int64_t stride = kUnknownStride;
+    if (shape_known && !flattened.nonlinear_vars.count(loop.var_name)) {
+      auto it = flattened.coefficients.find(loop.var_name);
+      stride  = it == flattened.coefficients.end() ? 0 : it->second;
+    }
+    access.strides.push_back(stride);
+    access.extents.push_back(loop.extent);
+  }
+
+  LoopBlockFeature &loop_feature = feature_.CurrentLoopBlock();
+  const LoopInfo &innermost      = loops_.back();
+  int64_t stride                 = access.strides.back();
+  if (stride == 0) {
+    loop_feature.invariant_access += 1;
+  } else if (stride == 1 || stride == -1) {
+    loop_feature.contiguous_access += 1;
+  } else {
+    loop_feature.strided_access += 1;
+  }
+
+  int factor = innermost.vectorize_factor;
+  if (factor > 0 && (stride == 0 || stride == 1) && innermost.extent > 0 && innermost.extent % factor == 0) {
+    bool aligned = access.offset != kUnknownStride && access.offset % factor == 0;
+    for (size_t i = 0; i + 1 < access.strides.size() && aligned; ++i) {
+      aligned = access.strides[i] != kUnknownStride && access.strides[i] % factor == 0;
+    }
+    if (aligned) {
+      loop_feature.aligned_vector_access += 1;
+    }
+  }
+
+  accesses_.emplace_back(std::move(access));
+}
+
+void FeatureExtractor::ComputeWorkingSet(LoopBlockFeature *loop_feature) {
+  const size_t depth   = loops_.size() - 1;
+  const LoopInfo &loop = loops_.back();
+  bool carries_reuse   = false;
+  // accesses to the same buffer are assumed to overlap, so the footprint
+  // of a buffer is the maximum among its accesses, in the whole loop and
+  // in one iteration respectively
+  std::unordered_map<std::string, std::pair<int64_t, int64_t>> buffer_footprints;
+  for (size_t i = loop.access_begin; i < accesses_.size(); ++i) {
+    const AccessInfo &access = accesses_[i];
+    int64_t iteration_numel  = 1;
+    for (size_t l = depth + 1; l < access.strides.size(); ++l) {
+      if (access.strides[l] != 0 && access.extents[l] > 0) {
+        iteration_numel *= access.extents[l];
+      }
+    }
+    int64_t loop_numel = iteration_numel;
+    if (access.strides[depth] == 0) {
+      carries_reuse = true;
+    } else if (access.extents[depth] > 0) {
+      loop_numel *= access.extents[depth];
+    }
+    int64_t iteration_bytes = iteration_numel * access.element_bytes;
+    int64_t loop_bytes      = loop_numel * access.element_bytes;
+    if (access.buffer_bytes > 0) {
+      iteration_bytes = std::min(iteration_bytes, access.buffer_bytes);
+      loop_bytes      = std::min(loop_bytes, access.buffer_bytes);
+    }
+    std::pair<int64_t, int64_t> &footprint = buffer_footprints[access.buffer_name];
+    footprint.first                        = std::max(footprint.first, loop_bytes);
+    footprint.second                       = std::max(footprint.second, iteration_bytes);
+  }
+
+  int64_t bytes_touched   = 0;
+  int64_t iteration_bytes = 0;
+  for (const auto &name2footprint : buffer_footprints) {
+    bytes_touched += name2footprint.second.first;
+    iteration_bytes += name2footprint.second.second;
+  }
+  loop_feature->bytes_touched  = bytes_touched;
+  loop_feature->reuse_distance = carries_reuse ? iteration_bytes : 0;
+  if (bytes_touched > 0) {
+    int level = 0;
+    while (level < static_cast<int>(cache_sizes_.size()) && bytes_touched > cache_sizes_[level]) {
+      ++level;
+    }
+    loop_feature->cache_fit_level = level;
+  }
+}
 
 /* Visit for loops */
 
@@ -195,11 +448,31 @@ void FeatureExtractor::Visit(const For *x) {
     }
   }
 
+  LoopInfo loop_info;
+  loop_info.var_name         = x->loop_var->name;
+  loop_info.extent           = loop_feature.loop_length;
+  loop_info.vectorize_factor = x->is_vectorized() ? x->vectorize_info().factor : 0;
+  loop_info.access_begin     = accesses_.size();
+  loop_info.body_iterations  = 0;
+  loops_.push_back(loop_info);
+
   std::vector<const Expr *> sub_exprs = x->expr_fields();
   for (const Expr *e : sub_exprs) {
     Visit(e);
   }
 
+  // loop_feature may be invalid after visiting sub-loops, which add LoopBlockFeatures
+  ComputeWorkingSet(&feature_.CurrentLoopBlock());
+  int64_t body_iterations = std::max<int64_t>(loops_.back().body_iterations, 1);
+  int64_t iterations      = body_iterations * std::max<int64_t>(loops_.back().extent, 1);
+  loops_.pop_back();
+  if (x->is_parallel()) {
+    feature_.CurrentLoopBlock().parallel_grain_size = body_iterations;
+  }
+  if (!loops_.empty()) {
+    loops_.back().body_iterations += iterations;
+  }
+
   feature_.ExitLoopBlock();
 }
 
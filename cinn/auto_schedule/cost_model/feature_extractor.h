@@ -27,6 +27,11 @@
 
 #pragma once
 
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #include "cinn/auto_schedule/cost_model/feature.h"
 #include "cinn/common/target.h"
 #include "cinn/ir/ir.h"
@@ -53,7 +58,46 @@ class FeatureExtractor : public ir::IRVisitor {
 #undef __
 
  private:
+  // A loop enclosing the visiting node
+  struct LoopInfo {
+    std::string var_name;
+    // -1 represents unknown
+    int64_t extent;
+    // 0 if the loop is not vectorized
+    int vectorize_factor;
+    // the index in accesses_ of the first access inside the loop
+    size_t access_begin;
+    // the number of the innermost iterations executed by one iteration
+    int64_t body_iterations;
+  };
+
+  // A load or store, with the strides of its flattened index on the enclosing loops
+  struct AccessInfo {
+    std::string buffer_name;
+    int element_bytes;
+    // bytes of the whole buffer, 0 if unknown
+    int64_t buffer_bytes;
+    // the strides and extents of the enclosing loops, from outer to inner
+    std::vector<int64_t> strides;
+    std::vector<int64_t> extents;
+    // the constant offset of the flattened index, kUnknownStride if unknown
+    int64_t offset;
+  };
+
+  static constexpr int64_t kUnknownStride = INT64_MIN;
+
+  // Record an access to a tensor and update the access features of the current loop
+  void RecordAccess(const ir::Expr& tensor, const std::vector<ir::Expr>& indices, const common::Type& type);
+
+  // Compute the working set features of the innermost enclosing loop, called before exiting it
+  void ComputeWorkingSet(LoopBlockFeature* loop_feature);
+
   Feature feature_;
+  std::vector<int64_t> cache_sizes_;
+  std::vector<LoopInfo> loops_;
+  std::vector<AccessInfo> accesses_;
+  // the bound values of the iter vars of the visited schedule blocks
+  std::unordered_map<std::string, ir::Expr> iter_var_values_;
 };
 
 }  // namespace auto_schedule
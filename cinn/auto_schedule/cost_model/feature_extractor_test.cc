@@ -18,6 +18,7 @@
 #include <pybind11/embed.h>
 
 #include <cmath>
+#include <functional>
 #include <unordered_set>
 #include <vector>
 
@@ -29,6 +30,7 @@
 #include "cinn/lang/compute.h"
 #include "cinn/lang/lower.h"
 #include "cinn/lang/placeholder.h"
+#include "cinn/optim/ir_copy.h"
 #include "cinn/poly/stage.h"
 
 namespace cinn {
@@ -66,7 +68,7 @@ TEST(FeatureExtractor, SimpleAssign) {
   VLOG(6) << "Feature data before slog:";
   for (size_t i = 0; i < to_check.size(); ++i) {
     VLOG(6) << i << " " << (std::pow(2, to_check[i]) - 1);
-    if (i != 0 && i != 17 && i != 18 && i != 29) {
+    if (i != 0 && i != 17 && i != 18 && i != 29 && i != 42 && i != 46 && i != 49) {
       ASSERT_EQ(to_check[i], 0);
     }
   }
@@ -82,6 +84,12 @@ TEST(FeatureExtractor, SimpleAssign) {
   ASSERT_EQ(to_check[18], slog(M.get_constant() * N.get_constant()));  // mem_write
   // non-opt loops, including root block
   ASSERT_EQ(to_check[29], slog(3));
+  // contiguous_access
+  ASSERT_EQ(to_check[42], slog(2 * M.get_constant() * N.get_constant()));
+  // bytes_touched, 2 buffers * 32 * 4 bytes by the inner loop run 32 times, plus 2 buffers * 4KB by the outer loop
+  ASSERT_EQ(to_check[46], slog(2 * 128 * 32 + 2 * 4096));
+  // both loops fit in L1 cache
+  ASSERT_EQ(to_check[49], slog(2));
 }
 
 TEST(FeatureExtractor, MatrixMultiply) {
@@ -122,7 +130,7 @@ TEST(FeatureExtractor, MatrixMultiply) {
   std::vector<float> to_check = feature.ToFixedSizeVector();
 
   ASSERT_EQ(to_check.size(), static_cast<size_t>(LoopBlockFeature::kTotalSize + 1));
-  std::unordered_set<size_t> non_zero_indice = {0, 1, 2, 17, 18, 29, 30, 37};
+  std::unordered_set<size_t> non_zero_indice = {0, 1, 2, 17, 18, 29, 30, 37, 42, 43, 44, 46, 47, 49};
   for (size_t i = 0; i < to_check.size(); ++i) {
     VLOG(6) << i << " " << (std::pow(2, to_check[i]) - 1);
     if (!non_zero_indice.count(i)) {
@@ -152,6 +160,66 @@ TEST(FeatureExtractor, MatrixMultiply) {
   ASSERT_EQ(to_check[30], slog(1));
   // GpuBind loop
   ASSERT_EQ(to_check[37], slog(out_loop));
+
+  // contiguous_access, C[i, j] in the init block and A[i, k] in the reduce block
+  ASSERT_EQ(to_check[42], slog(out_loop + total_loop));
+  // strided_access, B[k, j]
+  ASSERT_EQ(to_check[43], slog(total_loop));
+  // invariant_access, load and store of C[i, j] in the reduce block
+  ASSERT_EQ(to_check[44], slog(total_loop * 2));
+  // bytes_touched of loop k, j and i are 36, 56 and 80, and they run 4, 2 and 1 times
+  ASSERT_EQ(to_check[46], slog(36 * 4 + 56 * 2 + 80));
+  // reuse_distance, one iteration of loop i touches 2 elements of C, 4 of A and 8 of B
+  ASSERT_EQ(to_check[47], slog((2 + 4 + 8) * 4));
+  // all loops fit in L1 cache
+  ASSERT_EQ(to_check[49], slog(3));
+}
+
+TEST(FeatureExtractor, MemoryAccess) {
+  Context::Global().ResetNameId();
+  Target target = common::DefaultHostTarget();
+
+  ir::Expr M(32);
+  ir::Expr N(32);
+
+  lang::Placeholder<float> A("A", {M, N});
+  ir::Tensor B = lang::Compute(
+      {M, N}, [&](Var i, Var j) { return A(i, j); }, "B");
+
+  poly::StageMap stages              = poly::CreateStages({A, B});
+  std::vector<ir::LoweredFunc> funcs = lang::LowerVec("MemoryAccess", stages, {A, B}, {}, {}, nullptr, target, true);
+
+  auto extract = [&](const std::function<void(ir::IRSchedule*)>& schedule) {
+    ir::IRSchedule ir_sch(ir::ModuleExpr({optim::IRCopy(funcs[0]->body)}));
+    schedule(&ir_sch);
+    VLOG(6) << "Expr to test: " << ir_sch.GetModule().GetExprs()[0];
+    FeatureExtractor extractor;
+    return extractor.Extract(ir_sch.GetModule(), target).ToFixedSizeVector();
+  };
+  float numel = M.get_constant() * N.get_constant();
+
+  // the inner loop accesses contiguous elements
+  std::vector<float> row_major = extract([](ir::IRSchedule* ir_sch) {});
+  ASSERT_EQ(row_major[42], slog(2 * numel));
+  ASSERT_EQ(row_major[43], 0);
+
+  // the inner loop accesses elements with stride 32 after reordering
+  std::vector<float> column_major = extract([](ir::IRSchedule* ir_sch) {
+    std::vector<ir::Expr> loops = ir_sch->GetLoops("B");
+    ir_sch->Reorder({loops[1], loops[0]});
+  });
+  ASSERT_EQ(column_major[42], 0);
+  ASSERT_EQ(column_major[43], slog(2 * numel));
+
+  std::vector<float> parallel_vectorize = extract([](ir::IRSchedule* ir_sch) {
+    std::vector<ir::Expr> loops = ir_sch->GetLoops("B");
+    ir_sch->Parallel(loops[0]);
+    ir_sch->Vectorize(ir_sch->GetLoops("B")[1], 8);
+  });
+  // aligned_vector_access, both A[i, j] and B[i, j] start at a multiple of 8 elements
+  ASSERT_EQ(parallel_vectorize[45], slog(2 * numel));
+  // parallel_grain_size, each iteration of the parallel loop runs the inner loop once
+  ASSERT_EQ(parallel_vectorize[48], slog(N.get_constant()));
 }
 
 }  // namespace auto_schedule
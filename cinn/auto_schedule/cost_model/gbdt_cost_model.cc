@@ -0,0 +1,385 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/cost_model/gbdt_cost_model.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <limits>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "cinn/utils/multi_threading.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+namespace {
+
+constexpr char kModelMagic[] = "cinn_gbdt_cost_model";
+constexpr int kModelVersion  = 1;
+// the stride of the bins of a feature in a histogram
+constexpr int kHistStride = 256;
+// the jobs run in multiple threads only if the work is more than this
+constexpr int64_t kParallelWorkThreshold = 1 << 15;
+// the number of samples predicted by a job
+constexpr int kPredictChunkSize = 64;
+
+// Run fn(0), ..., fn(num_jobs - 1), in multiple threads if the total work is large enough.
+void ParallelFor(int num_jobs, int64_t work, const utils::WorkerFuncType& fn) {
+  int num_threads = std::min<int>(num_jobs, std::thread::hardware_concurrency());
+  if (work < kParallelWorkThreshold || num_threads <= 1) {
+    for (int i = 0; i < num_jobs; ++i) {
+      fn(i);
+    }
+    return;
+  }
+  utils::parallel_run(fn, utils::SequenceDispatcher(0, num_jobs), num_threads);
+}
+
+struct GradStats {
+  double grad = 0.0;
+  double hess = 0.0;
+
+  void Add(const GradStats& other) {
+    grad += other.grad;
+    hess += other.hess;
+  }
+
+  GradStats operator-(const GradStats& other) const { return {grad - other.grad, hess - other.hess}; }
+};
+
+// The samples quantized by feature, the bin b of feature f holds the values in [cuts[f][b - 1], cuts[f][b]).
+struct QuantizedMatrix {
+  QuantizedMatrix(const std::vector<std::vector<float>>& samples, int num_features, int max_bins)
+      : num_rows(samples.size()), cuts(num_features), bins(static_cast<size_t>(num_features) * samples.size()) {
+    ParallelFor(num_features, static_cast<int64_t>(num_rows) * num_features, [&](int f) {
+      std::vector<float> values(num_rows);
+      for (int i = 0; i < num_rows; ++i) {
+        values[i] = samples[i][f];
+      }
+      std::sort(values.begin(), values.end());
+      values.erase(std::unique(values.begin(), values.end()), values.end());
+
+      // cut at the quantiles of the distinct values
+      int num_values = values.size();
+      int num_bins   = std::min(num_values, max_bins);
+      for (int k = 1; k < num_bins; ++k) {
+        int idx   = static_cast<int64_t>(k) * num_values / num_bins;
+        float cut = values[idx - 1] + (values[idx] - values[idx - 1]) / 2;
+        if (cuts[f].empty() || cut > cuts[f].back()) {
+          cuts[f].push_back(cut);
+        }
+      }
+      for (int i = 0; i < num_rows; ++i) {
+        bins[static_cast<size_t>(f) * num_rows + i] =
+            std::upper_bound(cuts[f].begin(), cuts[f].end(), samples[i][f]) - cuts[f].begin();
+      }
+    });
+  }
+
+  int Bin(int feature, int row) const { return bins[static_cast<size_t>(feature) * num_rows + row]; }
+
+  int NumBins(int feature) const { return cuts[feature].size() + 1; }
+
+  int num_rows;
+  std::vector<std::vector<float>> cuts;
+  std::vector<uint8_t> bins;
+};
+
+struct SplitInfo {
+  float gain  = 0.f;
+  int feature = -1;
+  // the samples in bins [0, bin] go to the left child
+  int bin = -1;
+  GradStats left_sum;
+};
+
+// A node to be split during growing a tree.
+struct PendingNode {
+  int node_id;
+  int depth;
+  std::vector<int> rows;
+  GradStats sum;
+  // the gradient histograms of all features, hist[f * kHistStride + b] is the sum of bin b of feature f
+  std::vector<GradStats> hist;
+};
+
+class TreeBuilder {
+ public:
+  TreeBuilder(const GbdtCostModel::Params& params,
+              const QuantizedMatrix& data,
+              const std::vector<GradStats>& gradients,
+              int num_features)
+      : params_(params), data_(data), gradients_(gradients), num_features_(num_features) {}
+
+  // Grow a tree at the end of nodes and add its leaf values to the predictions of the samples.
+  template <typename NodeT>
+  void Build(std::vector<NodeT>* nodes, std::vector<float>* predictions) {
+    PendingNode root;
+    root.node_id = nodes->size();
+    root.depth   = 0;
+    root.rows.resize(data_.num_rows);
+    std::iota(root.rows.begin(), root.rows.end(), 0);
+    for (int row : root.rows) {
+      root.sum.Add(gradients_[row]);
+    }
+    root.hist = BuildHistogram(root.rows);
+    nodes->emplace_back();
+
+    // grow depth first, so that only the histograms along a path are alive
+    std::vector<PendingNode> stack;
+    stack.emplace_back(std::move(root));
+    while (!stack.empty()) {
+      PendingNode cur = std::move(stack.back());
+      stack.pop_back();
+
+      SplitInfo split;
+      if (cur.depth < params_.max_depth && cur.rows.size() > 1U) {
+        split = FindBestSplit(cur);
+      }
+      if (split.feature < 0) {
+        float value                  = -cur.sum.grad / (cur.sum.hess + params_.lambda) * params_.learning_rate;
+        nodes->at(cur.node_id).value = value;
+        for (int row : cur.rows) {
+          (*predictions)[row] += value;
+        }
+        continue;
+      }
+
+      PendingNode left, right;
+      left.depth = right.depth = cur.depth + 1;
+      left.sum                 = split.left_sum;
+      right.sum                = cur.sum - split.left_sum;
+      for (int row : cur.rows) {
+        (data_.Bin(split.feature, row) <= split.bin ? left.rows : right.rows).push_back(row);
+      }
+      left.node_id  = nodes->size();
+      right.node_id = left.node_id + 1;
+      nodes->emplace_back();
+      nodes->emplace_back();
+      auto& node     = nodes->at(cur.node_id);
+      node.feature   = split.feature;
+      node.threshold = data_.cuts[split.feature][split.bin];
+      node.left      = left.node_id;
+      node.right     = right.node_id;
+
+      // build the histogram of the smaller child, and subtract it from the parent's for the larger one
+      PendingNode* smaller = left.rows.size() <= right.rows.size() ? &left : &right;
+      PendingNode* larger  = smaller == &left ? &right : &left;
+      smaller->hist        = BuildHistogram(smaller->rows);
+      larger->hist         = std::move(cur.hist);
+      for (size_t i = 0; i < larger->hist.size(); ++i) {
+        larger->hist[i] = larger->hist[i] - smaller->hist[i];
+      }
+      stack.emplace_back(std::move(right));
+      stack.emplace_back(std::move(left));
+    }
+  }
+
+ private:
+  std::vector<GradStats> BuildHistogram(const std::vector<int>& rows) const {
+    std::vector<GradStats> hist(static_cast<size_t>(num_features_) * kHistStride);
+    ParallelFor(num_features_, static_cast<int64_t>(rows.size()) * num_features_, [&](int f) {
+      GradStats* feature_hist = hist.data() + static_cast<size_t>(f) * kHistStride;
+      for (int row : rows) {
+        feature_hist[data_.Bin(f, row)].Add(gradients_[row]);
+      }
+    });
+    return hist;
+  }
+
+  double Score(const GradStats& stats) const { return stats.grad * stats.grad / (stats.hess + params_.lambda); }
+
+  SplitInfo FindBestSplit(const PendingNode& node) const {
+    std::vector<SplitInfo> best_of_features(num_features_);
+    double parent_score = Score(node.sum);
+    ParallelFor(num_features_, static_cast<int64_t>(num_features_) * kHistStride, [&](int f) {
+      const GradStats* feature_hist = node.hist.data() + static_cast<size_t>(f) * kHistStride;
+      GradStats left_sum;
+      for (int b = 0; b + 1 < data_.NumBins(f); ++b) {
+        left_sum.Add(feature_hist[b]);
+        GradStats right_sum = node.sum - left_sum;
+        if (left_sum.hess < params_.min_child_weight || right_sum.hess < params_.min_child_weight) {
+          continue;
+        }
+        float gain = 0.5 * (Score(left_sum) + Score(right_sum) - parent_score);
+        if (gain > params_.min_split_gain && gain > best_of_features[f].gain) {
+          best_of_features[f] = {gain, f, b, left_sum};
+        }
+      }
+    });
+    // reduce in order of features so that the result is deterministic
+    SplitInfo best;
+    for (auto& split : best_of_features) {
+      if (split.feature >= 0 && split.gain > best.gain) {
+        best = split;
+      }
+    }
+    return best;
+  }
+
+  const GbdtCostModel::Params& params_;
+  const QuantizedMatrix& data_;
+  const std::vector<GradStats>& gradients_;
+  int num_features_;
+};
+
+}  // namespace
+
+GbdtCostModel::GbdtCostModel(const Params& params) : params_(params) {
+  CHECK_GE(params_.max_bins, 2) << "max_bins of GbdtCostModel should be in [2, " << kHistStride << "]";
+  CHECK_LE(params_.max_bins, kHistStride) << "max_bins of GbdtCostModel should be in [2, " << kHistStride << "]";
+}
+
+void GbdtCostModel::Train(const std::vector<std::vector<float>>& samples, const std::vector<float>& labels) {
+  update_samples_ = samples;
+  update_labels_  = labels;
+  Fit(update_samples_, update_labels_);
+}
+
+void GbdtCostModel::Update(const std::vector<std::vector<float>>& samples, const std::vector<float>& labels) {
+  update_samples_.insert(update_samples_.end(), samples.begin(), samples.end());
+  update_labels_.insert(update_labels_.end(), labels.begin(), labels.end());
+  Fit(update_samples_, update_labels_);
+}
+
+void GbdtCostModel::Fit(const std::vector<std::vector<float>>& samples, const std::vector<float>& labels) {
+  CHECK_EQ(samples.size(), labels.size()) << "Samples must have same size as labels";
+  nodes_.clear();
+  tree_roots_.clear();
+  base_score_ = 0.f;
+  if (samples.empty()) {
+    return;
+  }
+  num_features_ = samples[0].size();
+  for (const auto& sample : samples) {
+    CHECK_EQ(sample.size(), num_features_) << "Samples must have same number of features in GbdtCostModel";
+  }
+
+  int num_rows = samples.size();
+  std::vector<float> predictions;
+  if (base_model_) {
+    base_score_ = 0.f;
+    predictions = base_model_->Predict(samples);
+  } else {
+    base_score_ = std::accumulate(labels.begin(), labels.end(), 0.0) / num_rows;
+    predictions.assign(num_rows, base_score_);
+  }
+  QuantizedMatrix data(samples, num_features_, params_.max_bins);
+
+  // the gradient and hessian of the squared error are (prediction - label) and 1
+  std::vector<GradStats> gradients(num_rows);
+  for (int round = 0; round < params_.num_rounds; ++round) {
+    for (int i = 0; i < num_rows; ++i) {
+      gradients[i] = {static_cast<double>(predictions[i]) - labels[i], 1.0};
+    }
+    int root = nodes_.size();
+    TreeBuilder(params_, data, gradients, num_features_).Build(&nodes_, &predictions);
+    tree_roots_.push_back(root);
+  }
+  VLOG(4) << "GbdtCostModel trains " << tree_roots_.size() << " trees with " << nodes_.size() << " nodes on "
+          << num_rows << " samples";
+}
+
+float GbdtCostModel::PredictOne(const float* sample) const {
+  float result = 0.f;
+  for (int root : tree_roots_) {
+    int id = root;
+    while (nodes_[id].feature >= 0) {
+      const Node& node = nodes_[id];
+      id               = sample[node.feature] < node.threshold ? node.left : node.right;
+    }
+    result += nodes_[id].value;
+  }
+  return result;
+}
+
+std::vector<float> GbdtCostModel::Predict(const std::vector<std::vector<float>>& samples) const {
+  std::vector<float> result(samples.size(), base_score_);
+  if (base_model_) {
+    std::vector<float> base_result = base_model_->Predict(samples);
+    for (size_t i = 0; i < result.size(); ++i) {
+      result[i] += base_result[i];
+    }
+  }
+  if (tree_roots_.empty()) {
+    return result;
+  }
+  for (const auto& sample : samples) {
+    CHECK_EQ(sample.size(), num_features_) << "The number of features is not equal to the trained one";
+  }
+  int num_chunks = (samples.size() + kPredictChunkSize - 1) / kPredictChunkSize;
+  ParallelFor(num_chunks, static_cast<int64_t>(samples.size()) * nodes_.size(), [&](int chunk) {
+    size_t end = std::min(samples.size(), static_cast<size_t>(chunk + 1) * kPredictChunkSize);
+    for (size_t i = static_cast<size_t>(chunk) * kPredictChunkSize; i < end; ++i) {
+      result[i] += PredictOne(samples[i].data());
+    }
+  });
+  return result;
+}
+
+void GbdtCostModel::Save(const std::string& path) {
+  std::ofstream os(path);
+  CHECK(os.good()) << "Cannot open the file to save GbdtCostModel: " << path;
+  os << std::setprecision(std::numeric_limits<float>::max_digits10);
+  os << kModelMagic << " " << kModelVersion << "\n";
+  os << params_.num_rounds << " " << params_.max_depth << " " << params_.learning_rate << " " << params_.lambda << " "
+     << params_.min_child_weight << " " << params_.min_split_gain << " " << params_.max_bins << "\n";
+  os << num_features_ << " " << base_score_ << " " << tree_roots_.size() << " " << nodes_.size() << "\n";
+  for (int root : tree_roots_) {
+    os << root << " ";
+  }
+  os << "\n";
+  for (const Node& node : nodes_) {
+    os << node.feature << " " << node.threshold << " " << node.left << " " << node.right << " " << node.value << "\n";
+  }
+  CHECK(os.good()) << "Failed to save GbdtCostModel to " << path;
+}
+
+void GbdtCostModel::Load(const std::string& path) {
+  std::ifstream is(path);
+  CHECK(is.good()) << "Cannot open the file to load GbdtCostModel: " << path;
+  std::string magic;
+  int version = 0;
+  is >> magic >> version;
+  CHECK_EQ(magic, kModelMagic) << path << " is not a saved GbdtCostModel";
+  CHECK_EQ(version, kModelVersion) << "Unsupported version of GbdtCostModel in " << path;
+
+  size_t num_trees = 0, num_nodes = 0;
+  is >> params_.num_rounds >> params_.max_depth >> params_.learning_rate >> params_.lambda >>
+      params_.min_child_weight >> params_.min_split_gain >> params_.max_bins;
+  is >> num_features_ >> base_score_ >> num_trees >> num_nodes;
+  tree_roots_.resize(num_trees);
+  for (int& root : tree_roots_) {
+    is >> root;
+  }
+  nodes_.resize(num_nodes);
+  for (Node& node : nodes_) {
+    is >> node.feature >> node.threshold >> node.left >> node.right >> node.value;
+  }
+  CHECK(!is.fail()) << "Failed to load GbdtCostModel from " << path;
+  update_samples_.clear();
+  update_labels_.clear();
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
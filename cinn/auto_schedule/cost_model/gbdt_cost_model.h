@@ -0,0 +1,110 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cinn/common/cost_model.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+/**
+ * A native C++ cost model of gradient boosted decision trees, which minimizes
+ * the squared error as the default objective of xgboost does.
+ *
+ * Training quantizes each feature into at most Params::max_bins bins and grows
+ * the trees on histograms of gradients. Only the histogram of the smaller child
+ * is built from the samples, the larger one is got by subtracting it from the
+ * parent's. The trees are stored in a flat node array, and a batch of samples
+ * is predicted in multiple threads.
+ */
+class GbdtCostModel : public CostModel {
+ public:
+  struct Params {
+    // the number of boosting rounds, each round adds a tree
+    int num_rounds = 10;
+    int max_depth  = 6;
+    // the shrinkage of the leaf values
+    float learning_rate = 0.3f;
+    // L2 regularization on the leaf values
+    float lambda = 1.0f;
+    // the minimum sum of hessian in a child
+    float min_child_weight = 1.0f;
+    // the minimum loss reduction to split a node
+    float min_split_gain = 0.0f;
+    // the maximum number of bins of a feature, should be in [2, 256]
+    int max_bins = 256;
+  };
+
+  GbdtCostModel() = default;
+  explicit GbdtCostModel(const Params& params);
+  ~GbdtCostModel() = default;
+
+  void Train(const std::vector<std::vector<float>>& samples, const std::vector<float>& labels) override;
+
+  std::vector<float> Predict(const std::vector<std::vector<float>>& samples) const override;
+
+  // Retrain the model on all the samples trained and updated so far.
+  void Update(const std::vector<std::vector<float>>& samples, const std::vector<float>& labels) override;
+
+  void Save(const std::string& path) override;
+
+  void Load(const std::string& path) override;
+
+  int NumTrees() const { return tree_roots_.size(); }
+
+  // Boost from a pre-trained model, so the trees of this model are fitted on
+  // the residual of the base model. It takes effect in the following
+  // training, and Save/Load don't include the base model.
+  void SetBaseModel(std::shared_ptr<const GbdtCostModel> base_model) { base_model_ = std::move(base_model); }
+
+ private:
+  // A node of a tree, it is a leaf if feature < 0. The samples whose
+  // feature value is less than threshold go to the left child. The children
+  // are indices in nodes_.
+  struct Node {
+    int feature     = -1;
+    float threshold = 0.f;
+    int left        = -1;
+    int right       = -1;
+    float value     = 0.f;
+  };
+
+  void Fit(const std::vector<std::vector<float>>& samples, const std::vector<float>& labels);
+
+  // Returns the sum of the leaf values of all trees
+  float PredictOne(const float* sample) const;
+
+  Params params_;
+  int num_features_ = 0;
+  // the initial prediction, which is the mean of the labels if there is no base model
+  float base_score_ = 0.f;
+  std::shared_ptr<const GbdtCostModel> base_model_;
+  // nodes of all the trees
+  std::vector<Node> nodes_;
+  // the index of the root in nodes_ for each tree
+  std::vector<int> tree_roots_;
+
+  std::vector<std::vector<float>> update_samples_;
+  std::vector<float> update_labels_;
+};
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,138 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/cost_model/gbdt_cost_model.h"
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+namespace cinn {
+namespace auto_schedule {
+
+// label = 2 * x0 + x1 * x1, x2 is noise
+void GenerateSamples(int batch_size, std::vector<std::vector<float>>* samples, std::vector<float>* labels) {
+  samples->assign(batch_size, std::vector<float>(3));
+  labels->resize(batch_size);
+  for (int i = 0; i < batch_size; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      (*samples)[i][j] = rand() % 10;
+    }
+    (*labels)[i] = 2 * (*samples)[i][0] + (*samples)[i][1] * (*samples)[i][1];
+  }
+}
+
+float MeanSquaredError(const std::vector<float>& pred, const std::vector<float>& labels) {
+  float error = 0.f;
+  for (size_t i = 0; i < pred.size(); ++i) {
+    error += (pred[i] - labels[i]) * (pred[i] - labels[i]);
+  }
+  return error / pred.size();
+}
+
+TEST(GbdtCostModel, TrainAndPredict) {
+  srand(0);
+  std::vector<std::vector<float>> samples;
+  std::vector<float> labels;
+  GenerateSamples(512, &samples, &labels);
+
+  GbdtCostModel::Params params;
+  params.num_rounds = 50;
+  GbdtCostModel cost_model(params);
+  cost_model.Train(samples, labels);
+  ASSERT_EQ(cost_model.NumTrees(), 50);
+
+  // the variance of the labels is about 800
+  std::vector<float> pred = cost_model.Predict(samples);
+  ASSERT_EQ(pred.size(), labels.size());
+  EXPECT_LT(MeanSquaredError(pred, labels), 1.0f);
+
+  std::vector<std::vector<float>> test_samples;
+  std::vector<float> test_labels;
+  GenerateSamples(1000, &test_samples, &test_labels);
+  EXPECT_LT(MeanSquaredError(cost_model.Predict(test_samples), test_labels), 1.0f);
+}
+
+TEST(GbdtCostModel, SaveLoadAndUpdate) {
+  srand(0);
+  std::vector<std::vector<float>> samples;
+  std::vector<float> labels;
+  GenerateSamples(64, &samples, &labels);
+
+  GbdtCostModel cost_model;
+  // an untrained model predicts zeros
+  ASSERT_EQ(cost_model.Predict(samples), std::vector<float>(samples.size(), 0.f));
+  cost_model.Train(samples, labels);
+  std::vector<float> pred = cost_model.Predict(samples);
+
+  std::string path = "./test_gbdt_cost_model.cpp_save_model";
+  cost_model.Save(path);
+  GbdtCostModel load_cost_model;
+  load_cost_model.Load(path);
+  std::remove(path.c_str());
+  ASSERT_EQ(load_cost_model.NumTrees(), cost_model.NumTrees());
+  std::vector<float> load_pred = load_cost_model.Predict(samples);
+  ASSERT_EQ(pred.size(), load_pred.size());
+  for (size_t i = 0; i < pred.size(); ++i) {
+    ASSERT_EQ(pred[i], load_pred[i]);
+  }
+
+  std::vector<std::vector<float>> new_samples;
+  std::vector<float> new_labels;
+  GenerateSamples(64, &new_samples, &new_labels);
+  float error_before = MeanSquaredError(cost_model.Predict(new_samples), new_labels);
+  cost_model.Update(new_samples, new_labels);
+  float error_after = MeanSquaredError(cost_model.Predict(new_samples), new_labels);
+  VLOG(6) << "Mean squared error before update: " << error_before << ", after update: " << error_after;
+  EXPECT_LE(error_after, error_before);
+}
+
+TEST(GbdtCostModel, BoostFromBaseModel) {
+  srand(0);
+  std::vector<std::vector<float>> samples;
+  std::vector<float> labels;
+  GenerateSamples(512, &samples, &labels);
+  auto base_model = std::make_shared<GbdtCostModel>();
+  base_model->Train(samples, labels);
+
+  // a related workload whose costs are shifted, with only a few samples
+  auto shift_fn = [](std::vector<float>* labels) {
+    for (float& label : *labels) {
+      label += 5.f;
+    }
+  };
+  GenerateSamples(16, &samples, &labels);
+  shift_fn(&labels);
+  std::vector<std::vector<float>> test_samples;
+  std::vector<float> test_labels;
+  GenerateSamples(1000, &test_samples, &test_labels);
+  shift_fn(&test_labels);
+
+  GbdtCostModel cold_model;
+  cold_model.Train(samples, labels);
+  GbdtCostModel warm_model;
+  warm_model.SetBaseModel(base_model);
+  warm_model.Train(samples, labels);
+  float cold_error = MeanSquaredError(cold_model.Predict(test_samples), test_labels);
+  float warm_error = MeanSquaredError(warm_model.Predict(test_samples), test_labels);
+  VLOG(6) << "Mean squared error of cold model: " << cold_error << ", warm model: " << warm_error;
+  EXPECT_LT(warm_error, cold_error);
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
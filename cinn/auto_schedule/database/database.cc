@@ -18,6 +18,8 @@
 #include <google/protobuf/text_format.h>
 #include <google/protobuf/util/json_util.h>
 
+#include <algorithm>
+
 #include "cinn/ir/ir_schedule.h"
 
 namespace cinn {
@@ -27,14 +29,100 @@ bool TuningRecord::Compare::operator()(const TuningRecord& lhs, const TuningReco
   return lhs.execution_cost < rhs.execution_cost;
 }
 
+TuningRecord::TuningRecord(const proto::TuningRecord& record_proto)
+    : task_key(record_proto.task_key()),
+      execution_cost(record_proto.execution_cost()),
+      state(ir::ModuleExpr()),
+      workload_pattern(record_proto.workload_pattern()),
+      block_names(record_proto.block_names().begin(), record_proto.block_names().end()) {
+  state.trace = TraceFromProto(record_proto.trace());
+}
+
 proto::TuningRecord TuningRecord::ToProto() const {
   proto::TuningRecord record_proto;
   record_proto.set_task_key(task_key);
   record_proto.set_execution_cost(execution_cost);
+  *record_proto.mutable_trace() = TraceToProto(state.trace);
+  record_proto.set_workload_pattern(workload_pattern);
+  for (const std::string& name : block_names) {
+    record_proto.add_block_names(name);
+  }
 
   return record_proto;
 }
 
+proto::ScheduleTrace TraceToProto(const ir::ScheduleTrace& trace) {
+  proto::ScheduleTrace trace_proto;
+  trace_proto.set_replayable(trace.IsReplayable());
+  for (const auto& step : trace.GetSteps()) {
+    auto* step_proto = trace_proto.add_steps();
+    step_proto->set_type(step.type);
+    for (const auto& ref : step.inputs) {
+      auto* ref_proto = step_proto->add_inputs();
+      ref_proto->set_block_name(ref.block_name);
+      ref_proto->set_loop_index(ref.loop_index);
+    }
+    for (const auto& attr : step.attrs) {
+      auto* attr_proto = step_proto->add_attrs();
+      attr_proto->set_name(attr.first);
+      if (absl::holds_alternative<bool>(attr.second)) {
+        attr_proto->set_b(absl::get<bool>(attr.second));
+      } else if (absl::holds_alternative<int>(attr.second)) {
+        attr_proto->set_i(absl::get<int>(attr.second));
+      } else if (absl::holds_alternative<float>(attr.second)) {
+        attr_proto->set_f(absl::get<float>(attr.second));
+      } else if (absl::holds_alternative<std::string>(attr.second)) {
+        attr_proto->set_s(absl::get<std::string>(attr.second));
+      } else if (absl::holds_alternative<std::vector<int>>(attr.second)) {
+        for (int value : absl::get<std::vector<int>>(attr.second)) {
+          attr_proto->mutable_ints()->add_values(value);
+        }
+      } else {
+        LOG(FATAL) << "Unsupported type of attribute " << attr.first << " in step " << step.type;
+      }
+    }
+  }
+  return trace_proto;
+}
+
+ir::ScheduleTrace TraceFromProto(const proto::ScheduleTrace& trace_proto) {
+  ir::ScheduleTrace trace;
+  for (const auto& step_proto : trace_proto.steps()) {
+    ir::ScheduleTrace::Step step;
+    step.type = step_proto.type();
+    for (const auto& ref_proto : step_proto.inputs()) {
+      step.inputs.push_back({ref_proto.block_name(), ref_proto.loop_index()});
+    }
+    for (const auto& attr_proto : step_proto.attrs()) {
+      switch (attr_proto.value_case()) {
+        case proto::ScheduleTrace::Attr::kB:
+          step.attrs[attr_proto.name()] = attr_proto.b();
+          break;
+        case proto::ScheduleTrace::Attr::kI:
+          step.attrs[attr_proto.name()] = attr_proto.i();
+          break;
+        case proto::ScheduleTrace::Attr::kF:
+          step.attrs[attr_proto.name()] = attr_proto.f();
+          break;
+        case proto::ScheduleTrace::Attr::kS:
+          step.attrs[attr_proto.name()] = attr_proto.s();
+          break;
+        case proto::ScheduleTrace::Attr::kInts:
+          step.attrs[attr_proto.name()] =
+              std::vector<int>(attr_proto.ints().values().begin(), attr_proto.ints().values().end());
+          break;
+        default:
+          LOG(FATAL) << "Attribute " << attr_proto.name() << " in step " << step.type << " has no value";
+      }
+    }
+    trace.Append(step);
+  }
+  if (!trace_proto.replayable()) {
+    trace.SetUnreplayable();
+  }
+  return trace;
+}
+
 Database::Database(int capacity_per_task) : capacity_per_task_(capacity_per_task) {
   CHECK_GT(capacity_per_task_, 0) << "capacity_per_task_ should be greater than 0";
 }
@@ -42,13 +130,19 @@ Database::Database(int capacity_per_task) : capacity_per_task_(capacity_per_task
 bool Database::AddRecord(TuningRecord&& record) {
   CHECK(!record.task_key.empty()) << "task_key of TuningRecord can't be empty";
   Commit(record);
+  Insert(record);
+  return true;
+}
 
+void Database::Insert(const TuningRecord& record) {
   auto& records = key2record_[record.task_key];
   records.emplace(record);
   if (records.size() > capacity_per_task_) {
     records.erase(std::prev(records.end()));
   }
-  return true;
+  if (!record.workload_pattern.empty()) {
+    pattern2keys_[record.workload_pattern].insert(record.task_key);
+  }
 }
 
 std::vector<TuningRecord> Database::LookUp(const std::string& task_key) {
@@ -84,6 +178,28 @@ std::vector<SearchState> Database::GetTopK(const std::string& task_key, int k) {
   return results;
 }
 
+std::vector<TuningRecord> Database::LookUpRelated(const std::string& workload_pattern,
+                                                  const std::string& task_key,
+                                                  int k) {
+  auto pit = pattern2keys_.find(workload_pattern);
+  if (pit == pattern2keys_.end() || k <= 0) {
+    return {};
+  }
+
+  std::vector<TuningRecord> results;
+  for (const std::string& key : pit->second) {
+    auto fit = key2record_.find(key);
+    if (key != task_key && fit != key2record_.end() && !fit->second.empty()) {
+      results.push_back(*fit->second.begin());
+    }
+  }
+  std::sort(results.begin(), results.end(), TuningRecord::Compare());
+  if (results.size() > k) {
+    results.resize(k);
+  }
+  return results;
+}
+
 size_t Database::Size() {
   auto res =
       std::accumulate(key2record_.begin(), key2record_.end(), size_t(0), [](size_t res, const auto& kv) -> size_t {
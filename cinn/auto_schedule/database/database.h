@@ -18,10 +18,16 @@
 #include <google/protobuf/text_format.h>
 #include <google/protobuf/util/json_util.h>
 
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #include "cinn/auto_schedule/auto_schedule.pb.h"
 #include "cinn/auto_schedule/measure/measure.h"
 #include "cinn/auto_schedule/search_space/search_state.h"
 #include "cinn/ir/ir_schedule.h"
+#include "cinn/ir/schedule_trace.h"
 
 namespace cinn {
 namespace auto_schedule {
@@ -34,6 +40,10 @@ struct TuningRecord {
   double execution_cost;  // unit: us
   // the searched candidate to be saved
   SearchState state;
+  // the key shared by related tasks, see TuneTask::workload_pattern
+  std::string workload_pattern;
+  // the names of the schedule blocks of the un-optimized task in order, see TuneTask::GetBlockNames
+  std::vector<std::string> block_names;
 
   // a binary compare function that denotes when the left
   // will be sorted in the front of the right
@@ -43,9 +53,9 @@ struct TuningRecord {
 
   TuningRecord() = default;
 
-  // initialize a TuningRecord object from a proto object
-  TuningRecord(const proto::TuningRecord& record_proto)
-      : task_key(record_proto.task_key()), execution_cost(record_proto.execution_cost()), state(ir::ModuleExpr()) {}
+  // initialize a TuningRecord object from a proto object, only the trace of
+  // the state is restored, which should be replayed on the lowered task
+  TuningRecord(const proto::TuningRecord& record_proto);
 
   TuningRecord(const std::string& task_key, double execution_cost, const SearchState& state)
       : task_key(task_key), execution_cost(execution_cost), state(state) {}
@@ -54,6 +64,10 @@ struct TuningRecord {
   proto::TuningRecord ToProto() const;
 };
 
+// convert a ScheduleTrace to/from its proto object
+proto::ScheduleTrace TraceToProto(const ir::ScheduleTrace& trace);
+ir::ScheduleTrace TraceFromProto(const proto::ScheduleTrace& trace_proto);
+
 // A database supports insert or lookup historial tuning result with sepecified traits.
 // It can be implemented with a concrete storage to save/load underlying data,
 // such as memory, file, database server and so on, this base class can be regarded as
@@ -69,6 +83,9 @@ class Database {
   std::vector<TuningRecord> LookUp(const std::string& task_key);
   // return the states of the top k in sorted candidates
   std::vector<SearchState> GetTopK(const std::string& task_key, int k);
+  // return the best records of at most k tasks sharing the workload pattern
+  // other than the specified one, sorted by their costs
+  std::vector<TuningRecord> LookUpRelated(const std::string& workload_pattern, const std::string& task_key, int k);
   // return the total number of stored candidates
   size_t Size();
   // return the number of stored candidates with specified key
@@ -78,8 +95,13 @@ class Database {
   // commit the newly added record into underlying storage
   virtual bool Commit(const TuningRecord& record) { return true; }
 
+  // insert a record in memory and drop the worst one of its task if the capacity is exceeded
+  void Insert(const TuningRecord& record);
+
   // map task_key to its records
   std::unordered_map<std::string, std::multiset<TuningRecord, TuningRecord::Compare>> key2record_;
+  // map workload_pattern to the task_keys of its records
+  std::unordered_map<std::string, std::set<std::string>> pattern2keys_;
   // the max number of candidates stored
   const int capacity_per_task_;
 };
@@ -16,6 +16,8 @@
 
 #include <gtest/gtest.h>
 
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "cinn/auto_schedule/auto_schedule.pb.h"
@@ -69,5 +71,28 @@ TEST_F(TestDatabase, GetTopK) {
   EXPECT_FLOAT_EQ(states[1].predicted_cost, 1.0);
 }
 
+TEST_F(TestDatabase, LookUpRelated) {
+  auto add_record_fn = [this](const std::string& key, const std::string& pattern, double cost) {
+    TuningRecord record(key, cost, SearchState(ir::ModuleExpr()));
+    record.workload_pattern = pattern;
+    test_db.AddRecord(std::move(record));
+  };
+  add_record_fn("k5", "p1", 6.0);
+  add_record_fn("k5", "p1", 5.0);
+  add_record_fn("k6", "p1", 3.0);
+  add_record_fn("k7", "p1", 4.0);
+  add_record_fn("k8", "p2", 1.0);
+
+  // the best record of each other task with the pattern, sorted by cost
+  auto records = test_db.LookUpRelated("p1", "k7", 3);
+  ASSERT_EQ(records.size(), 2);
+  EXPECT_EQ(records[0].task_key, "k6");
+  EXPECT_EQ(records[1].task_key, "k5");
+  EXPECT_EQ(records[1].execution_cost, 5.0);
+  ASSERT_EQ(test_db.LookUpRelated("p1", "k7", 1).size(), 1);
+  EXPECT_TRUE(test_db.LookUpRelated("p2", "k8", 3).empty());
+  EXPECT_TRUE(test_db.LookUpRelated("p3", "k1", 3).empty());
+}
+
 }  // namespace auto_schedule
 }  // namespace cinn
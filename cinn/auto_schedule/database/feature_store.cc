@@ -0,0 +1,94 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/database/feature_store.h"
+
+#include <glog/logging.h>
+#include <google/protobuf/util/json_util.h>
+
+#include <utility>
+
+#include "cinn/auto_schedule/database/jsonfile_database.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+FeatureRecord::FeatureRecord(const proto::FeatureRecord& record_proto)
+    : task_key(record_proto.task_key()),
+      workload_pattern(record_proto.workload_pattern()),
+      features(record_proto.features().begin(), record_proto.features().end()),
+      execution_cost(record_proto.execution_cost()) {}
+
+proto::FeatureRecord FeatureRecord::ToProto() const {
+  proto::FeatureRecord record_proto;
+  record_proto.set_task_key(task_key);
+  record_proto.set_workload_pattern(workload_pattern);
+  for (float value : features) {
+    record_proto.add_features(value);
+  }
+  record_proto.set_execution_cost(execution_cost);
+  return record_proto;
+}
+
+FeatureStore::FeatureStore(const std::string& record_file_path, bool allow_new_file)
+    : record_file_path_(record_file_path) {
+  if (record_file_path_.empty()) {
+    return;
+  }
+  for (const std::string& json_string : ReadLinesFromFile(record_file_path_, allow_new_file)) {
+    proto::FeatureRecord record_proto;
+    auto status = google::protobuf::util::JsonStringToMessage(json_string, &record_proto);
+    CHECK(status.ok()) << "Failed to parse JSON: " << json_string;
+    pattern2indices_[record_proto.workload_pattern()].push_back(records_.size());
+    records_.emplace_back(record_proto);
+  }
+  VLOG(3) << "FeatureStore loads " << records_.size() << " records from " << record_file_path_;
+}
+
+void FeatureStore::AddRecord(FeatureRecord&& record) {
+  if (!record_file_path_.empty()) {
+    std::string json_string;
+    auto status = google::protobuf::util::MessageToJsonString(record.ToProto(), &json_string);
+    CHECK(status.ok()) << "Failed to serialize record to JSON, task key = " << record.task_key;
+    AppendLineToFile(record_file_path_, json_string);
+  }
+  pattern2indices_[record.workload_pattern].push_back(records_.size());
+  records_.emplace_back(std::move(record));
+}
+
+void FeatureStore::GetSamples(const std::string& workload_pattern,
+                              size_t feature_size,
+                              std::vector<std::vector<float>>* samples,
+                              std::vector<float>* labels) const {
+  auto it = pattern2indices_.find(workload_pattern);
+  if (it == pattern2indices_.end()) {
+    return;
+  }
+  for (size_t index : it->second) {
+    const FeatureRecord& record = records_[index];
+    if (record.features.size() != feature_size) {
+      continue;
+    }
+    samples->push_back(record.features);
+    labels->push_back(record.execution_cost);
+  }
+}
+
+size_t FeatureStore::Count(const std::string& workload_pattern) const {
+  auto it = pattern2indices_.find(workload_pattern);
+  return it == pattern2indices_.end() ? 0 : it->second.size();
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,93 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "cinn/auto_schedule/auto_schedule.pb.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+// The features of a measured candidate and its cost, used to train cost models
+struct FeatureRecord {
+  // the unique key to identify a task
+  std::string task_key;
+  // the key shared by related tasks, see TuneTask::workload_pattern
+  std::string workload_pattern;
+  // the fixed size feature vector of the candidate
+  std::vector<float> features;
+  // the cost time of the candidate executed during measure
+  double execution_cost;  // unit: us
+
+  FeatureRecord() = default;
+
+  FeatureRecord(const proto::FeatureRecord& record_proto);
+
+  FeatureRecord(const std::string& task_key,
+                const std::string& workload_pattern,
+                const std::vector<float>& features,
+                double execution_cost)
+      : task_key(task_key), workload_pattern(workload_pattern), features(features), execution_cost(execution_cost) {}
+
+  proto::FeatureRecord ToProto() const;
+};
+
+// A store of the features and labels of all measured candidates, so a cost
+// model can be pre-trained by the history of related tasks. Unlike
+// Database, which only keeps the best candidates of a task, all records
+// are kept. The records are appended to a json file if a path is given.
+class FeatureStore {
+ public:
+  /*!
+   * \brief Build a FeatureStore object from a json file.
+   * \param record_file_path The path of the json file, the records are only kept in memory if it is empty.
+   * \param allow_new_file Whether to create new file when the given path is not found.
+   */
+  explicit FeatureStore(const std::string& record_file_path = "", bool allow_new_file = true);
+
+  // add a record into the store
+  void AddRecord(FeatureRecord&& record);
+
+  /*!
+   * \brief Get the training samples of a workload pattern.
+   * \param workload_pattern The pattern of the records to get.
+   * \param feature_size The size of features, the records with a different size, which are saved by
+   * another version of feature extraction, are skipped.
+   * \param samples The output features.
+   * \param labels The output costs.
+   */
+  void GetSamples(const std::string& workload_pattern,
+                  size_t feature_size,
+                  std::vector<std::vector<float>>* samples,
+                  std::vector<float>* labels) const;
+
+  // return the number of records of a workload pattern
+  size_t Count(const std::string& workload_pattern) const;
+
+  // return the total number of records
+  size_t Size() const { return records_.size(); }
+
+ private:
+  std::string record_file_path_;
+  std::vector<FeatureRecord> records_;
+  // map workload_pattern to the indices of its records
+  std::unordered_map<std::string, std::vector<size_t>> pattern2indices_;
+};
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,64 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/database/feature_store.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace cinn {
+namespace auto_schedule {
+
+TEST(FeatureStore, AddAndGetSamples) {
+  FeatureStore store;
+  store.AddRecord(FeatureRecord("k1", "pattern1", {1.f, 2.f}, 1.0));
+  store.AddRecord(FeatureRecord("k2", "pattern1", {3.f, 4.f}, 2.0));
+  store.AddRecord(FeatureRecord("k3", "pattern2", {5.f, 6.f}, 3.0));
+  // saved by another version of feature extraction
+  store.AddRecord(FeatureRecord("k1", "pattern1", {7.f}, 4.0));
+  ASSERT_EQ(store.Size(), 4UL);
+  ASSERT_EQ(store.Count("pattern1"), 3UL);
+  ASSERT_EQ(store.Count("pattern3"), 0UL);
+
+  std::vector<std::vector<float>> samples;
+  std::vector<float> labels;
+  store.GetSamples("pattern1", 2, &samples, &labels);
+  ASSERT_EQ(samples, std::vector<std::vector<float>>({{1.f, 2.f}, {3.f, 4.f}}));
+  ASSERT_EQ(labels, std::vector<float>({1.f, 2.f}));
+}
+
+TEST(FeatureStore, SaveAndLoad) {
+  std::string path = "./test_feature_store.json";
+  std::remove(path.c_str());
+  {
+    FeatureStore store(path);
+    store.AddRecord(FeatureRecord("k1", "pattern1", {1.f, 2.5f}, 1.5));
+    store.AddRecord(FeatureRecord("k2", "pattern2", {3.f, 4.f}, 2.0));
+  }
+
+  FeatureStore loaded_store(path, false);
+  ASSERT_EQ(loaded_store.Size(), 2UL);
+  std::vector<std::vector<float>> samples;
+  std::vector<float> labels;
+  loaded_store.GetSamples("pattern1", 2, &samples, &labels);
+  ASSERT_EQ(samples, std::vector<std::vector<float>>({{1.f, 2.5f}}));
+  ASSERT_EQ(labels, std::vector<float>({1.5f}));
+  std::remove(path.c_str());
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -61,11 +61,7 @@ JSONFileDatabase::JSONFileDatabase(int capacity_per_task, const std::string& rec
   utils::parallel_run(worker_fn, utils::SequenceDispatcher(0, json_lines.size()), -1);
 
   for (const auto& record : all_records) {
-    auto& records = this->key2record_[record.task_key];
-    records.emplace(record);
-    if (records.size() > this->capacity_per_task_) {
-      records.erase(std::prev(records.end()));
-    }
+    this->Insert(record);
   }
 }
 
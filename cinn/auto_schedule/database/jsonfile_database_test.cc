@@ -17,10 +17,12 @@
 #include <gtest/gtest.h>
 
 #include <fstream>
+#include <string>
 #include <vector>
 
 #include "cinn/auto_schedule/search_space/search_state.h"
 #include "cinn/ir/ir_schedule.h"
+#include "cinn/ir/schedule_trace.h"
 
 namespace cinn {
 namespace auto_schedule {
@@ -75,25 +77,57 @@ class TestJSONFileDatabase : public ::testing::Test {
 TEST_F(TestJSONFileDatabase, SerializeAndDeserialize) {
   TuningRecord record1("test", 1.0, SearchState(ir::ModuleExpr()));
   std::string str = test_db.RecordToJSON(record1);
-  EXPECT_EQ(str, "{\"taskKey\":\"test\",\"executionCost\":1}");
+  EXPECT_EQ(str, "{\"taskKey\":\"test\",\"executionCost\":1,\"trace\":{\"replayable\":true}}");
 
   TuningRecord record2 = test_db.JSONToRecord(str);
   EXPECT_EQ(record1.task_key, record2.task_key);
   EXPECT_EQ(record1.execution_cost, record2.execution_cost);
 }
 
+TEST_F(TestJSONFileDatabase, SerializeAndDeserializeTrace) {
+  ir::ScheduleTrace trace;
+  trace.Append({"Split", {{"B", 0}}, {{"factors", std::vector<int>({4, -1})}}});
+  trace.Append({"CacheRead", {{"B", -1}}, {{"read_buffer_index", 0}, {"memory_type", std::string("local")}}});
+  SearchState state(ir::ModuleExpr{});
+  state.trace = trace;
+  TuningRecord record1("test", 1.0, state);
+  record1.workload_pattern = "pattern";
+  record1.block_names      = {"A", "B"};
+  std::string str          = test_db.RecordToJSON(record1);
+
+  TuningRecord record2 = test_db.JSONToRecord(str);
+  EXPECT_EQ(record2.workload_pattern, "pattern");
+  EXPECT_EQ(record2.block_names, std::vector<std::string>({"A", "B"}));
+  EXPECT_TRUE(record2.state.trace.IsReplayable());
+  const auto& steps = record2.state.trace.GetSteps();
+  ASSERT_EQ(steps.size(), 2);
+  EXPECT_EQ(steps[0].type, "Split");
+  ASSERT_EQ(steps[0].inputs.size(), 1);
+  EXPECT_EQ(steps[0].inputs[0].block_name, "B");
+  EXPECT_EQ(steps[0].inputs[0].loop_index, 0);
+  EXPECT_EQ(absl::get<std::vector<int>>(steps[0].attrs.at("factors")), std::vector<int>({4, -1}));
+  EXPECT_EQ(steps[1].type, "CacheRead");
+  EXPECT_EQ(steps[1].inputs[0].loop_index, -1);
+  EXPECT_EQ(absl::get<int>(steps[1].attrs.at("read_buffer_index")), 0);
+  EXPECT_EQ(absl::get<std::string>(steps[1].attrs.at("memory_type")), "local");
+
+  state.trace.SetUnreplayable();
+  TuningRecord record3 = test_db.JSONToRecord(test_db.RecordToJSON(TuningRecord("test", 1.0, state)));
+  EXPECT_FALSE(record3.state.trace.IsReplayable());
+}
+
 TEST_F(TestJSONFileDatabase, SaveLoad) {
   std::vector<std::string> strs = ReadLinesFromFile(record_file_path);
   ASSERT_EQ(strs.size(), 9);
-  EXPECT_EQ(strs[0], "{\"taskKey\":\"k1\",\"executionCost\":1}");
-  EXPECT_EQ(strs[1], "{\"taskKey\":\"k2\",\"executionCost\":2}");
-  EXPECT_EQ(strs[2], "{\"taskKey\":\"k2\",\"executionCost\":3}");
-  EXPECT_EQ(strs[3], "{\"taskKey\":\"k3\",\"executionCost\":3}");
-  EXPECT_EQ(strs[4], "{\"taskKey\":\"k3\",\"executionCost\":4}");
-  EXPECT_EQ(strs[5], "{\"taskKey\":\"k3\",\"executionCost\":5}");
-  EXPECT_EQ(strs[6], "{\"taskKey\":\"k4\",\"executionCost\":4}");
-  EXPECT_EQ(strs[7], "{\"taskKey\":\"k4\",\"executionCost\":2}");
-  EXPECT_EQ(strs[8], "{\"taskKey\":\"k4\",\"executionCost\":3}");
+  EXPECT_EQ(strs[0], "{\"taskKey\":\"k1\",\"executionCost\":1,\"trace\":{\"replayable\":true}}");
+  EXPECT_EQ(strs[1], "{\"taskKey\":\"k2\",\"executionCost\":2,\"trace\":{\"replayable\":true}}");
+  EXPECT_EQ(strs[2], "{\"taskKey\":\"k2\",\"executionCost\":3,\"trace\":{\"replayable\":true}}");
+  EXPECT_EQ(strs[3], "{\"taskKey\":\"k3\",\"executionCost\":3,\"trace\":{\"replayable\":true}}");
+  EXPECT_EQ(strs[4], "{\"taskKey\":\"k3\",\"executionCost\":4,\"trace\":{\"replayable\":true}}");
+  EXPECT_EQ(strs[5], "{\"taskKey\":\"k3\",\"executionCost\":5,\"trace\":{\"replayable\":true}}");
+  EXPECT_EQ(strs[6], "{\"taskKey\":\"k4\",\"executionCost\":4,\"trace\":{\"replayable\":true}}");
+  EXPECT_EQ(strs[7], "{\"taskKey\":\"k4\",\"executionCost\":2,\"trace\":{\"replayable\":true}}");
+  EXPECT_EQ(strs[8], "{\"taskKey\":\"k4\",\"executionCost\":3,\"trace\":{\"replayable\":true}}");
 }
 
 TEST_F(TestJSONFileDatabase, Basic) {
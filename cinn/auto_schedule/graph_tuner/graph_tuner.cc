@@ -0,0 +1,244 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/graph_tuner/graph_tuner.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <exception>
+#include <limits>
+#include <numeric>
+#include <tuple>
+#include <unordered_set>
+#include <utility>
+
+#include "cinn/auto_schedule/task/tune_task.h"
+#include "cinn/hlir/framework/op.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+using ::cinn::common::GraphNode;
+using ::cinn::hlir::framework::Node;
+using ::cinn::hlir::framework::NodeData;
+using ::cinn::hlir::framework::Operator;
+using ::cinn::hlir::framework::OpPatternKind;
+using Grouping = std::vector<std::vector<Node*>>;
+
+GraphTuner::GraphTuner(hlir::framework::Graph* graph,
+                       hlir::framework::GraphCompiler* graph_compiler,
+                       ScheduleMeasurer* measurer,
+                       const Config& config)
+    : graph_(graph), graph_compiler_(graph_compiler), measurer_(measurer), config_(config) {
+  CHECK(graph_ && graph_compiler_ && measurer_) << "The graph, graph_compiler and measurer should be set";
+  auto topo_order = graph_->topological_order();
+  int index       = 0;
+  for (GraphNode* n : std::get<0>(topo_order)) {
+    Node* op_node = n->safe_as<Node>();
+    if (op_node) {
+      topo_index_[op_node] = index++;
+    }
+  }
+}
+
+Grouping GraphTuner::Tune(const Grouping& groups) {
+  Grouping result = groups;
+  for (auto& group : result) {
+    std::sort(group.begin(), group.end(), [this](const Node* lhs, const Node* rhs) {
+      return topo_index_.at(lhs) < topo_index_.at(rhs);
+    });
+  }
+  if (result.empty() || config_.num_expensive_groups <= 0) {
+    return result;
+  }
+
+  // measure each group alone to find the expensive ones
+  std::vector<Grouping> singles;
+  for (const auto& group : result) {
+    singles.push_back({group});
+  }
+  std::vector<double> costs = Measure(singles);
+  std::vector<int> order(result.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&costs](int lhs, int rhs) { return costs[lhs] > costs[rhs]; });
+  // the groups are identified by their first node since the indices change as groups are replaced
+  std::vector<Node*> expensive_heads;
+  for (int i = 0; i < order.size() && expensive_heads.size() < config_.num_expensive_groups; ++i) {
+    if (costs[order[i]] < std::numeric_limits<double>::max()) {
+      expensive_heads.push_back(result[order[i]].front());
+    }
+  }
+
+  for (Node* head : expensive_heads) {
+    auto it    = std::find_if(result.begin(), result.end(), [head](const std::vector<Node*>& group) {
+      return std::find(group.begin(), group.end(), head) != group.end();
+    });
+    int index  = it - result.begin();
+    auto cands = ProposeCandidates(result, index);
+    if (cands.empty()) {
+      continue;
+    }
+
+    // the original groups replaced by the candidates are measured in the same batch as baselines
+    std::vector<Grouping> groupings;
+    std::vector<std::pair<int, int>> ranges;
+    for (const Candidate& cand : cands) {
+      if (std::find(ranges.begin(), ranges.end(), std::make_pair(cand.begin, cand.end)) == ranges.end()) {
+        ranges.emplace_back(cand.begin, cand.end);
+        groupings.emplace_back(result.begin() + cand.begin, result.begin() + cand.end);
+      }
+    }
+    for (const Candidate& cand : cands) {
+      groupings.push_back(cand.groups);
+    }
+    std::vector<double> grouping_costs = Measure(groupings);
+
+    int best_cand    = -1;
+    double best_gain = config_.min_improvement;
+    for (int i = 0; i < cands.size(); ++i) {
+      int range_index = std::find(ranges.begin(), ranges.end(), std::make_pair(cands[i].begin, cands[i].end)) -
+                        ranges.begin();
+      double baseline = grouping_costs[range_index];
+      double cost     = grouping_costs[ranges.size() + i];
+      if (baseline == std::numeric_limits<double>::max() || cost == std::numeric_limits<double>::max()) {
+        continue;
+      }
+      double gain = (baseline - cost) / std::max(baseline, 1e-6);
+      VLOG(3) << "Candidate " << i << " of group " << index << " costs " << cost << "us against " << baseline
+              << "us of the original groups";
+      if (gain >= best_gain) {
+        best_cand = i;
+        best_gain = gain;
+      }
+    }
+    if (best_cand == -1) {
+      continue;
+    }
+
+    Candidate& best = cands[best_cand];
+    LOG(INFO) << "Replace " << best.end - best.begin << " group(s) around group " << index << " with "
+              << best.groups.size() << " group(s), the measured latency is reduced by " << best_gain * 100 << "%";
+    result.erase(result.begin() + best.begin, result.begin() + best.end);
+    result.insert(result.begin() + best.begin, best.groups.begin(), best.groups.end());
+  }
+  return result;
+}
+
+std::vector<GraphTuner::Candidate> GraphTuner::ProposeCandidates(const Grouping& groups, int index) const {
+  CHECK(index >= 0 && index < groups.size()) << "The index of group is out of range";
+  std::vector<Candidate> candidates;
+  auto add_candidate_fn = [&](int begin, int end, Grouping new_groups) {
+    if (candidates.size() < config_.max_candidates_per_group) {
+      candidates.push_back(Candidate{begin, end, std::move(new_groups)});
+    }
+  };
+  auto merge_fn = [](const std::vector<Node*>& producer, const std::vector<Node*>& consumer) {
+    std::vector<Node*> merged = producer;
+    merged.insert(merged.end(), consumer.begin(), consumer.end());
+    return merged;
+  };
+
+  // merging saves the traffic of the intermediate variables, so try it firstly
+  const std::vector<Node*>& group = groups[index];
+  if (index > 0 && CanMerge(groups[index - 1], group)) {
+    add_candidate_fn(index - 1, index + 1, {merge_fn(groups[index - 1], group)});
+  }
+  if (index + 1 < groups.size() && CanMerge(group, groups[index + 1])) {
+    add_candidate_fn(index, index + 2, {merge_fn(group, groups[index + 1])});
+  }
+
+  if (group.size() > 1) {
+    // split the group into single ops
+    Grouping singles;
+    for (Node* node : group) {
+      singles.push_back({node});
+    }
+    add_candidate_fn(index, index + 1, std::move(singles));
+    // split the group into two parts at each position, the nodes are in
+    // topological order so the first part never depends on the second one
+    for (int pos = 1; group.size() > 2 && pos < group.size(); ++pos) {
+      add_candidate_fn(index,
+                       index + 1,
+                       {std::vector<Node*>(group.begin(), group.begin() + pos),
+                        std::vector<Node*>(group.begin() + pos, group.end())});
+    }
+  }
+  return candidates;
+}
+
+bool GraphTuner::CanMerge(const std::vector<Node*>& producer, const std::vector<Node*>& consumer) const {
+  // the fused lowering computes the consumers inline, so only the injective ones are merged
+  auto& op_pattern_dict = Operator::GetAttrs<OpPatternKind>("OpPattern");
+  for (const Node* node : consumer) {
+    if (op_pattern_dict[node->op()] > hlir::framework::kInjective) {
+      return false;
+    }
+  }
+
+  std::unordered_set<const Node*> consumer_set(consumer.begin(), consumer.end());
+  for (const Node* node : producer) {
+    for (auto& link : node->outlinks()) {
+      const NodeData* out_var = link->sink()->safe_as<NodeData>();
+      if (!out_var) {
+        continue;
+      }
+      for (auto& out_link : out_var->outlinks()) {
+        const Node* out_node = out_link->sink()->safe_as<Node>();
+        if (out_node && consumer_set.count(out_node)) {
+          return true;
+        }
+      }
+    }
+  }
+  return false;
+}
+
+std::vector<double> GraphTuner::Measure(const std::vector<Grouping>& groupings) {
+  std::vector<double> costs(groupings.size(), std::numeric_limits<double>::max());
+  // the tasks should live until the measurement is done
+  std::vector<TuneTask> tasks(groupings.size());
+  std::vector<MeasureInput> inputs;
+  std::vector<int> input_indices;
+  for (int i = 0; i < groupings.size(); ++i) {
+    tasks[i].task_graph = groupings[i];
+    tasks[i].target     = graph_->target_;
+    MeasureInput input;
+    input.task = &tasks[i];
+    try {
+      input.lowered_funcs = graph_compiler_->FusedGraphToLoweredFunc(groupings[i]);
+    } catch (std::exception& e) {
+      VLOG(3) << "Grouping " << i << " failed to lower, error: " << e.what();
+      continue;
+    }
+    inputs.push_back(std::move(input));
+    input_indices.push_back(i);
+  }
+  if (inputs.empty()) {
+    return costs;
+  }
+
+  std::vector<MeasureResult> results = measurer_->Measure(inputs);
+  for (int i = 0; i < results.size(); ++i) {
+    if (results[i].error_msg.empty()) {
+      costs[input_indices[i]] = results[i].execution_cost;
+    } else {
+      VLOG(3) << "Grouping " << input_indices[i] << " failed to measure, error: " << results[i].error_msg;
+    }
+  }
+  return costs;
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,88 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "cinn/auto_schedule/measure/schedule_measurer.h"
+#include "cinn/common/target.h"
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/node.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+/**
+ * GraphTuner revisits the fusion decisions against measurements.
+ *
+ * The groups of the graph are measured one by one, then the boundaries
+ * around the most expensive ones are changed: a group is split into smaller
+ * groups, or merged with an adjacent group it produces for or consumes from.
+ * Every alternative is measured together with the original groups it replaces
+ * as a sub-program, so the traffic of the intermediate variables is counted,
+ * and the fastest one is kept if it beats the original clearly.
+ */
+class GraphTuner {
+ public:
+  struct Config {
+    // the number of the most expensive groups to revisit
+    int num_expensive_groups = 3;
+    // an alternative replaces the original groups only if it reduces
+    // the measured latency by at least this fraction
+    double min_improvement = 0.02;
+    // the max number of alternatives proposed for a group
+    int max_candidates_per_group = 8;
+  };
+
+  // An alternative grouping, which replaces the groups in [begin, end)
+  struct Candidate {
+    int begin;
+    int end;
+    std::vector<std::vector<hlir::framework::Node*>> groups;
+  };
+
+  GraphTuner(hlir::framework::Graph* graph,
+             hlir::framework::GraphCompiler* graph_compiler,
+             ScheduleMeasurer* measurer,
+             const Config& config);
+
+  // Return the tuned groups, they are in topological order as the input groups.
+  std::vector<std::vector<hlir::framework::Node*>> Tune(const std::vector<std::vector<hlir::framework::Node*>>& groups);
+
+  // Propose the alternatives of groups[index], the original grouping is not included.
+  std::vector<Candidate> ProposeCandidates(const std::vector<std::vector<hlir::framework::Node*>>& groups,
+                                           int index) const;
+
+ private:
+  // Whether the consumer group can be fused into the producer group
+  bool CanMerge(const std::vector<hlir::framework::Node*>& producer,
+                const std::vector<hlir::framework::Node*>& consumer) const;
+
+  // Measure each grouping as a sub-program, the cost of a grouping failed
+  // to lower or measure is the max double.
+  std::vector<double> Measure(const std::vector<std::vector<std::vector<hlir::framework::Node*>>>& groupings);
+
+  hlir::framework::Graph* graph_;
+  hlir::framework::GraphCompiler* graph_compiler_;
+  ScheduleMeasurer* measurer_;
+  Config config_;
+  // the index of each op node in the topological order of the graph
+  std::unordered_map<const hlir::framework::Node*, int> topo_index_;
+};
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,131 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/graph_tuner/graph_tuner.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "cinn/auto_schedule/measure/schedule_measurer.h"
+#include "cinn/auto_schedule/measure/simple_builder.h"
+#include "cinn/auto_schedule/measure/simple_runner.h"
+#include "cinn/common/target.h"
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/syntax.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/node.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+using ::cinn::hlir::framework::BuildScope;
+using ::cinn::hlir::framework::Graph;
+using ::cinn::hlir::framework::GraphCompiler;
+using ::cinn::hlir::framework::Node;
+
+class TestGraphTuner : public ::testing::Test {
+ public:
+  Target target = common::DefaultHostTarget();
+  std::shared_ptr<Graph> graph;
+  std::unique_ptr<GraphCompiler> graph_compiler;
+  std::unique_ptr<ScheduleBuilder> builder;
+  std::unique_ptr<ScheduleRunner> runner;
+  std::unique_ptr<ScheduleMeasurer> measurer;
+  // the groups of the graph, an op a group
+  std::vector<std::vector<Node*>> groups;
+
+  void SetUp() override {
+    frontend::NetBuilder net_builder("test");
+    auto a = net_builder.CreateInput(Float(32), {64, 256}, "A");
+    auto b = net_builder.CreateInput(Float(32), {64, 256}, "B");
+    auto c = net_builder.Add(a, b);
+    auto d = net_builder.Relu(c);
+
+    graph          = std::make_shared<Graph>(net_builder.Build(), target);
+    graph_compiler = std::make_unique<GraphCompiler>(target, BuildScope(target, graph), graph);
+    builder        = std::make_unique<SimpleBuilder>(graph_compiler.get());
+    runner         = std::make_unique<SimpleRunner>(1);
+    measurer       = std::make_unique<ScheduleMeasurer>(builder.get(), runner.get());
+
+    auto topo_order = graph->topological_order();
+    for (auto* n : std::get<0>(topo_order)) {
+      Node* op_node = n->safe_as<Node>();
+      if (op_node) {
+        groups.push_back({op_node});
+      }
+    }
+    ASSERT_EQ(groups.size(), 2UL);
+  }
+};
+
+TEST_F(TestGraphTuner, ProposeCandidates) {
+  GraphTuner graph_tuner(graph.get(), graph_compiler.get(), measurer.get(), GraphTuner::Config());
+
+  // relu consumes the output of add, so they can be merged
+  std::vector<GraphTuner::Candidate> candidates = graph_tuner.ProposeCandidates(groups, 1);
+  ASSERT_EQ(candidates.size(), 1UL);
+  EXPECT_EQ(candidates[0].begin, 0);
+  EXPECT_EQ(candidates[0].end, 2);
+  ASSERT_EQ(candidates[0].groups.size(), 1UL);
+  ASSERT_EQ(candidates[0].groups[0].size(), 2UL);
+  EXPECT_EQ(candidates[0].groups[0][0]->op()->name, "elementwise_add");
+  EXPECT_EQ(candidates[0].groups[0][1]->op()->name, "relu");
+
+  // the merged group can be split back
+  std::vector<std::vector<Node*>> fused_groups = candidates[0].groups;
+  candidates                                   = graph_tuner.ProposeCandidates(fused_groups, 0);
+  ASSERT_EQ(candidates.size(), 1UL);
+  EXPECT_EQ(candidates[0].begin, 0);
+  EXPECT_EQ(candidates[0].end, 1);
+  EXPECT_EQ(candidates[0].groups, groups);
+}
+
+TEST_F(TestGraphTuner, Tune) {
+  GraphTuner::Config config;
+  config.num_expensive_groups = 2;
+  GraphTuner graph_tuner(graph.get(), graph_compiler.get(), measurer.get(), config);
+  std::vector<std::vector<Node*>> tuned_groups = graph_tuner.Tune(groups);
+  // either grouping is valid, it depends on the measurements
+  ASSERT_FALSE(tuned_groups.empty());
+  std::vector<Node*> nodes;
+  for (const auto& group : tuned_groups) {
+    nodes.insert(nodes.end(), group.begin(), group.end());
+  }
+  ASSERT_EQ(nodes.size(), 2UL);
+  EXPECT_EQ(nodes[0], groups[0][0]);
+  EXPECT_EQ(nodes[1], groups[1][0]);
+
+  // the tuned groups can be compiled and run
+  GraphCompiler::CompileOptions compile_options;
+  compile_options.with_instantiate_variables = true;
+  compile_options.groups                     = tuned_groups;
+  compile_options.lowered_funcs              = graph_compiler->FusedGraphToLoweredFunc(tuned_groups);
+  auto runtime_program                       = graph_compiler->Build(compile_options).runtime_program;
+  ASSERT_EQ(runtime_program->size(), tuned_groups.size());
+  runtime_program->Execute();
+}
+
+TEST_F(TestGraphTuner, NoImprovement) {
+  // no grouping can save the whole latency
+  GraphTuner::Config config;
+  config.num_expensive_groups = 2;
+  config.min_improvement      = 1.0;
+  GraphTuner graph_tuner(graph.get(), graph_compiler.get(), measurer.get(), config);
+  EXPECT_EQ(graph_tuner.Tune(groups), groups);
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -40,9 +40,12 @@ struct MeasureInput {
 
 // The result of a measurement
 struct MeasureResult {
-  // The time cost of execution in average of running
-  // with a specific repeated times.
+  // The time cost of execution, which is the median of several
+  // trials, and a trial takes the average of running repeatedly.
   double execution_cost = 0.0;  // unit: us
+  // The 95% confidence interval of execution_cost
+  double execution_cost_lower = 0.0;  // unit: us
+  double execution_cost_upper = 0.0;  // unit: us
   // The time cost of the whole measurement process including
   // building and running
   double elapsed_time = 0.0;  // unit: us
@@ -54,7 +57,10 @@ struct MeasureResult {
 // The result of building with input schedule
 struct BuildResult {
   // The scope that owns detail compilation infos of parameters in the runtime program
-  const hlir::framework::Scope* compiled_scope;
+  std::shared_ptr<hlir::framework::Scope> compiled_scope;
+  // The compiler that owns the compiled module called by the runtime program,
+  // it should live longer than runtime_program if it is set
+  std::unique_ptr<hlir::framework::GraphCompiler> graph_compiler;
   // The executable program
   std::unique_ptr<hlir::framework::Program> runtime_program;
 };
@@ -62,7 +68,8 @@ struct BuildResult {
 // This interface defines how to generate executable objects
 // with input schedule. A builer should not contain stateful data
 // releated to any task so it can be called parallelly among multiple
-// processes of task tuning.
+// processes of task tuning, and Build may be called by multiple
+// threads concurrently.
 class ScheduleBuilder {
  public:
   virtual BuildResult Build(const MeasureInput& input) = 0;
@@ -15,6 +15,7 @@
 #include <gtest/gtest.h>
 
 #include <memory>
+#include <string>
 
 #include "cinn/auto_schedule/measure/schedule_measurer.h"
 #include "cinn/auto_schedule/measure/simple_builder.h"
@@ -24,6 +25,7 @@
 #include "cinn/frontend/net_builder.h"
 #include "cinn/frontend/syntax.h"
 #include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/utils/string.h"
 
 namespace cinn {
 namespace auto_schedule {
@@ -96,6 +98,48 @@ TEST_F(TestMeasurer, Basic) {
   ASSERT_EQ(inputs.size(), results.size());
 }
 
+TEST_F(TestMeasurer, ParallelBuild) {
+  auto builder  = std::make_unique<SimpleBuilder>(graph_compiler.get());
+  auto runner   = std::make_unique<SimpleRunner>(1);
+  auto measurer = std::make_unique<ScheduleMeasurer>(builder.get(), runner.get(), 2, 0);
+  std::vector<MeasureInput> repeated_inputs;
+  for (int i = 0; i < 4; ++i) {
+    repeated_inputs.insert(repeated_inputs.end(), inputs.begin(), inputs.end());
+  }
+  std::vector<MeasureResult> results = measurer->Measure(repeated_inputs);
+  ASSERT_EQ(repeated_inputs.size(), results.size());
+  for (auto&& result : results) {
+    EXPECT_TRUE(result.error_msg.empty()) << result.error_msg;
+    EXPECT_GE(result.elapsed_time, result.execution_cost);
+  }
+
+  const MeasureStatistics& statistics = measurer->GetStatistics();
+  EXPECT_EQ(statistics.num_candidates, repeated_inputs.size());
+  EXPECT_GT(statistics.BuilderUtilization(2), 0.0);
+  EXPECT_LE(statistics.RunnerUtilization(), 1.0);
+}
+
+TEST_F(TestMeasurer, IsolatedBuild) {
+  auto builder       = std::make_unique<SimpleBuilder>(graph_compiler.get());
+  MeasureInput input = inputs[0];
+#ifndef CINN_WITH_CUDA
+  input.lowered_funcs = graph_compiler->FusedGraphToLoweredFunc(input.task->task_graph);
+  std::string funcs_before = utils::GetStreamCnt(input.lowered_funcs[0][0]);
+#endif
+  size_t num_vars = graph_compiler->GetScope()->var_names().size();
+
+  BuildResult result1 = builder->Build(input);
+  BuildResult result2 = builder->Build(input);
+  // each build owns its scope, and the shared scope and lowered funcs are not changed
+  ASSERT_NE(result1.compiled_scope, nullptr);
+  EXPECT_NE(result1.compiled_scope, result2.compiled_scope);
+  EXPECT_NE(result1.compiled_scope, graph_compiler->GetScope());
+  EXPECT_EQ(graph_compiler->GetScope()->var_names().size(), num_vars);
+#ifndef CINN_WITH_CUDA
+  EXPECT_EQ(utils::GetStreamCnt(input.lowered_funcs[0][0]), funcs_before);
+#endif
+}
+
 TEST_F(TestMeasurer, CatchException) {
   auto builder                       = std::make_unique<SimpleBuilder>(graph_compiler.get());
   auto runner                        = std::make_unique<SimpleRunner>(1);
@@ -107,8 +151,7 @@ TEST_F(TestMeasurer, CatchException) {
   EXPECT_EQ(results[0].error_msg, "Build failed, error: BuildError\n");
   EXPECT_EQ(results[1].error_msg, "Build failed, error: BuildError\n");
 
-  // TODO(CtfGo): test parallel build after we support thread-safe compilation
-  auto measurer_with_run_error = std::make_unique<ScheduleMeasurer>(builder.get(), throw_runner.get(), 1);
+  auto measurer_with_run_error = std::make_unique<ScheduleMeasurer>(builder.get(), throw_runner.get(), 2);
   results                      = measurer_with_run_error->Measure(inputs);
   ASSERT_EQ(inputs.size(), results.size());
   EXPECT_EQ(results[0].error_msg, "Run failed, error: RunError\n");
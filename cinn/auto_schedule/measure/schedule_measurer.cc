@@ -14,27 +14,97 @@
 
 #include "cinn/auto_schedule/measure/schedule_measurer.h"
 
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <chrono>
+#include <condition_variable>
 #include <exception>
+#include <mutex>
+#include <queue>
+#include <thread>
 
 #include "cinn/utils/multi_threading.h"
 
 namespace cinn {
 namespace auto_schedule {
 
-ScheduleMeasurer::ScheduleMeasurer(ScheduleBuilder* builder, ScheduleRunner* runner, int num_threads)
-    : builder_(builder), runner_(runner), num_threads_(num_threads) {}
+// Bind the calling thread to the cpu, only supported on linux now.
+static void BindCurrentThreadToCpu(int cpu_id) {
+#ifdef __linux__
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  CPU_SET(cpu_id, &cpu_set);
+  int ret = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpu_set);
+  if (ret != 0) {
+    LOG(WARNING) << "Failed to bind the runner thread to cpu " << cpu_id << ", error code: " << ret;
+  }
+#else
+  LOG(WARNING) << "Binding the runner thread to a cpu is not supported on this platform";
+#endif
+}
+
+namespace {
+
+// Keep the calling thread off a cpu during the lifetime, so that building
+// doesn't disturb the runner bound to that cpu. Only supported on linux now.
+class CpuExclusionGuard {
+ public:
+  explicit CpuExclusionGuard(int cpu_id) {
+#ifdef __linux__
+    if (cpu_id < 0 || pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &old_cpu_set_) != 0) {
+      return;
+    }
+    cpu_set_t cpu_set = old_cpu_set_;
+    CPU_CLR(cpu_id, &cpu_set);
+    restore_ = CPU_COUNT(&cpu_set) > 0 && pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpu_set) == 0;
+#endif
+  }
+
+  ~CpuExclusionGuard() {
+#ifdef __linux__
+    if (restore_) {
+      pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &old_cpu_set_);
+    }
+#endif
+  }
+
+ private:
+#ifdef __linux__
+  cpu_set_t old_cpu_set_;
+#endif
+  bool restore_ = false;
+};
+
+}  // namespace
+
+ScheduleMeasurer::ScheduleMeasurer(ScheduleBuilder* builder, ScheduleRunner* runner, int num_threads, int runner_cpu_id)
+    : builder_(builder), runner_(runner), num_threads_(num_threads), runner_cpu_id_(runner_cpu_id) {
+  CHECK_GT(num_threads_, 0) << "num_threads of ScheduleMeasurer should be greater than 0";
+}
 
 std::vector<MeasureResult> ScheduleMeasurer::Measure(const std::vector<MeasureInput>& inputs) {
   if (inputs.empty()) {
     LOG(WARNING) << "inputs is empty";
     return {};
   }
+  auto measure_start = std::chrono::steady_clock::now();
   std::vector<BuildResult> build_results(inputs.size());
   std::vector<MeasureResult> results(inputs.size());
 
+  // indices of the built candidates waiting to run
+  std::queue<int> built_indices;
+  std::mutex mtx;
+  std::condition_variable built_cv;
+  double build_time = 0.0;
+  double run_time   = 0.0;
+
   // define how to build a candidate with the specified index
-  auto build_fn = [builder = builder_, &inputs, &build_results, &results](int index) {
+  auto build_fn = [&, builder = builder_](int index) {
     VLOG(6) << "Build candidate: " << index;
+    CpuExclusionGuard cpu_guard(runner_cpu_id_);
     auto m_start = std::chrono::steady_clock::now();
     try {
       build_results[index] = builder->Build(inputs[index]);
@@ -43,6 +113,12 @@ std::vector<MeasureResult> ScheduleMeasurer::Measure(const std::vector<MeasureIn
     }
     auto time_span = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_start);
     results[index].elapsed_time += static_cast<double>(time_span.count());
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      build_time += static_cast<double>(time_span.count());
+      built_indices.push(index);
+    }
+    built_cv.notify_one();
   };
 
   // define how to run a candidate with the specified index
@@ -52,24 +128,50 @@ std::vector<MeasureResult> ScheduleMeasurer::Measure(const std::vector<MeasureIn
     try {
       // if error occured in building, then skip running
       if (results[index].error_msg.empty()) {
-        results[index] = runner->Run(inputs[index], build_results[index]);
+        double build_elapsed_time   = results[index].elapsed_time;
+        results[index]              = runner->Run(inputs[index], build_results[index]);
+        results[index].elapsed_time = build_elapsed_time;
       }
     } catch (std::exception& e) {
       results[index].error_msg = utils::StringFormat("Run failed, error: %s\n", e.what());
     }
+    // release the compiled module as soon as possible, and the program
+    // must be released before the compiler which owns the called functions
+    build_results[index].runtime_program.reset();
+    build_results[index].graph_compiler.reset();
     auto time_span = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_start);
     results[index].elapsed_time += static_cast<double>(time_span.count());
+    return static_cast<double>(time_span.count());
   };
 
-  // measure a candidate by calling build and run successively
-  auto measure_fn = [&build_fn, &run_fn](int index) {
-    build_fn(index);
-    run_fn(index);
-  };
-  // default num_threads_ is 1 and in that case it will perform all measurements sequentially inplace.
-  utils::parallel_run(measure_fn, utils::SequenceDispatcher(0, inputs.size()), num_threads_);
+  // the runner runs the candidates one at a time in the order they are built
+  std::thread runner_thread([&]() {
+    if (runner_cpu_id_ >= 0) {
+      BindCurrentThreadToCpu(runner_cpu_id_);
+    }
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      int index = -1;
+      {
+        std::unique_lock<std::mutex> lock(mtx);
+        built_cv.wait(lock, [&built_indices]() { return !built_indices.empty(); });
+        index = built_indices.front();
+        built_indices.pop();
+      }
+      run_time += run_fn(index);
+    }
+  });
+  // default num_threads_ is 1 and in that case all candidates are built sequentially inplace.
+  utils::parallel_run(build_fn, utils::SequenceDispatcher(0, inputs.size()), num_threads_);
+  runner_thread.join();
 
-  VLOG(4) << "Measure " << inputs.size() << " candidates";
+  auto wall_time =
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - measure_start);
+  statistics_.num_candidates += inputs.size();
+  statistics_.wall_time += static_cast<double>(wall_time.count());
+  statistics_.build_time += build_time;
+  statistics_.run_time += run_time;
+  VLOG(4) << "Measure " << inputs.size() << " candidates in " << wall_time.count() << "us, build time: " << build_time
+          << "us, run time: " << run_time << "us";
   return results;
 }
 
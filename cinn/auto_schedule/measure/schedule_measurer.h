@@ -21,23 +21,56 @@
 namespace cinn {
 namespace auto_schedule {
 
+// The accumulated statistics of all measurements of a ScheduleMeasurer,
+// used to see whether the builders or the runner is the bottleneck.
+struct MeasureStatistics {
+  int num_candidates = 0;
+  // The time cost of the Measure calls
+  double wall_time = 0.0;  // unit: us
+  // The time cost of building, summed over all builder threads
+  double build_time = 0.0;  // unit: us
+  // The time cost of running
+  double run_time = 0.0;  // unit: us
+
+  // The fraction of time the builder threads are busy
+  double BuilderUtilization(int num_threads) const {
+    return wall_time > 0 ? build_time / (wall_time * num_threads) : 0.0;
+  }
+  // The fraction of time the runner is busy
+  double RunnerUtilization() const { return wall_time > 0 ? run_time / wall_time : 0.0; }
+};
+
 // Entrance of schedule measurement, it mainly includes two processes:
 // which are building the input schedules and running the generated codes.
+//
+// The two processes are pipelined: num_threads builder threads build the
+// candidates concurrently, and a dedicated runner thread runs the built
+// ones one at a time, so that the timing of a candidate isn't disturbed by
+// running others at the same time. If the runner is bound to a cpu, the
+// builder threads are kept off that cpu while building.
 class ScheduleMeasurer {
  public:
-  ScheduleMeasurer(ScheduleBuilder* builder, ScheduleRunner* runner, int num_threads = 1);
+  // runner_cpu_id: the cpu to bind the runner thread to, -1 means not binding
+  ScheduleMeasurer(ScheduleBuilder* builder, ScheduleRunner* runner, int num_threads = 1, int runner_cpu_id = -1);
 
   // Measure a batch of inputs and return all results once.
   std::vector<MeasureResult> Measure(const std::vector<MeasureInput>& inputs);
 
+  const MeasureStatistics& GetStatistics() const { return statistics_; }
+
+  int NumThreads() const { return num_threads_; }
+
  private:
   // The handle to implemented ScheduleBuilder
   ScheduleBuilder* builder_;
   // The handle to implemented ScheduleRunner
   ScheduleRunner* runner_;
-  // The number of threads used to perform measurement,
-  // if it is greater than 1 that means parallel measurement.
+  // The number of threads used to build candidates,
+  // if it is greater than 1 that means parallel building.
   const int num_threads_;
+  const int runner_cpu_id_;
+
+  MeasureStatistics statistics_;
 };
 
 }  // namespace auto_schedule
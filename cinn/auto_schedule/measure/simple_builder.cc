@@ -14,25 +14,67 @@
 
 #include "cinn/auto_schedule/measure/simple_builder.h"
 
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "cinn/optim/ir_copy.h"
+
 namespace cinn {
 namespace auto_schedule {
 
 using hlir::framework::GraphCompiler;
+using hlir::framework::Scope;
+using hlir::framework::Tensor;
 
-SimpleBuilder::SimpleBuilder(hlir::framework::GraphCompiler* graph_compiler) : graph_compiler_(graph_compiler) {}
+namespace {
+
+// Create a scope with the variables of the given one, only the shapes and
+// types are copied without the buffers.
+std::shared_ptr<Scope> CopyScopeMeta(const Scope& scope) {
+  auto res = std::make_shared<Scope>();
+  for (absl::string_view name : scope.var_names()) {
+    std::string var_name(name);
+    Tensor src = scope.GetTensor(var_name);
+    auto* var  = res->Var<Tensor>(var_name);
+    Tensor dst = absl::get<Tensor>(*var);
+    dst->Resize(src->shape());
+    dst->set_type(src->type());
+  }
+  return res;
+}
+
+}  // namespace
+
+SimpleBuilder::SimpleBuilder(hlir::framework::GraphCompiler* graph_compiler) {
+  CHECK_NE(graph_compiler, static_cast<GraphCompiler*>(nullptr)) << "empty hanlde to GraphCompiler";
+  target_ = graph_compiler->GetTarget();
+  scope_  = graph_compiler->GetScope();
+  graph_  = graph_compiler->GetGraph();
+}
 
 BuildResult SimpleBuilder::Build(const MeasureInput& input) {
-  CHECK_NE(graph_compiler_, static_cast<GraphCompiler*>(nullptr)) << "empty hanlde to GraphCompiler";
   GraphCompiler::CompileOptions compile_options;
   compile_options.groups                  = input.task->task_graph;
-  compile_options.lowered_funcs           = input.lowered_funcs;
   compile_options.remove_unused_variables = false;
+  // the passes in compiling mutate the IR in place, and the tensors and buffers
+  // may be shared among the candidates, so they are copied for this build
+  compile_options.lowered_funcs.reserve(input.lowered_funcs.size());
+  for (const std::vector<ir::LoweredFunc>& funcs : input.lowered_funcs) {
+    compile_options.lowered_funcs.emplace_back(optim::IRCopy(funcs));
+  }
+  // other candidates may be building in parallel
+  compile_options.reset_name_id = false;
   VLOG(5) << "call GraphCompiler to Build with " << compile_options.groups.size() << " groups, "
           << compile_options.lowered_funcs.size() << " lowered_funcs";
-  GraphCompiler::CompilationResult compiled_result = graph_compiler_->Build(compile_options);
+  // compiling adds the temporary variables to the scope, so each build has its own one
+  std::shared_ptr<Scope> scope                     = CopyScopeMeta(*scope_);
+  auto graph_compiler                              = std::make_unique<GraphCompiler>(target_, scope, graph_);
+  GraphCompiler::CompilationResult compiled_result = graph_compiler->Build(compile_options);
 
   BuildResult build_result;
-  build_result.compiled_scope  = graph_compiler_->GetScope().get();
+  build_result.compiled_scope  = scope;
+  build_result.graph_compiler  = std::move(graph_compiler);
   build_result.runtime_program = std::move(compiled_result.runtime_program);
   return build_result;
 }
@@ -14,14 +14,19 @@
 
 #pragma once
 
+#include <memory>
+
 #include "cinn/auto_schedule/measure/measure.h"
 #include "cinn/hlir/framework/graph_compiler.h"
 
 namespace cinn {
 namespace auto_schedule {
 
-// This class utilize the GraphCompiler bound to the graph to build
-// the input schedule as executable objects
+// This class builds the input schedule as executable objects on the
+// graph which the given GraphCompiler is bound to. Every candidate is
+// built by a new GraphCompiler on its own scope and its own copies of the
+// lowered funcs, so Build can be called by multiple threads concurrently
+// and doesn't change the state of the given one.
 class SimpleBuilder : public ScheduleBuilder {
  public:
   SimpleBuilder(hlir::framework::GraphCompiler* graph_compiler);
@@ -30,7 +35,9 @@ class SimpleBuilder : public ScheduleBuilder {
   BuildResult Build(const MeasureInput& input) override;
 
  private:
-  hlir::framework::GraphCompiler* graph_compiler_;
+  common::Target target_;
+  std::shared_ptr<hlir::framework::Scope> scope_;
+  std::shared_ptr<hlir::framework::Graph> graph_;
 };
 
 }  // namespace auto_schedule
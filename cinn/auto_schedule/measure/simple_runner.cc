@@ -16,6 +16,7 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <iterator>
 #include <limits>
 #include <memory>
@@ -77,8 +78,49 @@ static std::shared_ptr<Buffer> AllocBuffer(const common::Target& target,
   return buffer;
 }
 
-SimpleRunner::SimpleRunner(int repeat_times) : repeat_times_(repeat_times) {
-  CHECK_GT(repeat_times_, 0) << "repeat_times can't less than 0";
+// Returns the median of the samples and its 95% confidence interval, which
+// is bounded by the order statistics around the median.
+static void MedianWithInterval(std::vector<double> samples, double* median, double* lower, double* upper) {
+  CHECK(!samples.empty());
+  std::sort(samples.begin(), samples.end());
+  int n = samples.size();
+  if (n % 2 == 1) {
+    *median = samples[n / 2];
+  } else {
+    *median = (samples[n / 2 - 1] + samples[n / 2]) / 2;
+  }
+  double half_width = 0.98 * std::sqrt(static_cast<double>(n));
+  int lower_idx     = std::max(0, static_cast<int>(std::floor(n / 2.0 - half_width)));
+  int upper_idx     = std::min(n - 1, static_cast<int>(std::ceil(n / 2.0 + half_width)));
+  *lower            = std::min(samples[lower_idx], *median);
+  *upper            = std::max(samples[upper_idx], *median);
+}
+
+SimpleRunner::SimpleRunner(int repeat_times) : SimpleRunner(Options{repeat_times}) {}
+
+SimpleRunner::SimpleRunner(const Options& options) : options_(options) {
+  CHECK_GT(options_.repeat_times, 0) << "repeat_times can't less than 0";
+  CHECK_GE(options_.warmup_times, 0) << "warmup_times can't less than 0";
+  CHECK_GT(options_.num_trials, 0) << "num_trials should be greater than 0";
+  if (options_.flush_cache) {
+    flush_buffer_.resize(options_.flush_cache_bytes);
+  }
+}
+
+std::shared_ptr<Buffer> SimpleRunner::GetOrAllocBuffer(const std::string& name,
+                                                       const common::Target& target,
+                                                       const common::Type& type,
+                                                       const Shape& shape) {
+  const uint32_t bytes_of_ele = static_cast<uint32_t>(std::floor(static_cast<float>(type.bits() + 1) / 8.0));
+  const uint32_t bytes        = shape.numel() * bytes_of_ele;
+  auto it                     = cached_buffers_.find(name);
+  if (it != cached_buffers_.end() && it->second.first == bytes) {
+    VLOG(6) << "Argument[" << name << "] reuse the cached buffer";
+    return it->second.second;
+  }
+  auto buffer           = AllocBuffer(target, type, shape);
+  cached_buffers_[name] = std::make_pair(bytes, buffer);
+  return buffer;
 }
 
 // Prepare execution arguments of all instructions to run, a argument
@@ -91,7 +133,7 @@ std::map<std::string, cinn_pod_value_t> SimpleRunner::PrepareArgs(const MeasureI
 
   const auto& target         = input.task->target;
   const auto* input_args     = input.execution_args;
-  const auto* compiled_scope = build_result.compiled_scope;
+  const auto& compiled_scope = build_result.compiled_scope;
   const auto& instructions   = build_result.runtime_program->GetRunInstructions();
 
   auto fill_arg_fn = [&](const std::string& param) {
@@ -114,10 +156,10 @@ std::map<std::string, cinn_pod_value_t> SimpleRunner::PrepareArgs(const MeasureI
       return;
     }
 
-    // allocate a new buffer for this argument and store it in
-    // the temporary scope to be released at proper time.
+    // take a buffer for this argument and store it in the temporary
+    // scope, the buffer is kept for the following candidates of the task.
     auto compiled_tensor = compiled_scope->GetTensor(param);
-    auto buffer          = AllocBuffer(target, compiled_tensor->type(), compiled_tensor->shape());
+    auto buffer          = GetOrAllocBuffer(param, target, compiled_tensor->type(), compiled_tensor->shape());
     temp_scope->Var<Tensor>(param);
     auto temp_tensor = temp_scope->GetTensor(param);
     temp_tensor->set_buffer(buffer);
@@ -136,35 +178,99 @@ std::map<std::string, cinn_pod_value_t> SimpleRunner::PrepareArgs(const MeasureI
   return result;
 }
 
+void SimpleRunner::FlushCache() {
+  // touch every cache line so the data of the previous run is evicted
+  constexpr int kCacheLineSize = 64;
+  for (size_t i = 0; i < flush_buffer_.size(); i += kCacheLineSize) {
+    flush_buffer_[i] += 1;
+  }
+}
+
+double SimpleRunner::RunTrial(const std::vector<std::unique_ptr<hlir::framework::Instruction>>& instructions,
+                              const common::Target& target,
+                              int repeat_times,
+                              std::map<std::string, cinn_pod_value_t>* execution_args) {
+  bool flush_cache = options_.flush_cache && target == common::DefaultHostTarget();
+  double cost      = 0.0;
+  for (auto ct = 0; ct < instructions.size(); ++ct) {
+    auto&& instr = instructions.at(ct);
+    VLOG(5) << "Start running instruction-" << ct;
+    if (flush_cache) {
+      // every run starts with cold caches, so the runs are timed separately to exclude the flushes
+      std::chrono::duration<double, std::micro> time_span(0);
+      for (int i = 0; i < repeat_times; ++i) {
+        FlushCache();
+        auto run_start = std::chrono::steady_clock::now();
+        instr->Run(execution_args);
+        time_span += std::chrono::steady_clock::now() - run_start;
+      }
+      cost += time_span.count() / repeat_times;
+      continue;
+    }
+    auto run_start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeat_times; ++i) {
+      instr->Run(execution_args);
+    }
+    std::chrono::duration<double, std::micro> time_span = std::chrono::steady_clock::now() - run_start;
+    cost += time_span.count() / repeat_times;
+  }
+  return cost;
+}
+
 MeasureResult SimpleRunner::Run(const MeasureInput& input, const BuildResult& build_result) {
+  std::lock_guard<std::mutex> lock(mtx_);
   MeasureResult result;
   auto t_start = std::chrono::steady_clock::now();
+  if (input.task != cached_task_) {
+    cached_task_ = input.task;
+    cached_buffers_.clear();
+    best_cost_ = std::numeric_limits<double>::max();
+  }
   // prepare execution arguments
   VLOG(4) << "SimpleRunner prepare execution arguments";
   hlir::framework::Scope temp_scope;  // used for store temporary allocated data
-  auto execution_args = PrepareArgs(input, build_result, &temp_scope);
-
-  // Execute each instruction repeatedly and take the average as cost.
-  result.execution_cost    = 0;
+  auto execution_args      = PrepareArgs(input, build_result, &temp_scope);
   const auto& instructions = build_result.runtime_program->GetRunInstructions();
-  for (auto ct = 0; ct < instructions.size(); ++ct) {
-    auto&& instr = instructions.at(ct);
-    VLOG(5) << "Start running instruction-" << ct;
-    auto run_start = std::chrono::steady_clock::now();
-    for (int i = 0; i < repeat_times_; ++i) {
+  const auto& target       = input.task->target;
+
+  for (int i = 0; i < options_.warmup_times; ++i) {
+    for (auto&& instr : instructions) {
       instr->Run(&execution_args);
     }
-    auto time_span =
-        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - run_start);
-    auto cost_avg = static_cast<double>(time_span.count()) / repeat_times_;
-    result.execution_cost += cost_avg;
   }
 
+  // increase the repeat times until a trial lasts long enough, the runs
+  // of calibration are taken as warmup and not counted
+  constexpr int kMaxCalibrationTimes = 10;
+  int repeat_times                   = options_.repeat_times;
+  if (options_.min_run_duration > 0) {
+    double cost = RunTrial(instructions, target, repeat_times, &execution_args);
+    for (int i = 0; i < kMaxCalibrationTimes && cost * repeat_times < options_.min_run_duration; ++i) {
+      double scale = options_.min_run_duration / std::max(cost * repeat_times, 1.0);
+      repeat_times = static_cast<int>(std::ceil(repeat_times * std::min(scale * 1.2, 1000.0)));
+      cost         = RunTrial(instructions, target, repeat_times, &execution_args);
+    }
+  }
+
+  // Execute the instructions in trials and take the median as cost.
+  std::vector<double> trial_costs;
+  for (int i = 0; i < options_.num_trials; ++i) {
+    trial_costs.push_back(RunTrial(instructions, target, repeat_times, &execution_args));
+    if (i == 0 && options_.early_stop_ratio > 0 && trial_costs[0] > best_cost_ * options_.early_stop_ratio) {
+      VLOG(4) << "Stop measuring since the cost " << trial_costs[0] << "us is much more than the best " << best_cost_
+              << "us";
+      break;
+    }
+  }
+  MedianWithInterval(trial_costs, &result.execution_cost, &result.execution_cost_lower, &result.execution_cost_upper);
+  best_cost_ = std::min(best_cost_, result.execution_cost);
+
   auto time_span = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t_start);
   result.elapsed_time = static_cast<double>(time_span.count());
 
-  VLOG(4) << "A measurement done:repeat_times[" << repeat_times_ << "]total_elapsed_time[" << result.elapsed_time
-          << "]us,execution_cost[" << result.execution_cost << "]us";
+  VLOG(4) << "A measurement done:repeat_times[" << repeat_times << "]num_trials[" << trial_costs.size()
+          << "]total_elapsed_time[" << result.elapsed_time << "]us,execution_cost[" << result.execution_cost
+          << "]us,interval[" << result.execution_cost_lower << ", " << result.execution_cost_upper << "]us";
   return result;
 }
 
@@ -14,18 +14,56 @@
 
 #pragma once
 
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "cinn/auto_schedule/measure/measure.h"
+#include "cinn/hlir/framework/buffer.h"
 #include "cinn/hlir/framework/instruction.h"
 
 namespace cinn {
 namespace auto_schedule {
 
 // This class utilize the built instructions to execute the generated
-// kernels and count the elapsed time as the measurement of performance
+// kernels and count the elapsed time as the measurement of performance.
+//
+// A measurement warms up first, then runs several timed trials and takes
+// the median of them as the cost. In a trial, each instruction runs
+// repeatedly and the repeat times are increased until a trial lasts at
+// least min_run_duration, which smooths out the noise of the timer and
+// frequency scaling. The buffers of arguments are reused among the
+// candidates of the same task, and the calls of Run are serialized.
 class SimpleRunner : public ScheduleRunner {
  public:
+  struct Options {
+    // The min repeat times of running an instruction in a trial
+    int repeat_times = 1;
+    // The times of running all instructions before timing
+    int warmup_times = 1;
+    // The min time cost of a trial, the repeat times will be increased
+    // until a trial lasts longer than it
+    double min_run_duration = 0.0;  // unit: us
+    // The number of timed trials
+    int num_trials = 1;
+    // Whether to flush the cpu caches before each timed run, only
+    // supported on host target
+    bool flush_cache = false;
+    // The bytes written to flush the cpu caches, should be larger than the last level cache
+    int flush_cache_bytes = 64 << 20;
+    // Stop measuring a candidate after its first trial if its cost is more than
+    // early_stop_ratio times of the best one of the task, 0 means never stop
+    double early_stop_ratio = 0.0;
+  };
+
   SimpleRunner(int repeat_times);
 
+  explicit SimpleRunner(const Options& options);
+
   MeasureResult Run(const MeasureInput& input, const BuildResult& build_result) override;
 
  private:
@@ -33,10 +71,34 @@ class SimpleRunner : public ScheduleRunner {
                                                       const BuildResult& build_result,
                                                       hlir::framework::Scope* temp_scope);
 
+  // Get the cached buffer of an argument of the current task, or allocate a new one
+  std::shared_ptr<hlir::framework::Buffer> GetOrAllocBuffer(const std::string& name,
+                                                            const common::Target& target,
+                                                            const common::Type& type,
+                                                            const hlir::framework::Shape& shape);
+
+  // Run each instruction repeat_times and return the sum of their average time cost,
+  // the caches are flushed before each run if required, which is not timed
+  double RunTrial(const std::vector<std::unique_ptr<hlir::framework::Instruction>>& instructions,
+                  const common::Target& target,
+                  int repeat_times,
+                  std::map<std::string, cinn_pod_value_t>* execution_args);
+
+  void FlushCache();
+
  private:
-  // The repeat times of running instructions,
-  // this runner will return the average time
-  const int repeat_times_;
+  const Options options_;
+  std::mutex mtx_;
+
+  // The task whose argument buffers are cached, which is the last one run.
+  const TuneTask* cached_task_ = nullptr;
+  // Mapping from argument name to its bytes and buffer
+  std::map<std::string, std::pair<uint32_t, std::shared_ptr<hlir::framework::Buffer>>> cached_buffers_;
+  // The best execution cost of the cached task
+  double best_cost_ = std::numeric_limits<double>::max();
+
+  // Written to flush the cpu caches
+  std::vector<char> flush_buffer_;
 };
 
 }  // namespace auto_schedule
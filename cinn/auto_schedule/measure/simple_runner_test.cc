@@ -58,7 +58,7 @@ class TestSimpleRunner : public ::testing::Test {
     const auto& instructions = runtime_program->GetRunInstructions();
     ASSERT_EQ(2, instructions.size());
 
-    build_result.compiled_scope  = compiled_scope.get();
+    build_result.compiled_scope  = compiled_scope;
     build_result.runtime_program = std::move(runtime_program);
 
     task = std::make_unique<TuneTask>();
@@ -129,6 +129,36 @@ TEST_F(TestSimpleRunner, TimeMeasured) {
   // be greater than 100us and 200us (repeatedly running 2 times) respectively.
   ASSERT_GE(measure_result.execution_cost, 100);
   ASSERT_GE(measure_result.elapsed_time, 200);
+
+  // flushing the caches writes to every cache line of 256MB, which takes far longer than a run
+  SimpleRunner::Options options;
+  options.warmup_times      = 1;
+  options.min_run_duration  = 1000;
+  options.num_trials        = 5;
+  options.flush_cache       = true;
+  options.flush_cache_bytes = 256 << 20;
+  runner                    = std::make_unique<SimpleRunner>(options);
+  measure_result            = runner->Run(input, build_result);
+  // a trial runs at least 1000us, so the 5 trials take 5000us in total
+  ASSERT_GE(measure_result.execution_cost, 100);
+  ASSERT_GE(measure_result.elapsed_time, 5000);
+  // the flushes before the runs are excluded from the timing
+  ASSERT_LT(measure_result.execution_cost, 10000);
+  ASSERT_LE(measure_result.execution_cost_lower, measure_result.execution_cost);
+  ASSERT_GE(measure_result.execution_cost_upper, measure_result.execution_cost);
+}
+
+TEST_F(TestSimpleRunner, ReuseBuffersOfTask) {
+  SimpleRunner::Options options;
+  options.num_trials       = 3;
+  options.early_stop_ratio = 1.5;
+  auto runner              = std::make_unique<SimpleRunner>(options);
+  // the buffers allocated in the first run are reused by the following ones
+  for (int i = 0; i < 3; ++i) {
+    MeasureResult measure_result;
+    ASSERT_NO_THROW(measure_result = runner->Run(input, build_result));
+    ASSERT_GT(measure_result.execution_cost, 0);
+  }
 }
 
 }  // namespace auto_schedule
@@ -0,0 +1,106 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/add_cache_write.h"
+
+#include <glog/logging.h>
+
+#include <cstdlib>
+#include <set>
+
+#include "cinn/ir/buffer.h"
+#include "cinn/ir/collect_ir_nodes.h"
+#include "cinn/ir/ir_printer.h"
+#include "cinn/ir/tensor.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+bool AddCacheWrite::MeetCondition(const ir::Expr& block_realize) const {
+  const ir::ScheduleBlockRealize* realize = block_realize.As<ir::ScheduleBlockRealize>();
+  const ir::ScheduleBlock* sche_block     = realize->schedule_block.As<ir::ScheduleBlock>();
+  std::set<ir::Expr> stores =
+      ir::CollectIRNodesWithoutTensor(sche_block->body, [](const Expr* x) { return x->As<ir::Store>() != nullptr; });
+  if (stores.size() != 1) {
+    return false;
+  }
+  // skip the blocks computed on a cache already
+  const ir::Tensor& tensor = stores.begin()->As<ir::Store>()->tensor.as_tensor_ref();
+  if (!tensor->buffer.defined() || tensor->buffer->memory_type == ir::MemoryType::GPULocal) {
+    return false;
+  }
+
+  // ComputeAt keeps the reduce loops, it requires the reduce iter vars bound to the
+  // loop vars directly, and the names of the loop vars unique in the module
+  bool has_reduce_iter = false;
+  for (size_t i = 0; i < realize->iter_values.size(); ++i) {
+    if (!sche_block->iter_vars[i]->is_reduce_axis) {
+      continue;
+    }
+    has_reduce_iter = true;
+    if (!realize->iter_values[i].as_var()) {
+      return false;
+    }
+    const std::string& loop_var_name = realize->iter_values[i].as_var()->name;
+    for (const ir::Expr& expr : ir_schedule_->GetModule().GetExprs()) {
+      std::set<ir::Expr> same_name_loops = ir::CollectIRNodesWithoutTensor(
+          expr, [&](const Expr* x) { return x->As<ir::For>() && x->As<ir::For>()->loop_var->name == loop_var_name; });
+      if (same_name_loops.size() != 1) {
+        return false;
+      }
+    }
+  }
+  return has_reduce_iter;
+}
+
+RuleApplyType AddCacheWrite::Init(const ir::ModuleExpr& mod_expr) {
+  ir_schedule_ = std::make_unique<ir::IRSchedule>(mod_expr);
+  applicable_blocks_.clear();
+  num_applicable_ = 0;
+  if (target_->arch == common::Target::Arch::NVGPU) {
+    return RuleApplyType::kCannotApply;
+  }
+
+  for (const ir::Expr& block_realize : ir_schedule_->GetAllBlocks()) {
+    if (!block_realize.As<ir::ScheduleBlockRealize>()->iter_values.empty() && MeetCondition(block_realize)) {
+      applicable_blocks_.push_back(block_realize);
+    }
+  }
+  num_applicable_ = applicable_blocks_.size();
+  VLOG(6) << "Collect applicable blocks of AddCacheWrite:" << num_applicable_;
+
+  return num_applicable_ > 0 ? RuleApplyType::kApplyAndSkipThisRule : RuleApplyType::kCannotApply;
+}
+
+ir::ModuleExpr AddCacheWrite::Apply(int index) {
+  CHECK(ir_schedule_ != nullptr) << "Run AddCacheWrite::Apply without Init";
+  CHECK_LT(index, applicable_blocks_.size()) << "invalid apply index:" << index;
+  const ir::Expr& block_realize           = applicable_blocks_[index];
+  const ir::ScheduleBlockRealize* realize = block_realize.As<ir::ScheduleBlockRealize>();
+  std::string block_name                  = realize->schedule_block.As<ir::ScheduleBlock>()->name;
+
+  ir::Expr cache_block = ir_schedule_->CacheWrite(block_realize, 0, "local");
+  // the block named as the original one writes back the cache now
+  std::vector<ir::Expr> loops = ir_schedule_->GetLoops(block_name);
+  if (loops.empty()) {
+    return ir_schedule_->GetModule();
+  }
+  ir::Expr loop = loops[std::rand() % loops.size()];
+  VLOG(6) << "AddCacheWrite computes the cache of " << block_name << " at:\n" << loop;
+  ir_schedule_->ComputeAt(cache_block, loop);
+  return ir_schedule_->GetModule();
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,57 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_gen_rule.h"
+#include "cinn/common/target.h"
+#include "cinn/ir/ir.h"
+#include "cinn/ir/ir_schedule.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+// This rule caches the accumulation of a reduction on CPU. The reduction is computed
+// on a "local" cache by CacheWrite, then it is moved by ComputeAt under a randomly
+// chosen loop of the block writing back the cache, so a tile of the partial results
+// is written back to the output right after it is accumulated.
+class AddCacheWrite : public AutoGenRule {
+ public:
+  AddCacheWrite(const common::Target& target) : AutoGenRule(target) {}
+  ~AddCacheWrite() = default;
+
+  RuleApplyType Init(const ir::ModuleExpr& mod_expr) override;
+
+  ir::ModuleExpr Apply(int index) override;
+
+  std::string GetRuleName() const override { return "AddCacheWrite"; }
+
+  AutoGenRule* NewPointer() const override { return new AddCacheWrite(*target_); }
+
+  ir::ScheduleTrace GetTrace() const override { return ir_schedule_ ? ir_schedule_->GetTrace() : ir::ScheduleTrace(); }
+
+  // Returns true if the block is a reduction that can be computed on a cache
+  bool MeetCondition(const ir::Expr& block_realize) const;
+
+ private:
+  std::unique_ptr<ir::IRSchedule> ir_schedule_;
+  std::vector<ir::Expr> applicable_blocks_;
+};
+
+}  // namespace auto_schedule
+}  // namespace cinn
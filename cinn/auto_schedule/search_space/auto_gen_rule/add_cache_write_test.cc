@@ -0,0 +1,129 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/add_cache_write.h"
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <set>
+#include <vector>
+
+#include "cinn/auto_schedule/analysis/analyze_ir.h"
+#include "cinn/backends/llvm/execution_engine.h"
+#include "cinn/cinn.h"
+#include "cinn/common/test_helper.h"
+#include "cinn/ir/collect_ir_nodes.h"
+#include "cinn/ir/ir_printer.h"
+#include "cinn/lang/lower.h"
+#include "cinn/runtime/cinn_runtime.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+TEST(AddCacheWrite, Matmul) {
+  using namespace ir;
+
+  srand(0);
+  Context::Global().ResetNameId();
+  Target target = common::DefaultHostTarget();
+
+  const int m = 32, n = 16, k = 8;
+  Expr M(m);
+  Expr N(n);
+  Expr K(k);
+  Placeholder<float> A("A", {M, K});
+  Placeholder<float> B("B", {K, N});
+  Var k0(K.as_int32(), "k0");
+  Tensor C = Compute(
+      {M, N}, [&](Var i, Var j) { return ReduceSum(A(i, k0) * B(k0, j), {k0}); }, "C");
+
+  auto stages = CreateStages({C});
+  auto funcs  = cinn::lang::LowerVec("test_add_cache_write", stages, {A, B, C}, {}, {}, nullptr, target, true);
+  ir::ModuleExpr mod_expr({funcs[0]->body});
+
+  AddCacheWrite test_rule(target);
+  ASSERT_EQ(test_rule.Init(mod_expr), RuleApplyType::kApplyAndSkipThisRule);
+  EXPECT_EQ(test_rule.NumberApplicable(), 1);
+  ir::ModuleExpr new_mod_expr = test_rule.ApplyRandomly();
+  VLOG(6) << "After AddCacheWrite:\n" << new_mod_expr.GetExprs()[0];
+
+  // the reduction is initialized and accumulated on the cache, then written
+  // back in the loop nest of the output
+  ir::IRSchedule ir_sch(new_mod_expr);
+  ir::Expr cache_block = ir_sch.GetBlock("C_local");
+  ir_sch.GetBlock("C_local__reduce_init");
+  std::set<ir::Expr> output_loads = ir::CollectIRNodesWithoutTensor(cache_block, [](const Expr* x) {
+    return x->As<ir::Load>() && x->As<ir::Load>()->tensor.as_tensor_ref()->name == "C";
+  });
+  EXPECT_TRUE(output_loads.empty());
+  EXPECT_EQ(ir_sch.GetLoops("C_local").front(), ir_sch.GetLoops("C").front());
+  // the cache is not applicable anymore
+  EXPECT_EQ(test_rule.Init(new_mod_expr), RuleApplyType::kCannotApply);
+
+  funcs[0]->body = new_mod_expr.GetExprs()[0];
+  UpdateTempBuffers(funcs[0]);
+  ASSERT_EQ(funcs[0]->temp_bufs.size(), 1UL);
+
+  Module::Builder builder("module0", target);
+  builder.AddFunction(funcs[0]);
+  auto jit = backends::ExecutionEngine::Create({});
+  jit->Link(builder.Build());
+  auto fn = reinterpret_cast<void (*)(void*, int32_t)>(jit->Lookup("test_add_cache_write"));
+  ASSERT_NE(fn, nullptr);
+
+  cinn_buffer_t* A_buf = common::BufferBuilder(Float(32), {m, k}).set_random().Build();
+  cinn_buffer_t* B_buf = common::BufferBuilder(Float(32), {k, n}).set_random().Build();
+  cinn_buffer_t* C_buf = common::BufferBuilder(Float(32), {m, n}).set_zero().Build();
+  cinn_pod_value_t a_arg(A_buf), b_arg(B_buf), c_arg(C_buf);
+  cinn_pod_value_t args[] = {a_arg, b_arg, c_arg};
+  fn(args, 3);
+
+  auto* ad = reinterpret_cast<float*>(A_buf->memory);
+  auto* bd = reinterpret_cast<float*>(B_buf->memory);
+  auto* cd = reinterpret_cast<float*>(C_buf->memory);
+  for (int i = 0; i < m; ++i) {
+    for (int j = 0; j < n; ++j) {
+      float expected = 0.f;
+      for (int r = 0; r < k; ++r) {
+        expected += ad[i * k + r] * bd[r * n + j];
+      }
+      ASSERT_NEAR(cd[i * n + j], expected, 1e-4);
+    }
+  }
+}
+
+TEST(AddCacheWrite, Elementwise) {
+  using namespace ir;
+
+  Context::Global().ResetNameId();
+  Target target = common::DefaultHostTarget();
+
+  Expr M(64);
+  Placeholder<float> A("A", {M});
+  Tensor B = Compute(
+      {M}, [&](Var i) { return A(i) * Expr(2.f); }, "B");
+
+  auto stages = CreateStages({B});
+  auto funcs  = cinn::lang::LowerVec("test_elementwise", stages, {A, B}, {}, {}, nullptr, target, true);
+  ir::ModuleExpr mod_expr({funcs[0]->body});
+
+  // only the reductions accumulate
+  AddCacheWrite test_rule(target);
+  EXPECT_EQ(test_rule.Init(mod_expr), RuleApplyType::kCannotApply);
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -18,6 +18,7 @@
 
 #include "cinn/common/target.h"
 #include "cinn/ir/ir_schedule.h"
+#include "cinn/ir/schedule_trace.h"
 
 namespace cinn {
 namespace auto_schedule {
@@ -67,6 +68,11 @@ class AutoGenRule {
   // Returns the name of the rule, used for debug.
   virtual std::string GetRuleName() const = 0;
 
+  // Returns the schedule primitives applied since Init, which can be replayed
+  // on the mod_expr passed to Init. It is empty for the rules that don't
+  // modify the ModuleExpr.
+  virtual ir::ScheduleTrace GetTrace() const { return ir::ScheduleTrace(); }
+
   // Returns a pointer pointing to the rule. This class doesn't own the
   // pointer, caller should manage the life time of the pointer.
   virtual AutoGenRule* NewPointer() const = 0;
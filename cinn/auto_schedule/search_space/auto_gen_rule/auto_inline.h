@@ -52,6 +52,8 @@ class AutoInline : public AutoGenRule {
 
   AutoGenRule* NewPointer() const override;
 
+  ir::ScheduleTrace GetTrace() const override { return ir_schedule_ ? ir_schedule_->GetTrace() : ir::ScheduleTrace(); }
+
   AutoInlineType AnalyzeInlineType(const Expr& sche_block_realize_expr) const;
 
   bool CanInlineIntoConsumer(const Expr& sche_block_realize_expr) const;
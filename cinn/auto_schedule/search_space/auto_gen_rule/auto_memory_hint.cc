@@ -0,0 +1,107 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_memory_hint.h"
+
+#include <glog/logging.h>
+
+#include <cstdlib>
+#include <set>
+
+#include "cinn/ir/collect_ir_nodes.h"
+#include "cinn/ir/ir_printer.h"
+#include "cinn/optim/prefetch_and_nontemporal_store.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+// the numbers of the innermost loop iterations to prefetch ahead, 0 disables the prefetch
+static std::vector<int> prefetch_distance_options = {0, 4, 8, 16, 32};
+
+AutoMemoryHint::AutoMemoryHint(const common::Target& target) : AutoGenRule(target) {
+  llc_bytes_ = target.arch == common::Target::Arch::X86 ? target.cache_sizes()[2] : 0;
+}
+
+int64_t AutoMemoryHint::GetAccessedBytes(const ir::Expr& block_realize) const {
+  const ir::ScheduleBlock* sche_block =
+      block_realize.As<ir::ScheduleBlockRealize>()->schedule_block.As<ir::ScheduleBlock>();
+  std::set<const ir::_Tensor_*> tensors;
+  ir::CollectIRNodesWithoutTensor(sche_block->body, [&](const Expr* x) {
+    const Expr* tensor = nullptr;
+    if (x->As<ir::Load>()) {
+      tensor = &x->As<ir::Load>()->tensor;
+    } else if (x->As<ir::Store>()) {
+      tensor = &x->As<ir::Store>()->tensor;
+    }
+    if (tensor && tensor->As<ir::_Tensor_>()) {
+      tensors.insert(tensor->As<ir::_Tensor_>());
+    }
+    return false;
+  });
+
+  int64_t bytes = 0;
+  for (const ir::_Tensor_* tensor : tensors) {
+    if (tensor->buffer.defined() && tensor->buffer->memory_type != ir::MemoryType::Heap) {
+      continue;
+    }
+    int64_t tensor_bytes = optim::TensorBytes(tensor);
+    if (tensor_bytes < 0) {
+      return -1;
+    }
+    bytes += tensor_bytes;
+  }
+  return bytes;
+}
+
+RuleApplyType AutoMemoryHint::Init(const ir::ModuleExpr& mod_expr) {
+  ir_schedule_ = std::make_unique<ir::IRSchedule>(mod_expr);
+  applicable_blocks_.clear();
+  num_applicable_ = 0;
+  if (llc_bytes_ <= 0) {
+    return RuleApplyType::kCannotApply;
+  }
+
+  for (const ir::Expr& block_realize : ir_schedule_->GetAllBlocks()) {
+    const ir::ScheduleBlockRealize* realize = block_realize.As<ir::ScheduleBlockRealize>();
+    const ir::ScheduleBlock* sche_block     = realize->schedule_block.As<ir::ScheduleBlock>();
+    if (realize->iter_values.empty() || sche_block->attrs.count(ir::attr::prefetch_distance)) {
+      continue;
+    }
+    if (GetAccessedBytes(block_realize) > llc_bytes_) {
+      applicable_blocks_.push_back(block_realize);
+    }
+  }
+  num_applicable_ = applicable_blocks_.size();
+  VLOG(6) << "Collect applicable blocks of AutoMemoryHint:" << num_applicable_;
+
+  return num_applicable_ > 0 ? RuleApplyType::kApply : RuleApplyType::kCannotApply;
+}
+
+ir::ModuleExpr AutoMemoryHint::Apply(int index) {
+  CHECK(ir_schedule_ != nullptr) << "Run AutoMemoryHint::Apply without Init";
+  CHECK_LT(index, applicable_blocks_.size()) << "invalid apply index:" << index;
+  const ir::Expr& block_realize = applicable_blocks_[index];
+  int distance                  = prefetch_distance_options[std::rand() % prefetch_distance_options.size()];
+  bool nontemporal              = std::rand() % 2 == 0;
+
+  VLOG(6) << "AutoMemoryHint sets prefetch distance " << distance << " and non-temporal store " << nontemporal
+          << " on the block:\n"
+          << block_realize;
+  ir_schedule_->Prefetch(block_realize, distance);
+  ir_schedule_->NonTemporalStore(block_realize, nontemporal);
+  return ir_schedule_->GetModule();
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,61 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_gen_rule.h"
+#include "cinn/common/target.h"
+#include "cinn/ir/ir.h"
+#include "cinn/ir/ir_schedule.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+// This rule samples the memory access hints of a schedule block on CPU if the tensors
+// it accesses are larger than the last level cache, so the block is bound by the memory
+// bandwidth. The distance of the software prefetches is sampled from a few numbers of
+// the innermost loop iterations, and whether to write the output with non-temporal stores
+// is sampled as well. The hints are applied by the prefetch_and_nontemporal_store pass.
+class AutoMemoryHint : public AutoGenRule {
+ public:
+  AutoMemoryHint(const common::Target& target);
+  ~AutoMemoryHint() = default;
+
+  RuleApplyType Init(const ir::ModuleExpr& mod_expr) override;
+
+  ir::ModuleExpr Apply(int index) override;
+
+  std::string GetRuleName() const override { return "AutoMemoryHint"; }
+
+  AutoGenRule* NewPointer() const override { return new AutoMemoryHint(*target_); }
+
+  ir::ScheduleTrace GetTrace() const override { return ir_schedule_ ? ir_schedule_->GetTrace() : ir::ScheduleTrace(); }
+
+  // Returns the total size in bytes of the global tensors loaded and stored in the block,
+  // -1 if any of them has a non-constant shape
+  int64_t GetAccessedBytes(const ir::Expr& block_realize) const;
+
+ private:
+  std::unique_ptr<ir::IRSchedule> ir_schedule_;
+  std::vector<ir::Expr> applicable_blocks_;
+  int64_t llc_bytes_;
+};
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,97 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_memory_hint.h"
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <vector>
+
+#include "cinn/cinn.h"
+#include "cinn/ir/ir_printer.h"
+#include "cinn/lang/lower.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+TEST(AutoMemoryHint, Transpose) {
+  using namespace ir;
+
+  srand(0);
+  Context::Global().ResetNameId();
+  Target target = common::DefaultHostTarget();
+
+  // the tensors are much larger than the last level cache
+  Expr M(16384);
+  Expr N(8192);
+  Placeholder<float> A("A", {N, M});
+  Tensor B = Compute(
+      {M, N}, [&](Var i, Var j) { return A(j, i); }, "B");
+
+  auto stages = CreateStages({B});
+  auto funcs  = cinn::lang::LowerVec("test_transpose", stages, {A, B}, {}, {}, nullptr, target, true);
+  ir::ModuleExpr mod_expr({funcs[0]->body});
+
+  AutoMemoryHint test_rule(target);
+  ASSERT_EQ(test_rule.Init(mod_expr), RuleApplyType::kApply);
+  EXPECT_EQ(test_rule.NumberApplicable(), 1);
+  ir::ModuleExpr new_mod_expr = test_rule.ApplyRandomly();
+  VLOG(6) << "After AutoMemoryHint:\n" << new_mod_expr.GetExprs()[0];
+
+  ir::IRSchedule ir_sch(new_mod_expr);
+  ir::Expr block_realize         = ir_sch.GetBlock("B");
+  const ir::ScheduleBlock* block = block_realize.As<ir::ScheduleBlockRealize>()->schedule_block.As<ir::ScheduleBlock>();
+  ASSERT_EQ(block->attrs.count(ir::attr::prefetch_distance), 1UL);
+  ASSERT_EQ(block->attrs.count(ir::attr::nontemporal_store), 1UL);
+  const int* distance = absl::get_if<int>(&block->attrs.at(ir::attr::prefetch_distance));
+  ASSERT_NE(distance, nullptr);
+  EXPECT_GE(*distance, 0);
+  EXPECT_NE(absl::get_if<bool>(&block->attrs.at(ir::attr::nontemporal_store)), nullptr);
+
+  // the hints are replayable
+  ir::ScheduleTrace trace = test_rule.GetTrace();
+  EXPECT_TRUE(trace.IsReplayable());
+  ASSERT_EQ(trace.GetSteps().size(), 2UL);
+  EXPECT_EQ(trace.GetSteps()[0].type, "Prefetch");
+  EXPECT_EQ(trace.GetSteps()[1].type, "NonTemporalStore");
+
+  // not applicable once the hints are set
+  EXPECT_EQ(test_rule.Init(new_mod_expr), RuleApplyType::kCannotApply);
+}
+
+TEST(AutoMemoryHint, SmallTensor) {
+  using namespace ir;
+
+  Context::Global().ResetNameId();
+  Target target = common::DefaultHostTarget();
+
+  Expr M(64);
+  Expr N(32);
+  Placeholder<float> A("A", {M, N});
+  Tensor B = Compute(
+      {M, N}, [&](Var i, Var j) { return A(i, j) * Expr(2.f); }, "B");
+
+  auto stages = CreateStages({B});
+  auto funcs  = cinn::lang::LowerVec("test_small_tensor", stages, {A, B}, {}, {}, nullptr, target, true);
+  ir::ModuleExpr mod_expr({funcs[0]->body});
+
+  // the tensors stay in the cache
+  AutoMemoryHint test_rule(target);
+  EXPECT_EQ(test_rule.Init(mod_expr), RuleApplyType::kCannotApply);
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,121 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_parallel.h"
+
+#include <glog/logging.h>
+
+#include <cstdlib>
+#include <map>
+#include <utility>
+
+#include "cinn/auto_schedule/analysis/analyze_ir.h"
+#include "cinn/ir/ir_printer.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+AutoParallel::AutoParallel(const common::Target& target) : AutoGenRule(target) {
+  num_cores_ = target.arch == common::Target::Arch::NVGPU ? 1 : target.num_cores();
+}
+
+std::vector<ir::Expr> AutoParallel::GetParallelizableLoops(const ir::Expr& block_realize) const {
+  std::vector<ir::Expr> loops = ir_schedule_->GetLoops(block_realize);
+  std::vector<ir::Expr> result;
+  for (const ir::Expr& loop : loops) {
+    const ir::For* for_node = loop.As<ir::For>();
+    if (!for_node->is_serial() || !for_node->extent.is_constant() || !IsSpatialLoop(loop)) {
+      break;
+    }
+    // only the perfectly nested loops can be fused
+    if (!result.empty()) {
+      const ir::Block* outer_body = result.back().As<ir::For>()->body.As<ir::Block>();
+      if (outer_body == nullptr || outer_body->stmts.size() != 1 || outer_body->stmts[0] != loop) {
+        break;
+      }
+    }
+    result.push_back(loop);
+  }
+  if (result.size() == loops.size() && result.size() > 1) {
+    result.pop_back();
+  }
+  return result;
+}
+
+RuleApplyType AutoParallel::Init(const ir::ModuleExpr& mod_expr) {
+  ir_schedule_ = std::make_unique<ir::IRSchedule>(mod_expr);
+  applicable_blocks_.clear();
+  num_applicable_ = 0;
+  if (num_cores_ <= 1) {
+    return RuleApplyType::kCannotApply;
+  }
+
+  // blocks in a loop nest share the outermost loop, take the one with the most loops
+  std::map<ir::Expr, std::pair<ir::Expr, int>> outermost_loop_to_block;
+  for (const ir::Expr& block_realize : ir_schedule_->GetAllBlocks()) {
+    if (block_realize.As<ir::ScheduleBlockRealize>()->iter_values.empty()) {
+      continue;
+    }
+    std::vector<ir::Expr> loops = ir_schedule_->GetLoops(block_realize);
+    if (loops.empty()) {
+      continue;
+    }
+    auto it = outermost_loop_to_block.find(loops.front());
+    if (it == outermost_loop_to_block.end() || it->second.second < loops.size()) {
+      outermost_loop_to_block[loops.front()] = std::make_pair(block_realize, loops.size());
+    }
+  }
+  for (auto& loop_and_block : outermost_loop_to_block) {
+    const ir::Expr& block_realize = loop_and_block.second.first;
+    std::vector<ir::Expr> loops   = GetParallelizableLoops(block_realize);
+    int64_t extent                = 1;
+    for (const ir::Expr& loop : loops) {
+      extent *= loop.As<ir::For>()->extent.as_int64();
+    }
+    if (extent > 1) {
+      applicable_blocks_.push_back(block_realize);
+    }
+  }
+  num_applicable_ = applicable_blocks_.size();
+  VLOG(6) << "Collect applicable blocks of AutoParallel:" << num_applicable_;
+
+  return num_applicable_ > 0 ? RuleApplyType::kApply : RuleApplyType::kCannotApply;
+}
+
+ir::ModuleExpr AutoParallel::Apply(int index) {
+  CHECK(ir_schedule_ != nullptr) << "Run AutoParallel::Apply without Init";
+  CHECK_LT(index, applicable_blocks_.size()) << "invalid apply index:" << index;
+  std::vector<ir::Expr> loops = GetParallelizableLoops(applicable_blocks_[index]);
+  CHECK(!loops.empty());
+
+  // the fewest outer loops whose iterations are enough for all the cores
+  int num_fused  = 0;
+  int64_t extent = 1;
+  while (num_fused < loops.size() && extent < num_cores_) {
+    extent *= loops[num_fused].As<ir::For>()->extent.as_int64();
+    ++num_fused;
+  }
+  num_fused += std::rand() % (loops.size() - num_fused + 1);
+
+  ir::Expr parallel_loop = loops.front();
+  if (num_fused > 1) {
+    parallel_loop = ir_schedule_->Fuse(std::vector<ir::Expr>(loops.begin(), loops.begin() + num_fused));
+  }
+  VLOG(6) << "AutoParallel fuses " << num_fused << " loops and parallelizes:\n" << parallel_loop;
+  ir_schedule_->Parallel(parallel_loop);
+  return ir_schedule_->GetModule();
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,59 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_gen_rule.h"
+#include "cinn/common/target.h"
+#include "cinn/ir/ir.h"
+#include "cinn/ir/ir_schedule.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+// This rule parallelizes a loop nest on CPU. The outermost serial spatial loops are
+// fused until the fused loop has enough iterations for all the cores, and the fused
+// loop is set parallel. More outer loops may be fused to sample finer grains, but the
+// innermost loop of a block is kept for vectorization.
+class AutoParallel : public AutoGenRule {
+ public:
+  AutoParallel(const common::Target& target);
+  ~AutoParallel() = default;
+
+  RuleApplyType Init(const ir::ModuleExpr& mod_expr) override;
+
+  ir::ModuleExpr Apply(int index) override;
+
+  std::string GetRuleName() const override { return "AutoParallel"; }
+
+  AutoGenRule* NewPointer() const override { return new AutoParallel(*target_); }
+
+  ir::ScheduleTrace GetTrace() const override { return ir_schedule_ ? ir_schedule_->GetTrace() : ir::ScheduleTrace(); }
+
+  // Returns the outer loops of the block which can be fused and parallelized
+  std::vector<ir::Expr> GetParallelizableLoops(const ir::Expr& block_realize) const;
+
+ private:
+  std::unique_ptr<ir::IRSchedule> ir_schedule_;
+  // a block for each loop nest to parallelize, which has the most loops in the nest
+  std::vector<ir::Expr> applicable_blocks_;
+  int num_cores_;
+};
+
+}  // namespace auto_schedule
+}  // namespace cinn
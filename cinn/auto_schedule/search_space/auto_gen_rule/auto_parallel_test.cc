@@ -0,0 +1,139 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_parallel.h"
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <set>
+#include <vector>
+
+#include "cinn/cinn.h"
+#include "cinn/ir/collect_ir_nodes.h"
+#include "cinn/ir/ir_printer.h"
+#include "cinn/lang/lower.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+std::vector<ir::Expr> GetParallelLoops(const ir::ModuleExpr& mod_expr) {
+  std::set<ir::Expr> loops = ir::CollectIRNodesWithoutTensor(mod_expr.GetExprs()[0], [](const Expr* x) {
+    return x->As<ir::For>() && x->As<ir::For>()->is_parallel();
+  });
+  return std::vector<ir::Expr>(loops.begin(), loops.end());
+}
+
+TEST(AutoParallel, Elementwise) {
+  using namespace ir;
+
+  srand(0);
+  Context::Global().ResetNameId();
+  Target target = common::DefaultHostTarget();
+
+  Expr M(64);
+  Expr N(32);
+  Placeholder<float> A("A", {M, N});
+  Placeholder<float> B("B", {M, N});
+  Tensor C = Compute(
+      {M, N}, [&](Var i, Var j) { return A(i, j) + B(i, j); }, "C");
+
+  auto stages = CreateStages({C});
+  auto funcs  = cinn::lang::LowerVec("test_elementwise", stages, {A, B, C}, {}, {}, nullptr, target, true);
+  ir::ModuleExpr mod_expr({funcs[0]->body});
+
+  AutoParallel test_rule(target);
+  if (target.num_cores() <= 1) {
+    ASSERT_EQ(test_rule.Init(mod_expr), RuleApplyType::kCannotApply);
+    return;
+  }
+  ASSERT_EQ(test_rule.Init(mod_expr), RuleApplyType::kApply);
+  EXPECT_EQ(test_rule.NumberApplicable(), 1);
+  ir::ModuleExpr new_mod_expr = test_rule.ApplyRandomly();
+  VLOG(6) << "After AutoParallel:\n" << new_mod_expr.GetExprs()[0];
+
+  // the outer loop is parallelized and the inner loop is kept for vectorization
+  ir::IRSchedule ir_sch(new_mod_expr);
+  std::vector<ir::Expr> loops = ir_sch.GetLoops("C");
+  ASSERT_EQ(loops.size(), 2UL);
+  EXPECT_TRUE(loops[0].As<ir::For>()->is_parallel());
+  EXPECT_TRUE(loops[1].As<ir::For>()->is_serial());
+
+  // not applicable once parallelized
+  EXPECT_EQ(test_rule.Init(new_mod_expr), RuleApplyType::kCannotApply);
+}
+
+TEST(AutoParallel, Matmul) {
+  using namespace ir;
+
+  srand(0);
+  Context::Global().ResetNameId();
+  Target target = common::DefaultHostTarget();
+
+  Expr M(16);
+  Expr N(8);
+  Expr K(32);
+  Placeholder<float> A("A", {M, K});
+  Placeholder<float> B("B", {K, N});
+  Var k(K.as_int32(), "k0");
+  Tensor C = Compute(
+      {M, N}, [&](Var i, Var j) { return ReduceSum(A(i, k) * B(k, j), {k}); }, "C");
+
+  auto stages = CreateStages({C});
+  auto funcs  = cinn::lang::LowerVec("test_matmul", stages, {A, B, C}, {}, {}, nullptr, target, true);
+  ir::ModuleExpr mod_expr({funcs[0]->body});
+
+  AutoParallel test_rule(target);
+  if (target.num_cores() <= 1) {
+    ASSERT_EQ(test_rule.Init(mod_expr), RuleApplyType::kCannotApply);
+    return;
+  }
+  ASSERT_EQ(test_rule.Init(mod_expr), RuleApplyType::kApply);
+  // the init block and the reduction are in a loop nest
+  EXPECT_EQ(test_rule.NumberApplicable(), 1);
+  ir::ModuleExpr new_mod_expr = test_rule.ApplyRandomly();
+  VLOG(6) << "After AutoParallel:\n" << new_mod_expr.GetExprs()[0];
+
+  // only a spatial loop is parallelized, the reduce loop stays serial
+  std::vector<ir::Expr> parallel_loops = GetParallelLoops(new_mod_expr);
+  ASSERT_EQ(parallel_loops.size(), 1UL);
+  ir::IRSchedule ir_sch(new_mod_expr);
+  std::vector<ir::Expr> loops = ir_sch.GetLoops("C");
+  EXPECT_EQ(loops.front(), parallel_loops.front());
+  EXPECT_TRUE(loops.back().As<ir::For>()->is_serial());
+  EXPECT_EQ(loops.back().As<ir::For>()->loop_var->name, "k0");
+}
+
+TEST(AutoParallel, NVGPU) {
+  using namespace ir;
+
+  Context::Global().ResetNameId();
+  Target target = common::DefaultNVGPUTarget();
+
+  Expr M(64);
+  Placeholder<float> A("A", {M});
+  Tensor B = Compute(
+      {M}, [&](Var i) { return A(i) * Expr(2.f); }, "B");
+
+  auto stages = CreateStages({B});
+  auto funcs  = cinn::lang::LowerVec("test_nvgpu", stages, {A, B}, {}, {}, nullptr, target, true);
+  ir::ModuleExpr mod_expr({funcs[0]->body});
+
+  AutoParallel test_rule(target);
+  EXPECT_EQ(test_rule.Init(mod_expr), RuleApplyType::kCannotApply);
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -41,6 +41,13 @@ class AutoUnroll : public AutoGenRule {
 
   AutoGenRule* NewPointer() const override { return new AutoUnroll(*target_); }
 
+  // The attribute is set on the block directly, which can't be restored by a trace.
+  ir::ScheduleTrace GetTrace() const override {
+    ir::ScheduleTrace trace;
+    trace.SetUnreplayable();
+    return trace;
+  }
+
  private:
   bool MeetCondition(const ir::ScheduleBlock* schedule_block);
 
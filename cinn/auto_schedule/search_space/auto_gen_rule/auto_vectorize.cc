@@ -0,0 +1,148 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_vectorize.h"
+
+#include <glog/logging.h>
+
+#include <cstdlib>
+#include <set>
+
+#include "cinn/auto_schedule/analysis/analyze_ir.h"
+#include "cinn/ir/collect_ir_nodes.h"
+#include "cinn/ir/ir_printer.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+namespace {
+
+bool UsesVar(const ir::Expr& expr, const std::string& var_name) {
+  std::set<ir::Expr> vars = ir::CollectIRNodesWithoutTensor(
+      expr, [&](const Expr* x) { return x->as_var() && x->as_var()->name == var_name; });
+  return !vars.empty();
+}
+
+}  // namespace
+
+AutoVectorize::AutoVectorize(const common::Target& target) : AutoGenRule(target) {
+  vector_bits_ = target.arch == common::Target::Arch::NVGPU ? 0 : target.vector_bits();
+}
+
+std::vector<int> AutoVectorize::GetVectorizeFactors(const ir::Expr& block_realize) const {
+  std::vector<ir::Expr> loops = ir_schedule_->GetLoops(block_realize);
+  if (loops.empty()) {
+    return {};
+  }
+  const ir::For* for_node = loops.back().As<ir::For>();
+  if (!for_node->is_serial() || !for_node->extent.is_constant() || !IsSpatialLoop(loops.back())) {
+    return {};
+  }
+  // the loop should contain the block only, otherwise the inner loops are vectorized as well
+  const ir::Block* body = for_node->body.As<ir::Block>();
+  if (body == nullptr || body->stmts.size() != 1 || body->stmts[0] != block_realize) {
+    return {};
+  }
+
+  const ir::ScheduleBlockRealize* realize = block_realize.As<ir::ScheduleBlockRealize>();
+  const ir::ScheduleBlock* sche_block     = realize->schedule_block.As<ir::ScheduleBlock>();
+  std::set<ir::Expr> stores =
+      ir::CollectIRNodesWithoutTensor(sche_block->body, [](const Expr* x) { return x->As<ir::Store>() != nullptr; });
+  if (stores.size() != 1) {
+    return {};
+  }
+  const ir::Store* store = stores.begin()->As<ir::Store>();
+  if (store->indices.empty()) {
+    return {};
+  }
+
+  // the block iter vars bound to the loop var should index the last dimension of the written tensor
+  const std::string& loop_var_name = for_node->loop_var->name;
+  bool index_last_dim              = false;
+  for (size_t i = 0; i < realize->iter_values.size(); ++i) {
+    if (!UsesVar(realize->iter_values[i], loop_var_name)) {
+      continue;
+    }
+    const std::string& iter_var_name = sche_block->iter_vars[i]->name;
+    for (size_t j = 0; j + 1 < store->indices.size(); ++j) {
+      if (UsesVar(store->indices[j], iter_var_name)) {
+        return {};
+      }
+    }
+    index_last_dim = index_last_dim || UsesVar(store->indices.back(), iter_var_name);
+  }
+  if (!index_last_dim) {
+    return {};
+  }
+
+  int bits = store->tensor.as_tensor_ref()->type().bits();
+  if (bits < 8 || vector_bits_ < bits) {
+    return {};
+  }
+  int lanes      = vector_bits_ / bits;
+  int64_t extent = for_node->extent.as_int64();
+  std::vector<int> factors;
+  for (int factor = lanes; factor <= lanes * max_vectors_ && factor <= extent; factor *= 2) {
+    if (extent % factor == 0) {
+      factors.push_back(factor);
+    }
+  }
+  // a narrower vector for the short loops
+  if (factors.empty()) {
+    for (int factor = lanes / 2; factor >= 2; factor /= 2) {
+      if (extent % factor == 0) {
+        factors.push_back(factor);
+        break;
+      }
+    }
+  }
+  return factors;
+}
+
+RuleApplyType AutoVectorize::Init(const ir::ModuleExpr& mod_expr) {
+  ir_schedule_ = std::make_unique<ir::IRSchedule>(mod_expr);
+  applicable_blocks_.clear();
+  num_applicable_ = 0;
+  if (vector_bits_ <= 0) {
+    return RuleApplyType::kCannotApply;
+  }
+
+  for (const ir::Expr& block_realize : ir_schedule_->GetAllBlocks()) {
+    if (!block_realize.As<ir::ScheduleBlockRealize>()->iter_values.empty() &&
+        !GetVectorizeFactors(block_realize).empty()) {
+      applicable_blocks_.push_back(block_realize);
+    }
+  }
+  num_applicable_ = applicable_blocks_.size();
+  VLOG(6) << "Collect applicable blocks of AutoVectorize:" << num_applicable_;
+
+  return num_applicable_ > 0 ? RuleApplyType::kApply : RuleApplyType::kCannotApply;
+}
+
+ir::ModuleExpr AutoVectorize::Apply(int index) {
+  CHECK(ir_schedule_ != nullptr) << "Run AutoVectorize::Apply without Init";
+  CHECK_LT(index, applicable_blocks_.size()) << "invalid apply index:" << index;
+  const ir::Expr& block_realize = applicable_blocks_[index];
+  std::vector<int> factors      = GetVectorizeFactors(block_realize);
+  CHECK(!factors.empty());
+  int factor = factors[std::rand() % factors.size()];
+
+  ir::Expr loop = ir_schedule_->GetLoops(block_realize).back();
+  VLOG(6) << "AutoVectorize vectorizes with factor " << factor << ":\n" << loop;
+  ir_schedule_->Vectorize(loop, factor);
+  return ir_schedule_->GetModule();
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
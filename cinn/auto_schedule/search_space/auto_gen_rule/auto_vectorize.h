@@ -0,0 +1,61 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_gen_rule.h"
+#include "cinn/common/target.h"
+#include "cinn/ir/ir.h"
+#include "cinn/ir/ir_schedule.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+// This rule vectorizes the innermost loop of a schedule block on CPU if it is a serial
+// spatial loop indexing the last dimension of the written tensor, so that the stores are
+// contiguous. The factor is sampled from the multiples of the SIMD lanes of the target
+// for the written data type, which divide the extent of the loop.
+class AutoVectorize : public AutoGenRule {
+ public:
+  AutoVectorize(const common::Target& target);
+  ~AutoVectorize() = default;
+
+  RuleApplyType Init(const ir::ModuleExpr& mod_expr) override;
+
+  ir::ModuleExpr Apply(int index) override;
+
+  std::string GetRuleName() const override { return "AutoVectorize"; }
+
+  AutoGenRule* NewPointer() const override { return new AutoVectorize(*target_); }
+
+  ir::ScheduleTrace GetTrace() const override { return ir_schedule_ ? ir_schedule_->GetTrace() : ir::ScheduleTrace(); }
+
+  // Returns the vectorize factors applicable on the innermost loop of the block,
+  // empty if the loop can't be vectorized
+  std::vector<int> GetVectorizeFactors(const ir::Expr& block_realize) const;
+
+ private:
+  std::unique_ptr<ir::IRSchedule> ir_schedule_;
+  std::vector<ir::Expr> applicable_blocks_;
+  int vector_bits_;
+  // the maximum number of vectors a vectorized loop processes in an iteration
+  int max_vectors_ = 4;
+};
+
+}  // namespace auto_schedule
+}  // namespace cinn
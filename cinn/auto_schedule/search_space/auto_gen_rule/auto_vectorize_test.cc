@@ -0,0 +1,116 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_vectorize.h"
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <vector>
+
+#include "cinn/cinn.h"
+#include "cinn/ir/ir_printer.h"
+#include "cinn/lang/lower.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+TEST(AutoVectorize, Elementwise) {
+  using namespace ir;
+
+  srand(0);
+  Context::Global().ResetNameId();
+  Target target = common::DefaultHostTarget();
+
+  Expr M(64);
+  Expr N(32);
+  Placeholder<float> A("A", {M, N});
+  Placeholder<float> B("B", {M, N});
+  Tensor C = Compute(
+      {M, N}, [&](Var i, Var j) { return A(i, j) + B(i, j); }, "C");
+
+  auto stages = CreateStages({C});
+  auto funcs  = cinn::lang::LowerVec("test_elementwise", stages, {A, B, C}, {}, {}, nullptr, target, true);
+  ir::ModuleExpr mod_expr({funcs[0]->body});
+
+  AutoVectorize test_rule(target);
+  ASSERT_EQ(test_rule.Init(mod_expr), RuleApplyType::kApply);
+  EXPECT_EQ(test_rule.NumberApplicable(), 1);
+  ir::ModuleExpr new_mod_expr = test_rule.ApplyRandomly();
+  VLOG(6) << "After AutoVectorize:\n" << new_mod_expr.GetExprs()[0];
+
+  // the factor is a multiple of the lanes of float32 dividing the extent
+  ir::IRSchedule ir_sch(new_mod_expr);
+  std::vector<ir::Expr> loops = ir_sch.GetLoops("C");
+  ASSERT_EQ(loops.size(), 2UL);
+  EXPECT_TRUE(loops[0].As<ir::For>()->is_serial());
+  ASSERT_TRUE(loops[1].As<ir::For>()->is_vectorized());
+  int factor = loops[1].As<ir::For>()->vectorize_info().factor;
+  int lanes  = target.vector_bits() / 32;
+  EXPECT_EQ(factor % lanes, 0);
+  EXPECT_EQ(32 % factor, 0);
+
+  // not applicable once vectorized
+  EXPECT_EQ(test_rule.Init(new_mod_expr), RuleApplyType::kCannotApply);
+}
+
+TEST(AutoVectorize, OddExtent) {
+  using namespace ir;
+
+  Context::Global().ResetNameId();
+  Target target = common::DefaultHostTarget();
+
+  Expr M(64);
+  Expr N(3);
+  Placeholder<float> A("A", {M, N});
+  Tensor B = Compute(
+      {M, N}, [&](Var i, Var j) { return A(i, j) * Expr(2.f); }, "B");
+
+  auto stages = CreateStages({B});
+  auto funcs  = cinn::lang::LowerVec("test_odd_extent", stages, {A, B}, {}, {}, nullptr, target, true);
+  ir::ModuleExpr mod_expr({funcs[0]->body});
+
+  // no vector width divides the extent
+  AutoVectorize test_rule(target);
+  EXPECT_EQ(test_rule.Init(mod_expr), RuleApplyType::kCannotApply);
+}
+
+TEST(AutoVectorize, Matmul) {
+  using namespace ir;
+
+  Context::Global().ResetNameId();
+  Target target = common::DefaultHostTarget();
+
+  Expr M(16);
+  Expr N(8);
+  Expr K(32);
+  Placeholder<float> A("A", {M, K});
+  Placeholder<float> B("B", {K, N});
+  Var k(K.as_int32(), "k0");
+  Tensor C = Compute(
+      {M, N}, [&](Var i, Var j) { return ReduceSum(A(i, k) * B(k, j), {k}); }, "C");
+
+  auto stages = CreateStages({C});
+  auto funcs  = cinn::lang::LowerVec("test_matmul", stages, {A, B, C}, {}, {}, nullptr, target, true);
+  ir::ModuleExpr mod_expr({funcs[0]->body});
+
+  // the innermost loop of the reduction is a reduce loop, and the innermost
+  // loop of the init block contains the reduce loop
+  AutoVectorize test_rule(target);
+  EXPECT_EQ(test_rule.Init(mod_expr), RuleApplyType::kCannotApply);
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,173 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/auto_schedule/analysis/analyze_ir.h"
+#include "cinn/auto_schedule/search_space/auto_gen_rule/add_cache_write.h"
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_parallel.h"
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_vectorize.h"
+#include "cinn/auto_schedule/search_space/auto_gen_rule/reduction_factoring.h"
+#include "cinn/backends/llvm/execution_engine.h"
+#include "cinn/cinn.h"
+#include "cinn/common/test_helper.h"
+#include "cinn/lang/lower.h"
+#include "cinn/runtime/cinn_runtime.h"
+#include "cinn/utils/timer.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+/**
+ * Times the kernels scheduled by the CPU rules against the un-scheduled ones.
+ * The timings are logged rather than checked, because they depend on the host,
+ * and the outputs of every scheduled kernel are compared with the baseline.
+ */
+class CpuRulesBenchmark : public ::testing::Test {
+ public:
+  using LowerFn = std::function<ir::LoweredFunc(const std::string&)>;
+
+  void SetUp() override {
+    srand(0);
+    Context::Global().ResetNameId();
+  }
+
+  // Apply the rule once on a newly lowered function, return an undefined function if the rule can't be applied
+  ir::LoweredFunc LowerAndApply(const LowerFn& lower_fn, AutoGenRule* rule) {
+    ir::LoweredFunc func = lower_fn("bench_" + rule->GetRuleName());
+    ir::ModuleExpr mod_expr({func->body});
+    if (rule->Init(mod_expr) == RuleApplyType::kCannotApply) {
+      LOG(INFO) << rule->GetRuleName() << " can't be applied on this host";
+      return ir::LoweredFunc();
+    }
+    func->body = rule->ApplyRandomly().GetExprs()[0];
+    UpdateTempBuffers(func);
+    return func;
+  }
+
+  // Run the function once for warmup, and return the average time of the repeated runs in ms
+  double Time(const ir::LoweredFunc& func, cinn_pod_value_t* args, int num_args) {
+    Module::Builder builder("module_" + func->name, target);
+    builder.AddFunction(func);
+    auto jit = backends::ExecutionEngine::Create({});
+    jit->Link(builder.Build());
+    auto fn = reinterpret_cast<void (*)(void*, int32_t)>(jit->Lookup(func->name));
+    CHECK(fn) << "Can't find the function " << func->name;
+
+    fn(args, num_args);
+    utils::Timer timer;
+    timer.Start();
+    for (int i = 0; i < repeat; ++i) {
+      fn(args, num_args);
+    }
+    return timer.Stop() / repeat;
+  }
+
+  Target target = common::DefaultHostTarget();
+  int repeat    = 10;
+};
+
+TEST_F(CpuRulesBenchmark, Matmul) {
+  const int m = 256, n = 256, k = 256;
+  Expr M(m);
+  Expr N(n);
+  Expr K(k);
+  Placeholder<float> A("A", {M, K});
+  Placeholder<float> B("B", {K, N});
+  Var k0(K.as_int32(), "k0");
+  ir::Tensor C = Compute(
+      {M, N}, [&](Var i, Var j) { return ReduceSum(A(i, k0) * B(k0, j), {k0}); }, "C");
+  auto stages   = CreateStages({C});
+  auto lower_fn = [&](const std::string& name) {
+    return cinn::lang::LowerVec(name, stages, {A, B, C}, {}, {}, nullptr, target, true)[0];
+  };
+
+  cinn_buffer_t* A_buf        = common::BufferBuilder(Float(32), {m, k}).set_random().Build();
+  cinn_buffer_t* B_buf        = common::BufferBuilder(Float(32), {k, n}).set_random().Build();
+  cinn_buffer_t* expected_buf = common::BufferBuilder(Float(32), {m, n}).set_zero().Build();
+  cinn_pod_value_t a_arg(A_buf), b_arg(B_buf), expected_arg(expected_buf);
+  cinn_pod_value_t expected_args[] = {a_arg, b_arg, expected_arg};
+  double baseline                  = Time(lower_fn("bench_baseline"), expected_args, 3);
+  LOG(INFO) << "Matmul " << m << "x" << n << "x" << k << " baseline: " << baseline << " ms";
+
+  std::vector<std::unique_ptr<AutoGenRule>> rules;
+  rules.emplace_back(new AutoParallel(target));
+  rules.emplace_back(new AutoVectorize(target));
+  rules.emplace_back(new AddCacheWrite(target));
+  for (auto& rule : rules) {
+    ir::LoweredFunc func = LowerAndApply(lower_fn, rule.get());
+    if (!func.defined()) {
+      continue;
+    }
+    cinn_buffer_t* C_buf = common::BufferBuilder(Float(32), {m, n}).set_zero().Build();
+    cinn_pod_value_t c_arg(C_buf);
+    cinn_pod_value_t args[] = {a_arg, b_arg, c_arg};
+    double cost             = Time(func, args, 3);
+    LOG(INFO) << rule->GetRuleName() << ": " << cost << " ms, speedup " << baseline / cost;
+
+    auto* expected = reinterpret_cast<float*>(expected_buf->memory);
+    auto* actual   = reinterpret_cast<float*>(C_buf->memory);
+    for (int i = 0; i < m * n; ++i) {
+      ASSERT_NEAR(actual[i], expected[i], 1e-2) << "Wrong output of " << rule->GetRuleName();
+    }
+  }
+}
+
+TEST_F(CpuRulesBenchmark, ReduceSum) {
+  const int m = 2, n = 1024;
+  Expr M(m);
+  Expr N(n);
+  Placeholder<float> A("A", {M, N});
+  Var k0(N.as_int32(), "k0");
+  ir::Tensor B = Compute(
+      {M}, [&](Var i) { return ReduceSum(A(i, k0), {k0}); }, "B");
+  auto stages   = CreateStages({B});
+  auto lower_fn = [&](const std::string& name) {
+    return cinn::lang::LowerVec(name, stages, {A, B}, {}, {}, nullptr, target, true)[0];
+  };
+
+  cinn_buffer_t* A_buf        = common::BufferBuilder(Float(32), {m, n}).set_random().Build();
+  cinn_buffer_t* expected_buf = common::BufferBuilder(Float(32), {m}).set_zero().Build();
+  cinn_pod_value_t a_arg(A_buf), expected_arg(expected_buf);
+  cinn_pod_value_t expected_args[] = {a_arg, expected_arg};
+  double baseline                  = Time(lower_fn("bench_baseline"), expected_args, 2);
+  LOG(INFO) << "ReduceSum " << m << "x" << n << " baseline: " << baseline << " ms";
+
+  ReductionFactoring rule(target);
+  ir::LoweredFunc func = LowerAndApply(lower_fn, &rule);
+  if (!func.defined()) {
+    return;
+  }
+  cinn_buffer_t* B_buf = common::BufferBuilder(Float(32), {m}).set_zero().Build();
+  cinn_pod_value_t b_arg(B_buf);
+  cinn_pod_value_t args[] = {a_arg, b_arg};
+  double cost             = Time(func, args, 2);
+  LOG(INFO) << rule.GetRuleName() << ": " << cost << " ms, speedup " << baseline / cost;
+
+  auto* expected = reinterpret_cast<float*>(expected_buf->memory);
+  auto* actual   = reinterpret_cast<float*>(B_buf->memory);
+  for (int i = 0; i < m; ++i) {
+    ASSERT_NEAR(actual[i], expected[i], 1e-2);
+  }
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
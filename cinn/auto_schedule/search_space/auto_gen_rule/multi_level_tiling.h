@@ -51,6 +51,9 @@ class MultiLevelTiling : public AutoGenRule {
   // pointer, caller should manage the life time of the pointer.
   AutoGenRule* NewPointer() const override;
 
+  // Returns the schedule primitives applied since Init.
+  ir::ScheduleTrace GetTrace() const override { return ir_schedule_ ? ir_schedule_->GetTrace() : ir::ScheduleTrace(); }
+
   // Returns true if sche_block_realize is applicable by MultiLevelTiling
   bool MeetCondition(const ir::ScheduleBlockRealize& sche_block_realize) const;
 
@@ -0,0 +1,136 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/reduction_factoring.h"
+
+#include <glog/logging.h>
+
+#include <cstdlib>
+#include <set>
+
+#include "cinn/auto_schedule/analysis/analyze_ir.h"
+#include "cinn/ir/collect_ir_nodes.h"
+#include "cinn/ir/ir_printer.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+ReductionFactoring::ReductionFactoring(const common::Target& target) : AutoGenRule(target) {
+  num_cores_ = target.arch == common::Target::Arch::NVGPU ? 1 : target.num_cores();
+}
+
+std::vector<ir::Expr> ReductionFactoring::GetFactorableLoops(const ir::Expr& block_realize) const {
+  const ir::ScheduleBlockRealize* realize = block_realize.As<ir::ScheduleBlockRealize>();
+  const ir::ScheduleBlock* sche_block     = realize->schedule_block.As<ir::ScheduleBlock>();
+  std::set<ir::Expr> stores =
+      ir::CollectIRNodesWithoutTensor(sche_block->body, [](const Expr* x) { return x->As<ir::Store>() != nullptr; });
+  if (stores.size() != 1) {
+    return {};
+  }
+  // Rfactor supports reduce_sum, reduce_mul, reduce_min and reduce_max only
+  const ir::Expr& value = stores.begin()->As<ir::Store>()->value;
+  if (!value.As<ir::Add>() && !value.As<ir::Mul>() && !value.As<ir::Min>() && !value.As<ir::Max>()) {
+    return {};
+  }
+
+  std::vector<ir::Expr> loops = ir_schedule_->GetLoops(block_realize);
+  int64_t spatial_extent      = 1;
+  std::vector<ir::Expr> reduce_loops;
+  for (const ir::Expr& loop : loops) {
+    const ir::For* for_node = loop.As<ir::For>();
+    if (IsSpatialLoop(loop)) {
+      if (for_node->extent.is_constant()) {
+        spatial_extent *= for_node->extent.as_int64();
+      }
+    } else {
+      reduce_loops.push_back(loop);
+    }
+  }
+  if (reduce_loops.empty() || spatial_extent >= num_cores_) {
+    return {};
+  }
+
+  std::vector<ir::Expr> result;
+  for (const ir::Expr& loop : reduce_loops) {
+    const ir::For* for_node = loop.As<ir::For>();
+    if (!for_node->is_serial() || !for_node->extent.is_constant() || for_node->extent.as_int64() < 2) {
+      continue;
+    }
+    // Rfactor requires the loop var bound to a block iter var directly, and
+    // only the block under the loop
+    int num_bindings  = 0;
+    bool direct_bound = false;
+    for (const ir::Expr& iter_value : realize->iter_values) {
+      std::set<ir::Expr> used = ir::CollectIRNodesWithoutTensor(iter_value, [&](const Expr* x) {
+        return x->as_var() && x->as_var()->name == for_node->loop_var->name;
+      });
+      if (!used.empty()) {
+        ++num_bindings;
+        direct_bound = iter_value.as_var() != nullptr;
+      }
+    }
+    std::set<ir::Expr> blocks = ir::CollectIRNodesWithoutTensor(
+        for_node->body, [](const Expr* x) { return x->As<ir::ScheduleBlockRealize>() != nullptr; });
+    if (num_bindings == 1 && direct_bound && blocks.size() == 1) {
+      result.push_back(loop);
+    }
+  }
+  return result;
+}
+
+RuleApplyType ReductionFactoring::Init(const ir::ModuleExpr& mod_expr) {
+  ir_schedule_ = std::make_unique<ir::IRSchedule>(mod_expr);
+  applicable_blocks_.clear();
+  num_applicable_ = 0;
+  if (num_cores_ <= 1) {
+    return RuleApplyType::kCannotApply;
+  }
+
+  for (const ir::Expr& block_realize : ir_schedule_->GetAllBlocks()) {
+    if (!block_realize.As<ir::ScheduleBlockRealize>()->iter_values.empty() &&
+        !GetFactorableLoops(block_realize).empty()) {
+      applicable_blocks_.push_back(block_realize);
+    }
+  }
+  num_applicable_ = applicable_blocks_.size();
+  VLOG(6) << "Collect applicable blocks of ReductionFactoring:" << num_applicable_;
+
+  return num_applicable_ > 0 ? RuleApplyType::kApplyAndSkipThisRule : RuleApplyType::kCannotApply;
+}
+
+ir::ModuleExpr ReductionFactoring::Apply(int index) {
+  CHECK(ir_schedule_ != nullptr) << "Run ReductionFactoring::Apply without Init";
+  CHECK_LT(index, applicable_blocks_.size()) << "invalid apply index:" << index;
+  const ir::Expr& block_realize           = applicable_blocks_[index];
+  const ir::ScheduleBlockRealize* realize = block_realize.As<ir::ScheduleBlockRealize>();
+  std::string block_name                  = realize->schedule_block.As<ir::ScheduleBlock>()->name;
+  std::vector<ir::Expr> loops             = GetFactorableLoops(block_realize);
+  CHECK(!loops.empty());
+  ir::Expr rf_loop         = loops[std::rand() % loops.size()];
+  std::string rf_loop_name = "rf_" + rf_loop.As<ir::For>()->loop_var->name;
+  VLOG(6) << "ReductionFactoring factors out the loop of " << block_name << ":\n" << rf_loop;
+  ir_schedule_->Rfactor(rf_loop, 0);
+
+  // the factored loop is a spatial loop of the new block computing the partial results
+  for (const ir::Expr& loop : ir_schedule_->GetLoops("rf_" + block_name)) {
+    if (loop.As<ir::For>()->loop_var->name == rf_loop_name && loop.As<ir::For>()->is_serial()) {
+      ir_schedule_->Parallel(loop);
+      break;
+    }
+  }
+  return ir_schedule_->GetModule();
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -0,0 +1,60 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_gen_rule.h"
+#include "cinn/common/target.h"
+#include "cinn/ir/ir.h"
+#include "cinn/ir/ir_schedule.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+// This rule parallelizes a reduction on CPU whose spatial loops have too few
+// iterations for all the cores, as the cross-thread reduction does on GPU. A reduce
+// loop is factored out by Rfactor to a block computing the partial results, where it
+// becomes a spatial loop and is parallelized, then the original block reduces the
+// partial results.
+class ReductionFactoring : public AutoGenRule {
+ public:
+  ReductionFactoring(const common::Target& target);
+  ~ReductionFactoring() = default;
+
+  RuleApplyType Init(const ir::ModuleExpr& mod_expr) override;
+
+  ir::ModuleExpr Apply(int index) override;
+
+  std::string GetRuleName() const override { return "ReductionFactoring"; }
+
+  AutoGenRule* NewPointer() const override { return new ReductionFactoring(*target_); }
+
+  ir::ScheduleTrace GetTrace() const override { return ir_schedule_ ? ir_schedule_->GetTrace() : ir::ScheduleTrace(); }
+
+  // Returns the reduce loops of the block which can be factored out by Rfactor,
+  // empty if the block doesn't need the factorization
+  std::vector<ir::Expr> GetFactorableLoops(const ir::Expr& block_realize) const;
+
+ private:
+  std::unique_ptr<ir::IRSchedule> ir_schedule_;
+  std::vector<ir::Expr> applicable_blocks_;
+  int num_cores_;
+};
+
+}  // namespace auto_schedule
+}  // namespace cinn
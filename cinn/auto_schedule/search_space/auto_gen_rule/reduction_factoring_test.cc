@@ -0,0 +1,129 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/search_space/auto_gen_rule/reduction_factoring.h"
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <vector>
+
+#include "cinn/auto_schedule/analysis/analyze_ir.h"
+#include "cinn/backends/llvm/execution_engine.h"
+#include "cinn/cinn.h"
+#include "cinn/common/test_helper.h"
+#include "cinn/ir/ir_printer.h"
+#include "cinn/lang/lower.h"
+#include "cinn/runtime/cinn_runtime.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+TEST(ReductionFactoring, ReduceSum) {
+  using namespace ir;
+
+  srand(0);
+  Context::Global().ResetNameId();
+  Target target = common::DefaultHostTarget();
+
+  const int m = 2, n = 4, k = 64;
+  Expr M(m);
+  Expr N(n);
+  Expr K(k);
+  Placeholder<float> A("A", {M, N, K});
+  Var j(N.as_int32(), "j0");
+  Var k0(K.as_int32(), "k0");
+  Tensor B = Compute(
+      {M}, [&](Var i) { return ReduceSum(A(i, j, k0), {j, k0}); }, "B");
+
+  auto stages = CreateStages({B});
+  auto funcs  = cinn::lang::LowerVec("test_reduction_factoring", stages, {A, B}, {}, {}, nullptr, target, true);
+  ir::ModuleExpr mod_expr({funcs[0]->body});
+
+  ReductionFactoring test_rule(target);
+  if (target.num_cores() <= m) {
+    // the spatial loop is enough for all the cores
+    ASSERT_EQ(test_rule.Init(mod_expr), RuleApplyType::kCannotApply);
+    return;
+  }
+  ASSERT_EQ(test_rule.Init(mod_expr), RuleApplyType::kApplyAndSkipThisRule);
+  EXPECT_EQ(test_rule.NumberApplicable(), 1);
+  ir::ModuleExpr new_mod_expr = test_rule.ApplyRandomly();
+  VLOG(6) << "After ReductionFactoring:\n" << new_mod_expr.GetExprs()[0];
+
+  // the partial results are computed in parallel by the factored loop
+  ir::IRSchedule ir_sch(new_mod_expr);
+  int num_parallel_loops = 0;
+  for (const ir::Expr& loop : ir_sch.GetLoops("rf_B")) {
+    if (loop.As<ir::For>()->is_parallel()) {
+      ++num_parallel_loops;
+      EXPECT_EQ(loop.As<ir::For>()->loop_var->name.substr(0, 3), "rf_");
+    }
+  }
+  EXPECT_EQ(num_parallel_loops, 1);
+
+  funcs[0]->body = new_mod_expr.GetExprs()[0];
+  UpdateTempBuffers(funcs[0]);
+  ASSERT_EQ(funcs[0]->temp_bufs.size(), 1UL);
+
+  Module::Builder builder("module0", target);
+  builder.AddFunction(funcs[0]);
+  auto jit = backends::ExecutionEngine::Create({});
+  jit->Link(builder.Build());
+  auto fn = reinterpret_cast<void (*)(void*, int32_t)>(jit->Lookup("test_reduction_factoring"));
+  ASSERT_NE(fn, nullptr);
+
+  cinn_buffer_t* A_buf = common::BufferBuilder(Float(32), {m, n, k}).set_random().Build();
+  cinn_buffer_t* B_buf = common::BufferBuilder(Float(32), {m}).set_zero().Build();
+  cinn_pod_value_t a_arg(A_buf), b_arg(B_buf);
+  cinn_pod_value_t args[] = {a_arg, b_arg};
+  fn(args, 2);
+
+  auto* ad = reinterpret_cast<float*>(A_buf->memory);
+  auto* bd = reinterpret_cast<float*>(B_buf->memory);
+  for (int i = 0; i < m; ++i) {
+    float expected = 0.f;
+    for (int r = 0; r < n * k; ++r) {
+      expected += ad[i * n * k + r];
+    }
+    ASSERT_NEAR(bd[i], expected, 1e-3);
+  }
+}
+
+TEST(ReductionFactoring, EnoughSpatialIterations) {
+  using namespace ir;
+
+  Context::Global().ResetNameId();
+  Target target = common::DefaultHostTarget();
+
+  Expr M(4096);
+  Expr K(16);
+  Placeholder<float> A("A", {M, K});
+  Var k0(K.as_int32(), "k0");
+  Tensor B = Compute(
+      {M}, [&](Var i) { return ReduceSum(A(i, k0), {k0}); }, "B");
+
+  auto stages = CreateStages({B});
+  auto funcs  = cinn::lang::LowerVec("test_enough_spatial", stages, {A, B}, {}, {}, nullptr, target, true);
+  ir::ModuleExpr mod_expr({funcs[0]->body});
+
+  ReductionFactoring test_rule(target);
+  if (target.num_cores() <= 4096) {
+    EXPECT_EQ(test_rule.Init(mod_expr), RuleApplyType::kCannotApply);
+  }
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
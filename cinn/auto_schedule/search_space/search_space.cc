@@ -16,7 +16,11 @@
 
 #include <glog/logging.h>
 
+#include <algorithm>
 #include <cstdlib>
+#include <functional>
+#include <string>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -25,6 +29,7 @@
 #include "cinn/auto_schedule/task/tune_task.h"
 #include "cinn/ir/ir_base.h"
 #include "cinn/ir/ir_schedule.h"
+#include "cinn/ir/schedule_trace.h"
 #include "cinn/optim/ir_copy.h"
 #include "cinn/runtime/flags.h"
 
@@ -33,12 +38,125 @@ DECLARE_bool(auto_schedule_use_cost_model);
 namespace cinn {
 namespace auto_schedule {
 
+namespace {
+
+using Steps = std::vector<ir::ScheduleTrace::Step>;
+
+// Re-sample the factors of a random Split with the same product
+bool ResampleTileSize(Steps* steps) {
+  std::vector<int> candidates;
+  for (int i = 0; i < steps->size(); ++i) {
+    const ir::ScheduleTrace::Step& step = steps->at(i);
+    auto it                             = step.attrs.find("factors");
+    if (step.type != "Split" || it == step.attrs.end() || !absl::holds_alternative<std::vector<int>>(it->second)) {
+      continue;
+    }
+    const std::vector<int>& factors = absl::get<std::vector<int>>(it->second);
+    if (factors.size() > 1 && std::all_of(factors.begin(), factors.end(), [](int f) { return f > 0; })) {
+      candidates.push_back(i);
+    }
+  }
+  if (candidates.empty()) {
+    return false;
+  }
+  utils::Attribute& attr   = steps->at(candidates[rand() % candidates.size()]).attrs.at("factors");
+  std::vector<int> factors = absl::get<std::vector<int>>(attr);
+  int remain               = 1;
+  for (int f : factors) {
+    remain *= f;
+  }
+  for (int i = 0; i + 1 < factors.size(); ++i) {
+    std::vector<int> divisors;
+    for (int d = 1; d <= remain; ++d) {
+      if (remain % d == 0) {
+        divisors.push_back(d);
+      }
+    }
+    factors[i] = divisors[rand() % divisors.size()];
+    remain /= factors[i];
+  }
+  factors.back() = remain;
+  if (factors == absl::get<std::vector<int>>(attr)) {
+    return false;
+  }
+  attr = factors;
+  return true;
+}
+
+// Drop a random parallel, vectorize or unroll annotation
+bool DropAnnotation(Steps* steps) {
+  std::vector<int> candidates;
+  for (int i = 0; i < steps->size(); ++i) {
+    const ir::ScheduleTrace::Step& step = steps->at(i);
+    auto it                             = step.attrs.find("for_type");
+    if (step.type != "MutateForType" || it == step.attrs.end() || !absl::holds_alternative<int>(it->second)) {
+      continue;
+    }
+    ir::ForType for_type = static_cast<ir::ForType>(absl::get<int>(it->second));
+    if (for_type == ir::ForType::Parallel || for_type == ir::ForType::Vectorized || for_type == ir::ForType::Unrolled) {
+      candidates.push_back(i);
+    }
+  }
+  if (candidates.empty()) {
+    return false;
+  }
+  steps->erase(steps->begin() + candidates[rand() % candidates.size()]);
+  return true;
+}
+
+// Move a random compute-at location to an outer loop of the same block
+bool MoveComputeAt(Steps* steps) {
+  std::vector<int> candidates;
+  for (int i = 0; i < steps->size(); ++i) {
+    const ir::ScheduleTrace::Step& step = steps->at(i);
+    if ((step.type == "ComputeAt" || step.type == "SimpleComputeAt") && step.inputs.size() == 2 &&
+        step.inputs[1].loop_index > 0) {
+      candidates.push_back(i);
+    }
+  }
+  if (candidates.empty()) {
+    return false;
+  }
+  ir::ScheduleTrace::ExprRef& loop = steps->at(candidates[rand() % candidates.size()]).inputs[1];
+  loop.loop_index                  = rand() % loop.loop_index;
+  return true;
+}
+
+// Parallelize the outermost loop or unroll the innermost loop of a random block
+bool AddAnnotation(const common::Target& target, int max_unroll_extent, ir::IRSchedule* ir_sch) {
+  std::vector<std::function<void()>> candidates;
+  for (const ir::Expr& block : ir_sch->GetAllBlocks()) {
+    std::vector<ir::Expr> loops = ir_sch->GetLoops(block);
+    if (loops.empty()) {
+      continue;
+    }
+    if (target != common::DefaultNVGPUTarget() && loops.front().As<ir::For>()->is_serial()) {
+      ir::Expr outer = loops.front();
+      candidates.emplace_back([ir_sch, outer]() { ir_sch->Parallel(outer); });
+    }
+    const ir::For* inner = loops.back().As<ir::For>();
+    if (inner->is_serial() && inner->extent.is_constant() && inner->extent.get_constant() <= max_unroll_extent) {
+      ir::Expr inner_loop = loops.back();
+      candidates.emplace_back([ir_sch, inner_loop]() { ir_sch->Unroll(inner_loop); });
+    }
+  }
+  if (candidates.empty()) {
+    return false;
+  }
+  candidates[rand() % candidates.size()]();
+  return true;
+}
+
+}  // namespace
+
 SearchSpace::SearchSpace(const TuneTask& tune_task) : tune_task_(tune_task) {}
 
 std::vector<SearchState> SearchSpace::GetRandomInitialSketch(int num) {
   VLOG(4) << "Start SearchSpace::GetRandomInitialSketch";
   std::vector<SearchState> result;
-  while (result.size() < num) {
+  std::unordered_set<size_t> hashes;
+  // stop after some tries in case the sketches are too few to be different
+  for (int num_tries = 0; result.size() < num && num_tries < num * max_sketch_tries_; ++num_tries) {
     std::vector<ir::Expr> body_exprs = tune_task_.GetLoweredFuncBodyExprs();
     std::vector<ir::Expr> copy_exprs;
     for (const ir::Expr& e : body_exprs) {
@@ -53,7 +171,10 @@ std::vector<SearchState> SearchSpace::GetRandomInitialSketch(int num) {
         break;
       }
     }
-    // TODO:(zhhsplendid): De-duplication on the result after we have Expr/ModuleExpr hash;
+    if (!hashes.insert(state.StructuralHash()).second) {
+      VLOG(6) << "Skip a duplicated sketch";
+      continue;
+    }
     result.emplace_back(std::move(state));
   }
   return result;
@@ -66,7 +187,15 @@ SearchState SearchSpace::GetScheduleMutate(const SearchState& state, const ExprC
     SearchState ret = ManualScheduleMutate(state);
     return ret;
   }
-  SearchState ret = RandomScheduleMutate(state);
+  SearchState ret;
+  bool mutated = false;
+  // half of the mutations modify the applied schedules if there are rules left to apply
+  if (state.applicable_rules.empty() || rand() % 2 == 0) {
+    mutated = TraceScheduleMutate(state, &ret);
+  }
+  if (!mutated) {
+    ret = RandomScheduleMutate(state);
+  }
   if (FLAGS_auto_schedule_use_cost_model) {
     ret.predicted_cost = cost_model.Predict(ret.mod_expr, tune_task_.target);
   }
@@ -118,8 +247,48 @@ SearchState SearchSpace::RandomScheduleMutate(const SearchState& state) {
 
   // 4. Apply the schedule change
   ret.mod_expr = sample_rule->Apply(sample_index - iter->first);
+  ret.trace.Append(sample_rule->GetTrace());
   return ret;
 }
 
+bool SearchSpace::TraceScheduleMutate(const SearchState& state, SearchState* result) {
+  if (!state.trace.IsReplayable() || state.trace.GetSteps().empty()) {
+    return false;
+  }
+  VLOG(4) << "Start SearchSpace::TraceScheduleMutate";
+  Steps steps = state.trace.GetSteps();
+  // try the modifications in random order until one is applicable
+  std::vector<int> mutate_types = {0, 1, 2, 3};
+  std::random_shuffle(mutate_types.begin(), mutate_types.end(), [](int n) { return rand() % n; });
+  int applied_type = -1;
+  for (int type : mutate_types) {
+    if ((type == 0 && ResampleTileSize(&steps)) || (type == 1 && DropAnnotation(&steps)) ||
+        (type == 2 && MoveComputeAt(&steps)) || type == 3) {
+      applied_type = type;
+      break;
+    }
+  }
+
+  ir::ScheduleTrace trace;
+  for (const ir::ScheduleTrace::Step& step : steps) {
+    trace.Append(step);
+  }
+  ir::IRSchedule ir_sch{ir::ModuleExpr(optim::IRCopy(tune_task_.GetLoweredFuncBodyExprs()))};
+  if (!trace.Replay(&ir_sch)) {
+    VLOG(6) << "The mutated trace can't be replayed";
+    return false;
+  }
+  // adding an annotation is applied on the replayed schedule
+  if (applied_type == 3 && !AddAnnotation(tune_task_.target, max_unroll_extent_, &ir_sch)) {
+    return false;
+  }
+  VLOG(6) << "Applied trace mutation " << applied_type;
+
+  *result          = state;
+  result->mod_expr = ir_sch.GetModule();
+  result->trace    = ir_sch.GetTrace();
+  return true;
+}
+
 }  // namespace auto_schedule
 }  // namespace cinn
@@ -37,14 +37,14 @@ namespace auto_schedule {
  *
  * 1. Manual defined schedule
  * 2. Schedule generated by AutoGenRule
- *
- * TODO(zhhsplendid): de-duplication the generated ModuleExpr
+ * 3. Modification on the trace of the applied schedules
  */
 class SearchSpace {
  public:
   SearchSpace(const TuneTask& tune_task);
 
-  // Generate sketch as initial population of evolutionary search
+  // Generate different sketches as initial population of evolutionary
+  // search, it returns less than num if the sketches are too few
   virtual std::vector<SearchState> GetRandomInitialSketch(int num);
 
   // Evolutionary search mutate, returns the mutated ModuleExpr and estimited cost
@@ -56,9 +56,22 @@ class SearchSpace {
 
   SearchState RandomScheduleMutate(const SearchState& state);
 
+  // Mutate the applied schedules by modifying the trace of state and replaying
+  // it on the initial ModuleExpr. The modification is one of re-sampling the
+  // factors of a split, dropping or adding a loop annotation (parallel,
+  // vectorize or unroll) and moving a compute-at location to an outer loop.
+  // Returns false if the trace can't be mutated or replayed.
+  bool TraceScheduleMutate(const SearchState& state, SearchState* result);
+
   const TuneTask& tune_task_;
 
   int init_sketch_random_depth_ = 6;
+
+  // the maximum tries to generate each different sketch
+  int max_sketch_tries_ = 4;
+
+  // loops with no larger constant extent are allowed to be unrolled by TraceScheduleMutate
+  int max_unroll_extent_ = 16;
 };
 
 }  // namespace auto_schedule
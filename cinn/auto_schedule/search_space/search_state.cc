@@ -14,28 +14,123 @@
 
 #include "cinn/auto_schedule/search_space/search_state.h"
 
+#include <functional>
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
+#include "cinn/auto_schedule/search_space/auto_gen_rule/add_cache_write.h"
 #include "cinn/auto_schedule/search_space/auto_gen_rule/auto_gen_rule.h"
 #include "cinn/auto_schedule/search_space/auto_gen_rule/auto_inline.h"
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_memory_hint.h"
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_parallel.h"
+#include "cinn/auto_schedule/search_space/auto_gen_rule/auto_vectorize.h"
 #include "cinn/auto_schedule/search_space/auto_gen_rule/multi_level_tiling.h"
+#include "cinn/auto_schedule/search_space/auto_gen_rule/reduction_factoring.h"
 #include "cinn/auto_schedule/search_space/auto_gen_rule/skip_rule.h"
 #include "cinn/common/target.h"
+#include "cinn/ir/ir.h"
 #include "cinn/ir/ir_base.h"
 #include "cinn/ir/ir_schedule.h"
 
 namespace cinn {
 namespace auto_schedule {
 
+namespace {
+
+class StructuralHasher {
+ public:
+  size_t operator()(const ir::ModuleExpr& mod_expr) {
+    for (const ir::Expr& expr : mod_expr.GetExprs()) {
+      Hash(expr);
+    }
+    return hash_;
+  }
+
+ private:
+  void Combine(size_t value) { hash_ ^= value + 0x9e3779b9 + (hash_ << 6) + (hash_ >> 2); }
+
+  void CombineName(const std::string& name) {
+    auto it = name_ids_.find(name);
+    if (it == name_ids_.end()) {
+      it = name_ids_.emplace(name, name_ids_.size()).first;
+    }
+    Combine(it->second);
+  }
+
+  void Hash(const ir::Expr& expr) {
+    if (!expr.defined()) {
+      Combine(0);
+      return;
+    }
+    Combine(static_cast<size_t>(expr.node_type()) + 1);
+    if (expr.As<ir::IntImm>()) {
+      Combine(std::hash<int64_t>()(expr.As<ir::IntImm>()->value));
+    } else if (expr.As<ir::UIntImm>()) {
+      Combine(std::hash<uint64_t>()(expr.As<ir::UIntImm>()->value));
+    } else if (expr.As<ir::FloatImm>()) {
+      Combine(std::hash<double>()(expr.As<ir::FloatImm>()->value));
+    } else if (expr.As<ir::StringImm>()) {
+      Combine(std::hash<std::string>()(expr.As<ir::StringImm>()->value));
+    } else if (expr.As<ir::_Var_>()) {
+      CombineName(expr.As<ir::_Var_>()->name);
+    } else if (expr.As<ir::_Tensor_>()) {
+      // the compute body of a tensor is not a part of the schedule
+      CombineName(expr.As<ir::_Tensor_>()->name);
+      return;
+    } else if (expr.As<ir::_Buffer_>()) {
+      CombineName(expr.As<ir::_Buffer_>()->name);
+      return;
+    } else if (expr.As<ir::Cast>()) {
+      const Type& type = expr.As<ir::Cast>()->type();
+      Combine(static_cast<size_t>(type.type()));
+      Combine(type.bits());
+      Combine(type.lanes());
+    } else if (expr.As<ir::Call>()) {
+      Combine(std::hash<std::string>()(expr.As<ir::Call>()->name));
+    } else if (expr.As<ir::Reduce>()) {
+      Combine(static_cast<size_t>(expr.As<ir::Reduce>()->reduce_type));
+    } else if (expr.As<ir::For>()) {
+      const ir::For* for_node = expr.As<ir::For>();
+      CombineName(for_node->loop_var->name);
+      Combine(static_cast<size_t>(for_node->for_type()));
+      Combine(for_node->vectorize_info().factor);
+      Combine(for_node->bind_info().offset);
+    } else if (expr.As<ir::ScheduleBlockRealize>()) {
+      const ir::ScheduleBlockRealize* realize = expr.As<ir::ScheduleBlockRealize>();
+      for (const ir::Expr& value : realize->iter_values) {
+        Hash(value);
+      }
+      Hash(realize->schedule_block);
+      return;
+    } else if (expr.As<ir::ScheduleBlock>()) {
+      const ir::ScheduleBlock* block = expr.As<ir::ScheduleBlock>();
+      CombineName(block->name);
+      for (const ir::Var& var : block->iter_vars) {
+        CombineName(var->name);
+      }
+    }
+    for (const ir::Expr* field : static_cast<const ir::IrNode*>(expr.ptr())->expr_fields()) {
+      Hash(*field);
+    }
+  }
+
+  size_t hash_ = 0;
+  std::unordered_map<std::string, size_t> name_ids_;
+};
+
+}  // namespace
+
 SearchState::SearchState(const ir::ModuleExpr& mod_expr) { this->mod_expr = mod_expr; }
 
 SearchState::SearchState(ir::ModuleExpr&& mod_expr) { this->mod_expr = std::move(mod_expr); }
 
 SearchState::SearchState(const SearchState& state) {
   mod_expr       = state.mod_expr;
+  trace          = state.trace;
   predicted_cost = state.predicted_cost;
   for (const std::shared_ptr<AutoGenRule>& rule : state.applicable_rules) {
     applicable_rules.emplace_back(std::shared_ptr<AutoGenRule>(rule->NewPointer()));
@@ -44,6 +139,7 @@ SearchState::SearchState(const SearchState& state) {
 
 SearchState& SearchState::operator=(const SearchState& src) {
   this->mod_expr       = src.mod_expr;
+  this->trace          = src.trace;
   this->predicted_cost = src.predicted_cost;
   this->applicable_rules.clear();
   for (const std::shared_ptr<AutoGenRule>& rule : src.applicable_rules) {
@@ -52,13 +148,23 @@ SearchState& SearchState::operator=(const SearchState& src) {
   return *this;
 }
 
+size_t SearchState::StructuralHash() const { return StructuralHasher()(mod_expr); }
+
 bool operator<(const SearchState& left, const SearchState& right) { return left.predicted_cost < right.predicted_cost; }
 
 void SearchState::InitAutoGenRules(const common::Target& target, const std::unordered_set<std::string>& output_names) {
   // TODO(zhhsplendid): pass correct output names to AutoInline
   applicable_rules = {std::shared_ptr<AutoGenRule>(new AutoInline(target, output_names)),
-                      std::shared_ptr<AutoGenRule>(new MultiLevelTiling(target)),
-                      std::shared_ptr<AutoGenRule>(new SkipRule(target))};
+                      std::shared_ptr<AutoGenRule>(new MultiLevelTiling(target))};
+  // the rules deciding the cache, parallelization, vectorization and memory access hints on CPU
+  if (target.arch != common::Target::Arch::NVGPU) {
+    applicable_rules.emplace_back(new AddCacheWrite(target));
+    applicable_rules.emplace_back(new ReductionFactoring(target));
+    applicable_rules.emplace_back(new AutoParallel(target));
+    applicable_rules.emplace_back(new AutoVectorize(target));
+    applicable_rules.emplace_back(new AutoMemoryHint(target));
+  }
+  applicable_rules.emplace_back(new SkipRule(target));
 }
 
 }  // namespace auto_schedule
@@ -24,6 +24,7 @@
 #include "cinn/common/target.h"
 #include "cinn/ir/ir_base.h"
 #include "cinn/ir/ir_schedule.h"
+#include "cinn/ir/schedule_trace.h"
 
 namespace cinn {
 namespace auto_schedule {
@@ -36,6 +37,9 @@ class SearchState {
   // The ModuleExpr
   ir::ModuleExpr mod_expr;
 
+  // The schedule primitives applied on the initial ModuleExpr to get mod_expr
+  ir::ScheduleTrace trace;
+
   // The rules that can be applied to this ModuleExpr at this state.
   // Initialized by list of all AutoGenRule
   std::vector<std::shared_ptr<AutoGenRule>> applicable_rules;
@@ -63,6 +67,12 @@ class SearchState {
   // Not all ModuleExpr has to be mutated AutoGenRule. For those states which
   // have ModuleExpr to random mutated by AutoGenRule, initialize it.
   void InitAutoGenRules(const common::Target& target, const std::unordered_set<std::string>& output_names);
+
+  // Hash of the structure of mod_expr, it is used to de-duplicate the
+  // candidates. The names of variables, tensors and schedule blocks are
+  // replaced with the order they first appear, so ModuleExprs differing
+  // only in names have the same hash.
+  size_t StructuralHash() const;
 };
 
 }  // namespace auto_schedule
@@ -0,0 +1,70 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/auto_schedule/search_space/search_state.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "cinn/common/context.h"
+#include "cinn/ir/ir_base.h"
+#include "cinn/ir/ir_schedule.h"
+#include "cinn/lang/compute.h"
+#include "cinn/lang/lower.h"
+#include "cinn/lang/placeholder.h"
+#include "cinn/optim/ir_copy.h"
+
+namespace cinn {
+namespace auto_schedule {
+
+ir::ModuleExpr LowerAssign(const std::string& input_name, const std::string& output_name) {
+  Context::Global().ResetNameId();
+  ir::Expr M(32);
+  ir::Expr N(32);
+  lang::Placeholder<float> A(input_name, {M, N});
+  ir::Tensor B = lang::Compute(
+      {M, N}, [&](Var i, Var j) { return A(i, j); }, output_name);
+
+  poly::StageMap stages = poly::CreateStages({A, B});
+  std::vector<ir::LoweredFunc> funcs =
+      lang::LowerVec("assign", stages, {A, B}, {}, {}, nullptr, common::DefaultHostTarget(), true);
+  return ir::ModuleExpr({optim::IRCopy(funcs[0]->body)});
+}
+
+TEST(SearchState, StructuralHash) {
+  SearchState state(LowerAssign("A", "B"));
+  // only the names of tensors are different
+  SearchState renamed(LowerAssign("X", "Y"));
+  EXPECT_EQ(state.StructuralHash(), renamed.StructuralHash());
+
+  ir::IRSchedule split_8(LowerAssign("A", "B"));
+  split_8.Split(split_8.GetLoops("B")[1], {4, 8});
+  ir::IRSchedule split_4(LowerAssign("A", "B"));
+  split_4.Split(split_4.GetLoops("B")[1], {8, 4});
+  size_t split_8_hash = SearchState(split_8.GetModule()).StructuralHash();
+  size_t split_4_hash = SearchState(split_4.GetModule()).StructuralHash();
+  EXPECT_NE(state.StructuralHash(), split_8_hash);
+  EXPECT_NE(split_8_hash, split_4_hash);
+
+  ir::IRSchedule parallel(LowerAssign("A", "B"));
+  parallel.Split(parallel.GetLoops("B")[1], {4, 8});
+  EXPECT_EQ(SearchState(parallel.GetModule()).StructuralHash(), split_8_hash);
+  parallel.Parallel(parallel.GetLoops("B")[0]);
+  EXPECT_NE(SearchState(parallel.GetModule()).StructuralHash(), split_8_hash);
+}
+
+}  // namespace auto_schedule
+}  // namespace cinn
@@ -18,22 +18,29 @@
 
 #include <algorithm>
 #include <cstdlib>
+#include <functional>
 #include <limits>
 #include <memory>
+#include <numeric>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 
 #include "cinn/auto_schedule/search_space/search_space.h"
 #include "cinn/auto_schedule/search_space/search_state.h"
 #include "cinn/auto_schedule/task/tune_task.h"
 #include "cinn/auto_schedule/tuning.h"
+#include "cinn/ir/ir_schedule_util.h"
+#include "cinn/ir/schedule_trace.h"
 #include "cinn/optim/ir_copy.h"
 #include "cinn/utils/sized_multi_set.h"
 
 namespace cinn {
 namespace auto_schedule {
 
-EvolutionarySearch::EvolutionarySearch(const TuneTask& tune_task, const ExprCostModel& cost_model)
-    : tune_task_(tune_task), cost_model_(cost_model) {
+EvolutionarySearch::EvolutionarySearch(const TuneTask& tune_task, const ExprCostModel& cost_model, Database* database)
+    : tune_task_(tune_task), cost_model_(cost_model), database_(database) {
   search_space_ = std::make_unique<SearchSpace>(tune_task);
 }
 
@@ -44,6 +51,7 @@ SearchState EvolutionarySearch::SearchModuleExpr(const TuningOptions& options) {
 }
 
 std::vector<SearchState> EvolutionarySearch::SearchModuleExprBests(const TuningOptions& options) {
+  VisitDatabaseRecords();
   std::vector<SearchState> init_population;
   std::vector<SearchState> topk_from_database = GetTopKCandidatesFromDatabase(options.evolution_pick_database_topk);
   VLOG(5) << "EvolutionarySearch got " << topk_from_database.size() << " as topk from database";
@@ -66,13 +74,67 @@ std::vector<SearchState> EvolutionarySearch::SearchModuleExprBests(const TuningO
 std::vector<SearchState> EvolutionarySearch::SearchModuleExprEpsGreedy(const TuningOptions& options) {
   std::vector<SearchState> picked_bests = SearchModuleExprBests(options);
   int random_num                        = options.evolution_init_population_num - options.evolution_pick_database_topk;
-  return PickNextGenerationEpsGreedy(
+  std::vector<SearchState> result       = PickNextGenerationEpsGreedy(
       picked_bests, RandomInitSketch(random_num), options.num_samples_per_iteration, options.evolution_eps_greedy);
+  // the returned candidates are going to be measured, don't return them again
+  for (const SearchState& state : result) {
+    visited_candidates_.insert(state.StructuralHash());
+  }
+  return result;
+}
+
+void EvolutionarySearch::VisitDatabaseRecords() {
+  if (database_visited_ || database_ == nullptr) {
+    return;
+  }
+  // only the records existing before searching are needed, the later
+  // ones are the candidates returned by this class
+  database_visited_ = true;
+  for (const TuningRecord& record : database_->LookUp(tune_task_.serialized_key)) {
+    ir::IRSchedule ir_sch{ir::ModuleExpr(optim::IRCopy(tune_task_.GetLoweredFuncBodyExprs()))};
+    if (record.state.trace.Replay(&ir_sch)) {
+      visited_candidates_.insert(SearchState(ir_sch.GetModule()).StructuralHash());
+    }
+  }
+  VLOG(5) << "EvolutionarySearch visited " << visited_candidates_.size() << " candidates in database";
 }
 
 std::vector<SearchState> EvolutionarySearch::GetTopKCandidatesFromDatabase(int topk) {
-  // TODO(zhhsplendid): implement it after we have the database
-  return std::vector<SearchState>();
+  std::vector<SearchState> results;
+  if (database_ == nullptr || topk <= 0) {
+    return results;
+  }
+  // the records only keep the traces, so rebuild the candidates by
+  // replaying them on the un-optimized exprs of the task
+  for (SearchState& record : database_->GetTopK(tune_task_.serialized_key, topk)) {
+    ir::IRSchedule ir_sch{ir::ModuleExpr(optim::IRCopy(tune_task_.GetLoweredFuncBodyExprs()))};
+    if (!record.trace.Replay(&ir_sch)) {
+      VLOG(5) << "Skip a record can't be replayed";
+      continue;
+    }
+    SearchState state(ir_sch.GetModule());
+    state.trace = std::move(record.trace);
+    results.emplace_back(std::move(state));
+  }
+  if (results.size() >= topk) {
+    return results;
+  }
+  // warm start from the best records of the related tasks, whose blocks are renamed to those of this task
+  // and the records whose splits don't fit the extents of this task are skipped in replaying
+  std::vector<std::string> block_names = tune_task_.GetBlockNames();
+  for (TuningRecord& record :
+       database_->LookUpRelated(tune_task_.workload_pattern, tune_task_.serialized_key, topk - results.size())) {
+    ir::IRSchedule ir_sch{ir::ModuleExpr(optim::IRCopy(tune_task_.GetLoweredFuncBodyExprs()))};
+    if (!record.state.trace.RenameBlocks(record.block_names, block_names) || !record.state.trace.Replay(&ir_sch)) {
+      VLOG(5) << "Skip a record of the related task can't be replayed";
+      continue;
+    }
+    SearchState state(ir_sch.GetModule());
+    state.trace = std::move(record.state.trace);
+    results.emplace_back(std::move(state));
+  }
+  VLOG(5) << "EvolutionarySearch got " << results.size() << " candidates from database";
+  return results;
 }
 
 std::vector<SearchState> EvolutionarySearch::RandomInitSketch(int num) {
@@ -80,6 +142,10 @@ std::vector<SearchState> EvolutionarySearch::RandomInitSketch(int num) {
 }
 
 SearchState EvolutionarySearch::CrossOver(const SearchState& state1, const SearchState& state2) {
+  SearchState trace_child;
+  if (TraceCrossOver(state1, state2, &trace_child)) {
+    return trace_child;
+  }
   std::vector<ir::Expr> cross_over_exprs;
   std::vector<ir::Expr> father_exprs = state1.mod_expr.GetExprs();
   std::vector<ir::Expr> mother_exprs = state2.mod_expr.GetExprs();
@@ -94,7 +160,101 @@ SearchState EvolutionarySearch::CrossOver(const SearchState& state1, const Searc
       cross_over_exprs.push_back(optim::IRCopy(mother_exprs[i]));
     }
   }
-  return SearchState(ir::ModuleExpr(cross_over_exprs));
+  SearchState child{ir::ModuleExpr(cross_over_exprs)};
+  // the steps of the parents can't be split by AST, so the schedule of the child can't be replayed
+  child.trace.SetUnreplayable();
+  return child;
+}
+
+bool EvolutionarySearch::TraceCrossOver(const SearchState& father, const SearchState& mother, SearchState* child) {
+  const std::vector<ir::ScheduleTrace::Step>& father_steps = father.trace.GetSteps();
+  const std::vector<ir::ScheduleTrace::Step>& mother_steps = mother.trace.GetSteps();
+  if (!father.trace.IsReplayable() || !mother.trace.IsReplayable() || (father_steps.empty() && mother_steps.empty())) {
+    return false;
+  }
+  if (num_block_groups_ == 0) {
+    InitBlockGroups();
+  }
+
+  // union the groups scheduled by a same step, the blocks created by the
+  // steps and the steps without inputs are put into an extra group
+  std::vector<int> roots(num_block_groups_ + 1);
+  std::iota(roots.begin(), roots.end(), 0);
+  std::function<int(int)> find_root = [&](int x) { return roots[x] == x ? x : roots[x] = find_root(roots[x]); };
+  auto step_group = [&](const ir::ScheduleTrace::Step& step, int i) {
+    if (i >= step.inputs.size()) {
+      return num_block_groups_;
+    }
+    auto it = block_group_ids_.find(step.inputs[i].block_name);
+    return it == block_group_ids_.end() ? num_block_groups_ : it->second;
+  };
+  for (const auto* steps : {&father_steps, &mother_steps}) {
+    for (const ir::ScheduleTrace::Step& step : *steps) {
+      int root = find_root(step_group(step, 0));
+      for (int i = 1; i < step.inputs.size(); ++i) {
+        roots[find_root(step_group(step, i))] = root;
+      }
+    }
+  }
+
+  // pick a parent for each union of groups
+  std::vector<int> from_father(roots.size());
+  for (int& f : from_father) {
+    f = rand() % 2;
+  }
+  ir::ScheduleTrace trace;
+  int num_father_steps = 0;
+  for (const ir::ScheduleTrace::Step& step : father_steps) {
+    if (from_father[find_root(step_group(step, 0))]) {
+      trace.Append(step);
+      ++num_father_steps;
+    }
+  }
+  int num_mother_steps = 0;
+  for (const ir::ScheduleTrace::Step& step : mother_steps) {
+    if (!from_father[find_root(step_group(step, 0))]) {
+      trace.Append(step);
+      ++num_mother_steps;
+    }
+  }
+  if ((num_father_steps == father_steps.size() && num_mother_steps == 0) ||
+      (num_mother_steps == mother_steps.size() && num_father_steps == 0)) {
+    // the child is the same as one of the parents
+    return false;
+  }
+
+  ir::IRSchedule ir_sch{ir::ModuleExpr(optim::IRCopy(tune_task_.GetLoweredFuncBodyExprs()))};
+  if (!trace.Replay(&ir_sch)) {
+    VLOG(6) << "The crossed over trace can't be replayed";
+    return false;
+  }
+  *child       = SearchState(ir_sch.GetModule());
+  child->trace = ir_sch.GetTrace();
+  return true;
+}
+
+void EvolutionarySearch::InitBlockGroups() {
+  ir::IRSchedule ir_sch{ir::ModuleExpr(optim::IRCopy(tune_task_.GetLoweredFuncBodyExprs()))};
+  std::vector<ir::Expr> outer_loops;
+  for (const ir::Expr& block : ir_sch.GetAllBlocks()) {
+    if (block.As<ir::ScheduleBlockRealize>()->iter_values.empty()) {
+      // root block is not referred to by the traces
+      continue;
+    }
+    std::vector<ir::Expr> loops = ir_sch.GetLoops(block);
+    int group_id                = num_block_groups_;
+    if (!loops.empty()) {
+      auto it  = std::find(outer_loops.begin(), outer_loops.end(), loops.front());
+      group_id = it - outer_loops.begin();
+      if (it == outer_loops.end()) {
+        outer_loops.push_back(loops.front());
+      }
+    }
+    if (group_id == num_block_groups_) {
+      ++num_block_groups_;
+    }
+    block_group_ids_[ir::GetTensor(block)->name] = group_id;
+  }
 }
 
 std::vector<SearchState> EvolutionarySearch::Evolve(const std::vector<SearchState>& population,
@@ -106,7 +266,7 @@ std::vector<SearchState> EvolutionarySearch::Evolve(const std::vector<SearchStat
   }
   std::vector<SearchState> evolution(population);
 
-  for (int i = 0; i < cross_over_num; ++i) {
+  for (int i = 0; i < cross_over_num && generation_num > 1; ++i) {
     int first_rand_idx  = rand() % generation_num;
     int second_rand_idx = rand() % generation_num;
     while (first_rand_idx == second_rand_idx) {
@@ -116,9 +276,18 @@ std::vector<SearchState> EvolutionarySearch::Evolve(const std::vector<SearchStat
   }
 
   utils::SizedMultiSet<SearchState> evolution_with_cost(ret_num);
+  std::unordered_set<size_t> generation_hashes;
   for (size_t i = 0; i < evolution.size(); ++i) {
-    evolution_with_cost.Push(search_space_->GetScheduleMutate(evolution[i], cost_model_));
+    SearchState mutated = search_space_->GetScheduleMutate(evolution[i], cost_model_);
+    size_t hash         = mutated.StructuralHash();
+    if (visited_candidates_.count(hash) || !generation_hashes.insert(hash).second) {
+      continue;
+    }
+    evolution_with_cost.Push(std::move(mutated));
   }
+  unique_rates_.push_back(static_cast<float>(generation_hashes.size()) / evolution.size());
+  VLOG(3) << "Unique candidate rate of generation " << unique_rates_.size() << " of task "
+          << tune_task_.serialized_key << ": " << unique_rates_.back();
 
   return evolution_with_cost.ReturnAsContainer<std::vector<SearchState>>();
 }
@@ -131,15 +300,30 @@ std::vector<SearchState> EvolutionarySearch::PickNextGenerationEpsGreedy(const s
   int num_bests = num - num_rands;
 
   std::vector<SearchState> result;
+  std::unordered_set<size_t> picked_hashes;
+  for (const SearchState& state : picked_bests) {
+    picked_hashes.insert(state.StructuralHash());
+  }
+  // skip the random ones which are picked or visited
+  auto next_random = [&](int idx) {
+    while (idx < random_init.size()) {
+      size_t hash = random_init[idx].StructuralHash();
+      if (!visited_candidates_.count(hash) && picked_hashes.insert(hash).second) {
+        break;
+      }
+      ++idx;
+    }
+    return idx;
+  };
   int best_idx = 0;
-  int rand_idx = 0;
+  int rand_idx = next_random(0);
   for (int i = 0; i < num; ++i) {
     if (i < num_bests && best_idx < picked_bests.size()) {
       result.push_back(picked_bests[best_idx]);
       ++best_idx;
     } else if (rand_idx < random_init.size()) {
       result.push_back(random_init[rand_idx]);
-      ++rand_idx;
+      rand_idx = next_random(rand_idx + 1);
     } else if (best_idx < picked_bests.size()) {
       result.push_back(picked_bests[best_idx]);
       ++best_idx;
@@ -15,9 +15,13 @@
 #pragma once
 
 #include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "cinn/auto_schedule/cost_model/expr_cost_model.h"
+#include "cinn/auto_schedule/database/database.h"
 #include "cinn/auto_schedule/search_space/search_space.h"
 #include "cinn/auto_schedule/search_space/search_state.h"
 #include "cinn/auto_schedule/task/tune_task.h"
@@ -37,8 +41,10 @@ class EvolutionarySearch {
    *
    * @param tune_task: the TuneTask this class works on. This class doesn't
    *     take ownership of the pointer.
+   * @param database: the database to pick the best recorded candidates of
+   *     the task as initial population, not owned and can be nullptr.
    */
-  EvolutionarySearch(const TuneTask& tune_task, const ExprCostModel& cost_model);
+  EvolutionarySearch(const TuneTask& tune_task, const ExprCostModel& cost_model, Database* database = nullptr);
 
   /**
    * Destructor
@@ -72,6 +78,13 @@ class EvolutionarySearch {
    */
   std::vector<SearchState> SearchModuleExprEpsGreedy(const TuningOptions& options);
 
+  /**
+   * The rate of unique candidates of each generation evolved so far. A
+   * candidate is not unique if it is the same as another one in the
+   * generation, one returned by previous searches or one in the database.
+   */
+  const std::vector<float>& GetUniqueRates() const { return unique_rates_; }
+
 #ifdef CINN_WITH_TEST
   /**
    * Method only be called during testing. It is used to set mock search
@@ -88,8 +101,20 @@ class EvolutionarySearch {
 
   std::vector<SearchState> RandomInitSketch(int num);
 
+  // Mark the candidates recorded in the database as visited
+  void VisitDatabaseRecords();
+
   SearchState CrossOver(const SearchState& state1, const SearchState& state2);
 
+  // Cross over on the traces of the parents, the steps applied on a group of
+  // schedule blocks are taken from one parent. Returns false if the traces
+  // can't be crossed over or the result can't be replayed.
+  bool TraceCrossOver(const SearchState& father, const SearchState& mother, SearchState* child);
+
+  // Group the schedule blocks of the task, blocks under the same outermost
+  // loop share loops so they are in the same group
+  void InitBlockGroups();
+
   std::vector<SearchState> Evolve(const std::vector<SearchState>& population, int cross_over_num, int ret_num);
 
   std::vector<SearchState> PickNextGenerationEpsGreedy(const std::vector<SearchState>& population,
@@ -102,6 +127,19 @@ class EvolutionarySearch {
   const TuneTask& tune_task_;
 
   const ExprCostModel& cost_model_;  // not owned
+
+  Database* database_;  // not owned
+
+  bool database_visited_ = false;
+
+  // structural hashes of the candidates returned or in the database
+  std::unordered_set<size_t> visited_candidates_;
+
+  std::vector<float> unique_rates_;
+
+  // map the name of a schedule block to its group
+  std::unordered_map<std::string, int> block_group_ids_;
+  int num_block_groups_ = 0;
 };
 
 }  // namespace auto_schedule
@@ -17,6 +17,7 @@
 #include <gtest/gtest.h>
 
 #include <memory>
+#include <unordered_set>
 #include <utility>
 
 #include "cinn/auto_schedule/cost_model/expr_cost_model.h"
@@ -109,5 +110,34 @@ TEST(EvolutionarySearch, GetEpsGreedy) {
   }
 }
 
+TEST(EvolutionarySearch, Deduplicate) {
+  TuneTask mock_tune_task;
+  ExprCostModel cost_model;
+  TuningOptions options;
+  EvolutionarySearch evolutionary_search(mock_tune_task, cost_model);
+
+  MockSearchSpace* mock_search_space = new MockSearchSpace(mock_tune_task);
+  // Ownership is transferred so don't delete mock_search_space
+  evolutionary_search.SetSearchSpace(mock_search_space);
+
+  std::unordered_set<size_t> returned_hashes;
+  for (int round = 0; round < 2; ++round) {
+    std::vector<SearchState> search_states = evolutionary_search.SearchModuleExprEpsGreedy(options);
+    EXPECT_GE(search_states.size(), 1UL);
+    // the candidates are different from each other and from those returned in previous rounds
+    for (const SearchState& state : search_states) {
+      EXPECT_TRUE(returned_hashes.insert(state.StructuralHash()).second);
+    }
+  }
+
+  const std::vector<float>& unique_rates = evolutionary_search.GetUniqueRates();
+  ASSERT_EQ(unique_rates.size(), 2UL);
+  EXPECT_GT(unique_rates[0], 0.0f);
+  EXPECT_LE(unique_rates[0], 1.0f);
+  // the initial sketches are the same in both rounds, so those returned in
+  // the first round are not unique in the second round
+  EXPECT_LT(unique_rates[1], unique_rates[0]);
+}
+
 }  // namespace auto_schedule
 }  // namespace cinn
@@ -35,12 +35,7 @@ std::vector<TuneTask> TaskCreator::CreateTuneTaskOpLevel(hlir::framework::Graph*
 
   // The input graph has run Op Fusion
   if (!groups.empty()) {
-    for (const std::vector<Node*>& sub_graph : groups) {
-      ret_tasks.emplace_back(TuneTask());
-      ret_tasks.back().task_graph.push_back(sub_graph);
-      ret_tasks.back().target = graph->target_;
-    }
-    return ret_tasks;
+    return CreateTuneTaskOpLevel(groups, graph->target_);
   }
 
   // The input graph hasn't run Op Fusion
@@ -59,5 +54,16 @@ std::vector<TuneTask> TaskCreator::CreateTuneTaskOpLevel(hlir::framework::Graph*
   return ret_tasks;
 }
 
+std::vector<TuneTask> TaskCreator::CreateTuneTaskOpLevel(const std::vector<std::vector<Node*>>& groups,
+                                                         const common::Target& target) {
+  std::vector<TuneTask> ret_tasks;
+  for (const std::vector<Node*>& sub_graph : groups) {
+    ret_tasks.emplace_back(TuneTask());
+    ret_tasks.back().task_graph.push_back(sub_graph);
+    ret_tasks.back().target = target;
+  }
+  return ret_tasks;
+}
+
 }  // namespace auto_schedule
 }  // namespace cinn
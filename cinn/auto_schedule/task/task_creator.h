@@ -30,6 +30,10 @@ namespace auto_schedule {
 class TaskCreator {
  public:
   std::vector<TuneTask> CreateTuneTaskOpLevel(hlir::framework::Graph* graph);
+
+  // Create a task for each group, such as the groups got by graph tuning
+  std::vector<TuneTask> CreateTuneTaskOpLevel(const std::vector<std::vector<hlir::framework::Node*>>& groups,
+                                              const common::Target& target);
 };
 
 }  // namespace auto_schedule
@@ -17,8 +17,13 @@
 #include <glog/logging.h>
 
 #include <limits>
+#include <string>
+#include <utility>
+#include <vector>
 
+#include "cinn/auto_schedule/analysis/analyze_ir.h"
 #include "cinn/auto_schedule/cost_model/expr_cost_model.h"
+#include "cinn/auto_schedule/cost_model/feature.h"
 #include "cinn/auto_schedule/measure/measure.h"
 #include "cinn/auto_schedule/search_strategy/evolutionary_search.h"
 #include "cinn/ir/ir_schedule.h"
@@ -30,8 +35,16 @@ DECLARE_bool(auto_schedule_use_cost_model);
 namespace cinn {
 namespace auto_schedule {
 
-TaskOptimizer::TaskOptimizer(const TuneTask& task, ScheduleMeasurer* schedule_measurer)
-    : task_(&task), schedule_measurer_(schedule_measurer), cost_model_() {}
+TaskOptimizer::TaskOptimizer(const TuneTask& task,
+                             ScheduleMeasurer* schedule_measurer,
+                             Database* database,
+                             FeatureStore* feature_store)
+    : task_(&task),
+      schedule_measurer_(schedule_measurer),
+      database_(database),
+      feature_store_(feature_store),
+      cost_model_(),
+      best_cost_(std::numeric_limits<double>::max()) {}
 
 TuningResult::OptimizedComputeExpr TaskOptimizer::Optimize(const TuningOptions& options) {
   // TODO(zhhsplendid): develop other optimize methods and configure the method by options.
@@ -52,7 +65,18 @@ TuningResult::OptimizedComputeExpr TaskOptimizer::OptimizeByEvolution(const Tuni
   if (evolutionary_search_ == nullptr) {
     // TODO(zhhsplendid): check whether the options is same as previous,
     // if not, we should create new EvolutionarySearch
-    evolutionary_search_ = std::make_unique<EvolutionarySearch>(*task_, cost_model_);
+    evolutionary_search_ = std::make_unique<EvolutionarySearch>(*task_, cost_model_, database_);
+
+    // pre-train before the first search, so the records of the related tasks tuned earlier are also used.
+    // It stays gated on the flag: without it the search never queries the cost model, and the features
+    // are still saved into feature_store_ for the runs enabling it
+    if (feature_store_ != nullptr && FLAGS_auto_schedule_use_cost_model) {
+      std::vector<std::vector<float>> samples;
+      std::vector<float> labels;
+      feature_store_->GetSamples(task_->workload_pattern, Feature::kFixedSize, &samples, &labels);
+      VLOG(3) << "Pre-train the cost model with " << samples.size() << " records of related tasks";
+      cost_model_.Pretrain(samples, labels);
+    }
   }
 
   if (options.num_measure_trials == 0) {
@@ -66,11 +90,13 @@ TuningResult::OptimizedComputeExpr TaskOptimizer::OptimizeByEvolution(const Tuni
 
     result.lowered_funcs.emplace_back(optim::IRCopy(task_->lowered_funcs));
 
+    best_trace_                      = states[0].trace;
     std::vector<ir::Expr> best_exprs = states[0].mod_expr.GetExprs();
     CHECK_EQ(best_exprs.size(), result.lowered_funcs[0].size())
         << "RuntimeError: Expr size is not equal to LoweredFunc size in TaskOptimizer";
     for (size_t i = 0; i < best_exprs.size(); ++i) {
       result.lowered_funcs[0][i]->body = best_exprs[i];
+      UpdateTempBuffers(result.lowered_funcs[0][i]);
       if (task_->target == common::DefaultNVGPUTarget()) {
         result.lowered_funcs[0][i]->PrepareCudaAxisInfoFromBody();
       }
@@ -78,10 +104,10 @@ TuningResult::OptimizedComputeExpr TaskOptimizer::OptimizeByEvolution(const Tuni
     return result;
   }
 
-  int measured_count   = 0;
-  double min_exec_time = std::numeric_limits<double>().max();
-  TuningResult::OptimizedComputeExpr result;
-  result.lowered_funcs.push_back(optim::IRCopy(task_->lowered_funcs));
+  int measured_count = 0;
+  if (best_result_.lowered_funcs.empty()) {
+    best_result_.lowered_funcs.push_back(optim::IRCopy(task_->lowered_funcs));
+  }
 
   while (measured_count < options.num_measure_trials) {
     std::vector<SearchState> states = evolutionary_search_->SearchModuleExprEpsGreedy(options);
@@ -98,6 +124,7 @@ TuningResult::OptimizedComputeExpr TaskOptimizer::OptimizeByEvolution(const Tuni
       measure_inputs[i].lowered_funcs.emplace_back(optim::IRCopy(task_->lowered_funcs));
       for (size_t j = 0; j < best_exprs.size(); ++j) {
         measure_inputs[i].lowered_funcs.front().at(j)->body = best_exprs[j];
+        UpdateTempBuffers(measure_inputs[i].lowered_funcs.front().at(j));
         if (task_->target == common::DefaultNVGPUTarget()) {
           measure_inputs[i].lowered_funcs.front().at(j)->PrepareCudaAxisInfoFromBody();
         }
@@ -112,23 +139,48 @@ TuningResult::OptimizedComputeExpr TaskOptimizer::OptimizeByEvolution(const Tuni
       cost_model_labels[i] = measure_outputs[i].execution_cost;
     }
 
-    if (FLAGS_auto_schedule_use_cost_model) {
-      VLOG(6) << "cost_model_samples.size() = " << cost_model_samples.size();
-      VLOG(6) << "cost_model_labels.size() = " << cost_model_labels.size();
-      cost_model_.Update(cost_model_samples, cost_model_labels, task_->target);
+    if (FLAGS_auto_schedule_use_cost_model || feature_store_ != nullptr) {
+      std::vector<std::vector<float>> features = ExprCostModel::ExtractFeatures(cost_model_samples, task_->target);
+      if (FLAGS_auto_schedule_use_cost_model) {
+        VLOG(6) << "cost_model_samples.size() = " << cost_model_samples.size();
+        VLOG(6) << "cost_model_labels.size() = " << cost_model_labels.size();
+        cost_model_.Update(features, cost_model_labels);
+      }
+      if (feature_store_ != nullptr) {
+        for (size_t i = 0; i < states.size(); ++i) {
+          if (measure_outputs[i].error_msg.empty()) {
+            feature_store_->AddRecord(FeatureRecord(
+                task_->serialized_key, task_->workload_pattern, features[i], measure_outputs[i].execution_cost));
+          }
+        }
+      }
+    }
+    if (database_ != nullptr) {
+      std::vector<std::string> block_names = task_->GetBlockNames();
+      for (size_t i = 0; i < states.size(); ++i) {
+        if (!measure_outputs[i].error_msg.empty()) {
+          continue;
+        }
+        // the pattern and the block names let the related tasks warm start from the record
+        TuningRecord record(task_->serialized_key, measure_outputs[i].execution_cost, states[i]);
+        record.workload_pattern = task_->workload_pattern;
+        record.block_names      = block_names;
+        database_->AddRecord(std::move(record));
+      }
     }
-    // TODO(zhhsplendid): write measure record into cache.
 
     for (size_t i = 0; i < measure_outputs.size(); ++i) {
-      if (measure_outputs[i].execution_cost < min_exec_time) {
-        min_exec_time        = measure_outputs[i].execution_cost;
-        result.lowered_funcs = measure_inputs[i].lowered_funcs;
+      // the cost of a failed measurement is meaningless
+      if (measure_outputs[i].error_msg.empty() && measure_outputs[i].execution_cost < best_cost_) {
+        best_cost_                 = measure_outputs[i].execution_cost;
+        best_result_.lowered_funcs = measure_inputs[i].lowered_funcs;
+        best_trace_                = states[i].trace;
       }
     }
 
     measured_count += states.size();
   }
-  return result;
+  return best_result_;
 }
 
 }  // namespace auto_schedule
@@ -17,10 +17,13 @@
 #include <memory>
 
 #include "cinn/auto_schedule/cost_model/expr_cost_model.h"
+#include "cinn/auto_schedule/database/database.h"
+#include "cinn/auto_schedule/database/feature_store.h"
 #include "cinn/auto_schedule/measure/schedule_measurer.h"
 #include "cinn/auto_schedule/search_strategy/evolutionary_search.h"
 #include "cinn/auto_schedule/task/tune_task.h"
 #include "cinn/auto_schedule/tuning.h"
+#include "cinn/ir/schedule_trace.h"
 
 namespace cinn {
 namespace auto_schedule {
@@ -30,10 +33,23 @@ namespace auto_schedule {
 // optimal schedule for the task.
 class TaskOptimizer {
  public:
-  TaskOptimizer(const TuneTask& task, ScheduleMeasurer* schedule_measurer);
+  // the measured candidates are added into database and feature_store if they are not nullptr,
+  // and the cost model is pre-trained by the records of related tasks in feature_store before
+  // the first search
+  TaskOptimizer(const TuneTask& task,
+                ScheduleMeasurer* schedule_measurer,
+                Database* database          = nullptr,
+                FeatureStore* feature_store = nullptr);
 
   TuningResult::OptimizedComputeExpr Optimize(const TuningOptions& options);
 
+  // Returns the best execution cost measured so far, or the max double if nothing is measured
+  double BestCost() const { return best_cost_; }
+
+  // Returns the trace of the schedule returned by the last Optimize call, which
+  // is empty if the un-optimized LoweredFuncs are returned
+  const ir::ScheduleTrace& BestTrace() const { return best_trace_; }
+
  private:
   TuningResult::OptimizedComputeExpr OptimizeByEvolution(const TuningOptions& options);
 
@@ -41,9 +57,19 @@ class TaskOptimizer {
 
   ScheduleMeasurer* schedule_measurer_;
 
+  // not owned
+  Database* database_;
+  // not owned
+  FeatureStore* feature_store_;
+
   std::unique_ptr<EvolutionarySearch> evolutionary_search_ = nullptr;
 
   ExprCostModel cost_model_;
+
+  // the best result and its cost measured in all Optimize calls
+  double best_cost_;
+  TuningResult::OptimizedComputeExpr best_result_;
+  ir::ScheduleTrace best_trace_;
 };
 
 }  // namespace auto_schedule
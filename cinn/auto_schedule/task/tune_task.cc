@@ -17,6 +17,8 @@
 #include <glog/logging.h>
 
 #include <iostream>
+#include <map>
+#include <string>
 #include <vector>
 
 #include "cinn/auto_schedule/analysis/analyze_ir.h"
@@ -24,12 +26,30 @@
 #include "cinn/hlir/framework/node.h"
 #include "cinn/ir/ir_base.h"
 #include "cinn/ir/ir_schedule.h"
+#include "cinn/ir/ir_schedule_util.h"
 #include "cinn/ir/lowered_func.h"
 #include "cinn/utils/string.h"
 
 namespace cinn {
 namespace auto_schedule {
 
+namespace {
+
+// The attributes that change the cost of an op beyond its shapes, they are kept in the workload pattern
+const std::vector<std::string> kCostAffectingAttrs = {
+    "axes", "axis", "dilation", "dim", "groups", "kernel_size", "stride", "stride_size", "strides"};
+
+// Round an extent up to a power of two, so the extents of related workloads fall into the same bucket
+int BucketExtent(int extent) {
+  int bucket = 1;
+  while (bucket < extent) {
+    bucket <<= 1;
+  }
+  return bucket;
+}
+
+}  // namespace
+
 void TuneTask::SetGraphCompiler(hlir::framework::GraphCompiler* compiler) { graph_compiler_ = compiler; }
 
 std::vector<ir::Expr> TuneTask::GetLoweredFuncBodyExprs() const {
@@ -40,6 +60,16 @@ std::vector<ir::Expr> TuneTask::GetLoweredFuncBodyExprs() const {
   return result;
 }
 
+std::vector<std::string> TuneTask::GetBlockNames() const {
+  std::vector<std::string> names;
+  for (const ir::LoweredFunc& func : lowered_funcs) {
+    for (const ir::Expr& block : ir::FindBlocksVisitor()(&func->body)) {
+      names.push_back(ir::GetTensor(block)->name);
+    }
+  }
+  return names;
+}
+
 void TuneTask::SetLoweredFuncBodyExprs(const std::vector<ir::Expr>& exprs) {
   size_t exprs_size = exprs.size();
   CHECK_EQ(exprs_size, lowered_funcs.size())
@@ -67,7 +97,9 @@ const std::string& TuneTask::SerializeToString(
     const absl::flat_hash_map<std::string, hlir::framework::shape_t>& shape_dict,
     const absl::flat_hash_map<std::string, cinn::common::Type>& dtype_dict) {
   std::stringstream ss;
+  std::stringstream pattern_ss;
   ss << target << "\n\n";  // print target
+  pattern_ss << target << "\n\n";
 
   // local function to print dtype,shape of out/in variables of the specified node
   auto print_node_links_fn = [&](const std::vector<common::Shared<common::GraphEdge>>& links, bool is_input) {
@@ -82,28 +114,77 @@ const std::string& TuneTask::SerializeToString(
       CHECK(dit != dtype_dict.end()) << "can't find dtype of variable:" << var_node->id();
       if (printed_num > 0) {
         ss << ", ";
+        pattern_ss << ", ";
       }
       ++printed_num;
       ss << cinn::common::Type2Str(dit->second) << "[" + utils::Join(sit->second, ",") << "]";
+      // the extents are bucketed in the pattern
+      std::vector<std::string> buckets;
+      for (int extent : sit->second) {
+        buckets.push_back("<=" + std::to_string(BucketExtent(extent)));
+      }
+      pattern_ss << cinn::common::Type2Str(dit->second) << "[" << utils::Join(buckets, ",") << "]";
+    }
+  };
+
+  // local function to print the cost-affecting attributes of the specified node into the pattern
+  auto print_pattern_attrs_fn = [&](const hlir::framework::Node* node) {
+    std::map<std::string, std::string> attrs;
+    for (const std::string& name : kCostAffectingAttrs) {
+      auto it = node->attrs.attr_store.find(name);
+      if (it == node->attrs.attr_store.end()) {
+        continue;
+      }
+      if (absl::holds_alternative<int>(it->second)) {
+        attrs[name] = std::to_string(absl::get<int>(it->second));
+      } else if (absl::holds_alternative<std::vector<int>>(it->second)) {
+        attrs[name] = "[" + utils::Join(absl::get<std::vector<int>>(it->second), ",") + "]";
+      }
+    }
+    // the kernel size of a conv is the spatial extents of its weight, which are kept exactly
+    auto inlinks = node->inlinks_in_order();
+    if (node->op()->name.find("conv") != std::string::npos && inlinks.size() > 1) {
+      const auto* weight = inlinks[1]->source()->safe_as<hlir::framework::NodeData>();
+      auto sit           = weight ? shape_dict.find(weight->id()) : shape_dict.end();
+      if (sit != shape_dict.end() && sit->second.size() > 2) {
+        std::vector<int> kernel_size(sit->second.begin() + 2, sit->second.end());
+        attrs["kernel_size"] = "[" + utils::Join(kernel_size, ",") + "]";
+      }
+    }
+    if (attrs.empty()) {
+      return;
+    }
+    std::vector<std::string> attr_strs;
+    for (auto&& attr : attrs) {
+      attr_strs.push_back(attr.first + "=" + attr.second);
     }
+    pattern_ss << " {" << utils::Join(attr_strs, ", ") << "}";
   };
 
   // print each group of the task_graph
   for (auto p = 0; p < task_graph.size(); ++p) {
     const std::vector<hlir::framework::Node*>& group = task_graph.at(p);
     ss << "Group " << p << " {\n";
+    pattern_ss << "Group " << p << " {\n";
     for (auto i = 0; i < group.size(); ++i) {
       const hlir::framework::Node* node = group.at(i);
       ss << "  (";
+      pattern_ss << "  (";
       print_node_links_fn(node->outlinks_in_order(), false);
       ss << ") = " << node->op()->name << "(";
+      pattern_ss << ") = " << node->op()->name << "(";
       print_node_links_fn(node->inlinks_in_order(), true);
       ss << ")\n";
+      pattern_ss << ")";
+      print_pattern_attrs_fn(node);
+      pattern_ss << "\n";
     }
     ss << "}\n";
+    pattern_ss << "}\n";
   }
 
-  serialized_key = ss.str();
+  serialized_key   = ss.str();
+  workload_pattern = pattern_ss.str();
   return serialized_key;
 }
 
@@ -43,12 +43,16 @@ class TuneTask {
   void SetLoweredFuncsAndAnalyzeOutput(const std::vector<ir::LoweredFunc>& lowered_funcs);
   // Extract bodies in lowered_funcs() and return
   std::vector<ir::Expr> GetLoweredFuncBodyExprs() const;
+  // Return the names of the schedule blocks in lowered_funcs in order, which map the
+  // blocks of a task to those of another task lowered from the same computation
+  std::vector<std::string> GetBlockNames() const;
   // Set bodies in lowered_funcs() by exprs
   void SetLoweredFuncBodyExprs(const std::vector<ir::Expr>& exprs);
   // When you set GraphCompiler and task_graph, lower the task graph to
   // un-optimized LoweredFunc and store in lowered_funcs().
   void TaskGraphToUnoptLoweredFunc();
-  // Serialize this task as a string contains specific fields of it
+  // Serialize this task as a string contains specific fields of it,
+  // workload_pattern is also set
   const std::string& SerializeToString(const absl::flat_hash_map<std::string, hlir::framework::shape_t>& shape_dict,
                                        const absl::flat_hash_map<std::string, cinn::common::Type>& dtype_dict);
 
@@ -65,6 +69,14 @@ class TuneTask {
   // serialized string of this task, it contain struct,shape,dtype informat
   // and can be further used to hash
   std::string serialized_key;
+  // serialized_key with the extents of shapes rounded up to powers of two and
+  // the cost-affecting attributes of ops (axis, stride, kernel size and so on)
+  // added, tasks with the same pattern are related workloads, such as convs of
+  // close sizes with the same kernel and stride
+  std::string workload_pattern;
+  // the number of times this task occurs in the model, used to estimate
+  // its contribution to the end-to-end latency
+  int weight = 1;
 
  private:
   // Not owned
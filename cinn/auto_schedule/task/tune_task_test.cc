@@ -383,6 +383,23 @@ Group 0 {
   EXPECT_EQ(single_tasks[0].serialized_key, single_add_str);
   EXPECT_EQ(single_tasks[1].serialized_key, single_add_str);
 
+#ifdef CINN_WITH_CUDA
+  std::string single_add_pattern = R"ROC(Target<linux,nvgpu,64>
+
+Group 0 {
+  (float32[<=32,<=32]) = elementwise_add(float32[<=32,<=32], float32[<=32,<=32])
+}
+)ROC";
+#else
+  std::string single_add_pattern = R"ROC(Target<linux,x86,64>
+
+Group 0 {
+  (float32[<=32,<=32]) = elementwise_add(float32[<=32,<=32], float32[<=32,<=32])
+}
+)ROC";
+#endif
+  EXPECT_EQ(single_tasks[0].workload_pattern, single_add_pattern);
+
   ApplyPass(graph.get(), "OpFusion");
   std::vector<TuneTask> fused_tasks = task_creator.CreateTuneTaskOpLevel(graph.get());
   ASSERT_EQ(fused_tasks.size(), 1UL);
@@ -410,5 +427,36 @@ Group 0 {
   EXPECT_EQ(fused_tasks[0].serialized_key, fused_expected_str);
 }
 
+TEST(TuneTask, WorkloadPattern) {
+  Context::Global().ResetNameId();
+#ifdef CINN_WITH_CUDA
+  Target target = common::DefaultNVGPUTarget();
+#else
+  Target target                  = common::DefaultHostTarget();
+#endif
+  auto get_pattern_fn = [&](int m, const std::vector<int>& dim) {
+    NetBuilder builder("net_builder");
+    auto a     = builder.CreateInput(Float(32), {m, 24}, "A");
+    auto b     = builder.ReduceSum(a, dim);
+    auto graph = std::make_shared<hlir::framework::Graph>(builder.Build(), target);
+
+    TaskCreator task_creator;
+    std::vector<TuneTask> tasks = task_creator.CreateTuneTaskOpLevel(graph.get());
+    CHECK_EQ(tasks.size(), 1UL);
+    tasks[0].SerializeToString(
+        graph->GetAttrs<absl::flat_hash_map<std::string, hlir::framework::shape_t>>("infershape"),
+        graph->GetAttrs<absl::flat_hash_map<std::string, common::Type>>("inferdtype"));
+    return tasks[0].workload_pattern;
+  };
+
+  // the extents in the same bucket share a pattern
+  std::string pattern = get_pattern_fn(32, {1});
+  EXPECT_NE(pattern.find("(float32[<=32]) = reduce_sum(float32[<=32,<=32]) {dim=[1]}"), std::string::npos);
+  EXPECT_EQ(get_pattern_fn(30, {1}), pattern);
+  // but not the extents in different buckets or the reductions along different axes
+  EXPECT_NE(get_pattern_fn(64, {1}), pattern);
+  EXPECT_NE(get_pattern_fn(32, {0}), pattern);
+}
+
 }  // namespace auto_schedule
 }  // namespace cinn
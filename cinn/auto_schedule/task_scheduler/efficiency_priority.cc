@@ -14,20 +14,113 @@
 
 #include "cinn/auto_schedule/task_scheduler/efficiency_priority.h"
 
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <limits>
+
 namespace cinn {
 namespace auto_schedule {
 
+EfficiencyPriority::EfficiencyPriority(const std::vector<TuneTask>& tasks, const Config& config)
+    : TaskScheduler(tasks, config),
+      histories_(tasks.size()),
+      num_tunings_(tasks.size(), 0),
+      num_no_improvement_(tasks.size(), 0) {
+  CHECK_GE(config_.backward_weight, 0.0) << "backward_weight should be in [0, 1]";
+  CHECK_LE(config_.backward_weight, 1.0) << "backward_weight should be in [0, 1]";
+  CHECK_GT(config_.slope_window, 0) << "slope_window should be greater than 0";
+}
+
+void EfficiencyPriority::Reset() {
+  TaskScheduler::Reset();
+  predicted_latency_ = EstimatedLatency();
+}
+
 int EfficiencyPriority::NextTaskId() {
-  while (cur_task_id_ < tasks_->size()) {
-    if (IsTaskToTune(&tasks_->at(cur_task_id_))) {
-      return cur_task_id_++;
+  // select as many tasks as RoundRobin does in a round, cur_task_id_ counts the selected ones
+  if (cur_task_id_ >= tasks_->size()) {
+    return -1;
+  }
+
+  // tune the tasks never tuned first
+  int selected = -1;
+  for (int i = 0; i < tasks_->size(); ++i) {
+    if (IsTaskToTune(i) && num_tunings_[i] == 0) {
+      selected = i;
+      break;
     }
+  }
+  if (selected != -1) {
     ++cur_task_id_;
+    return selected;
   }
-  return -1;
+
+  double max_gain = 0.0;
+  for (int i = 0; i < tasks_->size(); ++i) {
+    if (!IsTaskToTune(i)) {
+      continue;
+    }
+    double gain = ExpectedGain(i);
+    if (selected == -1 || gain > max_gain) {
+      selected = i;
+      max_gain = gain;
+    }
+  }
+  if (selected == -1) {
+    VLOG(3) << "All tasks are stopped early";
+    return -1;
+  }
+  double latency = EstimatedLatency();
+  if (latency > 0 && max_gain / latency < config_.minimum_gain_threshold) {
+    VLOG(3) << "The max earnings ratio " << max_gain / latency << " is less than the threshold "
+            << config_.minimum_gain_threshold;
+    return -1;
+  }
+  VLOG(4) << "Select task " << selected << " with expected gain " << max_gain << "us";
+  predicted_latency_ -= max_gain;
+  ++cur_task_id_;
+  return selected;
 }
 
-bool EfficiencyPriority::IsTaskToTune(const TuneTask* task) { return config_.minimum_gain_threshold > 0.0; }
+void EfficiencyPriority::UpdateTaskResult(int task_id, double best_cost) {
+  double previous_cost = best_costs_.at(task_id);
+  TaskScheduler::UpdateTaskResult(task_id, best_cost);
+  ++num_tunings_[task_id];
+  if (best_costs_[task_id] == std::numeric_limits<double>::max()) {
+    // nothing is measured, the failed tuning counts as one without improvement
+    // and is kept out of the history
+    ++num_no_improvement_[task_id];
+    return;
+  }
+  if (best_costs_[task_id] < previous_cost) {
+    num_no_improvement_[task_id] = 0;
+  } else {
+    ++num_no_improvement_[task_id];
+  }
+  histories_[task_id].push_back(best_costs_[task_id]);
+}
+
+bool EfficiencyPriority::IsTaskToTune(int task_id) const {
+  return config_.early_stop_tunings <= 0 || num_no_improvement_[task_id] < config_.early_stop_tunings;
+}
+
+double EfficiencyPriority::ExpectedGain(int task_id) const {
+  const std::vector<double>& history = histories_[task_id];
+  int num_tunings                    = history.size();
+  // no gain is expected from a task failed in all tunings
+  if (num_tunings == 0) {
+    return 0.0;
+  }
+  double best_cost = history.back();
+  // the average decrease per tuning in the recent window
+  int window      = std::min(config_.slope_window, num_tunings - 1);
+  double backward = window > 0 ? (history[num_tunings - 1 - window] - best_cost) / window : 0.0;
+  // optimistically, the next tuning decreases the best cost by the
+  // average share of a tuning so far
+  double forward = best_cost / num_tunings;
+  return tasks_->at(task_id).weight * (config_.backward_weight * backward + (1 - config_.backward_weight) * forward);
+}
 
 }  // namespace auto_schedule
 }  // namespace cinn
@@ -15,6 +15,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "cinn/auto_schedule/task_scheduler/task_scheduler.h"
 
@@ -23,16 +24,45 @@ namespace auto_schedule {
 
 // Schedule tasks with efficiency_priority strategy, that
 // is picking a task with the maximum earnings ratio.
+//
+// Like the gradient-based task scheduler of Ansor, the gain of tuning a
+// task once more is estimated by its weight in the end-to-end latency and
+// the decrease of its best cost, which mixes the slope of the recent
+// tunings with an optimistic guess that it keeps improving at the average
+// speed. Each round selects as many tasks as RoundRobin does, and every
+// task is tuned once before its gain can be estimated, no gain is expected
+// from a task failed in all tunings. A task stops being tuned if it isn't
+// improved for Config::early_stop_tunings tunings, failed ones included, and a
+// round stops early if the best earnings ratio is less than
+// Config::minimum_gain_threshold.
 class EfficiencyPriority : public TaskScheduler {
  public:
-  EfficiencyPriority(const std::vector<TuneTask>& tasks, const Config& config) : TaskScheduler(tasks, config) {}
+  EfficiencyPriority(const std::vector<TuneTask>& tasks, const Config& config);
 
   const char* Name() const override { return "efficiency_priority"; };
 
+  void Reset() override;
+
   int NextTaskId() override;
 
+  void UpdateTaskResult(int task_id, double best_cost) override;
+
+  double PredictedLatency() const override { return predicted_latency_; }
+
  private:
-  bool IsTaskToTune(const TuneTask* task);
+  bool IsTaskToTune(int task_id) const;
+
+  // The expected decrease of the end-to-end latency by tuning the task once more
+  double ExpectedGain(int task_id) const;
+
+  // The best cost after each successful tuning of every task
+  std::vector<std::vector<double>> histories_;
+  // The number of tunings of every task, including the failed ones
+  std::vector<int> num_tunings_;
+  // The number of successive tunings without improvement of every task
+  std::vector<int> num_no_improvement_;
+  // The latency predicted at the end of this round
+  double predicted_latency_ = 0.0;
 };
 
 }  // namespace auto_schedule
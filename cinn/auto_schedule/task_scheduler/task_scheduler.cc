@@ -15,6 +15,7 @@
 #include "cinn/auto_schedule/task_scheduler/task_scheduler.h"
 
 #include <algorithm>
+#include <limits>
 
 #include "cinn/auto_schedule/task/tune_task.h"
 #include "cinn/auto_schedule/task_scheduler/efficiency_priority.h"
@@ -38,9 +39,25 @@ std::unique_ptr<TaskScheduler> TaskScheduler::Make(const std::vector<TuneTask>&
 }
 
 TaskScheduler::TaskScheduler(const std::vector<TuneTask>& tasks, const Config& config)
-    : tasks_(&tasks), config_(config), cur_task_id_(0) {}
+    : tasks_(&tasks), config_(config), cur_task_id_(0), best_costs_(tasks.size(), std::numeric_limits<double>::max()) {}
 
 void TaskScheduler::Reset() { cur_task_id_ = 0; }
 
+void TaskScheduler::UpdateTaskResult(int task_id, double best_cost) {
+  CHECK_GE(task_id, 0);
+  CHECK_LT(task_id, best_costs_.size());
+  best_costs_[task_id] = std::min(best_costs_[task_id], best_cost);
+}
+
+double TaskScheduler::EstimatedLatency() const {
+  double latency = 0.0;
+  for (size_t i = 0; i < best_costs_.size(); ++i) {
+    if (best_costs_[i] != std::numeric_limits<double>::max()) {
+      latency += tasks_->at(i).weight * best_costs_[i];
+    }
+  }
+  return latency;
+}
+
 }  // namespace auto_schedule
 }  // namespace cinn
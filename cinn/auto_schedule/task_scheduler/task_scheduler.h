@@ -34,6 +34,14 @@ class TaskScheduler {
   struct Config {
     // The minimum threshold of earnings ratio, used by EfficiencyPriority
     float minimum_gain_threshold = 0.0;
+    // The weight of the recent improvement slope against the optimistic
+    // estimation in predicting the gain of a task, used by EfficiencyPriority
+    float backward_weight = 0.2;
+    // The number of recent tunings to compute the improvement slope, used by EfficiencyPriority
+    int slope_window = 3;
+    // Stop tuning a task if it isn't improved in this number of successive
+    // tunings, 0 means never stop, used by EfficiencyPriority
+    int early_stop_tunings = 3;
   };
 
   // Create a TaskScheduler with the specific strategy name
@@ -43,7 +51,7 @@ class TaskScheduler {
                                              const std::string& strategy = "round_robin");
 
   // Reset associated states to schedule at the beginning
-  void Reset();
+  virtual void Reset();
 
   // Return the name of schedule strategy
   virtual const char* Name() const = 0;
@@ -51,6 +59,17 @@ class TaskScheduler {
   // Select a task to tune
   virtual int NextTaskId() = 0;
 
+  // Feed back the best execution cost of a task after it is tuned
+  virtual void UpdateTaskResult(int task_id, double best_cost);
+
+  // The end-to-end latency estimated by the best costs of the measured
+  // tasks weighted by their occurrences
+  double EstimatedLatency() const;
+
+  // The end-to-end latency predicted to achieve after the selected tasks
+  // of this round are tuned
+  virtual double PredictedLatency() const { return EstimatedLatency(); }
+
  protected:
   // A taskScheduler object should be created with the static function Make
   TaskScheduler(const std::vector<TuneTask>& tasks, const Config& config);
@@ -61,6 +80,8 @@ class TaskScheduler {
   int cur_task_id_;
   // The pointer refers to all tasks
   const std::vector<TuneTask>* tasks_;
+  // The best execution cost of each task, the max double if it is unknown
+  std::vector<double> best_costs_;
 };
 
 }  // namespace auto_schedule
@@ -16,6 +16,7 @@
 
 #include <gtest/gtest.h>
 
+#include <limits>
 #include <type_traits>
 
 #include "cinn/auto_schedule/task_scheduler/efficiency_priority.h"
@@ -47,8 +48,126 @@ TEST(RoundRobinScheduler, NextTaskId) {
 TEST(EfficiencyPriorityScheduler, NextTaskId) {
   std::vector<TuneTask> tasks(3);
   TaskScheduler::Config config;
-  config.minimum_gain_threshold = -1.0;
+  config.early_stop_tunings = 2;
+  auto efficiency_priority  = TaskScheduler::Make(tasks, config, "efficiency_priority");
+
+  // every task is tuned once at first
+  efficiency_priority->Reset();
+  for (int i = 0; i < 3; ++i) {
+    int task_id = efficiency_priority->NextTaskId();
+    ASSERT_EQ(i, task_id);
+    efficiency_priority->UpdateTaskResult(task_id, (i + 1) * 100.0);
+  }
+  ASSERT_EQ(-1, efficiency_priority->NextTaskId());
+  ASSERT_DOUBLE_EQ(600.0, efficiency_priority->EstimatedLatency());
+
+  // the task contributing the most latency is selected
+  efficiency_priority->Reset();
+  ASSERT_EQ(2, efficiency_priority->NextTaskId());
+  ASSERT_LT(efficiency_priority->PredictedLatency(), 600.0);
+  efficiency_priority->UpdateTaskResult(2, 300.0);
+  // task 2 isn't improved and its optimistic gain decreases
+  ASSERT_EQ(1, efficiency_priority->NextTaskId());
+  efficiency_priority->UpdateTaskResult(1, 200.0);
+  ASSERT_EQ(2, efficiency_priority->NextTaskId());
+  efficiency_priority->UpdateTaskResult(2, 300.0);
+  ASSERT_EQ(-1, efficiency_priority->NextTaskId());
+
+  // task 2 is stopped early since it isn't improved in 2 tunings
+  efficiency_priority->Reset();
+  ASSERT_EQ(0, efficiency_priority->NextTaskId());
+  efficiency_priority->UpdateTaskResult(0, 100.0);
+  ASSERT_EQ(1, efficiency_priority->NextTaskId());
+  efficiency_priority->UpdateTaskResult(1, 200.0);
+  ASSERT_EQ(0, efficiency_priority->NextTaskId());
+  efficiency_priority->UpdateTaskResult(0, 100.0);
+  ASSERT_EQ(-1, efficiency_priority->NextTaskId());
+
+  // all tasks are stopped early
+  efficiency_priority->Reset();
+  ASSERT_EQ(-1, efficiency_priority->NextTaskId());
+}
+
+TEST(EfficiencyPriorityScheduler, AlwaysFailedTask) {
+  std::vector<TuneTask> tasks(1);
+  TaskScheduler::Config config;
+  config.early_stop_tunings = 2;
+  auto efficiency_priority  = TaskScheduler::Make(tasks, config, "efficiency_priority");
+
+  // nothing is measured in the tunings, and the task is stopped early
+  for (int round = 0; round < 2; ++round) {
+    efficiency_priority->Reset();
+    ASSERT_EQ(0, efficiency_priority->NextTaskId());
+    efficiency_priority->UpdateTaskResult(0, std::numeric_limits<double>::max());
+  }
+  efficiency_priority->Reset();
+  ASSERT_EQ(-1, efficiency_priority->NextTaskId());
+}
+
+TEST(EfficiencyPriorityScheduler, FailedThenMeasuredTask) {
+  std::vector<TuneTask> tasks(2);
+  TaskScheduler::Config config;
+  config.early_stop_tunings = 2;
+  auto efficiency_priority  = TaskScheduler::Make(tasks, config, "efficiency_priority");
+
+  efficiency_priority->Reset();
+  ASSERT_EQ(0, efficiency_priority->NextTaskId());
+  efficiency_priority->UpdateTaskResult(0, std::numeric_limits<double>::max());
+  ASSERT_EQ(1, efficiency_priority->NextTaskId());
+  efficiency_priority->UpdateTaskResult(1, 100.0);
+
+  // the failed task isn't selected first, the measured one is tuned until stopped early
+  efficiency_priority->Reset();
+  ASSERT_EQ(1, efficiency_priority->NextTaskId());
+  efficiency_priority->UpdateTaskResult(1, 100.0);
+  ASSERT_EQ(1, efficiency_priority->NextTaskId());
+  efficiency_priority->UpdateTaskResult(1, 100.0);
+
+  efficiency_priority->Reset();
+  ASSERT_EQ(0, efficiency_priority->NextTaskId());
+  efficiency_priority->UpdateTaskResult(0, 50.0);
+  ASSERT_DOUBLE_EQ(150.0, efficiency_priority->EstimatedLatency());
+
+  // the failed tuning is kept out of the history, so the gain is 0.8 * 50 / 1 = 40us
+  efficiency_priority->Reset();
+  ASSERT_EQ(0, efficiency_priority->NextTaskId());
+  ASSERT_DOUBLE_EQ(110.0, efficiency_priority->PredictedLatency());
+}
+
+TEST(EfficiencyPriorityScheduler, Weight) {
+  // the gains of the tasks measured 100us and 200us are 0.8 * 100 = 80us and 0.8 * 200 = 160us,
+  // the task 0 is picked only if it occurs 3 times in the model
+  for (int weight : {1, 3}) {
+    std::vector<TuneTask> tasks(2);
+    tasks[0].weight = weight;
+    TaskScheduler::Config config;
+    auto efficiency_priority = TaskScheduler::Make(tasks, config, "efficiency_priority");
+    efficiency_priority->Reset();
+    efficiency_priority->UpdateTaskResult(efficiency_priority->NextTaskId(), 100.0);
+    efficiency_priority->UpdateTaskResult(efficiency_priority->NextTaskId(), 200.0);
+    ASSERT_DOUBLE_EQ(weight * 100.0 + 200.0, efficiency_priority->EstimatedLatency());
+
+    efficiency_priority->Reset();
+    ASSERT_EQ(weight == 1 ? 1 : 0, efficiency_priority->NextTaskId());
+  }
+}
+
+TEST(EfficiencyPriorityScheduler, MinimumGainThreshold) {
+  std::vector<TuneTask> tasks(2);
+  tasks[1].weight = 4;
+  TaskScheduler::Config config;
+  config.minimum_gain_threshold = 0.5;
   auto efficiency_priority      = TaskScheduler::Make(tasks, config, "efficiency_priority");
+  efficiency_priority->Reset();
+  efficiency_priority->UpdateTaskResult(efficiency_priority->NextTaskId(), 100.0);
+  efficiency_priority->UpdateTaskResult(efficiency_priority->NextTaskId(), 100.0);
+  ASSERT_DOUBLE_EQ(500.0, efficiency_priority->EstimatedLatency());
+
+  // the gain of task 1 is 4 * 0.8 * 100 = 320us, which is more than half of the latency
+  efficiency_priority->Reset();
+  ASSERT_EQ(1, efficiency_priority->NextTaskId());
+  efficiency_priority->UpdateTaskResult(1, 50.0);
+  // the latency becomes 300us, and the max gain is 4 * (0.2 * 50 + 0.8 * 25) = 120us
   ASSERT_EQ(-1, efficiency_priority->NextTaskId());
 }
 
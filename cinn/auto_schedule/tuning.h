@@ -70,11 +70,25 @@ struct TuningOptions {
   //
   // It explores the cases evolutionary search won't predict precisely
   float evolution_eps_greedy = 0.1f;
+
+  //////////////////////////////////////
+  // Graph Tuning Related Options
+  //////////////////////////////////////
+
+  // The number of the most expensive fusion groups whose boundaries are
+  // revisited against measurements before tuning schedules, graph tuning
+  // is disabled if it is 0.
+  int graph_tuning_expensive_groups = 0;
+
+  // A new grouping replaces the original groups only if it reduces
+  // the measured latency by at least this fraction.
+  float graph_tuning_min_improvement = 0.02f;
 };
 
 // Result of the tuning process
 struct TuningResult {
-  // Result of graph tuning
+  // Result of graph tuning, the groups of a sub-graph are those of
+  // the corresponding task, which may be changed by graph tuning
   struct TunedSubGraph {
     std::vector<std::vector<hlir::framework::Node*>> groups;
   };
@@ -119,6 +119,15 @@ struct StackVec {
   T* external_data_{nullptr};
 };
 
+//! Reinterprets the bits of a scalar or a StackVec as another type of the same size.
+template <typename To, typename From>
+inline To cinn_bitcast(const From& v) {
+  static_assert(sizeof(To) == sizeof(From), "cinn_bitcast should keep the size");
+  To res;
+  memcpy(&res, &v, sizeof(To));
+  return res;
+}
+
 /**
  * The vector with external data.
  */
@@ -774,6 +774,33 @@ void CodeGenC::Visit(const ir::intrinsics::ArgsConstruct *op) {
 }
 
 void CodeGenC::Visit(const ir::intrinsics::BuiltinIntrin *op) {
+  // the memory hints inserted by the prefetch_and_nontemporal_store pass on x86
+  if (op->name == "prefetch") {
+    CHECK_EQ(op->args.size(), 1U);
+    os() << "__builtin_prefetch(&";
+    Print(op->args[0]);
+    os() << ")";
+    return;
+  } else if (op->name == "store_fence") {
+    os() << "__builtin_ia32_sfence()";
+    return;
+  }
+  // inserted by the polynomial math rules of LowerIntrin, reinterpreted by memcpy in cinn_bitcast
+  if (op->name == "bitcast") {
+    CHECK_EQ(op->args.size(), 1U);
+    CHECK_EQ(op->type().bits() * op->type().lanes(), op->args[0].type().bits() * op->args[0].type().lanes())
+        << "The bitcast builtin should keep the width of " << op->args[0].type() << ", but got " << op->type();
+    os() << "cinn_bitcast<";
+    if (op->type().lanes() > 1) {
+      os() << "StackVec<" << GetTypeRepr(op->type().ElementOf()) << ", " << op->type().lanes() << ">";
+    } else {
+      os() << GetTypeRepr(op->type());
+    }
+    os() << ">(";
+    Print(op->args[0]);
+    os() << ")";
+    return;
+  }
   os() << op->name << "(";
   if (!op->args.empty()) {
     for (int i = 0; i < op->args.size() - 1; i++) {
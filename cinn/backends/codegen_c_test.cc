@@ -90,8 +90,9 @@ void add1(void* _args, int32_t num_args)
   const float* B = ((const float*)(_B->memory));
   float* C = ((float*)(_C->memory));
   for (int32_t i = 0; i < 100; i += 1) {
+    int32_t offset_0 = (20 * i);
     for (int32_t j = 0; j < 20; j += 1) {
-      C[((20 * i) + j)] = (A[((20 * i) + j)] + B[((20 * i) + j)]);
+      C[(offset_0 + j)] = (A[(offset_0 + j)] + B[(offset_0 + j)]);
     };
   };
   cinn_buffer_free((void*)(0), _C);
@@ -189,9 +190,11 @@ void add1(void* _args, int32_t num_args)
   float* C = ((float*)(_C->memory));
   float* D = ((float*)(_D->memory));
   for (int32_t i_outer = 0; i_outer < 25; i_outer += 1) {
+    int32_t offset_1 = (80 * i_outer);
     for (int32_t i_inner = 0; i_inner < 4; i_inner += 1) {
+      int32_t offset_0 = (offset_1 + (20 * i_inner));
       for (int32_t j = 0; j < 20; j += 1) {
-        C[((20 * i_inner) + ((80 * i_outer) + j))] = (1 + fma(3, A[((20 * i_inner) + ((80 * i_outer) + j))], B[((20 * i_inner) + ((80 * i_outer) + j))]));
+        C[(offset_0 + j)] = (1 + fma(3, A[(offset_0 + j)], B[(offset_0 + j)]));
       };
     };
   };
@@ -200,10 +203,13 @@ void add1(void* _args, int32_t num_args)
   auto flambda = [=](int task_id, int num_task) -> int {
     int n_per_task = (((25 + num_task) - 1) / num_task);
     for (int32_t i_outer = (task_id * n_per_task); i_outer < 25 && i_outer < ((task_id + 1) * n_per_task); i_outer += 1) {
+      int32_t offset_4 = (80 * i_outer);
       for (int32_t i_inner = 0; i_inner < 4; i_inner += 1) {
+        int32_t offset_3 = (offset_4 + (20 * i_inner));
         for (int32_t j_outer = 0; j_outer < 2; j_outer += 1) {
+          int32_t offset_2 = (offset_3 + (16 * j_outer));
           for (int32_t j_inner = 0; j_inner < cinn_min(16, (20 + (-16 * j_outer))); j_inner += 1) {
-            D[((20 * i_inner) + ((80 * i_outer) + ((16 * j_outer) + j_inner)))] = fma(4, (C[((20 * i_inner) + ((80 * i_outer) + ((16 * j_outer) + j_inner)))] * A[((20 * i_inner) + ((80 * i_outer) + ((16 * j_outer) + j_inner)))]), (2 * C[((20 * i_inner) + ((80 * i_outer) + ((16 * j_outer) + j_inner)))]));
+            D[(offset_2 + j_inner)] = fma(4, (C[(offset_2 + j_inner)] * A[(offset_2 + j_inner)]), (2 * C[(offset_2 + j_inner)]));
           };
         };
       };
@@ -396,14 +402,24 @@ void matmul(void* _args, int32_t num_args)
   float* C__reduce_init = ((float*)(_C->memory));
   float* C_init = ((float*)(_C->memory));
   for (int32_t i_outer = 0; i_outer < 4; i_outer += 1) {
+    int32_t offset_9 = (16000 * i_outer);
+    int32_t offset_8 = (6400 * i_outer);
     for (int32_t j_outer = 0; j_outer < 16; j_outer += 1) {
+      int32_t offset_7 = (offset_9 + (32 * j_outer));
+      int32_t offset_6 = (32 * j_outer);
       for (int32_t i_inner = 0; i_inner < cinn_min(32, (100 + (-32 * i_outer))); i_inner += 1) {
+        int32_t offset_5 = (offset_7 + (500 * i_inner));
+        int32_t offset_3 = (offset_8 + (200 * i_inner));
         for (int32_t j_inner = 0; j_inner < cinn_min(32, (500 + (-32 * j_outer))); j_inner += 1) {
-          C__reduce_init[((500 * i_inner) + ((16000 * i_outer) + ((32 * j_outer) + j_inner)))] = 0;
-          C_init[((500 * i_inner) + ((16000 * i_outer) + ((32 * j_outer) + j_inner)))] = 0;
+          C__reduce_init[(offset_5 + j_inner)] = 0;
+          C_init[(offset_5 + j_inner)] = 0;
+          int32_t offset_4 = (offset_6 + j_inner);
+          int32_t offset_2 = (offset_5 + j_inner);
           for (int32_t k0_outer = 0; k0_outer < 50; k0_outer += 1) {
+            int32_t offset_0 = (offset_3 + (4 * k0_outer));
+            int32_t offset_1 = (offset_4 + (2000 * k0_outer));
             for (int32_t k0_inner = 0; k0_inner < 4; k0_inner += 1) {
-              C[((500 * i_inner) + ((16000 * i_outer) + ((32 * j_outer) + j_inner)))] = fma(A[((200 * i_inner) + ((6400 * i_outer) + ((4 * k0_outer) + k0_inner)))], B[((32 * j_outer) + ((500 * k0_inner) + ((2000 * k0_outer) + j_inner)))], C[((500 * i_inner) + ((16000 * i_outer) + ((32 * j_outer) + j_inner)))]);
+              C[offset_2] = fma(A[(offset_0 + k0_inner)], B[(offset_1 + (500 * k0_inner))], C[offset_2]);
             };
           };
         };
@@ -109,7 +109,7 @@ void CodeGenCX86::PrintVecInputArgument(const Expr *op) {
 }
 
 void CodeGenCX86::Visit(const ir::intrinsics::BuiltinIntrin *op) {
-  if (op->type().lanes() == 1) {
+  if (op->type().lanes() == 1 || op->name == "bitcast") {
     CodeGenC::Visit(op);
     return;
   }
@@ -73,5 +73,34 @@ TEST(CodeGenCX86, basic) {
   std::cout << "out:\n" << out;
 }
 
+TEST(CodeGenCX86, vectorized_exp) {
+  Context::info_rgt().Clear();
+
+  Target target;
+  target.arch = Target::Arch ::X86;
+  target.bits = Target::Bit ::k64;
+  target.os   = Target::OS ::Linux;
+
+  Placeholder<float> A("A", {Expr(100), Expr(64)});
+  ir::Tensor B = Compute(
+      {Expr(100), Expr(64)}, [&](Var i, Var j) { return lang::Exp(A(i, j)); }, "B");
+
+  auto stages = CreateStages({B});
+  stages[B]->Vectorize(1, 16);
+
+  auto func = Lower("vectorized_exp", stages, {A, B});
+
+  ir::Module::Builder builder("module1", target);
+  builder.AddFunction(func);
+
+  // the polynomial exp reinterprets the exponent bits as float by the bitcast builtin
+  CodeGenCX86 codegen(target, CodeGenCX86::Feature::AVX512);
+  codegen.SetInlineBuiltinCodes(false);
+  auto out = codegen.Compile(builder.Build(), CodeGenC::OutputKind::CImpl);
+  VLOG(3) << "out:\n" << out;
+  EXPECT_NE(out.find("cinn_bitcast<StackVec<float, 16>>("), std::string::npos);
+  EXPECT_EQ(out.find(" bitcast("), std::string::npos);
+}
+
 }  // namespace backends
 }  // namespace cinn
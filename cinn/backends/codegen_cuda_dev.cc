@@ -330,6 +330,38 @@ void CodeGenCUDA_Dev::Visit(const ir::Let *op) {
   }
 }
 
+void CodeGenCUDA_Dev::Visit(const ir::intrinsics::BuiltinIntrin *op) {
+  if (op->name != "bitcast") {
+    CodeGenC::Visit(op);
+    return;
+  }
+  // reinterpret the bits of a scalar by the CUDA type casting intrinsics
+  CHECK_EQ(op->args.size(), 1U);
+  Type from = op->args[0].type();
+  Type to   = op->type();
+  CHECK(from.lanes() == 1 && to.lanes() == 1) << "The bitcast from " << from << " to " << to
+                                              << " is not supported in CUDA, only scalars can be reinterpreted";
+  std::string func;
+  if (from.is_float(32) && to.is_int(32)) {
+    func = "__float_as_int";
+  } else if (from.is_int(32) && to.is_float(32)) {
+    func = "__int_as_float";
+  } else if (from.is_float(32) && to.is_uint(32)) {
+    func = "__float_as_uint";
+  } else if (from.is_uint(32) && to.is_float(32)) {
+    func = "__uint_as_float";
+  } else if (from.is_float(64) && to.is_int(64)) {
+    func = "__double_as_longlong";
+  } else if (from.is_int(64) && to.is_float(64)) {
+    func = "__longlong_as_double";
+  } else {
+    LOG(FATAL) << "The bitcast from " << from << " to " << to << " is not supported in CUDA";
+  }
+  os() << func << "(";
+  Print(op->args[0]);
+  os() << ")";
+}
+
 bool CodeGenCUDA_Dev::PrintBuiltinVectorAccess(const ir::LoadStoreAddrMnger *op, ir::Expr index_expr) {
   static constexpr char index2suffix[4] = {'x', 'y', 'z', 'w'};
 
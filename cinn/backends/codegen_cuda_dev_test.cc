@@ -31,6 +31,7 @@
 #include "cinn/common/cuda_test_helper.h"
 #include "cinn/common/ir_util.h"
 #include "cinn/common/test_helper.h"
+#include "cinn/ir/intrinsic_ops.h"
 #include "cinn/hlir/pe/nn.h"
 #include "cinn/hlir/pe/schedule.h"
 #include "cinn/ir/ir_printer.h"
@@ -97,6 +98,27 @@ TEST(CodeGenCUDA, basic) {
   std::cout << "test cout: " << compiled << std::endl;
 }
 
+TEST(CodeGenCUDA, bitcast) {
+  Expr N(200);
+
+  Target target = common::DefaultNVGPUTarget();
+
+  Placeholder<float> A("A", {N});
+  auto B = Compute(
+      {N}, [&](Var i) { return ir::intrinsics::BuiltinIntrin::Make("bitcast", {A(i)}, -1, 1, Int(32)); }, "B");
+
+  auto stages = CreateStages({B});
+  stages[B]->Bind(0, "threadIdx.x");
+
+  CodeGenCUDA_Dev codegen(target);
+  auto func        = Lower("bitcast", stages, {A, B});
+  auto source_code = codegen.Compile(func);
+  LOG(INFO) << "CUDA source:\n" << source_code;
+
+  // the bits are reinterpreted by the CUDA intrinsic
+  EXPECT_NE(source_code.find("__float_as_int(A["), std::string::npos);
+}
+
 TEST(CodeGenCUDA2, test_of_cacheread) {
   Context::Global().ResetNameId();
   Expr M(100);
@@ -18,6 +18,7 @@
 
 #include "cinn/backends/llvm/runtime_symbol_registry.h"
 #include "cinn/common/context.h"
+#include "cinn/utils/profiler.h"
 #ifdef CINN_WITH_CUDA
 #include "cinn/backends/codegen_cuda_dev.h"
 #include "cinn/backends/codegen_cuda_host.h"
@@ -80,8 +81,12 @@ void Compiler::CompileCudaModule(const Module& module, const std::string& code)
   VLOG(3) << "[CUDA] host module:\n" << host_module;
 
   VLOG(3) << "[CUDA] device module:\n" << device_module;
-  CodeGenCUDA_Dev codegen(target_);
-  auto source_code = codegen.Compile(device_module);
+  std::string source_code;
+  {
+    utils::RecordCompileEvent event("CodeGenCUDA_Dev", "codegen");
+    CodeGenCUDA_Dev codegen(target_);
+    source_code = codegen.Compile(device_module);
+  }
   if (!code.empty()) source_code = code;
   if (FLAGS_cinn_source_code_save_path.empty()) {
     if (source_code.size() > DebugLogMaxLen) {
@@ -103,7 +108,11 @@ void Compiler::CompileCudaModule(const Module& module, const std::string& code)
 
   backends::NVRTC_Compiler compiler;
 
-  auto ptx = compiler(source_code);
+  std::string ptx;
+  {
+    utils::RecordCompileEvent event("NVRTC_Compiler", "codegen");
+    ptx = compiler(source_code);
+  }
   CHECK(!ptx.empty());
 
   // TODO(Superjomn) Whether to support multiple CUDA modules?
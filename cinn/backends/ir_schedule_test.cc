@@ -24,8 +24,12 @@
 #include "cinn/backends/codegen_c_x86.h"
 #include "cinn/backends/codegen_cuda_dev.h"
 #include "cinn/cinn.h"
+#include "cinn/hlir/pe/ir_schedule_pe.h"
+#include "cinn/hlir/pe/nn.h"
+#include "cinn/ir/collect_ir_nodes.h"
 #include "cinn/ir/ir_printer.h"
 #include "cinn/lang/lower.h"
+#include "cinn/optim/ir_copy.h"
 #include "cinn/optim/ir_simplify.h"
 #include "cinn/optim/remove_schedule_block.h"
 #include "cinn/optim/unroll_loops.h"
@@ -85,8 +89,9 @@ void test_split_and_fuse1(void* _args, int32_t num_args)
   const float* A = ((const float*)(_A->memory));
   float* B = ((float*)(_B->memory));
   for (int32_t i_j_fused_0_i_j_fused_1_fused_0 = 0; i_j_fused_0_i_j_fused_1_fused_0 < 256; i_j_fused_0_i_j_fused_1_fused_0 += 1) {
+    int32_t offset_0 = (4 * i_j_fused_0_i_j_fused_1_fused_0);
     for (int32_t i_j_fused_0_i_j_fused_1_fused_1 = 0; i_j_fused_0_i_j_fused_1_fused_1 < 4; i_j_fused_0_i_j_fused_1_fused_1 += 1) {
-      B[((4 * i_j_fused_0_i_j_fused_1_fused_0) + i_j_fused_0_i_j_fused_1_fused_1)] = A[((4 * i_j_fused_0_i_j_fused_1_fused_0) + i_j_fused_0_i_j_fused_1_fused_1)];
+      B[(offset_0 + i_j_fused_0_i_j_fused_1_fused_1)] = A[(offset_0 + i_j_fused_0_i_j_fused_1_fused_1)];
     };
   };
   cinn_buffer_free((void*)(0), _B);
@@ -144,9 +149,10 @@ void test_split_and_fuse2(void* _args, int32_t num_args)
   const float* A = ((const float*)(_A->memory));
   float* B = ((float*)(_B->memory));
   for (int32_t i_j_fused_0 = 0; i_j_fused_0 < 52; i_j_fused_0 += 1) {
+    int32_t offset_0 = (20 * i_j_fused_0);
     for (int32_t i_j_fused_1 = 0; i_j_fused_1 < 20; i_j_fused_1 += 1) {
       if ((((20 * i_j_fused_0) + i_j_fused_1) < 1024)) {
-        B[((20 * i_j_fused_0) + i_j_fused_1)] = A[((20 * i_j_fused_0) + i_j_fused_1)];
+        B[(offset_0 + i_j_fused_1)] = A[(offset_0 + i_j_fused_1)];
       };
     };
   };
@@ -207,10 +213,13 @@ void test_reorder1(void* _args, int32_t num_args)
   float* B = ((float*)(_B->memory));
   for (int32_t k = 0; k < 32; k += 1) {
     for (int32_t i_1 = 0; i_1 < 4; i_1 += 1) {
+      int32_t offset_2 = ((1024 * i_1) + k);
       for (int32_t j_0 = 0; j_0 < 16; j_0 += 1) {
+        int32_t offset_1 = (offset_2 + (64 * j_0));
         for (int32_t j_1 = 0; j_1 < 2; j_1 += 1) {
+          int32_t offset_0 = (offset_1 + (32 * j_1));
           for (int32_t i_0 = 0; i_0 < 8; i_0 += 1) {
-            B[((4096 * i_0) + ((1024 * i_1) + ((64 * j_0) + ((32 * j_1) + k))))] = A[((4096 * i_0) + ((1024 * i_1) + ((64 * j_0) + ((32 * j_1) + k))))];
+            B[(offset_0 + (4096 * i_0))] = A[(offset_0 + (4096 * i_0))];
           };
         };
       };
@@ -272,10 +281,13 @@ void test_reorder2(void* _args, int32_t num_args)
   float* B = ((float*)(_B->memory));
   for (int32_t k = 0; k < 32; k += 1) {
     for (int32_t j_0 = 0; j_0 < 16; j_0 += 1) {
+      int32_t offset_2 = ((64 * j_0) + k);
       for (int32_t j_1 = 0; j_1 < 2; j_1 += 1) {
+        int32_t offset_1 = (offset_2 + (32 * j_1));
         for (int32_t i_1 = 0; i_1 < 4; i_1 += 1) {
+          int32_t offset_0 = (offset_1 + (1024 * i_1));
           for (int32_t i_0 = 0; i_0 < 8; i_0 += 1) {
-            B[((4096 * i_0) + ((1024 * i_1) + ((64 * j_0) + ((32 * j_1) + k))))] = A[((4096 * i_0) + ((1024 * i_1) + ((64 * j_0) + ((32 * j_1) + k))))];
+            B[(offset_0 + (4096 * i_0))] = A[(offset_0 + (4096 * i_0))];
           };
         };
       };
@@ -338,13 +350,19 @@ void test_reorder3(void* _args, int32_t num_args)
   const float* A = ((const float*)(_A->memory));
   float* B = ((float*)(_B->memory));
   for (int32_t j_1 = 0; j_1 < 2; j_1 += 1) {
+    int32_t offset_3 = (32 * j_1);
     for (int32_t i_1 = 0; i_1 < 5; i_1 += 1) {
+      int32_t offset_2 = (offset_3 + (1024 * i_1));
       for (int32_t j_0 = 0; j_0 < 16; j_0 += 1) {
+        int32_t offset_1 = (offset_2 + (64 * j_0));
         for (int32_t i_0 = 0; i_0 < 7; i_0 += 1) {
           if ((((5 * i_0) + i_1) < 32)) {
+          {
+            int32_t offset_0 = (offset_1 + (5120 * i_0));
             for (int32_t k = 0; k < 32; k += 1) {
-              B[((5120 * i_0) + ((1024 * i_1) + ((64 * j_0) + ((32 * j_1) + k))))] = A[((5120 * i_0) + ((1024 * i_1) + ((64 * j_0) + ((32 * j_1) + k))))];
+              B[(offset_0 + k)] = A[(offset_0 + k)];
             };
+          }
           };
         };
       };
@@ -409,16 +427,24 @@ void test_reorder4(void* _args, int32_t num_args)
   const float* A = ((const float*)(_A->memory));
   float* B = ((float*)(_B->memory));
   for (int32_t i_0 = 0; i_0 < 4; i_0 += 1) {
+    int32_t offset_3 = (10240 * i_0);
     for (int32_t j_0 = 0; j_0 < 7; j_0 += 1) {
+      int32_t offset_2 = (offset_3 + (160 * j_0));
       for (int32_t i_1 = 0; i_1 < 10; i_1 += 1) {
         if ((((10 * i_0) + i_1) < 32)) {
+        {
+          int32_t offset_1 = (offset_2 + (1024 * i_1));
           for (int32_t j_1 = 0; j_1 < 5; j_1 += 1) {
             if ((((5 * j_0) + j_1) < 32)) {
+            {
+              int32_t offset_0 = (offset_1 + (32 * j_1));
               for (int32_t k = 0; k < 32; k += 1) {
-                B[((10240 * i_0) + ((1024 * i_1) + ((160 * j_0) + ((32 * j_1) + k))))] = A[((10240 * i_0) + ((1024 * i_1) + ((160 * j_0) + ((32 * j_1) + k))))];
+                B[(offset_0 + k)] = A[(offset_0 + k)];
               };
+            }
             };
           };
+        }
         };
       };
     };
@@ -480,8 +506,9 @@ void test_parallel(void* _args, int32_t num_args)
   auto flambda = [=](int task_id, int num_task) -> int {
     int n_per_task = (((32 + num_task) - 1) / num_task);
     for (int32_t i = (task_id * n_per_task); i < 32 && i < ((task_id + 1) * n_per_task); i += 1) {
+      int32_t offset_0 = (32 * i);
       for (int32_t j = 0; j < 32; j += 1) {
-        B[((32 * i) + j)] = A[((32 * i) + j)];
+        B[(offset_0 + j)] = A[(offset_0 + j)];
       };
     }
     return 0;
@@ -563,8 +590,9 @@ void test_vectorize(void* _args, int32_t num_args)
   const float* A = ((const float*)(_A->memory));
   float* B = ((float*)(_B->memory));
   for (int32_t i = 0; i < 32; i += 1) {
+    int32_t offset_0 = (32 * i);
     for (int32_t j = 0; j < 2; j += 1) {
-      B[StackVec<16,int32_t>::Ramp(((32 * i) + (16 * j)), 1, 16)] = StackedVec<float,16>::Load(A,((32 * i) + (16 * j)));
+      B[StackVec<16,int32_t>::Ramp((offset_0 + (16 * j)), 1, 16)] = StackedVec<float,16>::Load(A,(offset_0 + (16 * j)));
     };
   };
   cinn_buffer_free((void*)(0), _B);
@@ -747,12 +775,15 @@ void test_compute_at1(void* _args, int32_t num_args)
   float* B = ((float*)(_B->memory));
   float* C = ((float*)(_C->memory));
   for (int32_t i = 0; i < 32; i += 1) {
+    int32_t offset_2 = (1024 * i);
     for (int32_t j = 0; j < 32; j += 1) {
+      int32_t offset_0 = (offset_2 + (32 * j));
       for (int32_t ax0 = 0; ax0 < 32; ax0 += 1) {
-        B[((1024 * i) + ((32 * j) + ax0))] = A[((1024 * i) + ((32 * j) + ax0))];
+        B[(offset_0 + ax0)] = A[(offset_0 + ax0)];
       };
+      int32_t offset_1 = (offset_2 + (32 * j));
       for (int32_t k = 0; k < 32; k += 1) {
-        C[((1024 * i) + ((32 * j) + k))] = B[((1024 * i) + ((32 * j) + k))];
+        C[(offset_1 + k)] = B[(offset_1 + k)];
       };
     };
   };
@@ -818,13 +849,17 @@ void test_compute_at2(void* _args, int32_t num_args)
   float* B = ((float*)(_B->memory));
   float* C = ((float*)(_C->memory));
   for (int32_t i = 0; i < 32; i += 1) {
+    int32_t offset_1 = ((64 * i) + i);
     for (int32_t ax0 = 0; ax0 < 32; ax0 += 1) {
+      int32_t offset_0 = (offset_1 + (64 * ax0));
       for (int32_t ax1 = 0; ax1 < 32; ax1 += 1) {
-        B[((64 * ax0) + ((64 * i) + (ax1 + i)))] = A[((64 * ax0) + ((64 * i) + (ax1 + i)))];
+        B[(offset_0 + ax1)] = A[(offset_0 + ax1)];
       };
     };
+    int32_t offset_2 = (65 * i);
+    int32_t offset_3 = (32 * i);
     for (int32_t j = 0; j < 32; j += 1) {
-      C[((32 * i) + j)] = B[((65 * i) + (65 * j))];
+      C[(offset_3 + j)] = B[(offset_2 + (65 * j))];
     };
   };
   cinn_buffer_free((void*)(0), _B);
@@ -895,13 +930,16 @@ void test_compute_at3(void* _args, int32_t num_args)
   float* B = ((float*)(_B->memory));
   float* C = ((float*)(_C->memory));
   for (int32_t i_j_fused_0 = 0; i_j_fused_0 < 32; i_j_fused_0 += 1) {
+    int32_t offset_1 = (128 * i_j_fused_0);
     for (int32_t ax0 = 0; ax0 < 2; ax0 += 1) {
+      int32_t offset_0 = (offset_1 + (64 * ax0));
       for (int32_t ax1 = 0; ax1 < 64; ax1 += 1) {
-        B[((64 * ax0) + ((128 * i_j_fused_0) + ax1))] = A[((64 * ax0) + ((128 * i_j_fused_0) + ax1))];
+        B[(offset_0 + ax1)] = A[(offset_0 + ax1)];
       };
     };
+    int32_t offset_2 = (128 * i_j_fused_0);
     for (int32_t i_j_fused_1 = 0; i_j_fused_1 < 128; i_j_fused_1 += 1) {
-      C[((128 * i_j_fused_0) + i_j_fused_1)] = B[((128 * i_j_fused_0) + i_j_fused_1)];
+      C[(offset_2 + i_j_fused_1)] = B[(offset_2 + i_j_fused_1)];
     };
   };
   cinn_buffer_free((void*)(0), _B);
@@ -1192,23 +1230,29 @@ void test_cache_read1(void* _args, int32_t num_args)
   float* C = ((float*)(_C->memory));
   {
     for (int32_t ax0 = 0; ax0 < 32; ax0 += 1) {
+      int32_t offset_0 = (64 * ax0);
       for (int32_t ax1 = 0; ax1 < 32; ax1 += 1) {
-        A_local[((64 * ax0) + ax1)] = A[((64 * ax0) + ax1)];
+        A_local[(offset_0 + ax1)] = A[(offset_0 + ax1)];
       };
     };
     for (int32_t i = 0; i < 32; i += 1) {
+      int32_t offset_1 = (64 * i);
+      int32_t offset_2 = (32 * i);
       for (int32_t j = 0; j < 32; j += 1) {
-        B[((32 * i) + j)] = (2 * A_local[((64 * i) + j)]);
+        B[(offset_2 + j)] = (2 * A_local[(offset_1 + j)]);
       };
     };
     for (int32_t ax0 = 0; ax0 < 16; ax0 += 1) {
+      int32_t offset_3 = (32 * ax0);
       for (int32_t ax1 = 0; ax1 < 16; ax1 += 1) {
-        B_local[((32 * ax0) + ax1)] = B[((32 * ax0) + ax1)];
+        B_local[(offset_3 + ax1)] = B[(offset_3 + ax1)];
       };
     };
     for (int32_t i = 0; i < 16; i += 1) {
+      int32_t offset_4 = (32 * i);
+      int32_t offset_5 = (16 * i);
       for (int32_t j = 0; j < 16; j += 1) {
-        C[((16 * i) + j)] = (1 + B_local[((32 * i) + j)]);
+        C[(offset_5 + j)] = (1 + B_local[(offset_4 + j)]);
       };
     };
   };
@@ -1274,9 +1318,10 @@ void test_cache_read2(void* _args, int32_t num_args)
   const float* A = ((const float*)(_A->memory));
   float* B = ((float*)(_B->memory));
   for (int32_t i = 0; i < 64; i += 1) {
+    int32_t offset_0 = (32 * i);
     for (int32_t j = 0; j < 32; j += 1) {
-      A_local[((32 * i) + j)] = A[((32 * i) + j)];
-      B[((32 * i) + j)] = (2 * A_local[((32 * i) + j)]);
+      A_local[(offset_0 + j)] = A[(offset_0 + j)];
+      B[(offset_0 + j)] = (2 * A_local[(offset_0 + j)]);
     };
   };
   cinn_buffer_free((void*)(0), _B);
@@ -1344,23 +1389,27 @@ void test_cache_write1(void* _args, int32_t num_args)
   float* C = ((float*)(_C->memory));
   {
     for (int32_t i = 0; i < 64; i += 1) {
+      int32_t offset_0 = (32 * i);
       for (int32_t j = 0; j < 32; j += 1) {
-        B_local[((32 * i) + j)] = (2 * A[((32 * i) + j)]);
+        B_local[(offset_0 + j)] = (2 * A[(offset_0 + j)]);
       };
     };
     for (int32_t ax0 = 0; ax0 < 64; ax0 += 1) {
+      int32_t offset_1 = (32 * ax0);
       for (int32_t ax1 = 0; ax1 < 32; ax1 += 1) {
-        B[((32 * ax0) + ax1)] = B_local[((32 * ax0) + ax1)];
+        B[(offset_1 + ax1)] = B_local[(offset_1 + ax1)];
       };
     };
     for (int32_t i = 0; i < 64; i += 1) {
+      int32_t offset_2 = (32 * i);
       for (int32_t j = 0; j < 32; j += 1) {
-        C_local[((32 * i) + j)] = (1 + B[((32 * i) + j)]);
+        C_local[(offset_2 + j)] = (1 + B[(offset_2 + j)]);
       };
     };
     for (int32_t ax0 = 0; ax0 < 64; ax0 += 1) {
+      int32_t offset_3 = (32 * ax0);
       for (int32_t ax1 = 0; ax1 < 32; ax1 += 1) {
-        C[((32 * ax0) + ax1)] = C_local[((32 * ax0) + ax1)];
+        C[(offset_3 + ax1)] = C_local[(offset_3 + ax1)];
       };
     };
   };
@@ -1424,9 +1473,10 @@ void test_cache_write2(void* _args, int32_t num_args)
   const float* A = ((const float*)(_A->memory));
   float* B = ((float*)(_B->memory));
   for (int32_t ax0 = 0; ax0 < 64; ax0 += 1) {
+    int32_t offset_0 = (32 * ax0);
     for (int32_t ax1 = 0; ax1 < 32; ax1 += 1) {
-      B_local[((32 * ax0) + ax1)] = (2 * A[((32 * ax0) + ax1)]);
-      B[((32 * ax0) + ax1)] = B_local[((32 * ax0) + ax1)];
+      B_local[(offset_0 + ax1)] = (2 * A[(offset_0 + ax1)]);
+      B[(offset_0 + ax1)] = B_local[(offset_0 + ax1)];
     };
   };
   cinn_buffer_free((void*)(0), _B);
@@ -1437,6 +1487,83 @@ void test_cache_write2(void* _args, int32_t num_args)
 }
 
 #ifdef CINN_WITH_CUDA
+TEST(IrSchedule, cache_write_reduction) {
+  Context::Global().ResetNameId();
+  Expr M(32);
+  Expr N(16);
+  Expr K(64);
+
+  Target target = common::DefaultHostTarget();
+
+  Placeholder<float> A("A", {M, K});
+  Placeholder<float> B("B", {K, N});
+  Var k(K.as_int32(), "k0");
+  auto C = Compute(
+      {M, N}, [&](Var i, Var j) { return lang::ReduceSum(A(i, k) * B(k, j), {k}); }, "C");
+
+  auto stages = CreateStages({A, B, C});
+  auto func   = cinn::lang::LowerVec("test_cache_write_reduction", stages, {A, B, C}, {}, {}, nullptr, target, true);
+  CHECK_EQ(func.size(), 1U);
+
+  ir::IRSchedule ir_sch(ir::ModuleExpr({func[0]->body}));
+  ir_sch.CacheWrite(ir_sch.GetBlock("C"), 0, "local");
+  Expr body = ir_sch.GetModule().GetExprs().at(0);
+  VLOG(1) << "After CacheWrite, IR is : " << body;
+
+  auto count_fn = [&](const std::string& tensor_name, bool is_store) {
+    return ir::CollectIRNodes(body, [&](const Expr* x) {
+             if (is_store) {
+               return x->As<ir::Store>() && x->As<ir::Store>()->tensor.as_tensor()->name == tensor_name;
+             }
+             return x->As<ir::Load>() && x->As<ir::Load>()->tensor.as_tensor()->name == tensor_name;
+           })
+        .size();
+  };
+  // the reduction is initialized and accumulated on the cache, and C is only written back
+  EXPECT_EQ(count_fn("C_local__reduce_init", true), 1UL);
+  EXPECT_EQ(count_fn("C__reduce_init", true), 0UL);
+  EXPECT_EQ(count_fn("C_local", true), 1UL);
+  EXPECT_EQ(count_fn("C_local", false), 2UL);
+  EXPECT_EQ(count_fn("C", true), 1UL);
+  EXPECT_EQ(count_fn("C", false), 0UL);
+}
+
+TEST(IrSchedule, cache_write_cuda_conv) {
+  Context::Global().ResetNameId();
+  Target target = common::DefaultNVGPUTarget();
+
+  Placeholder<float> A("A", {Expr(1), Expr(16), Expr(14), Expr(14)});
+  Placeholder<float> W("W", {Expr(32), Expr(16), Expr(3), Expr(3)});
+  // the direct conv scheduled by IRCudaScheduleConv, which cache-writes the reduction to a local buffer
+  auto outs   = hlir::pe::Conv2d_NCHW(A, W, 1, 1, 1, 1, 1, 1, "conv", true);
+  auto stages = CreateStages({A, W, outs[1], outs[0]});
+  auto func =
+      cinn::lang::LowerVec("test_cache_write_cuda_conv", stages, {A, W, outs[0]}, {}, {}, nullptr, target, true);
+  CHECK_EQ(func.size(), 1U);
+
+  ir::IRSchedule ir_sch(ir::ModuleExpr({func[0]->body}));
+  hlir::pe::IRCudaScheduleConv(ir_sch, target);
+  Expr body = ir_sch.GetModule().GetExprs().at(0);
+  VLOG(1) << "After IRCudaScheduleConv, IR is : " << body;
+
+  auto count_fn = [&](const std::string& tensor_name, bool is_store) {
+    return ir::CollectIRNodes(body, [&](const Expr* x) {
+             if (is_store) {
+               return x->As<ir::Store>() && x->As<ir::Store>()->tensor.as_tensor()->name == tensor_name;
+             }
+             return x->As<ir::Load>() && x->As<ir::Load>()->tensor.as_tensor()->name == tensor_name;
+           })
+        .size();
+  };
+  // the conv is initialized and accumulated in the local buffer, and the output is only written back
+  EXPECT_EQ(count_fn("conv_local__reduce_init", true), 1UL);
+  EXPECT_EQ(count_fn("conv__reduce_init", true), 0UL);
+  EXPECT_EQ(count_fn("conv_local", true), 1UL);
+  EXPECT_EQ(count_fn("conv_local", false), 2UL);
+  EXPECT_EQ(count_fn("conv", true), 1UL);
+  EXPECT_EQ(count_fn("conv", false), 0UL);
+}
+
 TEST(IrSchedule, cache_read3) {
   Context::Global().ResetNameId();
   Expr M(64);
@@ -1827,10 +1954,13 @@ void test_rfactor(void* _args, int32_t num_args)
   float* rf_B__reduce_init = ((float*)(rf__B->memory));
   {
     for (int32_t rf_k0 = 0; rf_k0 < 16; rf_k0 += 1) {
+      int32_t offset_2 = (32 * rf_k0);
       for (int32_t i = 0; i < 32; i += 1) {
-        rf_B__reduce_init[((32 * rf_k0) + i)] = 0;
+        rf_B__reduce_init[(offset_2 + i)] = 0;
+        int32_t offset_0 = (offset_2 + i);
+        int32_t offset_1 = ((32 * i) + rf_k0);
         for (int32_t j0 = 0; j0 < 2; j0 += 1) {
-          rf_B[((32 * rf_k0) + i)] = (rf_B[((32 * rf_k0) + i)] + A[((32 * i) + ((16 * j0) + rf_k0))]);
+          rf_B[offset_0] = (rf_B[offset_0] + A[(offset_1 + (16 * j0))]);
         };
       };
     };
@@ -1957,17 +2087,22 @@ void test_rfactor(void* _args, int32_t num_args)
   float* rf_B__reduce_init = ((float*)(rf__B->memory));
   {
     for (int32_t i = 0; i < 32; i += 1) {
+      int32_t offset_2 = (2 * i);
+      int32_t offset_3 = (32 * i);
       for (int32_t rf_j0 = 0; rf_j0 < 2; rf_j0 += 1) {
-        rf_B__reduce_init[((2 * i) + rf_j0)] = 0;
+        rf_B__reduce_init[(offset_2 + rf_j0)] = 0;
+        int32_t offset_0 = (offset_2 + rf_j0);
+        int32_t offset_1 = (offset_3 + (16 * rf_j0));
         for (int32_t k0 = 0; k0 < 16; k0 += 1) {
-          rf_B[((2 * i) + rf_j0)] = (rf_B[((2 * i) + rf_j0)] + A[((32 * i) + ((16 * rf_j0) + k0))]);
+          rf_B[offset_0] = (rf_B[offset_0] + A[(offset_1 + k0)]);
         };
       };
     };
     for (int32_t i = 0; i < 32; i += 1) {
       B__reduce_init[i] = 0;
+      int32_t offset_4 = (2 * i);
       for (int32_t j0 = 0; j0 < 2; j0 += 1) {
-        B[i] = (B[i] + rf_B[((2 * i) + j0)]);
+        B[i] = (B[i] + rf_B[(offset_4 + j0)]);
       };
     };
   };
@@ -2088,18 +2223,24 @@ void test_rfactor(void* _args, int32_t num_args)
   float* rf_C__reduce_init = ((float*)(rf__C->memory));
   {
     for (int32_t rf_k0 = 0; rf_k0 < 16; rf_k0 += 1) {
+      int32_t offset_3 = (64 * rf_k0);
+      int32_t offset_2 = (2 * rf_k0);
       for (int32_t i = 0; i < 32; i += 1) {
+        int32_t offset_0 = (offset_3 + (2 * i));
+        int32_t offset_1 = ((16 * i) + rf_k0);
         for (int32_t j = 0; j < 2; j += 1) {
-          rf_C__reduce_init[((2 * i) + ((64 * rf_k0) + j))] = 0;
-          rf_C[((2 * i) + ((64 * rf_k0) + j))] = fma(A[((16 * i) + rf_k0)], B[((2 * rf_k0) + j)], rf_C[((2 * i) + ((64 * rf_k0) + j))]);
+          rf_C__reduce_init[(offset_0 + j)] = 0;
+          rf_C[(offset_0 + j)] = fma(A[offset_1], B[(offset_2 + j)], rf_C[(offset_0 + j)]);
         };
       };
     };
     for (int32_t i = 0; i < 32; i += 1) {
+      int32_t offset_5 = (2 * i);
       for (int32_t j = 0; j < 2; j += 1) {
-        C__reduce_init[((2 * i) + j)] = 0;
+        C__reduce_init[(offset_5 + j)] = 0;
+        int32_t offset_4 = (offset_5 + j);
         for (int32_t k0 = 0; k0 < 16; k0 += 1) {
-          C[((2 * i) + j)] = (C[((2 * i) + j)] + rf_C[((2 * i) + ((64 * k0) + j))]);
+          C[offset_4] = (C[offset_4] + rf_C[(offset_4 + (64 * k0))]);
         };
       };
     };
@@ -2163,9 +2304,13 @@ void test_compute_inline1(void* _args, int32_t num_args)
   float* B = ((float*)(_B->memory));
   float* C = ((float*)(_C->memory));
   for (int32_t i = 0; i < 32; i += 1) {
+    int32_t offset_2 = (32 * i);
+    int32_t offset_3 = (1024 * i);
     for (int32_t j = 0; j < 32; j += 1) {
+      int32_t offset_0 = (offset_2 + (1024 * j));
+      int32_t offset_1 = (offset_3 + (32 * j));
       for (int32_t k = 0; k < 32; k += 1) {
-        C[((1024 * i) + ((32 * j) + k))] = (2 * (1 + A[((32 * i) + ((1024 * j) + k))]));
+        C[(offset_1 + k)] = (2 * (1 + A[(offset_0 + k)]));
       };
     };
   };
@@ -2231,9 +2376,11 @@ void test_compute_inline2(void* _args, int32_t num_args)
   float* B = ((float*)(_B->memory));
   float* C = ((float*)(_C->memory));
   for (int32_t i = 0; i < 32; i += 1) {
+    int32_t offset_1 = (1024 * i);
     for (int32_t j = 0; j < 32; j += 1) {
+      int32_t offset_0 = (offset_1 + (32 * j));
       for (int32_t k = 0; k < 32; k += 1) {
-        C[((1024 * i) + ((32 * j) + k))] = (2 * (1 + A[((1024 * i) + ((32 * j) + k))]));
+        C[(offset_0 + k)] = (2 * (1 + A[(offset_0 + k)]));
       };
     };
   };
@@ -2445,22 +2592,34 @@ void test_copytransform1(void* _args, int32_t num_args)
   float* C = ((float*)(_C->memory));
   {
     for (int32_t i_0 = 0; i_0 < 4; i_0 += 1) {
+      int32_t offset_3 = (8192 * i_0);
       for (int32_t i_1 = 0; i_1 < 8; i_1 += 1) {
+        int32_t offset_2 = (offset_3 + (1024 * i_1));
         for (int32_t j_0 = 0; j_0 < 8; j_0 += 1) {
+          int32_t offset_1 = (offset_2 + (128 * j_0));
           for (int32_t j_1 = 0; j_1 < 4; j_1 += 1) {
+            int32_t offset_0 = (offset_1 + (32 * j_1));
             for (int32_t k = 0; k < 32; k += 1) {
-              B[((8192 * i_0) + ((1024 * i_1) + ((128 * j_0) + ((32 * j_1) + k))))] = (1 + A[((8192 * i_0) + ((1024 * i_1) + ((128 * j_0) + ((32 * j_1) + k))))]);
+              B[(offset_0 + k)] = (1 + A[(offset_0 + k)]);
             };
           };
         };
       };
     };
     for (int32_t i_0 = 0; i_0 < 4; i_0 += 1) {
+      int32_t offset_10 = (256 * i_0);
+      int32_t offset_11 = (8192 * i_0);
       for (int32_t i_1 = 0; i_1 < 8; i_1 += 1) {
+        int32_t offset_8 = (offset_10 + (32 * i_1));
+        int32_t offset_9 = (offset_11 + (1024 * i_1));
         for (int32_t j_0 = 0; j_0 < 8; j_0 += 1) {
+          int32_t offset_6 = (offset_8 + (4096 * j_0));
+          int32_t offset_7 = (offset_9 + (128 * j_0));
           for (int32_t j_1 = 0; j_1 < 4; j_1 += 1) {
+            int32_t offset_4 = (offset_6 + (1024 * j_1));
+            int32_t offset_5 = (offset_7 + (32 * j_1));
             for (int32_t k = 0; k < 32; k += 1) {
-              C[((8192 * i_0) + ((1024 * i_1) + ((128 * j_0) + ((32 * j_1) + k))))] = (2 * B[((256 * i_0) + ((32 * i_1) + ((4096 * j_0) + ((1024 * j_1) + k))))]);
+              C[(offset_5 + k)] = (2 * B[(offset_4 + k)]);
             };
           };
         };
@@ -2534,20 +2693,31 @@ void test_copytransform2(void* _args, int32_t num_args)
   float* C = ((float*)(_C->memory));
   {
     for (int32_t i_0 = 0; i_0 < 4; i_0 += 1) {
+      int32_t offset_2 = (65536 * i_0);
       for (int32_t i_1 = 0; i_1 < 8; i_1 += 1) {
+        int32_t offset_1 = (offset_2 + (8192 * i_1));
         for (int32_t j = 0; j < 64; j += 1) {
+          int32_t offset_0 = (offset_1 + (128 * j));
           for (int32_t k = 0; k < 128; k += 1) {
-            B[((65536 * i_0) + ((8192 * i_1) + ((128 * j) + k)))] = (1 + A[((65536 * i_0) + ((8192 * i_1) + ((128 * j) + k)))]);
+            B[(offset_0 + k)] = (1 + A[(offset_0 + k)]);
           };
         };
       };
     };
     for (int32_t i_0 = 0; i_0 < 4; i_0 += 1) {
+      int32_t offset_9 = (65536 * i_0);
+      int32_t offset_10 = (32768 * i_0);
       for (int32_t i_1 = 0; i_1 < 8; i_1 += 1) {
+        int32_t offset_7 = (offset_9 + (8192 * i_1));
+        int32_t offset_8 = (offset_10 + (4096 * i_1));
         for (int32_t j_0 = 0; j_0 < 8; j_0 += 1) {
+          int32_t offset_5 = (offset_7 + (512 * j_0));
+          int32_t offset_6 = (offset_8 + (512 * j_0));
           for (int32_t j_1 = 0; j_1 < 4; j_1 += 1) {
+            int32_t offset_3 = (offset_5 + (128 * j_1));
+            int32_t offset_4 = (offset_6 + (128 * j_1));
             for (int32_t k = 0; k < 128; k += 1) {
-              C[((32768 * i_0) + ((4096 * i_1) + ((512 * j_0) + ((128 * j_1) + k))))] = (2 * B[((65536 * i_0) + ((8192 * i_1) + ((512 * j_0) + ((128 * j_1) + k))))]);
+              C[(offset_4 + k)] = (2 * B[(offset_3 + k)]);
             };
           };
         };
@@ -2560,5 +2730,88 @@ void test_copytransform2(void* _args, int32_t num_args)
 )ROC";
   ASSERT_EQ(utils::Trim(target_code), utils::Trim(source_code));
 }
+
+TEST(IrSchedule, trace_replay) {
+  Expr M(32);
+  Expr N(64);
+
+  Target target = common::DefaultHostTarget();
+
+  Placeholder<float> A("A", {M, N});
+  auto B = Compute(
+      {M, N}, [&](Var i, Var j) { return A(i, j) + Expr(1.f); }, "B");
+  auto C = Compute(
+      {M, N}, [&](Var i, Var j) { return B(i, j) * Expr(2.f); }, "C");
+
+  auto stages = CreateStages({A, B, C});
+
+  auto lower = [&]() {
+    Context::Global().ResetNameId();
+    auto func = cinn::lang::LowerVec("test_trace_replay", stages, {A, C}, {}, {}, nullptr, target, true);
+    return ir::ModuleExpr({func[0]->body});
+  };
+
+  ir::IRSchedule ir_sch(lower());
+  ir_sch.ComputeInline(ir_sch.GetBlock("B"));
+  auto loops = ir_sch.GetLoops("C");
+  ir_sch.Split(loops[1], {-1, 8});
+  loops = ir_sch.GetLoops("C");
+  ir_sch.Reorder({loops[1], loops[0]});
+  loops = ir_sch.GetLoops("C");
+  ir_sch.Vectorize(loops[2], 8);
+  VLOG(3) << "After schedule, IR is : " << ir_sch.GetModule().GetExprs().at(0);
+
+  // the Split and Vectorize called by name or by loop are recorded only once
+  const auto& trace = ir_sch.GetTrace();
+  ASSERT_TRUE(trace.IsReplayable());
+  ASSERT_EQ(trace.GetSteps().size(), 4U);
+  EXPECT_EQ(trace.GetSteps()[0].type, "ComputeInline");
+  EXPECT_EQ(trace.GetSteps()[1].type, "Split");
+  EXPECT_EQ(trace.GetSteps()[1].inputs[0].block_name, "C");
+  EXPECT_EQ(trace.GetSteps()[1].inputs[0].loop_index, 1);
+  EXPECT_EQ(trace.GetSteps()[2].type, "Reorder");
+  EXPECT_EQ(trace.GetSteps()[3].type, "MutateForType");
+
+  ir::IRSchedule replayed_sch(lower());
+  ASSERT_TRUE(trace.Replay(&replayed_sch));
+  EXPECT_EQ(utils::GetStreamCnt(replayed_sch.GetModule().GetExprs().at(0)),
+            utils::GetStreamCnt(ir_sch.GetModule().GetExprs().at(0)));
+  EXPECT_EQ(replayed_sch.GetTrace().GetSteps().size(), trace.GetSteps().size());
+
+  // the trace can't be replayed on a module without block C
+  auto D = Compute(
+      {M, N}, [&](Var i, Var j) { return A(i, j) - Expr(1.f); }, "D");
+  auto other_stages = CreateStages({A, D});
+  auto other_func =
+      cinn::lang::LowerVec("test_trace_replay_other", other_stages, {A, D}, {}, {}, nullptr, target, true);
+  ir::IRSchedule other_sch(ir::ModuleExpr({other_func[0]->body}));
+  EXPECT_FALSE(trace.Replay(&other_sch));
+
+  // nor on a module where the name of block C is ambiguous
+  auto body = lower().GetExprs().at(0);
+  ir::IRSchedule ambiguous_sch(ir::ModuleExpr({body, optim::IRCopy(body)}));
+  EXPECT_FALSE(trace.Replay(&ambiguous_sch));
+
+  // but it can be replayed on the same computation with other names after renaming the blocks
+  auto E = Compute(
+      {M, N}, [&](Var i, Var j) { return A(i, j) + Expr(1.f); }, "E");
+  auto F = Compute(
+      {M, N}, [&](Var i, Var j) { return E(i, j) * Expr(2.f); }, "F");
+  auto renamed_stages = CreateStages({A, E, F});
+  auto renamed_func =
+      cinn::lang::LowerVec("test_trace_replay_renamed", renamed_stages, {A, F}, {}, {}, nullptr, target, true);
+  ir::IRSchedule renamed_sch(ir::ModuleExpr({renamed_func[0]->body}));
+  ir::ScheduleTrace renamed_trace = trace;
+  ASSERT_TRUE(renamed_trace.RenameBlocks({"B", "C"}, {"E", "F"}));
+  EXPECT_EQ(renamed_trace.GetSteps()[1].inputs[0].block_name, "F");
+  EXPECT_TRUE(renamed_trace.Replay(&renamed_sch));
+
+  // a split not fitting the extent of the loop stops replaying instead of failing the check of Split
+  ir::ScheduleTrace split_trace;
+  split_trace.Append({"Split", {{"C", 1}}, {{"factors", std::vector<int>({4, 8})}}});
+  ir::IRSchedule split_sch(lower());
+  EXPECT_FALSE(split_trace.Replay(&split_sch));
+}
+
 }  // namespace backends
 }  // namespace cinn
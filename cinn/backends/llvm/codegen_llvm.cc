@@ -20,6 +20,7 @@
 #include <llvm/IR/Instruction.h>
 #include <llvm/IR/Instructions.h>
 #include <llvm/IR/Intrinsics.h>
+#include <llvm/IR/IntrinsicsX86.h>
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/Metadata.h>
 #include <llvm/Support/TargetSelect.h>
@@ -96,6 +97,13 @@ int NextPowerOfTwo(int x) {
   return 0;
 }
 
+// Hint a store to write around the caches, which is lowered to MOVNT on x86 if the store is aligned.
+void SetNontemporal(llvm::StoreInst *inst) {
+  llvm::LLVMContext &ctx = inst->getContext();
+  llvm::Metadata *one    = llvm::ConstantAsMetadata::get(llvm::ConstantInt::get(llvm::Type::getInt32Ty(ctx), 1));
+  inst->setMetadata(llvm::LLVMContext::MD_nontemporal, llvm::MDNode::get(ctx, {one}));
+}
+
 }  // namespace
 
 CodeGenLLVM::CodeGenLLVM(llvm::Module *m,
@@ -825,6 +833,9 @@ llvm::Value *CodeGenLLVM::Visit(const ir::Store *op) {
     // llvm::MDNode *meta     = md_tbaa_alias_set;
     // store_inst->setMetadata("tbaa", md_builder_->createTBAAStructTagNode(meta, meta, 0));
     AddTbaaMetadata(store_inst, op->tensor.as_tensor()->name, op->index());
+    if (op->nontemporal) {
+      SetNontemporal(store_inst);
+    }
     return store_inst;
   } else {  // vector store
     Expr dense_strided_ramp = detail::StridedRampBase(op->index(), 1);
@@ -850,6 +861,9 @@ llvm::Value *CodeGenLLVM::Visit(const ir::Store *op) {
         llvm::StoreInst *inst =
             b_->CreateAlignedStore(CreateVecSlice(value, offset, lanes), b_->CreatePointerCast(ptr, vtype), alignment);
         AddTbaaMetadata(inst, op->tensor.as_tensor()->name, base);
+        if (op->nontemporal) {
+          SetNontemporal(inst);
+        }
         return inst;
       }
     }
@@ -865,6 +879,9 @@ llvm::Value *CodeGenLLVM::Visit(const ir::Store *op) {
       if (auto *store_tensor = op->tensor.as_tensor()) {
         AddTbaaMetadata(store_inst, store_tensor->name, op->index());
       }
+      if (op->nontemporal) {
+        SetNontemporal(store_inst);
+      }
     };
     Scalarize(op->index(), flambda);
     return ret;
@@ -1438,6 +1455,31 @@ llvm::Value *CodeGenLLVM::Visit(const ir::intrinsics::BuiltinIntrin *op) {
       CHECK_GE(op->args.size(), 1U);
       llvm::Value *v = Visit(&op->args[0]);
       return b_->CreateFCmpUNO(v, v);
+    } else if (func_name == "bitcast") {
+      CHECK_GE(op->args.size(), 1U);
+      return b_->CreateBitCast(Visit(&op->args[0]), CinnTypeToLLVMType(op->type(), m_, true));
+    } else if (func_name == "prefetch") {
+      // prefetch the element of a Load for reading into all levels of the caches
+      CHECK_EQ(op->args.size(), 1U);
+      auto *load = op->args[0].As<ir::Load>();
+      CHECK(load) << "The argument of prefetch should be a Load";
+      ir::Expr index = load->index();
+      CHECK_EQ(index.type().lanes(), 1) << "The prefetched address should be a scalar";
+      llvm::Value *buffer = Visit(&load->tensor);
+      auto *btype         = llvm::dyn_cast<llvm::PointerType>(buffer->getType());
+      CHECK(btype);
+      auto *ptype = CinnTypeToLLVMType(load->type().ElementOf(), m_)->getPointerTo(btype->getAddressSpace());
+      if (btype != ptype) {
+        buffer = b_->CreatePointerCast(buffer, ptype);
+      }
+      // the address may be out of the buffer in the last iterations, which is harmless to prefetch
+      llvm::Value *ptr   = b_->CreateGEP(buffer, Visit(&index));
+      ptr                = b_->CreatePointerCast(ptr, b_->getInt8PtrTy(btype->getAddressSpace()));
+      llvm::Function *fn = llvm::Intrinsic::getDeclaration(m_, llvm::Intrinsic::prefetch, {ptr->getType()});
+      return b_->CreateCall(fn, {ptr, b_->getInt32(0), b_->getInt32(3), b_->getInt32(1)});
+    } else if (func_name == "store_fence") {
+      // order the non-temporal stores before the following ones
+      return b_->CreateCall(llvm::Intrinsic::getDeclaration(m_, llvm::Intrinsic::x86_sse_sfence));
     }
   }
 
@@ -15,11 +15,31 @@
 #include "cinn/backends/llvm/codegen_x86.h"
 
 #include <gtest/gtest.h>
+#include <llvm/Analysis/AssumptionCache.h>
+#include <llvm/Analysis/LoopInfo.h>
+#include <llvm/Analysis/ScalarEvolution.h>
+#include <llvm/Analysis/ScalarEvolutionExpressions.h>
+#include <llvm/Analysis/TargetLibraryInfo.h>
+#include <llvm/AsmParser/Parser.h>
+#include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
+#include <llvm/IR/Dominators.h>
+#include <llvm/Support/SourceMgr.h>
+#include <llvm/Support/TargetSelect.h>
 
+#include <cmath>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "cinn/backends/llvm/cinn_runtime_llvm_ir.h"
+#include "cinn/backends/llvm/llvm_optimizer.h"
+#include "cinn/backends/llvm/llvm_util.h"
 #include "cinn/backends/llvm/simple_jit.h"
 #include "cinn/cinn.h"
 #include "cinn/common/test_helper.h"
 #include "cinn/runtime/cinn_runtime.h"
+#include "cinn/utils/string.h"
+#include "cinn/utils/timer.h"
 
 namespace cinn {
 namespace backends {
@@ -69,5 +89,224 @@ TEST(Vectorize, basic) {
   }
 }
 
+// The transcendental functions in vectorized loops are lowered to polynomials
+TEST(Vectorize, math) {
+  auto test_math = [](const std::string& name,
+                      const std::function<Expr(Expr)>& compute,
+                      const std::function<double(double)>& reference,
+                      float min,
+                      float max,
+                      double rtol,
+                      double atol) {
+    Expr M(1024);
+    Placeholder<float> A("A", {M});
+    auto B = Compute(
+        {M}, [&](Expr i) { return compute(A(i)); }, "B");
+    auto stages = CreateStages({B});
+    stages[B]->Vectorize(0, 8);
+    auto fn = Lower("fn_" + name, stages, {A, B});
+
+    Module::Builder builder("module_" + name, common::DefaultHostTarget());
+    builder.AddFunction(fn);
+    auto jit = SimpleJIT::Create();
+    jit->Link(builder.Build());
+    auto* fn_ptr = reinterpret_cast<lower_func_ptr_t>(jit->Lookup("fn_" + name));
+
+    auto* A_buf  = common::BufferBuilder(Float(32), {1024}).set_zero().set_align(64).Build();
+    auto* B_buf  = common::BufferBuilder(Float(32), {1024}).set_zero().set_align(64).Build();
+    auto* A_data = reinterpret_cast<float*>(A_buf->memory);
+    auto* B_data = reinterpret_cast<float*>(B_buf->memory);
+    for (int i = 0; i < 1024; i++) {
+      A_data[i] = min + (max - min) * i / 1023;
+    }
+    auto args = common::ArgsBuilder().Add(A_buf).Add(B_buf).Build();
+    fn_ptr(reinterpret_cast<void**>(args.data()), args.size());
+
+    for (int i = 0; i < 1024; i++) {
+      double expected = reference(A_data[i]);
+      ASSERT_NEAR(B_data[i], expected, atol + rtol * std::abs(expected)) << name << "(" << A_data[i] << ")";
+    }
+  };
+
+  test_math(
+      "exp", [](Expr x) { return lang::Exp(x); }, [](double x) { return std::exp(x); }, -87.f, 88.f, 2.4e-7, 0);
+  test_math(
+      "log", [](Expr x) { return lang::Log(x); }, [](double x) { return std::log(x); }, 1e-6f, 1e6f, 2.4e-7, 0);
+  test_math(
+      "tanh", [](Expr x) { return lang::Tanh(x); }, [](double x) { return std::tanh(x); }, -10.f, 10.f, 3e-7, 0);
+  test_math(
+      "sigmoid",
+      [](Expr x) { return lang::Sigmoid(x); },
+      [](double x) { return 1 / (1 + std::exp(-x)); },
+      -20.f,
+      20.f,
+      4e-7,
+      0);
+  test_math(
+      "erf", [](Expr x) { return lang::Erf(x); }, [](double x) { return std::erf(x); }, -5.f, 5.f, 0, 4e-7);
+}
+
+// Times GELU and softmax with the polynomials in vectorized loops against the scalar math calls, the timings
+// are logged rather than checked because they depend on the host
+TEST(Vectorize, math_benchmark) {
+  const int rows = 256, cols = 1024;
+  Expr R(rows);
+  Expr C(cols);
+
+  // JIT the function, run it once for warmup, and return the average time of the repeated runs in ms
+  auto time_fn = [](const ir::LoweredFunc& fn, std::vector<cinn_pod_value_t>* args) {
+    Module::Builder builder("module_" + fn->name, common::DefaultHostTarget());
+    builder.AddFunction(fn);
+    auto jit = SimpleJIT::Create();
+    jit->Link(builder.Build());
+    auto* fn_ptr = reinterpret_cast<lower_func_ptr_t>(jit->Lookup(fn->name));
+    CHECK(fn_ptr);
+
+    const int repeat = 10;
+    fn_ptr(reinterpret_cast<void**>(args->data()), args->size());
+    utils::Timer timer;
+    timer.Start();
+    for (int i = 0; i < repeat; ++i) {
+      fn_ptr(reinterpret_cast<void**>(args->data()), args->size());
+    }
+    return timer.Stop() / repeat;
+  };
+  auto new_buffer_fn = [](const std::vector<int>& shape) {
+    return common::BufferBuilder(Float(32), shape).set_zero().set_align(64).Build();
+  };
+  auto expect_near_fn = [](cinn_buffer_t* actual, cinn_buffer_t* expected, double tol) {
+    auto* actual_data   = reinterpret_cast<float*>(actual->memory);
+    auto* expected_data = reinterpret_cast<float*>(expected->memory);
+    for (int i = 0; i < expected->num_elements(); i++) {
+      ASSERT_NEAR(actual_data[i], expected_data[i], tol);
+    }
+  };
+
+  auto* X_buf  = common::BufferBuilder(Float(32), {rows, cols}).set_zero().set_align(64).Build();
+  auto* X_data = reinterpret_cast<float*>(X_buf->memory);
+  for (int i = 0; i < rows * cols; i++) {
+    X_data[i] = -8.f + 16.f * (i % cols) / cols;
+  }
+
+  // gelu(x) = 0.5 * x * (1 + erf(x / sqrt(2)))
+  auto lower_gelu_fn = [&](const std::string& name, bool vectorize) {
+    Placeholder<float> X("X", {R, C});
+    auto Y = Compute(
+        {R, C},
+        [&](Expr i, Expr j) {
+          return Expr(0.5f) * X(i, j) * (Expr(1.f) + lang::Erf(X(i, j) * Expr(0.70710678f)));
+        },
+        "Y");
+    auto stages = CreateStages({Y});
+    if (vectorize) {
+      stages[Y]->Vectorize(1, 8);
+    }
+    return Lower(name, stages, {X, Y});
+  };
+  std::vector<cinn_buffer_t*> gelu_outs = {new_buffer_fn({rows, cols}), new_buffer_fn({rows, cols})};
+  std::vector<double> gelu_times;
+  for (int v = 0; v < 2; ++v) {
+    auto args = common::ArgsBuilder().Add(X_buf).Add(gelu_outs[v]).Build();
+    gelu_times.push_back(time_fn(lower_gelu_fn("gelu_" + std::to_string(v), v), &args));
+  }
+  LOG(INFO) << "GELU " << rows << "x" << cols << ": scalar " << gelu_times[0] << " ms, vectorized " << gelu_times[1]
+            << " ms, speedup " << gelu_times[0] / gelu_times[1];
+  expect_near_fn(gelu_outs[1], gelu_outs[0], 1e-5);
+
+  // softmax along the rows, the exponents are computed in the vectorized loop
+  auto lower_softmax_fn = [&](const std::string& name, bool vectorize) {
+    Placeholder<float> X("X", {R, C});
+    Var k0(C.as_int32(), "k0");
+    Var k1(C.as_int32(), "k1");
+    auto Max = Compute(
+        {R}, [&](Expr i) { return lang::ReduceMax(X(i, k0), {k0}); }, "Max");
+    auto E = Compute(
+        {R, C}, [&](Expr i, Expr j) { return lang::Exp(X(i, j) - Max(i)); }, "E");
+    auto Sum = Compute(
+        {R}, [&](Expr i) { return lang::ReduceSum(E(i, k1), {k1}); }, "Sum");
+    auto Y = Compute(
+        {R, C}, [&](Expr i, Expr j) { return E(i, j) / Sum(i); }, "Y");
+    auto stages = CreateStages({Max, E, Sum, Y});
+    if (vectorize) {
+      stages[E]->Vectorize(1, 8);
+    }
+    return Lower(name, stages, {X, Max, E, Sum, Y});
+  };
+  std::vector<cinn_buffer_t*> softmax_outs = {new_buffer_fn({rows, cols}), new_buffer_fn({rows, cols})};
+  std::vector<double> softmax_times;
+  for (int v = 0; v < 2; ++v) {
+    auto args = common::ArgsBuilder()
+                    .Add(X_buf)
+                    .Add(new_buffer_fn({rows}))
+                    .Add(new_buffer_fn({rows, cols}))
+                    .Add(new_buffer_fn({rows}))
+                    .Add(softmax_outs[v])
+                    .Build();
+    softmax_times.push_back(time_fn(lower_softmax_fn("softmax_" + std::to_string(v), v), &args));
+  }
+  LOG(INFO) << "Softmax " << rows << "x" << cols << ": scalar " << softmax_times[0] << " ms, vectorized "
+            << softmax_times[1] << " ms, speedup " << softmax_times[0] / softmax_times[1];
+  expect_near_fn(softmax_outs[1], softmax_outs[0], 1e-6);
+}
+
+// LoopInvariantCodeMotion hoists the offsets out of the inner loops and leaves the multiplications of the loop
+// variables to LLVM: after the O3 pipeline of the execution engine every integer multiplication in a loop must be
+// invariant in the loop or an affine recurrence of it, which LoopStrengthReduce turns into an add in the backend
+TEST(LoopInvariantCodeMotion, strength_reduction) {
+  Expr M(30);
+  Expr N(20);
+  Expr K(7);
+  Placeholder<float> A("A", {M, N, K});
+  Placeholder<float> B("B", {M, N, K});
+  auto C = Compute(
+      {M, N, K}, [&](Expr i, Expr j, Expr k) { return A(i, j, k) + B(i, j, k); }, "C");
+  auto stages = CreateStages({C});
+  auto fn     = Lower("fn_licm", stages, {A, B, C});
+
+  Module::Builder builder("module_licm", common::DefaultHostTarget());
+  builder.AddFunction(fn);
+  auto module = builder.Build();
+  ASSERT_NE(utils::GetStreamCnt(module->functions[0]).find("offset_0"), std::string::npos);
+
+  llvm::InitializeNativeTarget();
+  llvm::InitializeNativeTargetAsmPrinter();
+  llvm::LLVMContext context;
+  llvm::SMDiagnostic error;
+  auto m = llvm::parseAssemblyString(AsStringRef(kRuntimeLlvmIr), error, context);
+  ASSERT_TRUE(m);
+  llvm::IRBuilder<> b(context);
+  CodeGenX86 codegen(m.get(), &b);
+  codegen.Compile(module);
+  auto machine = llvm::cantFail(llvm::cantFail(llvm::orc::JITTargetMachineBuilder::detectHost()).createTargetMachine());
+  LLVMModuleOptimizer optimize(machine.get(), 3, {});
+  optimize(m.get());
+
+  llvm::Function* f = m->getFunction("fn_licm");
+  ASSERT_TRUE(f);
+  llvm::DominatorTree dom_tree(*f);
+  llvm::LoopInfo loop_info(dom_tree);
+  llvm::TargetLibraryInfoImpl tli_impl(machine->getTargetTriple());
+  llvm::TargetLibraryInfo tli(tli_impl, f);
+  llvm::AssumptionCache assumption_cache(*f);
+  llvm::ScalarEvolution scev(*f, tli, assumption_cache, dom_tree, loop_info);
+  int num_muls = 0;
+  for (auto& bb : *f) {
+    llvm::Loop* loop = loop_info.getLoopFor(&bb);
+    if (!loop) continue;
+    for (auto& inst : bb) {
+      if (!inst.getType()->isIntegerTy() ||
+          (inst.getOpcode() != llvm::Instruction::Mul && inst.getOpcode() != llvm::Instruction::Shl)) {
+        continue;
+      }
+      ++num_muls;
+      const llvm::SCEV* expr = scev.getSCEV(&inst);
+      auto* rec              = llvm::dyn_cast<llvm::SCEVAddRecExpr>(expr);
+      EXPECT_TRUE(scev.isLoopInvariant(expr, loop) || (rec && rec->isAffine() && rec->getLoop() == loop))
+          << DumpToString(inst) << " is not reducible";
+    }
+  }
+  EXPECT_GT(num_muls, 0);
+}
+
 }  // namespace backends
 }  // namespace cinn
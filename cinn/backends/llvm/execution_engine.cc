@@ -63,6 +63,7 @@
 #include "cinn/backends/llvm/runtime_symbol_registry.h"
 #include "cinn/ir/ir_printer.h"
 #include "cinn/runtime/intrinsic.h"
+#include "cinn/utils/profiler.h"
 
 namespace cinn::backends {
 namespace {
@@ -161,25 +162,40 @@ void ExecutionEngine::Link(const ir::Module &module) {
   auto b          = std::make_unique<llvm::IRBuilder<>>(*ctx);
   auto ir_emitter = std::make_unique<CodeGenT>(m.get(), b.get());
   VLOG(3) << "ir_emitter->Compile(module) Begin";
-  ir_emitter->Compile(module);
+  {
+    utils::RecordCompileEvent event("CodeGenLLVM", "codegen");
+    ir_emitter->Compile(module);
+    if (event.enabled()) event.AddCounter("llvm_instructions", m->getInstructionCount());
+  }
   VLOG(3) << "ir_emitter->Compile(module) Succeed!";
   CHECK(!llvm::verifyModule(*m, &llvm::errs())) << "Invalid module found";
 
   auto machine =
       std::move(llvm::cantFail(llvm::cantFail(llvm::orc::JITTargetMachineBuilder::detectHost()).createTargetMachine()));
-  LLVMModuleOptimizer optimize(machine.get(), 3, {}, true);
-  optimize(m.get());
+  {
+    utils::RecordCompileEvent event("LLVMModuleOptimizer", "codegen");
+    LLVMModuleOptimizer optimize(machine.get(), 3, {}, true);
+    optimize(m.get());
+    if (event.enabled()) event.AddCounter("llvm_instructions", m->getInstructionCount());
+  }
   CHECK(!llvm::verifyModule(*m, &llvm::errs())) << "Invalid optimized module detected";
   for (auto &f : *m) {
     VLOG(5) << "function: " << DumpToString(f);
   }
 
-  llvm::raw_svector_ostream rawstream(buffer_);
-  llvm::legacy::PassManager pass_manager;
-  machine->addPassesToEmitFile(pass_manager, rawstream, nullptr, llvm::CGFT_ObjectFile);
-  pass_manager.run(*m);
+  {
+    utils::RecordCompileEvent event("EmitObjectFile", "codegen");
+    llvm::raw_svector_ostream rawstream(buffer_);
+    llvm::legacy::PassManager pass_manager;
+    machine->addPassesToEmitFile(pass_manager, rawstream, nullptr, llvm::CGFT_ObjectFile);
+    pass_manager.run(*m);
+    if (event.enabled()) event.AddCounter("object_bytes", buffer_.size());
+  }
 
-  CHECK(AddModule(std::move(m), std::move(ctx)));
+  {
+    utils::RecordCompileEvent event("ExecutionEngine::AddModule", "codegen");
+    CHECK(AddModule(std::move(m), std::move(ctx)));
+  }
 
   decltype(auto) es = jit_->getExecutionSession();
   if (false) {
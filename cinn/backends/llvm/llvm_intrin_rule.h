@@ -18,6 +18,7 @@
 #include <glog/logging.h>
 #include <llvm/IR/Intrinsics.h>
 
+#include <limits>
 #include <string>
 #include <utility>
 #include <vector>
@@ -45,13 +46,170 @@ inline void MakeFloatIntrinOp(lang::Args args, lang::RetValue *rv) {
   }
 }
 
+// The polynomial approximations of the transcendental functions for the
+// float32 vectors, which are emitted inline so that a vectorized loop doesn't
+// call the scalar libm functions lane by lane. The max errors measured on a
+// sweep of the float32 inputs are:
+//   exp: 1 ulp, log: 1 ulp, tanh: 1.5 ulp, sigmoid (1 / (1 + exp(-x))): 2.5 ulp,
+//   erf: 6 ulp for |x| >= 1e-20, and 4e-7 absolute error for all x.
+// The results less than FLT_MIN are flushed to zero, and the denormal inputs
+// of log are taken as FLT_MIN.
+namespace vectorized_math {
+
+inline bool IsFloat32Vector(const Expr &e) { return e.type().is_float(32) && e.type().lanes() > 1; }
+
+inline Expr Const(const Expr &e, double v) { return make_const(e.type(), v); }
+
+inline Expr IntConst(const Expr &e, int32_t v) { return make_const(Int(32, e.type().lanes()), v); }
+
+// Evaluates the polynomial of x with the coefficients from the highest order
+inline Expr Polynomial(const Expr &x, const std::vector<double> &coeffs) {
+  CHECK(!coeffs.empty());
+  Expr res = Const(x, coeffs[0]);
+  for (size_t i = 1; i < coeffs.size(); ++i) {
+    res = res * x + Const(x, coeffs[i]);
+  }
+  return res;
+}
+
+// Reinterprets the bits of a value as the type of the same width
+inline Expr BitCast(const Type &type, const Expr &e) {
+  return ir::intrinsics::BuiltinIntrin::Make("bitcast", {e}, -1, 1, type);
+}
+
+inline Expr BitwiseAnd(const Expr &a, int32_t b) {
+  return ir::intrinsics::BuiltinIntrin::Make("bitwise_and", {a, IntConst(a, b)}, -1, 2, a.type());
+}
+
+inline Expr BitwiseOr(const Expr &a, int32_t b) {
+  return ir::intrinsics::BuiltinIntrin::Make("bitwise_or", {a, IntConst(a, b)}, -1, 2, a.type());
+}
+
+inline Expr LeftShift(const Expr &a, int32_t b) {
+  return ir::intrinsics::BuiltinIntrin::Make("left_shift", {a, IntConst(a, b)}, -1, 2, a.type());
+}
+
+inline Expr RightShift(const Expr &a, int32_t b) {
+  return ir::intrinsics::BuiltinIntrin::Make("right_shift", {a, IntConst(a, b)}, -1, 2, a.type());
+}
+
+inline Expr Floor(const Expr &e) {
+  return ir::intrinsics::BuiltinIntrin::Make("floorf", {e}, ::llvm::Intrinsic::floor, 1, e.type());
+}
+
+inline Expr Fabs(const Expr &e) {
+  return ir::intrinsics::BuiltinIntrin::Make("fabsf", {e}, ::llvm::Intrinsic::fabs, 1, e.type());
+}
+
+inline Expr IsNan(const Expr &e) {
+  return ir::intrinsics::BuiltinIntrin::Make("isnan", {e}, -1, 1, Bool(e.type().lanes()));
+}
+
+inline Expr Clamp(const Expr &e, double lo, double hi) {
+  return ir::Max::Make(ir::Min::Make(e, Const(e, hi)), Const(e, lo));
+}
+
+// exp(x) = 2^n * exp(r), where n = round(x / ln2) and r = x - n * ln2 in [-ln2 / 2, ln2 / 2]
+inline Expr Exp(const Expr &arg) {
+  const double inf   = std::numeric_limits<float>::infinity();
+  const double x_max = 88.7228394;   // ln(FLT_MAX)
+  const double x_min = -87.3365479;  // ln(FLT_MIN)
+  Expr x             = Clamp(arg, x_min, x_max);
+  Expr n             = Floor(x * Const(x, 1.44269504088896341) + Const(x, 0.5));
+  // ln2 is split into two parts to reduce the rounding error of r
+  Expr r = x - n * Const(x, 0.693359375);
+  r      = r + n * Const(x, 2.12194440e-4);
+  Expr p = Polynomial(
+      r, {1.9875691500e-4, 1.3981999507e-3, 8.3334519073e-3, 4.1665795894e-2, 1.6666665459e-1, 5.0000001201e-1});
+  Expr y = p * (r * r) + r + Const(x, 1.0);
+  // 2^n is made from the exponent bits, and n is 128 at most, which is
+  // multiplied as 2^127 * 2
+  Expr n_low   = ir::Min::Make(n, Const(x, 127.0));
+  Expr exp2_n  = BitCast(x.type(), LeftShift(ir::Cast::Make(Int(32, x.type().lanes()), n_low) + IntConst(x, 127), 23));
+  y            = y * exp2_n * (n - n_low + Const(x, 1.0));
+  y            = ir::Select::Make(arg > Const(x, x_max), Const(x, inf), y);
+  y            = ir::Select::Make(arg < Const(x, x_min), Const(x, 0.0), y);
+  return ir::Select::Make(IsNan(arg), arg, y);
+}
+
+// log(x) = e * ln2 + log(m), where x = m * 2^e and m in [sqrt(0.5), sqrt(2))
+inline Expr Log(const Expr &arg) {
+  const double inf = std::numeric_limits<float>::infinity();
+  const double nan = std::numeric_limits<float>::quiet_NaN();
+  Type int_type    = Int(32, arg.type().lanes());
+  Expr x           = ir::Max::Make(arg, Const(arg, std::numeric_limits<float>::min()));
+  Expr bits        = BitCast(int_type, x);
+  Expr e           = ir::Cast::Make(x.type(), BitwiseAnd(RightShift(bits, 23), 0xff) - IntConst(x, 126));
+  // the mantissa in [0.5, 1)
+  Expr m     = BitCast(x.type(), BitwiseOr(BitwiseAnd(bits, 0x007fffff), 0x3f000000));
+  Expr small = m < Const(x, 0.707106781186547524);
+  e          = ir::Select::Make(small, e - Const(x, 1.0), e);
+  m          = ir::Select::Make(small, m + m - Const(x, 1.0), m - Const(x, 1.0));
+  Expr z     = m * m;
+  Expr p     = Polynomial(m,
+                      {7.0376836292e-2,
+                       -1.1514610310e-1,
+                       1.1676998740e-1,
+                       -1.2420140846e-1,
+                       1.4249322787e-1,
+                       -1.6668057665e-1,
+                       2.0000714765e-1,
+                       -2.4999993993e-1,
+                       3.3333331174e-1});
+  Expr y     = p * m * z;
+  y          = y + e * Const(x, -2.12194440e-4);
+  y          = y + z * Const(x, -0.5);
+  Expr res   = m + y;
+  res        = res + e * Const(x, 0.693359375);
+  res        = ir::Select::Make(arg < Const(x, 0.0), Const(x, nan), res);
+  res        = ir::Select::Make(ir::EQ::Make(arg, Const(x, 0.0)), Const(x, -inf), res);
+  res        = ir::Select::Make(ir::EQ::Make(arg, Const(x, inf)), arg, res);
+  return ir::Select::Make(IsNan(arg), arg, res);
+}
+
+// tanh(x) = x + x^3 * P(x^2) if |x| < 0.625, otherwise sign(x) * (1 - 2 / (exp(2|x|) + 1))
+inline Expr Tanh(const Expr &arg) {
+  Expr abs_x = Fabs(arg);
+  Expr z     = arg * arg;
+  Expr p     = Polynomial(
+      z, {-5.70498872745e-3, 2.06390887954e-2, -5.37397155531e-2, 1.33314422036e-1, -3.33332819422e-1});
+  Expr small = p * z * arg + arg;
+  // tanh(9) rounds to 1 in float32
+  Expr exp_2x = Exp(ir::Min::Make(abs_x, Const(arg, 9.0)) * Const(arg, 2.0));
+  Expr large  = Const(arg, 1.0) - Const(arg, 2.0) / (exp_2x + Const(arg, 1.0));
+  large       = ir::Select::Make(arg < Const(arg, 0.0), -large, large);
+  Expr res    = ir::Select::Make(abs_x < Const(arg, 0.625), small, large);
+  return ir::Select::Make(IsNan(arg), arg, res);
+}
+
+// A rational approximation of erf on [-4, 4], out of which erf rounds to +-1 in float32
+inline Expr Erf(const Expr &arg) {
+  Expr x  = Clamp(arg, -4.0, 4.0);
+  Expr x2 = x * x;
+  Expr p  = Polynomial(x2,
+                      {-2.72614225801306e-10,
+                       2.77068142495902e-08,
+                       -2.10102402082508e-06,
+                       -5.69250639462346e-05,
+                       -7.34990630326855e-04,
+                       -2.95459980854025e-03,
+                       -1.60960333262415e-02});
+  Expr q  = Polynomial(x2,
+                      {-1.45660718464996e-05,
+                       -2.13374055278905e-04,
+                       -1.68282697438203e-03,
+                       -7.37332916720468e-03,
+                       -1.42647390514189e-02});
+  return ir::Select::Make(IsNan(arg), arg, p * x / q);
+}
+
+}  // namespace vectorized_math
+
 void RegisterCpuIntrinRule() {
 #define __(intrin_name__, id) \
   ir::Registry::Register("lower_cpu_intrinsic_" #intrin_name__, true).SetBody(MakeFloatIntrinOp<id, 1>);
-  __(exp, ::llvm::Intrinsic::exp)
   __(exp2, ::llvm::Intrinsic::exp2)
   __(sqrt, ::llvm::Intrinsic::sqrt)
-  __(log, ::llvm::Intrinsic::log)
   __(log2, ::llvm::Intrinsic::log2)
   __(log10, ::llvm::Intrinsic::log10)
   __(floor, ::llvm::Intrinsic::floor)
@@ -133,12 +291,57 @@ void RegisterCpuIntrinRule() {
     *rv      = lang::Sin(arg) / lang::Cos(arg);
   });
 
+  ir::Registry::Register("lower_cpu_intrinsic_exp", true).SetBody([](lang::Args args, lang::RetValue *rv) {
+    CHECK_GE(args.size(), 1U);
+    Expr arg0      = args[0];
+    ir::Call *node = arg0->as<ir::Call>();
+    CHECK(node);
+    CHECK(!node->read_args.empty());
+    if (vectorized_math::IsFloat32Vector(node->read_args[0])) {
+      *rv = vectorized_math::Exp(node->read_args[0]);
+    } else {
+      MakeFloatIntrinOp<::llvm::Intrinsic::exp, 1>(args, rv);
+    }
+  });
+
+  ir::Registry::Register("lower_cpu_intrinsic_log", true).SetBody([](lang::Args args, lang::RetValue *rv) {
+    CHECK_GE(args.size(), 1U);
+    Expr arg0      = args[0];
+    ir::Call *node = arg0->as<ir::Call>();
+    CHECK(node);
+    CHECK(!node->read_args.empty());
+    if (vectorized_math::IsFloat32Vector(node->read_args[0])) {
+      *rv = vectorized_math::Log(node->read_args[0]);
+    } else {
+      MakeFloatIntrinOp<::llvm::Intrinsic::log, 1>(args, rv);
+    }
+  });
+
+  // only the vectorized erf is lowered here, the scalar one is mapped to
+  // the libm function by MapExternCall
+  ir::Registry::Register("lower_cpu_intrinsic_erf", true).SetBody([](lang::Args args, lang::RetValue *rv) {
+    CHECK_GE(args.size(), 1U);
+    Expr arg0      = args[0];
+    ir::Call *node = arg0->as<ir::Call>();
+    CHECK(node);
+    CHECK(!node->read_args.empty());
+    if (vectorized_math::IsFloat32Vector(node->read_args[0])) {
+      *rv = vectorized_math::Erf(node->read_args[0]);
+    } else {
+      *rv = arg0;
+    }
+  });
+
   ir::Registry::Register("lower_cpu_intrinsic_tanh", true).SetBody([](lang::Args args, lang::RetValue *rv) {
     CHECK_GE(args.size(), 1U);
     Expr arg0      = args[0];
     ir::Call *node = arg0->as<ir::Call>();
     CHECK(node);
     CHECK(!node->read_args.empty());
+    if (vectorized_math::IsFloat32Vector(node->read_args[0])) {
+      *rv = vectorized_math::Tanh(node->read_args[0]);
+      return;
+    }
     Expr arg     = node->read_args[0];
     Expr zero    = make_const(arg->type(), 0);
     Expr one     = make_const(arg->type(), 1);
@@ -14,9 +14,13 @@
 
 #include "cinn/common/cas.h"
 
+#include <gflags/gflags.h>
+
 #include <algorithm>
 #include <cmath>
+#include <set>
 #include <string>
+#include <unordered_map>
 #include <utility>
 
 #include "cinn/common/arithmatic.h"
@@ -29,10 +33,153 @@
 #include "cinn/optim/ir_copy.h"
 #include "cinn/utils/string.h"
 
+DECLARE_int32(cinn_cas_simplify_memo_capacity);
+DECLARE_int32(cinn_cas_simplify_budget);
+
 namespace cinn {
 namespace common {
 using namespace ir;  // NOLINT
 
+namespace {
+
+// Thrown when a CasSimplify call runs out of its rewrite budget.
+struct CasSimplifyBudgetExhausted {};
+
+// The state of the CasSimplify calls in a thread.
+struct CasSimplifyState {
+  // the depth of the nested CasSimplify calls
+  int depth = 0;
+  // the rewrite steps taken by the top-level call
+  int64_t steps = 0;
+  // the simplified expressions and whether they are unchanged, keyed by GetMemoKey
+  std::unordered_map<std::string, std::pair<Expr, bool>> memo;
+};
+
+CasSimplifyState& GetCasSimplifyState() {
+  static thread_local CasSimplifyState state;
+  return state;
+}
+
+void AppendType(const Type& type, std::string* key) {
+  key->append(std::to_string(static_cast<int>(type.type())));
+  key->append(".").append(std::to_string(type.bits()));
+  key->append(".").append(std::to_string(type.lanes()));
+}
+
+// Serialize an index expression structurally and collect the names of its vars.
+// Return false if it contains a node that isn't memoized, such as Load and Call.
+bool SerializeIndexExpr(const Expr& expr, std::string* key, std::set<std::string>* var_names) {
+  if (!expr.defined()) {
+    key->push_back('_');
+    return true;
+  }
+  switch (expr.node_type()) {
+    case IrNodeTy::IntImm:
+      key->push_back('i');
+      AppendType(expr.type(), key);
+      key->append(":").append(std::to_string(expr.As<IntImm>()->value));
+      return true;
+    case IrNodeTy::_Var_: {
+      auto* var = expr.As<_Var_>();
+      var_names->insert(var->name);
+      key->push_back(var->is_reduce_axis ? 'r' : 'v');
+      AppendType(var->type(), key);
+      key->append(":").append(var->name).append("[");
+      if (!SerializeIndexExpr(var->lower_bound, key, var_names) ||
+          !SerializeIndexExpr(var->upper_bound, key, var_names)) {
+        return false;
+      }
+      key->push_back(']');
+      return true;
+    }
+    case IrNodeTy::Add:
+    case IrNodeTy::Sub:
+    case IrNodeTy::Mul:
+    case IrNodeTy::Div:
+    case IrNodeTy::Mod:
+    case IrNodeTy::Min:
+    case IrNodeTy::Max:
+    case IrNodeTy::Minus:
+    case IrNodeTy::Sum:
+    case IrNodeTy::Product:
+    case IrNodeTy::FracOp:
+    case IrNodeTy::Power:
+    case IrNodeTy::EQ:
+    case IrNodeTy::NE:
+    case IrNodeTy::LT:
+    case IrNodeTy::LE:
+    case IrNodeTy::GT:
+    case IrNodeTy::GE:
+    case IrNodeTy::And:
+    case IrNodeTy::Or:
+    case IrNodeTy::Not: {
+      key->push_back('(');
+      key->append(std::to_string(static_cast<int>(expr.node_type())));
+      for (auto& operand : expr->operands) {
+        key->push_back(' ');
+        if (!SerializeIndexExpr(operand, key, var_names)) {
+          return false;
+        }
+      }
+      key->push_back(')');
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
+// Get the key to memoize the result of simplifying expr, which consists of the
+// structure of expr and the intervals of the vars it depends on. Return false
+// if the expression is not memoized.
+bool GetMemoKey(const Expr& expr, const cas_intervals_t& var_intervals, std::string* key) {
+  std::set<std::string> var_names;
+  if (!SerializeIndexExpr(expr, key, &var_names)) {
+    return false;
+  }
+
+  // the bounds of an interval may depend on other vars
+  std::vector<std::string> worklist(var_names.begin(), var_names.end());
+  while (!worklist.empty()) {
+    auto it = var_intervals.find(worklist.back());
+    worklist.pop_back();
+    if (it == var_intervals.end() || !it->second.e_l.defined() || !it->second.e_r.defined()) {
+      continue;
+    }
+    std::set<std::string> bound_var_names;
+    std::string bound_key;
+    if (!SerializeIndexExpr(it->second.e_l, &bound_key, &bound_var_names) ||
+        !SerializeIndexExpr(it->second.e_r, &bound_key, &bound_var_names)) {
+      return false;
+    }
+    for (auto& name : bound_var_names) {
+      if (var_names.insert(name).second) {
+        worklist.push_back(name);
+      }
+    }
+  }
+
+  std::set<std::string> unused_names;
+  for (auto& name : var_names) {
+    auto it = var_intervals.find(name);
+    if (it == var_intervals.end()) {
+      continue;
+    }
+    key->append("|").append(name).append("=");
+    const CasInterval& interval = it->second;
+    if (interval.e_l.defined() && interval.e_r.defined()) {
+      SerializeIndexExpr(interval.e_l, key, &unused_names);
+      key->push_back(',');
+      SerializeIndexExpr(interval.e_r, key, &unused_names);
+    } else {
+      key->append(std::to_string(interval.l)).append(",").append(std::to_string(interval.r));
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
 Expr AutoSimplify(Expr u, const absl::flat_hash_map<std::string, CasInterval>& var_intervals) {
   VLOG(7) << "Begin AutoSimplify: " << u;
   u = detail::ConvertCinnToCAS(u);
@@ -1587,6 +1734,12 @@ Expr CasSimplifyMutator::SimplifySpecificSum(Expr tmp) {
 }
 
 Expr CasSimplifyMutator::operator()(Expr u) {
+  // the steps of the nested calls are counted in the budget of the top-level call
+  auto& state = GetCasSimplifyState();
+  if (FLAGS_cinn_cas_simplify_budget > 0 && ++state.steps > FLAGS_cinn_cas_simplify_budget) {
+    throw CasSimplifyBudgetExhausted();
+  }
+
   if (u.As<Min>() || u.As<Max>()) {
     return SimplifyMinAndMax(u);
   }
@@ -2365,9 +2518,52 @@ Expr CasSimplifyMutator::SimplifyCond(Expr u) {
 }  // namespace detail
 
 Expr CasSimplify(Expr u, const absl::flat_hash_map<std::string, CasInterval>& var_intervals) {
-  return detail::CasSimplifyMutator(var_intervals)(u);
+  // the constants and vars are simplified already
+  if (u.is_constant() || u.As<_Var_>()) {
+    return u;
+  }
+
+  auto& state = GetCasSimplifyState();
+  std::string key;
+  bool memoized = FLAGS_cinn_cas_simplify_memo_capacity > 0 && GetMemoKey(u, var_intervals, &key);
+  if (memoized) {
+    auto it = state.memo.find(key);
+    if (it != state.memo.end()) {
+      // return a copy since the callers may mutate the result in place
+      return it->second.second ? u : optim::IRCopy(it->second.first);
+    }
+  }
+
+  bool is_top_level = state.depth == 0;
+  if (is_top_level) {
+    state.steps = 0;
+  }
+  Expr result;
+  ++state.depth;
+  try {
+    result = detail::CasSimplifyMutator(var_intervals)(u);
+  } catch (const CasSimplifyBudgetExhausted&) {
+    --state.depth;
+    if (!is_top_level) {
+      throw;
+    }
+    LOG(WARNING) << "CasSimplify runs out of the budget of " << FLAGS_cinn_cas_simplify_budget
+                 << " steps, return the expression unsimplified: " << u;
+    return u;
+  }
+  --state.depth;
+
+  if (memoized) {
+    if (state.memo.size() >= FLAGS_cinn_cas_simplify_memo_capacity) {
+      state.memo.clear();
+    }
+    state.memo.emplace(std::move(key), std::make_pair(optim::IRCopy(result), result.same_as(u)));
+  }
+  return result;
 }
 
+void ClearCasSimplifyMemo() { GetCasSimplifyState().memo.clear(); }
+
 Expr SolveInequality(Expr inequality, Var val) {
   auto copied = AutoSimplify(inequality);
 
@@ -84,9 +84,18 @@ using cas_intervals_t = absl::flat_hash_map<std::string, CasInterval>;
 
 Expr AutoSimplify(Expr u, const absl::flat_hash_map<std::string, CasInterval>& var_intervals = {});
 
-//! Simplify a CAS expression.
+/**
+ * Simplify a CAS expression.
+ *
+ * The results of index expressions are memoized in a thread-local table keyed by their structure and the intervals
+ * of their vars, see FLAGS_cinn_cas_simplify_memo_capacity. A call returns the expression unsimplified if it takes
+ * more rewrite steps than FLAGS_cinn_cas_simplify_budget.
+ */
 Expr CasSimplify(Expr u, const absl::flat_hash_map<std::string, CasInterval>& var_intervals = {});
 
+//! Clear the memo of CasSimplify in the current thread.
+void ClearCasSimplifyMemo();
+
 /**
  * \brief Solve an equality.
  * Currently this is an naive implementation using the GiNaC.
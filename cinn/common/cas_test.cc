@@ -14,6 +14,7 @@
 
 #include "cinn/common/cas.h"
 
+#include <gflags/gflags.h>
 #include <gtest/gtest.h>
 
 #include "cinn/cinn.h"
@@ -23,6 +24,9 @@
 #include "cinn/ir/ir_printer.h"
 #include "cinn/utils/string.h"
 
+DECLARE_int32(cinn_cas_simplify_memo_capacity);
+DECLARE_int32(cinn_cas_simplify_budget);
+
 namespace cinn {
 namespace common {
 
@@ -489,5 +493,46 @@ TEST(CAS, cond) {
   }
 }
 
+TEST(CAS, Memo) {
+  Var i = ir::_Var_::Make("i", Int(32));
+  Var j = ir::_Var_::Make("j", Int(32));
+  // (i * 64 + j) / 64
+  Expr u = ir::Div::Make(ir::Add::Make(ir::Mul::Make(i, Expr(64)), j), Expr(64));
+  cas_intervals_t var_intervals{{"i", CasInterval(0, 63)}, {"j", CasInterval(0, 63)}};
+  cas_intervals_t wider_intervals{{"i", CasInterval(0, 63)}, {"j", CasInterval(0, 127)}};
+
+  FLAGS_cinn_cas_simplify_memo_capacity = 0;
+  std::string expected       = GetStreamCnt(AutoSimplify(u, var_intervals));
+  std::string wider_expected = GetStreamCnt(AutoSimplify(u, wider_intervals));
+  EXPECT_EQ(expected, "i");
+
+  FLAGS_cinn_cas_simplify_memo_capacity = 8192;
+  ClearCasSimplifyMemo();
+  EXPECT_EQ(GetStreamCnt(AutoSimplify(u, var_intervals)), expected);
+  // the second call hits the memo
+  EXPECT_EQ(GetStreamCnt(AutoSimplify(u, var_intervals)), expected);
+  // the intervals are a part of the key
+  EXPECT_EQ(GetStreamCnt(AutoSimplify(u, wider_intervals)), wider_expected);
+  ClearCasSimplifyMemo();
+}
+
+TEST(CAS, Budget) {
+  Var i = ir::_Var_::Make("i", Int(32));
+  Var j = ir::_Var_::Make("j", Int(32));
+  Expr u = ir::Div::Make(ir::Add::Make(ir::Mul::Make(i, Expr(64)), j), Expr(64));
+  cas_intervals_t var_intervals{{"i", CasInterval(0, 63)}, {"j", CasInterval(0, 63)}};
+
+  ClearCasSimplifyMemo();
+  int old_capacity                      = FLAGS_cinn_cas_simplify_memo_capacity;
+  int old_budget                        = FLAGS_cinn_cas_simplify_budget;
+  FLAGS_cinn_cas_simplify_memo_capacity = 0;
+  // the simplification of the numerator is out of the budget
+  FLAGS_cinn_cas_simplify_budget = 1;
+  EXPECT_NE(GetStreamCnt(AutoSimplify(u, var_intervals)), "i");
+  FLAGS_cinn_cas_simplify_budget = old_budget;
+  EXPECT_EQ(GetStreamCnt(AutoSimplify(u, var_intervals)), "i");
+  FLAGS_cinn_cas_simplify_memo_capacity = old_capacity;
+}
+
 }  // namespace common
 }  // namespace cinn
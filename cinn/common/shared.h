@@ -16,6 +16,7 @@
 #include <atomic>
 #include <string>
 #include <type_traits>
+#include <utility>
 
 namespace cinn {
 namespace common {
@@ -25,8 +26,10 @@ class RefCount {
   using value_type = int32_t;
   RefCount()       = default;
 
-  value_type Inc() { return ++count_; }
-  value_type Dec() { return --count_; }
+  // A new reference is got from an existing one, so the increment needs no ordering,
+  // while the decrement should make the writes of the other owners visible before destroying.
+  value_type Inc() { return count_.fetch_add(1, std::memory_order_relaxed) + 1; }
+  value_type Dec() { return count_.fetch_sub(1, std::memory_order_acq_rel) - 1; }
   bool is_zero() const { return 0 == count_; }
   std::string to_string() { return std::to_string(count_.load()); }
   int32_t val() const { return count_; }
@@ -60,6 +63,7 @@ struct Shared {
   Shared(const Shared& other) : p_(other.p_) { IncRef(p_); }
   Shared(Shared&& other) : p_(other.p_) { other.p_ = nullptr; }
   Shared<T>& operator=(const Shared<T>& other);
+  Shared<T>& operator=(Shared<T>&& other);
 
   //! Reset to another pointer \p x.
   void Reset(T* x = nullptr);
@@ -118,9 +122,20 @@ Shared<T>& Shared<T>::operator=(const Shared<T>& other) {
   return *this;
 }
 
+template <typename T>
+Shared<T>& Shared<T>::operator=(Shared<T>&& other) {
+  if (&other == this) return *this;
+  // Take the pointer before decref ourselves, since other can be inside of something owned by this.
+  T* tmp   = other.p_;
+  other.p_ = nullptr;
+  DecRef(p_);
+  p_ = tmp;
+  return *this;
+}
+
 template <typename T, typename... Args>
 T* make_shared(Args&&... args) {
-  return new T(args...);
+  return new T(std::forward<Args>(args)...);
 }
 
 template <typename T>
@@ -15,8 +15,11 @@
 #include "cinn/common/target.h"
 
 #include <glog/logging.h>
+#include <unistd.h>
 
+#include <algorithm>
 #include <sstream>
+#include <thread>
 
 #include "cinn/runtime/cinn_runtime.h"
 
@@ -49,6 +52,47 @@ int Target::max_num_threads() const {
   return 1024;
 }
 
+std::vector<int64_t> Target::cache_sizes() const {
+  if (arch == Arch::NVGPU) {
+    // the L1 cache shared with the shared memory of a SM, and the L2 cache is the last level
+    return {128 * 1024, 4 * 1024 * 1024, 4 * 1024 * 1024};
+  }
+  std::vector<int64_t> sizes = {32 * 1024, 1024 * 1024, 32 * 1024 * 1024};
+#if defined(_SC_LEVEL1_DCACHE_SIZE) && defined(_SC_LEVEL2_CACHE_SIZE) && defined(_SC_LEVEL3_CACHE_SIZE)
+  const int names[] = {_SC_LEVEL1_DCACHE_SIZE, _SC_LEVEL2_CACHE_SIZE, _SC_LEVEL3_CACHE_SIZE};
+  for (int i = 0; i < 3; ++i) {
+    long size = sysconf(names[i]);
+    if (size > 0) {
+      sizes[i] = size;
+    }
+  }
+  // some machines have no L3 cache, then the L2 cache is the last level
+  sizes[2] = std::max(sizes[1], sizes[2]);
+#endif
+  return sizes;
+}
+
+int Target::num_cores() const {
+  CHECK(arch != Arch::NVGPU) << "The target is NVGPU! Cannot get the number of CPU cores.";
+  int num = std::thread::hardware_concurrency();
+  return num > 0 ? num : 1;
+}
+
+int Target::vector_bits() const {
+  CHECK(arch != Arch::NVGPU) << "The target is NVGPU! Cannot get the SIMD width.";
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+  if (arch == Arch::X86) {
+    if (__builtin_cpu_supports("avx512f")) {
+      return 512;
+    }
+    if (__builtin_cpu_supports("avx2") || __builtin_cpu_supports("avx")) {
+      return 256;
+    }
+  }
+#endif
+  return 128;
+}
+
 std::vector<Target::Lib> Target::get_target_libs() const { return libs; }
 
 int Target::get_target_bits() const {
@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <ostream>
 #include <string>
 #include <vector>
@@ -80,6 +81,17 @@ struct Target {
 
   int max_num_threads() const;
 
+  //! Get the sizes in bytes of the L1 data cache, the L2 cache and the last level cache.
+  //! They are detected on the host CPU if possible, or typical values otherwise.
+  std::vector<int64_t> cache_sizes() const;
+
+  //! Get the number of the CPU cores to run parallel loops, it is detected on the host.
+  int num_cores() const;
+
+  //! Get the width in bits of the SIMD registers, which is 512 with AVX-512, 256 with AVX/AVX2
+  //! and 128 otherwise. It is detected on the host CPU.
+  int vector_bits() const;
+
   int get_target_bits() const;
 
   std::vector<Lib> get_target_libs() const;
@@ -0,0 +1,137 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/frontend/decomposer_registry.h"
+#include "cinn/frontend/syntax.h"
+
+namespace cinn {
+namespace frontend {
+namespace decomposer {
+
+struct LayerNormHelper {
+  LayerNormHelper(CinnBuilder* cinn_builder, const std::vector<int>& arg_x_shape, int arg_begin_norm_axis) {
+    builder         = cinn_builder;
+    x_shape         = arg_x_shape;
+    begin_norm_axis = arg_begin_norm_axis < 0 ? arg_begin_norm_axis + x_shape.size() : arg_begin_norm_axis;
+    CHECK(begin_norm_axis > 0 && begin_norm_axis < x_shape.size())
+        << "The begin_norm_axis should be in [1, " << x_shape.size() << "), but got " << arg_begin_norm_axis;
+
+    for (int i = 0; i < x_shape.size(); ++i) {
+      if (i < begin_norm_axis) {
+        outer_axes.push_back(i);
+        stat_shape.push_back(x_shape[i]);
+      } else {
+        inner_axes.push_back(i);
+        inner_shape.push_back(x_shape[i]);
+        norm_size *= x_shape[i];
+      }
+    }
+    num_instructions = builder->size();
+  }
+
+  ~LayerNormHelper() {
+    VLOG(4) << "layer_norm_grad is decomposed to " << builder->size() - num_instructions << " instructions.";
+  }
+
+  // broadcast the statistics with shape x.shape[:begin_norm_axis] to x.shape
+  Variable BroadcastStat(Variable stat) { return builder->BroadcastTo(stat, x_shape, outer_axes); }
+
+  // broadcast the parameters with shape [prod(x.shape[begin_norm_axis:])] to x.shape
+  Variable BroadcastParam(Variable param) {
+    if (inner_shape.size() > 1U) {
+      param = builder->Reshape(param, inner_shape);
+    }
+    return builder->BroadcastTo(param, x_shape, inner_axes);
+  }
+
+  // reduce over the outer axes, the result is flattened to the shape of the parameters
+  Variable ReduceOuter(Variable x) {
+    auto sum = builder->Reduce(x, ReduceKind::kSum, outer_axes);
+    if (inner_shape.size() > 1U) {
+      sum = builder->Reshape(sum, {norm_size});
+    }
+    return sum;
+  }
+
+  // mean over the normalized axes, shape = x.shape[:begin_norm_axis]
+  Variable MeanInner(Variable x) {
+    auto sum = builder->Reduce(x, ReduceKind::kSum, inner_axes);
+    return builder->Div(sum, builder->FillConstant<float>(stat_shape, norm_size, common::UniqName("norm_size")));
+  }
+
+  // std_variance_inv = rsqrt(variance + epsilon)
+  Variable StdVarianceInv(Variable variance, float epsilon) {
+    auto epsilon_stat = builder->FillConstant<float>(stat_shape, epsilon, common::UniqName("epsilon"));
+    return builder->Rsqrt(builder->Add(variance, epsilon_stat));
+  }
+
+  CinnBuilder* builder{nullptr};
+  std::vector<int> x_shape;
+  std::vector<int> stat_shape;
+  std::vector<int> inner_shape;
+  std::vector<int> outer_axes;
+  std::vector<int> inner_axes;
+  int begin_norm_axis{1};
+  int norm_size{1};
+  int num_instructions{0};
+};
+
+void layer_norm_grad(const Instruction& instr, const DecomposerContext& context) {
+  CHECK_EQ(instr->inputs.size(), 5UL) << " The number of the given inputs is not equal to the required "
+                                      << instr->op_type;
+  CHECK_EQ(instr->outputs.size(), 3UL) << " The number of the given outputs is not equal to the required"
+                                       << instr->op_type;
+
+  auto& y_grad   = instr->inputs[0];
+  auto& x        = instr->inputs[1];
+  auto& scale    = instr->inputs[2];
+  auto& mean     = instr->inputs[3];
+  auto& variance = instr->inputs[4];
+
+  auto epsilon         = instr.GetAttrs<float>("epsilon");
+  auto begin_norm_axis = instr.GetAttrs<int>("begin_norm_axis");
+
+  CinnBuilder* builder = context.builder();
+  LayerNormHelper helper(builder, x->shape, begin_norm_axis);
+
+  // x_hat = (x - mean) * rsqrt(variance + epsilon)
+  auto std_variance_inv = helper.BroadcastStat(helper.StdVarianceInv(variance, epsilon));
+  auto x_hat            = builder->Mul(builder->Sub(x, helper.BroadcastStat(mean)), std_variance_inv);
+
+  // bias_grad = reduce_sum(y_grad), scale_grad = reduce_sum(y_grad * x_hat) over the outer axes
+  auto bias_grad  = helper.ReduceOuter(y_grad);
+  auto scale_grad = helper.ReduceOuter(builder->Mul(y_grad, x_hat));
+
+  // x_grad = rsqrt(variance + epsilon) * (g - mean(g) - x_hat * mean(g * x_hat)), where g = y_grad * scale and the
+  // means are over the normalized axes
+  auto g        = builder->Mul(y_grad, helper.BroadcastParam(scale));
+  auto g_mean   = helper.BroadcastStat(helper.MeanInner(g));
+  auto g_x_mean = helper.BroadcastStat(helper.MeanInner(builder->Mul(g, x_hat)));
+  auto diff     = builder->Sub(builder->Sub(g, g_mean), builder->Mul(x_hat, g_x_mean));
+  auto x_grad   = builder->Mul(std_variance_inv, diff);
+
+  context.MapOutToOrigin(x_grad, instr->outputs[0]);
+  context.MapOutToOrigin(scale_grad, instr->outputs[1]);
+  context.MapOutToOrigin(bias_grad, instr->outputs[2]);
+}
+
+}  // namespace decomposer
+}  // namespace frontend
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(layer_norm_grad_decomposer) {
+  CINN_DECOMPOSER_REGISTER(layer_norm_grad, cinn::frontend::decomposer::layer_norm_grad);
+
+  return true;
+}
@@ -0,0 +1,198 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cmath>
+
+#include "cinn/frontend/decomposer/test_helper.h"
+
+namespace cinn {
+namespace frontend {
+namespace {
+
+// Run the program and return the outputs, the inputs are given as {name, data} pairs.
+std::vector<std::vector<float>> RunProgram(Program* program,
+                                           const std::vector<std::pair<std::string, std::vector<float>>>& inputs,
+                                           const std::vector<std::string>& output_names) {
+  auto target = common::DefaultTarget();
+  RunDecomposer(program, target);
+
+  auto graph = std::make_shared<hlir::framework::Graph>(*program, target);
+  hlir::framework::ApplyPass(graph.get(), "OpFusionPass");
+  hlir::framework::ApplyPass(graph.get(), "FusionMergePass");
+
+  auto scope = BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto run_program = gc.Build();
+
+  for (auto& input : inputs) {
+    scope->Var<hlir::framework::Tensor>(input.first);
+    CopyFromVector(input.second, scope->GetTensor(input.first), target);
+  }
+  run_program->Execute();
+
+  std::vector<std::vector<float>> outputs;
+  for (auto& name : output_names) {
+    outputs.emplace_back();
+    CopyToVector(scope->GetTensor(name), &outputs.back());
+  }
+  return outputs;
+}
+
+// The reference of layer_norm on the input flattened to [m, n].
+void ComputeLayerNormRef(const std::vector<float>& x,
+                         const std::vector<float>& scale,
+                         const std::vector<float>& bias,
+                         int m,
+                         int n,
+                         float epsilon,
+                         std::vector<float>* y,
+                         std::vector<float>* mean,
+                         std::vector<float>* variance) {
+  y->resize(m * n);
+  mean->resize(m);
+  variance->resize(m);
+  for (int i = 0; i < m; ++i) {
+    double sum = 0.0;
+    for (int j = 0; j < n; ++j) {
+      sum += x[i * n + j];
+    }
+    double mu     = sum / n;
+    double sq_sum = 0.0;
+    for (int j = 0; j < n; ++j) {
+      sq_sum += (x[i * n + j] - mu) * (x[i * n + j] - mu);
+    }
+    double var = sq_sum / n;
+    for (int j = 0; j < n; ++j) {
+      y->at(i * n + j) = (x[i * n + j] - mu) / std::sqrt(var + epsilon) * scale[j] + bias[j];
+    }
+    mean->at(i)     = mu;
+    variance->at(i) = var;
+  }
+}
+
+TEST(Decomposer, LayerNorm) {
+  int b = 4, s = 32, h = 64;
+  float epsilon = 1e-5f;
+  NetBuilder net_builder("layer_norm");
+  std::vector<std::string> output_names;
+  {
+    auto x       = net_builder.CreateInput(Float(32), {b, s, h}, "x");
+    auto scale   = net_builder.CreateInput(Float(32), {h}, "scale");
+    auto bias    = net_builder.CreateInput(Float(32), {h}, "bias");
+    auto outputs = net_builder.LayerNorm(x, scale, bias, epsilon, 2);
+    for (auto output : outputs) {
+      output_names.push_back(output->id);
+    }
+  }
+  auto program = net_builder.Build();
+
+  std::vector<float> x, scale, bias;
+  // a large mean relative to the deviation, which E(x^2) - E(x)^2 would lose to cancellation
+  InitRandomVector<float>(&x, b * s * h, 10.0f, 11.0f);
+  InitRandomVector<float>(&scale, h, 0.0f, 1.0f);
+  InitRandomVector<float>(&bias, h, 0.0f, 1.0f);
+  auto outputs = RunProgram(&program, {{"x", x}, {"scale", scale}, {"bias", bias}}, output_names);
+
+  std::vector<float> y, mean, variance;
+  ComputeLayerNormRef(x, scale, bias, b * s, h, epsilon, &y, &mean, &variance);
+  CheckOutput<float>(outputs[0], y, 1e-5, 1e-4);
+  CheckOutput<float>(outputs[1], mean, 1e-5, 1e-5);
+  CheckOutput<float>(outputs[2], variance, 1e-6, 1e-5);
+}
+
+TEST(Decomposer, RMSNorm) {
+  int m = 64, n = 128;
+  float epsilon = 1e-6f;
+  NetBuilder net_builder("rms_norm");
+  std::string output_name;
+  {
+    auto x      = net_builder.CreateInput(Float(32), {m, n}, "x");
+    auto scale  = net_builder.CreateInput(Float(32), {n}, "scale");
+    auto output = net_builder.RMSNorm(x, scale, epsilon);
+    output_name = output->id;
+  }
+  auto program = net_builder.Build();
+
+  std::vector<float> x, scale;
+  InitRandomVector<float>(&x, m * n, -1.0f, 1.0f);
+  InitRandomVector<float>(&scale, n, 0.0f, 1.0f);
+  auto outputs = RunProgram(&program, {{"x", x}, {"scale", scale}}, {output_name});
+
+  std::vector<float> y(m * n);
+  for (int i = 0; i < m; ++i) {
+    double sq_sum = 0.0;
+    for (int j = 0; j < n; ++j) {
+      sq_sum += x[i * n + j] * x[i * n + j];
+    }
+    for (int j = 0; j < n; ++j) {
+      y[i * n + j] = x[i * n + j] / std::sqrt(sq_sum / n + epsilon) * scale[j];
+    }
+  }
+  CheckOutput<float>(outputs[0], y, 1e-5, 1e-4);
+}
+
+TEST(Decomposer, LayerNormGrad) {
+  int m = 32, n = 64;
+  float epsilon = 1e-5f;
+  NetBuilder net_builder("layer_norm_grad");
+  std::vector<std::string> output_names;
+  {
+    auto y_grad   = net_builder.CreateInput(Float(32), {m, n}, "y_grad");
+    auto x        = net_builder.CreateInput(Float(32), {m, n}, "x");
+    auto scale    = net_builder.CreateInput(Float(32), {n}, "scale");
+    auto mean     = net_builder.CreateInput(Float(32), {m}, "mean");
+    auto variance = net_builder.CreateInput(Float(32), {m}, "variance");
+    auto outputs  = net_builder.LayerNormGrad(y_grad, x, scale, mean, variance, epsilon, 1);
+    for (auto output : outputs) {
+      output_names.push_back(output->id);
+    }
+  }
+  auto program = net_builder.Build();
+
+  std::vector<float> y_grad, x, scale, bias(n, 0.0f), y, mean, variance;
+  InitRandomVector<float>(&y_grad, m * n, -1.0f, 1.0f);
+  InitRandomVector<float>(&x, m * n, 0.0f, 1.0f);
+  InitRandomVector<float>(&scale, n, 0.0f, 1.0f);
+  ComputeLayerNormRef(x, scale, bias, m, n, epsilon, &y, &mean, &variance);
+  auto outputs = RunProgram(
+      &program,
+      {{"y_grad", y_grad}, {"x", x}, {"scale", scale}, {"mean", mean}, {"variance", variance}},
+      output_names);
+
+  std::vector<float> x_grad(m * n), scale_grad(n, 0.0f), bias_grad(n, 0.0f);
+  for (int i = 0; i < m; ++i) {
+    double std_inv = 1.0 / std::sqrt(variance[i] + epsilon);
+    double g_sum   = 0.0, g_x_sum = 0.0;
+    for (int j = 0; j < n; ++j) {
+      double x_hat = (x[i * n + j] - mean[i]) * std_inv;
+      double g     = y_grad[i * n + j] * scale[j];
+      g_sum += g;
+      g_x_sum += g * x_hat;
+      scale_grad[j] += y_grad[i * n + j] * x_hat;
+      bias_grad[j] += y_grad[i * n + j];
+    }
+    for (int j = 0; j < n; ++j) {
+      double x_hat      = (x[i * n + j] - mean[i]) * std_inv;
+      double g          = y_grad[i * n + j] * scale[j];
+      x_grad[i * n + j] = std_inv * (g - g_sum / n - x_hat * g_x_sum / n);
+    }
+  }
+  CheckOutput<float>(outputs[0], x_grad, 1e-4, 1e-3);
+  CheckOutput<float>(outputs[1], scale_grad, 1e-4, 1e-4);
+  CheckOutput<float>(outputs[2], bias_grad, 1e-4, 1e-4);
+}
+
+}  // namespace
+}  // namespace frontend
+}  // namespace cinn
@@ -23,4 +23,5 @@ CINN_USE_REGISTER(broadcast_decomposers)
 CINN_USE_REGISTER(broadcast_grad_decomposers)
 CINN_USE_REGISTER(batch_norm_train_decomposer)
 CINN_USE_REGISTER(batch_norm_grad_decomposer)
+CINN_USE_REGISTER(layer_norm_grad_decomposer)
 CINN_USE_REGISTER(conv2d_grad_decomposer)
@@ -214,6 +214,51 @@ std::vector<Variable> NetBuilder::BatchNormGrad(const Variable& dy,
   return instr.GetOutputs();
 }
 
+std::vector<Variable> NetBuilder::LayerNorm(
+    const Variable& x, const Variable& scale, const Variable& bias, float epsilon, int begin_norm_axis) {
+  Instruction instr("layer_norm", {x, scale, bias});
+  instr.SetAttr("epsilon", epsilon);
+  instr.SetAttr("begin_norm_axis", begin_norm_axis);
+  InferShape(instr);
+  AppendInstruction(instr);
+  return instr.GetOutputs();
+}
+
+// layer norm grad, output(grad_x, grad_scale, grad_bias)
+std::vector<Variable> NetBuilder::LayerNormGrad(const Variable& dy,
+                                                const Variable& x,
+                                                const Variable& scale,
+                                                const Variable& mean,
+                                                const Variable& variance,
+                                                float epsilon,
+                                                int begin_norm_axis) {
+  Instruction instr("layer_norm_grad", {dy, x, scale, mean, variance});
+  instr.SetAttr("epsilon", epsilon);
+  instr.SetAttr("begin_norm_axis", begin_norm_axis);
+  InferShape(instr);
+  AppendInstruction(instr);
+  return instr.GetOutputs();
+}
+
+Variable NetBuilder::RMSNorm(const Variable& x, const Variable& scale, float epsilon, int begin_norm_axis) {
+  Instruction instr("rms_norm", {x, scale});
+  instr.SetAttr("epsilon", epsilon);
+  instr.SetAttr("begin_norm_axis", begin_norm_axis);
+  InferShape(instr);
+  AppendInstruction(instr);
+  return instr.GetOutput(0);
+}
+
+Variable NetBuilder::Attention(const std::vector<Variable>& inputs, float scale, bool causal) {
+  CHECK(inputs.size() == 3U || inputs.size() == 4U) << "The inputs of attention should be {q, k, v[, mask]}";
+  Instruction instr("attention", inputs);
+  instr.SetAttr("scale", scale);
+  instr.SetAttr("causal", causal);
+  InferShape(instr);
+  AppendInstruction(instr);
+  return instr.GetOutput(0);
+}
+
 Variable NetBuilder::Scale(const Variable& a, float scale, float bias, bool bias_after_scale) {
   Instruction instr("scale", {a});
   instr.SetAttr("scale", scale);
@@ -161,6 +161,39 @@ class NetBuilder : public BaseBuilder {
                                       const float epsilon            = 1e-5,
                                       const std::string& data_layout = "NCHW");
 
+  /**
+   * The layer normalization over the axes [begin_norm_axis, rank) of x, the shape of scale and bias is
+   * [prod(x.shape[begin_norm_axis:])]. outputs={y, mean, variance}, the shape of mean and variance is
+   * x.shape[:begin_norm_axis].
+   */
+  std::vector<Variable> LayerNorm(const Variable& x,
+                                  const Variable& scale,
+                                  const Variable& bias,
+                                  float epsilon       = 1e-5f,
+                                  int begin_norm_axis = 1);
+
+  // layer norm grad, output(x_grad, scale_grad, bias_grad)
+  std::vector<Variable> LayerNormGrad(const Variable& dy,
+                                      const Variable& x,
+                                      const Variable& scale,
+                                      const Variable& mean,
+                                      const Variable& variance,
+                                      float epsilon       = 1e-5f,
+                                      int begin_norm_axis = 1);
+
+  /**
+   * The root mean square normalization over the axes [begin_norm_axis, rank) of x, the shape of scale is
+   * [prod(x.shape[begin_norm_axis:])].
+   */
+  Variable RMSNorm(const Variable& x, const Variable& scale, float epsilon = 1e-6f, int begin_norm_axis = -1);
+
+  /**
+   * The fused scaled dot product attention softmax(scale * q * k^T + mask) * v, inputs={q, k, v[, mask]}. q, k and v
+   * are [batch, seq, dim] or [batch, heads, seq, dim], and the optional additive mask is broadcastable to
+   * [..., seq_q, seq_k]. With causal=true the query i only attends to the keys j <= i + seq_k - seq_q.
+   */
+  Variable Attention(const std::vector<Variable>& inputs, float scale, bool causal = false);
+
   Variable Scale(const Variable& a, float scale = 1.0f, float bias = 0.0f, bool bias_after_scale = true);
 
   Variable Softmax(const Variable& a, int axis = -1, const std::string& data_format = "AnyLayout");
@@ -0,0 +1,129 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <numeric>
+
+#include "cinn/frontend/op_mapper_registry.h"
+#include "cinn/frontend/op_mappers/common_utils.h"
+
+namespace cinn {
+namespace frontend {
+namespace paddle_mappers {
+
+namespace {
+// Scale and Bias are dispensable in paddle's layer_norm, the missing one is filled with `value` in the dtype of x.
+Variable GetParamOrFill(const paddle::cpp::OpDesc& op_desc,
+                        const OpMapperContext& ctx,
+                        const std::string& param,
+                        int norm_size,
+                        float value,
+                        const common::Type& dtype) {
+  if (op_desc.HasInput(param) && !op_desc.Input(param).empty()) {
+    return ctx.GetVar(op_desc.Input(param).front());
+  }
+  return ctx.Builder()->FillConstant(
+      {norm_size}, value, common::UniqName("layer_norm_" + param), common::Type2Str(dtype));
+}
+}  // namespace
+
+void LayerNormOpMapper(const paddle::cpp::OpDesc& op_desc, const OpMapperContext& ctx) {
+  CHECK_EQ(op_desc.Input("X").size(), 1UL);
+  auto x = ctx.GetVar(op_desc.Input("X").front());
+
+  auto epsilon         = utils::GetAttrOrDefault<float>(op_desc, "epsilon", 1e-5f);
+  auto begin_norm_axis = utils::GetAttrOrDefault<int>(op_desc, "begin_norm_axis", 1);
+
+  const auto& x_shape = x->shape;
+  int left            = std::accumulate(x_shape.begin(), x_shape.begin() + begin_norm_axis, 1, std::multiplies<int>());
+  int right           = std::accumulate(x_shape.begin() + begin_norm_axis, x_shape.end(), 1, std::multiplies<int>());
+
+  auto scale = GetParamOrFill(op_desc, ctx, "Scale", right, 1.0f, x->type);
+  auto bias  = GetParamOrFill(op_desc, ctx, "Bias", right, 0.0f, x->type);
+
+  VLOG(4) << "Invoke layer_norm OpMapper with begin_norm_axis=" << begin_norm_axis << ", epsilon=" << epsilon;
+  auto outs = ctx.Builder()->LayerNorm(x, scale, bias, epsilon, begin_norm_axis);
+  CHECK_EQ(outs.size(), 3UL) << "layer_norm API's should return 3 Variable!";
+
+  std::vector<std::string> output_names = {"Y", "Mean", "Variance"};
+  for (int i = 0; i < outs.size(); i++) {
+    if (!op_desc.HasOutput(output_names[i]) || op_desc.Output(output_names[i]).empty()) {
+      // The Mean and Variance can be empty
+      CHECK_NE(output_names[i], "Y") << "The output Y should not empty.";
+      continue;
+    }
+    auto out = outs[i];
+    if (i > 0 && begin_norm_axis > 1) {
+      // paddle's Mean and Variance are flattened to [left]
+      out = ctx.Builder()->Reshape(out, {left});
+    }
+    auto out_name = op_desc.Output(output_names[i]).front();
+    ctx.AddVar(out_name, out);
+    ctx.AddVarModelToProgram(out_name, out->id);
+  }
+}
+
+void LayerNormGradOpMapper(const paddle::cpp::OpDesc& op_desc, const OpMapperContext& ctx) {
+  auto get_input_var = [&op_desc, &ctx](const std::string& op_name) {
+    CHECK_EQ(op_desc.Input(op_name).size(), 1UL);
+    auto var_name = op_desc.Input(op_name).front();
+    return ctx.GetVar(var_name);
+  };
+
+  auto x        = get_input_var("X");
+  auto dy       = get_input_var(paddle::GradVarName("Y"));
+  auto mean     = get_input_var("Mean");
+  auto variance = get_input_var("Variance");
+
+  auto epsilon         = utils::GetAttrOrDefault<float>(op_desc, "epsilon", 1e-5f);
+  auto begin_norm_axis = utils::GetAttrOrDefault<int>(op_desc, "begin_norm_axis", 1);
+
+  const auto& x_shape = x->shape;
+  int right           = std::accumulate(x_shape.begin() + begin_norm_axis, x_shape.end(), 1, std::multiplies<int>());
+  auto scale          = GetParamOrFill(op_desc, ctx, "Scale", right, 1.0f, x->type);
+
+  std::vector<int> stat_shape(x_shape.begin(), x_shape.begin() + begin_norm_axis);
+  if (mean->shape != stat_shape) {
+    mean     = ctx.Builder()->Reshape(mean, stat_shape);
+    variance = ctx.Builder()->Reshape(variance, stat_shape);
+  }
+
+  // layer norm grad, output(grad_x, grad_scale, grad_bias)
+  auto outs = ctx.Builder()->LayerNormGrad(dy, x, scale, mean, variance, epsilon, begin_norm_axis);
+  CHECK_EQ(outs.size(), 3ul) << "layer_norm_grad API's should return 3 Variable!";
+
+  std::vector<std::string> output_names = {
+      paddle::GradVarName("X"), paddle::GradVarName("Scale"), paddle::GradVarName("Bias")};
+
+  for (int i = 0; i < outs.size(); i++) {
+    if (!op_desc.HasOutput(output_names[i]) || op_desc.Output(output_names[i]).empty()) {
+      // The grad of Scale and Bias can be empty
+      CHECK_NE(output_names[i], paddle::GradVarName("X")) << "The input X should not empty.";
+      continue;
+    }
+
+    auto out_name = op_desc.Output(output_names[i]).front();
+    ctx.AddVar(out_name, outs[i]);
+    ctx.AddVarModelToProgram(out_name, outs[i]->id);
+  }
+}
+
+}  // namespace paddle_mappers
+}  // namespace frontend
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(paddle_layer_norm) {
+  CINN_REGISTER_OP_MAPPER(layer_norm, cinn::frontend::paddle_mappers::LayerNormOpMapper)
+  CINN_REGISTER_OP_MAPPER(layer_norm_grad, cinn::frontend::paddle_mappers::LayerNormGradOpMapper)
+  return true;
+}
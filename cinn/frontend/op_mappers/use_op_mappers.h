@@ -24,6 +24,7 @@ CINN_USE_REGISTER(paddle_relu)
 CINN_USE_REGISTER(paddle_softmax)
 CINN_USE_REGISTER(paddle_scale)
 CINN_USE_REGISTER(paddle_batchnorm)
+CINN_USE_REGISTER(paddle_layer_norm)
 CINN_USE_REGISTER(paddle_dropout)
 CINN_USE_REGISTER(paddle_elementwise)
 CINN_USE_REGISTER(paddle_pool2d)
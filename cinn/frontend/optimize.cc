@@ -36,6 +36,7 @@ namespace frontend {
 
 OptimizeOptions DefaultTrainingOptimizeOptions() {
   OptimizeOptions options;
+  options.program_passes.emplace_back("AttentionRewriter");
   options.program_passes.emplace_back("Decomposer");
   options.program_passes.emplace_back("TransposeCollapsing");
   options.program_passes.emplace_back("TransposeFoldingInput");
@@ -46,6 +47,8 @@ OptimizeOptions DefaultTrainingOptimizeOptions() {
   if (FLAGS_cinn_use_fill_constant_folding) {
     options.program_passes.emplace_back("FillConstantFolding");
   }
+  options.program_passes.emplace_back("AlgebraicSimplify");
+  options.program_passes.emplace_back("CommonSubexpressionElimination");
   options.program_passes.emplace_back("RemoveIdentity");
   options.program_passes.emplace_back("DeadCodeEliminate");
   if (FLAGS_cinn_open_fusion_optimize) {
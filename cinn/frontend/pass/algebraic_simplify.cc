@@ -0,0 +1,359 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "cinn/frontend/cinn_builder.h"
+#include "cinn/frontend/program_pass.h"
+#include "glog/logging.h"
+
+namespace cinn {
+namespace frontend {
+namespace pass {
+
+namespace {
+
+// The producers of the variables, which have been simplified when the consumer is visited.
+using OutputToInstrMap = std::unordered_map<std::string, Instruction>;
+
+template <typename T>
+T GetAttrOrDefault(const Instruction& instr, const std::string& name, T def) {
+  if (!instr->attrs.count(name)) {
+    return def;
+  }
+  return instr.GetAttrs<T>(name);
+}
+
+const Instruction* GetProducer(const OutputToInstrMap& out2instr, const Variable& var, const std::string& op_type) {
+  auto iter = out2instr.find(var->id);
+  if (iter == out2instr.end() || iter->second->op_type != op_type) {
+    return nullptr;
+  }
+  return &iter->second;
+}
+
+void ReplaceWithIdentity(Instruction* instr, const Variable& input) {
+  (*instr)->op_type = "identity";
+  (*instr)->inputs  = {input};
+  (*instr)->attrs.clear();
+  (*instr)->attrs_ordered.clear();
+}
+
+bool IsFillConstantOf(const OutputToInstrMap& out2instr, const Variable& var, float value) {
+  auto* constant = GetProducer(out2instr, var, "fill_constant");
+  return constant && constant->GetAttrs<float>("value") == value;
+}
+
+// x * 1, 1 * x, x + 0, 0 + x, x - 0 and x / 1 => x, if the shape of x is the shape of the output.
+bool SimplifyBinaryIdentity(Instruction* instr, const OutputToInstrMap& out2instr, float value, bool commutative) {
+  const auto& out = (*instr)->outputs[0];
+  for (int i = 0; i < 2; ++i) {
+    if (i == 0 && !commutative) {
+      continue;
+    }
+    const auto& constant = (*instr)->inputs[i];
+    const auto& other    = (*instr)->inputs[1 - i];
+    if (IsFillConstantOf(out2instr, constant, value) && other->shape == out->shape && other->type == out->type) {
+      ReplaceWithIdentity(instr, other);
+      return true;
+    }
+  }
+  return false;
+}
+
+// scale(scale(x)) => scale(x), scale(x, scale=1, bias=0) => x
+bool SimplifyScale(Instruction* instr, const OutputToInstrMap& out2instr) {
+  bool changed = false;
+  auto* inner  = GetProducer(out2instr, (*instr)->inputs[0], "scale");
+  if (inner) {
+    // y = s0 * x + b0, z = s1 * y + b1 => z = (s0 * s1) * x + (s1 * b0 + b1)
+    float s0 = inner->GetAttrs<float>("scale");
+    float b0 = inner->GetAttrs<float>("bias");
+    float s1 = instr->GetAttrs<float>("scale");
+    float b1 = instr->GetAttrs<float>("bias");
+    if (!GetAttrOrDefault<bool>(*inner, "bias_after_scale", true)) {
+      b0 *= s0;
+    }
+    if (!GetAttrOrDefault<bool>(*instr, "bias_after_scale", true)) {
+      b1 *= s1;
+    }
+    (*instr)->inputs[0] = (*inner)->inputs[0];
+    instr->SetAttr("scale", s0 * s1);
+    instr->SetAttr("bias", s1 * b0 + b1);
+    instr->SetAttr("bias_after_scale", true);
+    changed = true;
+  }
+  if (instr->GetAttrs<float>("scale") == 1.0f && instr->GetAttrs<float>("bias") == 0.0f) {
+    ReplaceWithIdentity(instr, (*instr)->inputs[0]);
+    changed = true;
+  }
+  return changed;
+}
+
+// Whether every value of `from` can be represented by `to` exactly.
+bool IsLosslessCast(const common::Type& from, const common::Type& to) {
+  if (from == to || from.is_bool()) {
+    return true;
+  }
+  if (from.is_float() && to.is_float()) {
+    return to.bits() >= from.bits();
+  }
+  if ((from.is_int() || from.is_uint()) && (to.is_int() || to.is_uint())) {
+    if (from.is_int() && to.is_uint()) {
+      return false;
+    }
+    // a signed type needs one more bit for the unsigned values
+    return to.bits() > from.bits() || (to.bits() == from.bits() && from.is_int() == to.is_int());
+  }
+  if ((from.is_int() || from.is_uint()) && to.is_float()) {
+    // the mantissa of float16/float32/float64 holds 11/24/53 bits
+    int mantissa_bits = to.bits() == 16 ? 11 : (to.bits() == 32 ? 24 : 53);
+    return from.bits() <= mantissa_bits;
+  }
+  return false;
+}
+
+// cast(cast(x)) => cast(x) if the inner cast is lossless, cast(x) => x if the dtype is unchanged.
+bool SimplifyCast(Instruction* instr, const OutputToInstrMap& out2instr) {
+  bool changed = false;
+  auto* inner  = GetProducer(out2instr, (*instr)->inputs[0], "cast");
+  if (inner && IsLosslessCast((*inner)->inputs[0]->type, (*inner)->outputs[0]->type)) {
+    (*instr)->inputs[0] = (*inner)->inputs[0];
+    changed             = true;
+  }
+  if ((*instr)->inputs[0]->type == (*instr)->outputs[0]->type) {
+    ReplaceWithIdentity(instr, (*instr)->inputs[0]);
+    changed = true;
+  }
+  return changed;
+}
+
+// reshape(reshape(x)) => reshape(x)
+bool SimplifyReshape(Instruction* instr, const OutputToInstrMap& out2instr) {
+  auto* inner = GetProducer(out2instr, (*instr)->inputs[0], "reshape");
+  if (!inner) {
+    return false;
+  }
+  (*instr)->inputs[0] = (*inner)->inputs[0];
+  // the 0 and -1 in the shape were resolved against the inner reshape's output, which is bypassed now
+  instr->SetAttr("shape", (*instr)->outputs[0]->shape);
+  return true;
+}
+
+// reduce(transpose(x, perm), dim) => reduce(x, perm[dim]), if the kept axes are in the same order after the transpose.
+bool SimplifyTransposeReduce(Instruction* instr, const OutputToInstrMap& out2instr) {
+  auto* transpose = GetProducer(out2instr, (*instr)->inputs[0], "transpose");
+  if (!transpose) {
+    return false;
+  }
+  auto perm     = transpose->GetAttrs<std::vector<int>>("axis");
+  auto dim      = instr->GetAttrs<std::vector<int>>("dim");
+  bool keep_dim = GetAttrOrDefault<bool>(*instr, "keep_dim", false);
+  int rank      = perm.size();
+  // an empty dim means reducing all the axes
+  if (!dim.empty()) {
+    if (keep_dim) {
+      // the positions of the reduced axes of size 1 would be changed
+      return false;
+    }
+    std::vector<bool> reduced(rank, false);
+    for (auto d : dim) {
+      reduced[d < 0 ? d + rank : d] = true;
+    }
+    int last = -1;
+    for (int i = 0; i < rank; ++i) {
+      if (reduced[i]) {
+        continue;
+      }
+      if (perm[i] < last) {
+        return false;
+      }
+      last = perm[i];
+    }
+    std::vector<int> new_dim;
+    for (auto d : dim) {
+      new_dim.push_back(perm[d < 0 ? d + rank : d]);
+    }
+    std::sort(new_dim.begin(), new_dim.end());
+    instr->SetAttr("dim", new_dim);
+  }
+  (*instr)->inputs[0] = (*transpose)->inputs[0];
+  return true;
+}
+
+// elementwise(x, broadcast_to(y)) => elementwise(x, y), if y is broadcast along the leading axes, which the
+// elementwise op does by itself.
+bool SimplifyBroadcastElementwise(Instruction* instr, const OutputToInstrMap& out2instr) {
+  auto* broadcast = GetProducer(out2instr, (*instr)->inputs[1], "broadcast_to");
+  if (!broadcast || GetAttrOrDefault<int>(*instr, "axis", -1) != -1) {
+    return false;
+  }
+  const auto& out_shape = (*instr)->outputs[0]->shape;
+  const auto& x_shape   = (*instr)->inputs[0]->shape;
+  const auto& y_shape   = (*broadcast)->inputs[0]->shape;
+  if (x_shape != out_shape || (*instr)->inputs[1]->shape != out_shape || y_shape.size() > out_shape.size()) {
+    return false;
+  }
+  auto broadcast_axes = broadcast->GetAttrs<std::vector<int>>("broadcast_axes");
+  int offset          = out_shape.size() - y_shape.size();
+  for (int i = 0; i < y_shape.size(); ++i) {
+    if (broadcast_axes[i] != offset + i || (y_shape[i] != 1 && y_shape[i] != out_shape[offset + i])) {
+      return false;
+    }
+  }
+  (*instr)->inputs[1] = (*broadcast)->inputs[0];
+  return true;
+}
+
+// slice(concat(x0, x1, ...)) => slice(xi) or xi, if the slice only reads xi.
+bool SimplifySliceConcat(Instruction* instr, const OutputToInstrMap& out2instr) {
+  auto* concat = GetProducer(out2instr, (*instr)->inputs[0], "concat");
+  if (!concat) {
+    return false;
+  }
+  auto axes          = instr->GetAttrs<std::vector<int>>("axes");
+  auto starts        = instr->GetAttrs<std::vector<int>>("starts");
+  auto ends          = instr->GetAttrs<std::vector<int>>("ends");
+  auto strides       = GetAttrOrDefault<std::vector<int>>(*instr, "strides", {});
+  auto decrease_axis = GetAttrOrDefault<std::vector<int>>(*instr, "decrease_axis", {});
+  if (axes.size() != 1U || !decrease_axis.empty() ||
+      std::any_of(strides.begin(), strides.end(), [](int stride) { return stride != 1; })) {
+    return false;
+  }
+  const auto& concat_shape = (*concat)->outputs[0]->shape;
+  int rank                 = concat_shape.size();
+  int axis                 = GetAttrOrDefault<int>(*concat, "axis", 0);
+  axis                     = axis < 0 ? axis + rank : axis;
+  int slice_axis           = axes[0] < 0 ? axes[0] + rank : axes[0];
+  if (axis != slice_axis) {
+    return false;
+  }
+  int dim   = concat_shape[axis];
+  int start = starts[0] < 0 ? starts[0] + dim : std::min(starts[0], dim);
+  int end   = ends[0] < 0 ? ends[0] + dim : std::min(ends[0], dim);
+  if (start >= end) {
+    return false;
+  }
+  int offset = 0;
+  for (const auto& in : (*concat)->inputs) {
+    int size = in->shape[axis];
+    if (offset <= start && end <= offset + size) {
+      if (start == offset && end == offset + size) {
+        ReplaceWithIdentity(instr, in);
+      } else {
+        (*instr)->inputs[0] = in;
+        instr->SetAttr("starts", std::vector<int>{start - offset});
+        instr->SetAttr("ends", std::vector<int>{end - offset});
+      }
+      return true;
+    }
+    offset += size;
+  }
+  return false;
+}
+
+struct AlgebraicRule {
+  // the name of the rule, only used for logging
+  std::string name;
+  // the op type of the instruction to be simplified
+  std::string op_type;
+  // rewrite the instruction in place, return true if it is changed
+  std::function<bool(Instruction*, const OutputToInstrMap&)> simplify;
+};
+
+// The rule table, the rules of the same op type are applied in order.
+const std::vector<AlgebraicRule>& GetAlgebraicRules() {
+  using namespace std::placeholders;  // NOLINT
+  static const std::vector<AlgebraicRule> rules = {
+      {"x*1=>x", "elementwise_mul", std::bind(SimplifyBinaryIdentity, _1, _2, 1.0f, true)},
+      {"x+0=>x", "elementwise_add", std::bind(SimplifyBinaryIdentity, _1, _2, 0.0f, true)},
+      {"x-0=>x", "substract", std::bind(SimplifyBinaryIdentity, _1, _2, 0.0f, false)},
+      {"x/1=>x", "divide", std::bind(SimplifyBinaryIdentity, _1, _2, 1.0f, false)},
+      {"scale(scale(x))=>scale(x)", "scale", SimplifyScale},
+      {"cast(cast(x))=>cast(x)", "cast", SimplifyCast},
+      {"reshape(reshape(x))=>reshape(x)", "reshape", SimplifyReshape},
+      {"reduce(transpose(x))=>reduce(x)", "reduce_sum", SimplifyTransposeReduce},
+      {"reduce(transpose(x))=>reduce(x)", "reduce_prod", SimplifyTransposeReduce},
+      {"reduce(transpose(x))=>reduce(x)", "reduce_max", SimplifyTransposeReduce},
+      {"reduce(transpose(x))=>reduce(x)", "reduce_min", SimplifyTransposeReduce},
+      {"reduce(transpose(x))=>reduce(x)", "reduce_all", SimplifyTransposeReduce},
+      {"reduce(transpose(x))=>reduce(x)", "reduce_any", SimplifyTransposeReduce},
+      {"x+broadcast_to(y)=>x+y", "elementwise_add", SimplifyBroadcastElementwise},
+      {"x*broadcast_to(y)=>x*y", "elementwise_mul", SimplifyBroadcastElementwise},
+      {"x-broadcast_to(y)=>x-y", "substract", SimplifyBroadcastElementwise},
+      {"x/broadcast_to(y)=>x/y", "divide", SimplifyBroadcastElementwise},
+      {"max(x,broadcast_to(y))=>max(x,y)", "max", SimplifyBroadcastElementwise},
+      {"min(x,broadcast_to(y))=>min(x,y)", "min", SimplifyBroadcastElementwise},
+      {"slice(concat(x...))=>slice(xi)", "slice", SimplifySliceConcat},
+  };
+  return rules;
+}
+
+}  // namespace
+
+// AlgebraicSimplifyPass rewrites the arithmetic identities listed in the rule table of `GetAlgebraicRules`, such as
+// x * 1, scale(scale(x)) and slice(concat(x0, x1)). The instructions are visited in program order, so the producers
+// have been simplified when a consumer is matched, and a chain like scale(scale(scale(x))) is collapsed in one
+// visit. A simplified instruction either bypasses its producer, or becomes an identity which will be removed by
+// RemoveIdentityPass. The producers which are no longer used will be removed by DeadCodeEliminatePass.
+class AlgebraicSimplifyPass : public ProgramPass {
+ public:
+  using ProgramPass::ProgramPass;
+
+ protected:
+  void ApplyImpl(Program* program,
+                 const std::unordered_set<std::string>& fetch_ids,
+                 const common::Target& target) override {
+    std::unordered_map<std::string, std::vector<const AlgebraicRule*>> rules;
+    for (const auto& rule : GetAlgebraicRules()) {
+      rules[rule.op_type].push_back(&rule);
+    }
+
+    int num_simplified = 0;
+    OutputToInstrMap out2instr;
+    for (int i = 0; i < program->size(); ++i) {
+      auto& instr = (*program)[i];
+      if (rules.count(instr->op_type)) {
+        for (auto* rule : rules.at(instr->op_type)) {
+          // a rule may change the op type to identity
+          if (instr->op_type != rule->op_type) {
+            break;
+          }
+          if (rule->simplify(&instr, out2instr)) {
+            VLOG(3) << "Simplify the " << i << "-th instruction by rule [" << rule->name << "]: " << instr;
+            num_simplified++;
+          }
+        }
+      }
+      for (const auto& out : instr->outputs) {
+        out2instr.emplace(out->id, instr);
+      }
+    }
+    VLOG(3) << "Total simplify " << num_simplified << " instructions.";
+  }
+};
+
+}  // namespace pass
+}  // namespace frontend
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(AlgebraicSimplify) {
+  CINN_REGISTER_PROGRAM_PASS(AlgebraicSimplify, cinn::frontend::pass::AlgebraicSimplifyPass);
+
+  return true;
+}
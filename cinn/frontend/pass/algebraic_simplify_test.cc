@@ -0,0 +1,196 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "cinn/frontend/pass/test_helper.h"
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/tensor.h"
+#include "cinn/hlir/op/use_ops.h"
+
+namespace cinn::frontend {
+
+const std::vector<std::string> kAlgebraicSimplifyPasses = {"AlgebraicSimplify", "RemoveIdentity", "DeadCodeEliminate"};
+
+TEST(AlgebraicSimplify, multiply_one_add_zero) {
+  //         <x>   fill_constant(1)
+  //           \    /
+  //      elementwise_mul   fill_constant(0)
+  //                  \      /
+  //              elementwise_add
+  //                     |
+  //                   relu
+  NetBuilder builder("net_builder");
+  auto x      = builder.CreateInput(Float(32), {32, 16}, "x");
+  auto one    = builder.FillConstant<float>({32, 16}, 1.0f, "one");
+  auto zero   = builder.FillConstant<float>({32, 16}, 0.0f, "zero");
+  auto mul_1  = builder.ElementwiseMul(x, one);
+  auto add_1  = builder.ElementwiseAdd(zero, mul_1);
+  auto relu_1 = builder.Relu(add_1);
+
+  PassTest tester;
+  std::vector<std::string> input_names  = {x.id().data()};
+  std::vector<std::string> output_names = {relu_1->id};
+  int num_removed_ops = tester.RunAndCheck(builder, kAlgebraicSimplifyPasses, input_names, output_names);
+  ASSERT_EQ(num_removed_ops, 4);
+}
+
+TEST(AlgebraicSimplify, scale_scale) {
+  //      <x>
+  //       |
+  //  scale(2.0)
+  //       |
+  //  scale(0.5)
+  //       |
+  //     relu
+  NetBuilder builder("net_builder");
+  auto x       = builder.CreateInput(Float(32), {32, 16}, "x");
+  auto scale_1 = builder.Scale(x, 2.0f, 0.0f);
+  auto scale_2 = builder.Scale(scale_1, 0.5f, 0.0f);
+  auto relu_1  = builder.Relu(scale_2);
+
+  PassTest tester;
+  std::vector<std::string> input_names  = {x.id().data()};
+  std::vector<std::string> output_names = {relu_1->id};
+  int num_removed_ops = tester.RunAndCheck(builder, kAlgebraicSimplifyPasses, input_names, output_names);
+  ASSERT_EQ(num_removed_ops, 2);
+}
+
+TEST(AlgebraicSimplify, cast_cast) {
+  //      <x>
+  //       |
+  //  cast(float64)
+  //       |
+  //  cast(float32)
+  //       |
+  //     relu
+  NetBuilder builder("net_builder");
+  auto x      = builder.CreateInput(Float(32), {32, 16}, "x");
+  auto cast_1 = builder.Cast(x, "float64");
+  auto cast_2 = builder.Cast(cast_1, "float32");
+  auto relu_1 = builder.Relu(cast_2);
+
+  PassTest tester;
+  std::vector<std::string> input_names  = {x.id().data()};
+  std::vector<std::string> output_names = {relu_1->id};
+  int num_removed_ops = tester.RunAndCheck(builder, kAlgebraicSimplifyPasses, input_names, output_names);
+  ASSERT_EQ(num_removed_ops, 2);
+}
+
+TEST(AlgebraicSimplify, reshape_reshape) {
+  NetBuilder builder("net_builder");
+  auto x         = builder.CreateInput(Float(32), {32, 16}, "x");
+  auto reshape_1 = builder.Reshape(x, {4, 8, 16});
+  auto reshape_2 = builder.Reshape(reshape_1, {16, 32});
+  auto relu_1    = builder.Relu(reshape_2);
+
+  PassTest tester;
+  std::vector<std::string> input_names  = {x.id().data()};
+  std::vector<std::string> output_names = {relu_1->id};
+  int num_removed_ops = tester.RunAndCheck(builder, kAlgebraicSimplifyPasses, input_names, output_names);
+  ASSERT_EQ(num_removed_ops, 1);
+}
+
+TEST(AlgebraicSimplify, reshape_reshape_inferred_shape) {
+  NetBuilder builder("net_builder");
+  auto x         = builder.CreateInput(Float(32), {32, 16}, "x");
+  auto reshape_1 = builder.Reshape(x, {4, 8, 16});
+  // resolved to [4, 128] against the output of reshape_1, but to [32, 16] against x
+  auto reshape_2 = builder.Reshape(reshape_1, {0, -1});
+  auto reduce_1  = builder.ReduceSum(reshape_2, {1});
+  ASSERT_EQ(reshape_2->shape, std::vector<int>({4, 128}));
+
+  PassTest tester;
+  std::vector<std::string> input_names  = {x.id().data()};
+  std::vector<std::string> output_names = {reduce_1->id};
+  int num_removed_ops = tester.RunAndCheck(builder, kAlgebraicSimplifyPasses, input_names, output_names);
+  ASSERT_EQ(num_removed_ops, 1);
+}
+
+TEST(AlgebraicSimplify, transpose_reduce) {
+  //          <x>
+  //           |
+  //  transpose([0, 2, 1])
+  //           |
+  //    reduce_sum([2])   =>   reduce_sum([1])
+  NetBuilder builder("net_builder");
+  auto x            = builder.CreateInput(Float(32), {4, 8, 16}, "x");
+  auto transpose_1  = builder.Transpose(x, {0, 2, 1});
+  auto reduce_sum_1 = builder.ReduceSum(transpose_1, {2});
+
+  PassTest tester;
+  std::vector<std::string> input_names  = {x.id().data()};
+  std::vector<std::string> output_names = {reduce_sum_1->id};
+  int num_removed_ops = tester.RunAndCheck(builder, kAlgebraicSimplifyPasses, input_names, output_names);
+  ASSERT_EQ(num_removed_ops, 1);
+}
+
+TEST(AlgebraicSimplify, transpose_reduce_reordered) {
+  // The kept axes [2, 1] are reordered by the transpose, so it can not be simplified.
+  NetBuilder builder("net_builder");
+  auto x            = builder.CreateInput(Float(32), {4, 8, 16}, "x");
+  auto transpose_1  = builder.Transpose(x, {0, 2, 1});
+  auto reduce_sum_1 = builder.ReduceSum(transpose_1, {0});
+
+  PassTest tester;
+  std::vector<std::string> input_names  = {x.id().data()};
+  std::vector<std::string> output_names = {reduce_sum_1->id};
+  int num_removed_ops = tester.RunAndCheck(builder, kAlgebraicSimplifyPasses, input_names, output_names);
+  ASSERT_EQ(num_removed_ops, 0);
+}
+
+TEST(AlgebraicSimplify, broadcast_elementwise) {
+  //   <x>     <bias>
+  //    |        |
+  //    |   broadcast_to
+  //     \      /
+  //  elementwise_add
+  NetBuilder builder("net_builder");
+  auto x           = builder.CreateInput(Float(32), {4, 16}, "x");
+  auto bias        = builder.CreateInput(Float(32), {16}, "bias");
+  auto broadcast_1 = builder.BroadcastTo(bias, {4, 16}, {1});
+  auto add_1       = builder.ElementwiseAdd(x, broadcast_1);
+
+  PassTest tester;
+  std::vector<std::string> input_names  = {x.id().data(), bias.id().data()};
+  std::vector<std::string> output_names = {add_1->id};
+  int num_removed_ops = tester.RunAndCheck(builder, kAlgebraicSimplifyPasses, input_names, output_names);
+  ASSERT_EQ(num_removed_ops, 1);
+}
+
+TEST(AlgebraicSimplify, slice_concat) {
+  //        <x>   <y>
+  //          \   /
+  //         concat
+  //         /    \
+  //  slice(y)   slice(x[2:6])
+  //      |          |
+  //     relu       relu
+  NetBuilder builder("net_builder");
+  auto x        = builder.CreateInput(Float(32), {8, 16}, "x");
+  auto y        = builder.CreateInput(Float(32), {8, 16}, "y");
+  auto concat_1 = builder.Concat({x, y}, 0);
+  auto slice_1  = builder.Slice(concat_1, {0}, {8}, {16});
+  auto slice_2  = builder.Slice(concat_1, {0}, {2}, {6});
+  auto relu_1   = builder.Relu(slice_1);
+  auto relu_2   = builder.Relu(slice_2);
+
+  PassTest tester;
+  std::vector<std::string> input_names  = {x.id().data(), y.id().data()};
+  std::vector<std::string> output_names = {relu_1->id, relu_2->id};
+  int num_removed_ops = tester.RunAndCheck(builder, kAlgebraicSimplifyPasses, input_names, output_names);
+  ASSERT_EQ(num_removed_ops, 2);
+}
+
+}  // namespace cinn::frontend
@@ -0,0 +1,305 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "cinn/frontend/cinn_builder.h"
+#include "cinn/frontend/program_pass.h"
+#include "glog/logging.h"
+
+namespace cinn {
+namespace frontend {
+namespace pass {
+
+// Rewrite the scaled dot product attention
+//
+//        <q>   <k>
+//          \   /
+//   matmul(trans_b=true)
+//            |
+//        [reshape]
+//            |
+//     [scale(bias=0)]     <mask>
+//             \           /
+//           [elementwise_add]
+//                  |
+//           softmax(axis=-1)    <v>
+//                     \         /
+//                  matmul(no transpose)
+//                          |
+//                      [reshape]
+//
+// into one attention instruction, which is lowered to the blocked online-softmax kernel on CPU and never materializes
+// the [seq_q, seq_k] scores. The instructions in brackets are optional, and every intermediate variable should be
+// used only once and not be fetched.
+class AttentionRewriterPass : public ProgramPass {
+ public:
+  using ProgramPass::ProgramPass;
+
+ protected:
+  void ApplyImpl(Program* program,
+                 const std::unordered_set<std::string>& fetch_ids,
+                 const common::Target& target) override {
+    if (target.arch != Target::Arch::X86 || !program->size()) {
+      return;
+    }
+    CollectInfo(*program);
+
+    for (int i = 0; i < program->size(); ++i) {
+      auto& instr = (*program)[i];
+      if (instr->op_type == "softmax" && !removed_instrs_.count(instr.get())) {
+        RewriteAttention(instr, fetch_ids);
+      }
+    }
+
+    if (!replaced_instrs_.empty()) {
+      VLOG(3) << "Rewrite " << replaced_instrs_.size() << " attention patterns, before rewriting: " << *program;
+      CinnBuilder builder("attention_rewriter_builder");
+      for (auto& var : program->GetInputs()) {
+        builder.CreateInput(var);
+      }
+      for (int i = 0; i < program->size(); ++i) {
+        auto& instr = (*program)[i];
+        if (replaced_instrs_.count(instr.get())) {
+          builder.AppendInstruction(replaced_instrs_.at(instr.get()));
+        } else if (!removed_instrs_.count(instr.get())) {
+          builder.AppendInstruction(instr);
+        }
+      }
+      *program = builder.Build();
+      VLOG(3) << "After rewriting: " << *program;
+    }
+    ClearResources();
+  }
+
+ private:
+  void CollectInfo(const Program& program) {
+    for (int i = 0; i < program.size(); ++i) {
+      auto& instr = program[i];
+      for (auto& var : instr->outputs) {
+        output2instr_.emplace(var.get(), instr);
+      }
+      for (auto& var : instr->inputs) {
+        var_used_count_[var.get()]++;
+        input2instr_.erase(var.get());
+        input2instr_.emplace(var.get(), instr);
+      }
+    }
+  }
+
+  template <typename T>
+  static T GetAttrOrDefault(const Instruction& instr, const std::string& key, T default_value) {
+    return instr->attrs.count(key) ? instr.GetAttrs<T>(key) : default_value;
+  }
+
+  // Whether the variable is only used by the next instruction of the pattern.
+  bool IsIntermediate(const Variable& var, const std::unordered_set<std::string>& fetch_ids) const {
+    return var_used_count_.count(var.get()) && var_used_count_.at(var.get()) == 1 && !fetch_ids.count(var->id);
+  }
+
+  // Whether the extra outputs, such as the tuple output of the extern matmul and the temp output of softmax, are
+  // unused.
+  bool ExtraOutputsUnused(const Instruction& instr, const std::unordered_set<std::string>& fetch_ids) const {
+    for (int i = 1; i < instr->outputs.size(); ++i) {
+      auto& var = instr->outputs[i];
+      if (var_used_count_.count(var.get()) || fetch_ids.count(var->id)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  const Instruction* Producer(const Variable& var) const {
+    auto it = output2instr_.find(var.get());
+    return it == output2instr_.end() ? nullptr : &it->second;
+  }
+
+  const Instruction* Consumer(const Variable& var) const {
+    auto it = input2instr_.find(var.get());
+    return it == input2instr_.end() ? nullptr : &it->second;
+  }
+
+  // The mask is right aligned to the scores, its dimensions should be 1 or the same as the scores', except that the
+  // last dimension should be seq_k.
+  static bool IsBroadcastableMask(const Variable& mask, const Variable& scores, int axis) {
+    const auto& mask_shape   = mask->shape;
+    const auto& scores_shape = scores->shape;
+    int offset               = static_cast<int>(scores_shape.size()) - static_cast<int>(mask_shape.size());
+    if (mask_shape.size() < 2U || offset < 0 || (axis != -1 && axis != offset) || mask->type != scores->type) {
+      return false;
+    }
+    for (int i = 0; i < mask_shape.size(); ++i) {
+      if (mask_shape[i] != scores_shape[offset + i] && (mask_shape[i] != 1 || i + 1 == mask_shape.size())) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void RewriteAttention(const Instruction& softmax, const std::unordered_set<std::string>& fetch_ids) {
+    auto scores = softmax->inputs[0];
+    int rank    = scores->shape.size();
+    int axis    = GetAttrOrDefault<int>(softmax, "axis", -1);
+    if ((axis != -1 && axis != rank - 1) || !ExtraOutputsUnused(softmax, fetch_ids)) {
+      return;
+    }
+    std::vector<const Instruction*> pattern{&softmax};
+
+    // softmax -> matmul(probs, v) -> [reshape]
+    const auto& probs  = softmax->outputs[0];
+    const auto* matmul = Consumer(probs);
+    if (!IsIntermediate(probs, fetch_ids) || !matmul || (*matmul)->op_type != "matmul" ||
+        (*matmul)->inputs[0].get() != probs.get() || GetAttrOrDefault<bool>(*matmul, "trans_a", false) ||
+        GetAttrOrDefault<bool>(*matmul, "trans_b", false) || GetAttrOrDefault<float>(*matmul, "alpha", 1.f) != 1.f ||
+        !ExtraOutputsUnused(*matmul, fetch_ids)) {
+      return;
+    }
+    pattern.push_back(matmul);
+    auto v              = (*matmul)->inputs[1];
+    auto out            = (*matmul)->outputs[0];
+    const auto* last    = matmul;
+    const auto* reshape = Consumer(out);
+    if (IsIntermediate(out, fetch_ids) && reshape && (*reshape)->op_type == "reshape") {
+      pattern.push_back(reshape);
+      out  = (*reshape)->outputs[0];
+      last = reshape;
+    }
+
+    // [elementwise_add(scores, mask)] <- softmax
+    Variable mask;
+    bool has_mask   = false;
+    const auto* add = Producer(scores);
+    if (add && (*add)->op_type == "elementwise_add" && IsIntermediate(scores, fetch_ids)) {
+      int add_axis = GetAttrOrDefault<int>(*add, "axis", -1);
+      for (int i = 0; i < 2; ++i) {
+        auto& lhs = (*add)->inputs[i];
+        auto& rhs = (*add)->inputs[1 - i];
+        if (lhs->shape == scores->shape && Producer(lhs) && IsBroadcastableMask(rhs, scores, add_axis)) {
+          pattern.push_back(add);
+          mask     = rhs;
+          has_mask = true;
+          scores   = lhs;
+          break;
+        }
+      }
+    }
+
+    // matmul(q, k^T) -> [reshape] -> [scale] <- elementwise_add/softmax
+    float scale = 1.f;
+    for (const auto* instr = Producer(scores); instr && IsIntermediate(scores, fetch_ids); instr = Producer(scores)) {
+      const auto& op_type = (*instr)->op_type;
+      if (op_type == "scale" && GetAttrOrDefault<float>(*instr, "bias", 0.f) == 0.f) {
+        scale *= GetAttrOrDefault<float>(*instr, "scale", 1.f);
+      } else if (op_type != "reshape") {
+        break;
+      }
+      pattern.push_back(instr);
+      scores = (*instr)->inputs[0];
+    }
+    const auto* qk = Producer(scores);
+    if (!qk || (*qk)->op_type != "matmul" || !IsIntermediate(scores, fetch_ids) ||
+        GetAttrOrDefault<bool>(*qk, "trans_a", false) || !GetAttrOrDefault<bool>(*qk, "trans_b", false) ||
+        !ExtraOutputsUnused(*qk, fetch_ids)) {
+      return;
+    }
+    pattern.push_back(qk);
+    scale *= GetAttrOrDefault<float>(*qk, "alpha", 1.f);
+    auto q = (*qk)->inputs[0];
+    auto k = (*qk)->inputs[1];
+
+    if (!IsAttentionShape(q, k, v, softmax->inputs[0], out) || q->type != Float(32) || k->type != q->type ||
+        v->type != q->type) {
+      return;
+    }
+    for (const auto* instr : pattern) {
+      if (removed_instrs_.count(instr->get())) {
+        return;
+      }
+    }
+
+    std::vector<Variable> inputs{q, k, v};
+    if (has_mask) {
+      inputs.push_back(mask);
+    }
+    Instruction attention("attention", inputs);
+    attention.SetAttr("scale", scale);
+    attention.SetAttr("causal", false);
+    // reuse the output variable so that the consumers and the fetched variables are kept
+    Variable tuple;
+    tuple->type        = out->type;
+    tuple->shape       = {1};
+    attention->outputs = {out, tuple};
+    VLOG(4) << "Rewrite " << pattern.size() << " instructions into " << attention;
+
+    for (const auto* instr : pattern) {
+      removed_instrs_.insert(instr->get());
+    }
+    replaced_instrs_.emplace(last->get(), attention);
+  }
+
+  // q, k and v are [..., seq_q, head_dim], [..., seq_k, head_dim] and [..., seq_k, value_dim] with the same leading
+  // dimensions, the softmax input is [..., seq_q, seq_k] and the output is [..., seq_q, value_dim].
+  static bool IsAttentionShape(
+      const Variable& q, const Variable& k, const Variable& v, const Variable& scores, const Variable& out) {
+    int rank = q->shape.size();
+    if ((rank != 3 && rank != 4) || k->shape.size() != rank || v->shape.size() != rank) {
+      return false;
+    }
+    std::vector<int> leading(q->shape.begin(), q->shape.end() - 2);
+    if (!std::equal(leading.begin(), leading.end(), k->shape.begin()) ||
+        !std::equal(leading.begin(), leading.end(), v->shape.begin()) || q->shape[rank - 1] != k->shape[rank - 1] ||
+        k->shape[rank - 2] != v->shape[rank - 2]) {
+      return false;
+    }
+    std::vector<int> scores_shape = leading;
+    scores_shape.push_back(q->shape[rank - 2]);
+    scores_shape.push_back(k->shape[rank - 2]);
+    std::vector<int> out_shape = leading;
+    out_shape.push_back(q->shape[rank - 2]);
+    out_shape.push_back(v->shape[rank - 1]);
+    return scores->shape == scores_shape && out->shape == out_shape;
+  }
+
+  void ClearResources() {
+    removed_instrs_.clear();
+    replaced_instrs_.clear();
+    output2instr_.clear();
+    input2instr_.clear();
+    var_used_count_.clear();
+  }
+
+ private:
+  std::unordered_set<_Instruction_*> removed_instrs_;
+  // the last instruction of a pattern -> the attention instruction
+  std::unordered_map<_Instruction_*, Instruction> replaced_instrs_;
+  std::unordered_map<_Variable_*, Instruction> output2instr_;
+  // only valid for the variables used once
+  std::unordered_map<_Variable_*, Instruction> input2instr_;
+  std::unordered_map<_Variable_*, int> var_used_count_;
+};
+
+}  // namespace pass
+}  // namespace frontend
+}  // namespace cinn
+
+namespace fp = ::cinn::frontend::pass;
+CINN_REGISTER_HELPER(AttentionRewriter) {
+  CINN_REGISTER_PROGRAM_PASS(AttentionRewriter, fp::AttentionRewriterPass);
+
+  return true;
+}
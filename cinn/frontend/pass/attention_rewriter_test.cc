@@ -0,0 +1,109 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/pass/pass_test_helper.h"
+
+namespace cinn::frontend {
+
+// Run the program before and after AttentionRewriter and compare the outputs, the fused kernel normalizes the softmax
+// online, so the outputs are compared with a tolerance. Return the number of removed instructions.
+int RunAndCompare(NetBuilder* builder, const std::vector<std::string>& input_ids, const std::string& output_id) {
+  auto program = builder->Build();
+  auto target  = common::DefaultHostTarget();
+
+  auto origin_size = program.size();
+  auto origin_out  = RunProgram(program, target, input_ids, {output_id}, {}, 123);
+
+  ProgramPass::Apply(&program, {output_id}, target, {"AttentionRewriter"});
+  auto fused_size = program.size();
+  auto fused_out  = RunProgram(program, target, input_ids, {output_id}, {}, 123);
+
+  EXPECT_EQ(origin_out.size(), fused_out.size());
+  for (size_t i = 0; i < origin_out.size() && i < fused_out.size(); ++i) {
+    EXPECT_NEAR(origin_out[i], fused_out[i], 1e-4 * std::max(1.f, std::abs(origin_out[i]))) << " i is " << i;
+  }
+  return origin_size - fused_size;
+}
+
+TEST(AttentionRewriter, basic) {
+  //    <q>   <k>
+  //      \   /
+  //     matmul
+  //        |
+  //     softmax   <v>
+  //          \    /
+  //          matmul
+  NetBuilder builder("net_builder");
+  auto q      = builder.CreateInput(Float(32), {4, 40, 16}, "q");
+  auto k      = builder.CreateInput(Float(32), {4, 150, 16}, "k");
+  auto v      = builder.CreateInput(Float(32), {4, 150, 24}, "v");
+  auto scores = builder.Matmul(q, k, false, true, 0.01f);
+  auto probs  = builder.Softmax(scores);
+  auto out    = builder.Matmul(probs, v);
+
+  ASSERT_EQ(RunAndCompare(&builder, {"q", "k", "v"}, out->id), 2);
+}
+
+TEST(AttentionRewriter, multi_head_with_mask) {
+  //    <q>   <k>
+  //      \   /
+  //     matmul
+  //        |
+  //     reshape
+  //        |
+  //      scale    <mask>
+  //         \     /
+  //   elementwise_add
+  //          |
+  //       softmax    <v>
+  //            \     /
+  //            matmul
+  //               |
+  //            reshape
+  NetBuilder builder("net_builder");
+  auto q      = builder.CreateInput(Float(32), {2, 4, 40, 16}, "q");
+  auto k      = builder.CreateInput(Float(32), {2, 4, 150, 16}, "k");
+  auto v      = builder.CreateInput(Float(32), {2, 4, 150, 24}, "v");
+  auto mask   = builder.CreateInput(Float(32), {2, 1, 1, 150}, "mask");
+  auto scores = builder.Matmul(q, k, false, true);
+  auto scaled = builder.Scale(scores, 0.01f);
+  auto masked = builder.ElementwiseAdd(scaled, mask);
+  auto probs  = builder.Softmax(masked);
+  auto out    = builder.Matmul(probs, v);
+
+  ASSERT_EQ(RunAndCompare(&builder, {"q", "k", "v", "mask"}, out->id), 6);
+}
+
+TEST(AttentionRewriter, fetched_probs) {
+  // The probabilities are fetched, so the pattern is kept.
+  NetBuilder builder("net_builder");
+  auto q      = builder.CreateInput(Float(32), {4, 40, 16}, "q");
+  auto k      = builder.CreateInput(Float(32), {4, 150, 16}, "k");
+  auto v      = builder.CreateInput(Float(32), {4, 150, 24}, "v");
+  auto scores = builder.Matmul(q, k, false, true, 0.01f);
+  auto probs  = builder.Softmax(scores);
+  auto out    = builder.Matmul(probs, v);
+  auto relu   = builder.Relu(probs);
+
+  ASSERT_EQ(RunAndCompare(&builder, {"q", "k", "v"}, relu->id), 0);
+}
+
+}  // namespace cinn::frontend
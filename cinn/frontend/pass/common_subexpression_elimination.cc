@@ -0,0 +1,160 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "cinn/common/target.h"
+#include "cinn/frontend/cinn_builder.h"
+#include "cinn/frontend/program_pass.h"
+#include "cinn/frontend/syntax.h"
+#include "cinn/utils/type_defs.h"
+
+namespace cinn::frontend::pass {
+
+namespace {
+
+// The ops whose outputs are not determined by the inputs and attributes only, they can not be merged.
+const std::unordered_set<std::string> kNondeterministicOps = {
+    "uniform_random", "gaussian_random", "randint", "dropout", "custom_call"};
+
+struct AttrSerializer {
+  std::ostringstream& out;
+  explicit AttrSerializer(std::ostringstream& out) : out(out) {}
+
+  void operator()(int v) { out << "i" << v; }
+  void operator()(float v) {
+    // compare the bits of float, so the values that differ in the lower digits are not merged
+    uint32_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    out << "f" << bits;
+  }
+  void operator()(bool v) { out << "b" << v; }
+  void operator()(const std::string& v) { out << "s" << v.size() << ":" << v; }
+#define VISIT_ELEMENTS(T__, tag__)                          \
+  void operator()(const std::vector<T__>& vs) {             \
+    out << tag__ << vs.size() << "[";                       \
+    for (const auto& v : vs) (*this)(static_cast<T__>(v)); \
+    out << "]";                                             \
+  }
+  VISIT_ELEMENTS(int, "vi")
+  VISIT_ELEMENTS(float, "vf")
+  VISIT_ELEMENTS(bool, "vb")
+  VISIT_ELEMENTS(std::string, "vs")
+#undef VISIT_ELEMENTS
+};
+
+}  // namespace
+
+// Pass `CommonSubexpressionElimination` merges the instructions with the same op type, inputs and attributes, the
+// users of the removed instruction's outputs are relinked to the outputs of the first one. The instructions are
+// visited in program order and the inputs are rewritten before hashing, so a duplicated chain such as
+// reshape->transpose->cast on the same input is merged as a whole. If an output is in `fetch_ids`, the instruction is
+// kept.
+class CommonSubexpressionEliminationPass : public ProgramPass {
+ public:
+  using ProgramPass::ProgramPass;
+
+ protected:
+  void ApplyImpl(Program* program,
+                 const std::unordered_set<std::string>& fetch_ids,
+                 const common::Target& target) const override {
+    // `instr_map` is used to represent the key of the first instruction and its outputs.
+    std::unordered_map<std::string, std::vector<Variable>> instr_map;
+    // `var_map` is used to represent the mapping from the output of a removed instruction to the retained one.
+    std::unordered_map<std::string, Variable> var_map;
+    std::unordered_set<Instruction*> remove_instrs;
+
+    for (int i = 0; i < program->size(); ++i) {
+      auto& instr = (*program)[i];
+      for (auto& in : instr->inputs) {
+        if (var_map.count(in->id)) {
+          in = var_map.at(in->id);
+        }
+      }
+
+      if (kNondeterministicOps.count(instr->op_type) || instr->outputs.empty()) {
+        continue;
+      }
+
+      auto key = GetInstrKey(instr);
+      if (!instr_map.count(key)) {
+        instr_map.emplace(key, instr->outputs);
+        continue;
+      }
+
+      auto is_fetched = [&](const Variable& var) { return fetch_ids.count(var->id); };
+      if (std::any_of(instr->outputs.begin(), instr->outputs.end(), is_fetched)) {
+        VLOG(4) << "Cannot remove " << instr->op_type << ", because its outputs were fetched.";
+        continue;
+      }
+
+      const auto& retained_outs = instr_map.at(key);
+      VLOG(4) << "Remove " << instr->op_type << ", whose output is Var [" << instr->outputs[0]->id
+              << "], it is the same as Var [" << retained_outs[0]->id << "].";
+      for (int j = 0; j < instr->outputs.size(); ++j) {
+        var_map.emplace(instr->outputs[j]->id, retained_outs[j]);
+      }
+      remove_instrs.insert(&instr);
+    }
+    VLOG(3) << "CommonSubexpressionElimination removes " << remove_instrs.size() << " instructions.";
+
+    CinnBuilder builder("common_subexpression_elimination_builder");
+    for (auto& var : program->GetInputs()) {
+      builder.CreateInput(var);
+    }
+    for (int i = 0; i < program->size(); i++) {
+      if (remove_instrs.end() != remove_instrs.find(&(*program)[i])) continue;
+      builder.AppendInstruction((*program)[i]);
+    }
+    *program = builder.Build();
+  }
+
+ private:
+  static std::string GetInstrKey(const Instruction& instr) {
+    std::ostringstream key;
+    key << instr->op_type << "(";
+    for (const auto& in : instr->inputs) {
+      key << in->id << ",";
+    }
+    key << ")";
+    // the attributes are stored in a hash map, sort them by name to get a stable key
+    std::vector<std::string> attr_names;
+    for (const auto& attr : instr->attrs) {
+      attr_names.push_back(attr.first);
+    }
+    std::sort(attr_names.begin(), attr_names.end());
+    AttrSerializer serializer(key);
+    for (const auto& name : attr_names) {
+      key << name << "=";
+      absl::visit(serializer, instr->attrs.at(name));
+      key << ";";
+    }
+    key << "->" << instr->outputs.size();
+    return key.str();
+  }
+};
+
+}  // namespace cinn::frontend::pass
+
+CINN_REGISTER_HELPER(CommonSubexpressionElimination) {
+  CINN_REGISTER_PROGRAM_PASS(CommonSubexpressionElimination,
+                             ::cinn::frontend::pass::CommonSubexpressionEliminationPass);
+
+  return true;
+}
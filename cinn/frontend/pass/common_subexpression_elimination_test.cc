@@ -0,0 +1,130 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "cinn/cinn.h"
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/optimize.h"
+#include "cinn/frontend/pass/use_program_pass.h"
+#include "cinn/frontend/program_pass.h"
+#include "cinn/frontend/syntax.h"
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pass/use_pass.h"
+#include "cinn/utils/data_util.h"
+
+namespace cinn::frontend {
+
+std::vector<float> RunWithProgram(const Program& program,
+                                  const Target& target,
+                                  const std::vector<std::string>& input_ids,
+                                  Variable out) {
+  auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+  auto scope = hlir::framework::BuildScope(target, graph);
+
+  hlir::framework::ApplyPasses(graph.get(), {"InferShape"});
+  hlir::framework::ApplyPasses(graph.get(), DefaultOpFusionPasses());
+  VLOG(1) << "graph:\n" << graph->Visualize();
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+  for (auto& id : input_ids) {
+    SetRandData<float>(scope->GetTensor(id), target, 123);
+  }
+  runtime_program->Execute();
+
+  return GetTensorData<float>(scope->GetTensor(out->id), target);
+}
+
+TEST(CommonSubexpressionElimination, MergeDuplicatedChain) {
+  NetBuilder builder("net_builder");
+  auto x         = builder.CreateInput(Float(32), {4, 8, 16}, "x");
+  auto reshape_1 = builder.Reshape(x, {32, 16});
+  auto trans_1   = builder.Transpose(reshape_1, {1, 0});
+  auto reshape_2 = builder.Reshape(x, {32, 16});
+  auto trans_2   = builder.Transpose(reshape_2, {1, 0});
+  auto out       = builder.Add(trans_1, trans_2);
+  auto program   = builder.Build();
+  auto target    = common::DefaultTarget();
+
+  size_t origin_size = program.size();
+  VLOG(1) << "Program Before CommonSubexpressionElimination:\n" << program;
+  // Program {
+  //   var_1 = reshape(x, shape=[32,16])
+  //   var_2 = transpose(var_1, axis=[1,0])
+  //   var_3 = reshape(x, shape=[32,16])
+  //   var_4 = transpose(var_3, axis=[1,0])
+  //   var_5 = elementwise_add(var_2, var_4)
+  // }
+
+  auto origin_out = RunWithProgram(program, target, {"x"}, out);
+
+  ProgramPass::Apply(&program, {out->id}, target, {"CommonSubexpressionElimination"});
+  size_t cse_size = program.size();
+  VLOG(1) << "Program after CommonSubexpressionElimination:\n" << program;
+  // Program {
+  //   var_1 = reshape(x, shape=[32,16])
+  //   var_2 = transpose(var_1, axis=[1,0])
+  //   var_5 = elementwise_add(var_2, var_2)
+  // }
+
+  auto cse_out = RunWithProgram(program, target, {"x"}, out);
+
+  ASSERT_EQ(origin_size, cse_size + 2);
+  ASSERT_EQ(origin_out.size(), cse_out.size());
+  for (size_t i = 0; i < origin_out.size(); ++i) {
+    ASSERT_FLOAT_EQ(origin_out[i], cse_out[i]);
+  }
+}
+
+TEST(CommonSubexpressionElimination, KeepDifferentAttrs) {
+  NetBuilder builder("net_builder");
+  auto x       = builder.CreateInput(Float(32), {16, 16}, "x");
+  auto trans_1 = builder.Transpose(x, {1, 0});
+  auto trans_2 = builder.Transpose(x, {0, 1});
+  auto scale_1 = builder.Scale(trans_1, 1.0f, 0.0f);
+  auto scale_2 = builder.Scale(trans_1, 1.0f, 1e-7f);
+  auto add_1   = builder.Add(scale_1, scale_2);
+  auto out     = builder.Add(add_1, trans_2);
+  auto program = builder.Build();
+  auto target  = common::DefaultTarget();
+
+  size_t origin_size = program.size();
+  ProgramPass::Apply(&program, {out->id}, target, {"CommonSubexpressionElimination"});
+  VLOG(1) << "Program after CommonSubexpressionElimination:\n" << program;
+
+  // the axis of transpose and the bias of scale are different, nothing can be merged
+  ASSERT_EQ(origin_size, program.size());
+}
+
+TEST(CommonSubexpressionElimination, KeepFetchedOutput) {
+  NetBuilder builder("net_builder");
+  auto x       = builder.CreateInput(Float(32), {16, 16}, "x");
+  auto relu_1  = builder.Relu(x);
+  auto relu_2  = builder.Relu(x);
+  auto out     = builder.Add(relu_1, relu_2);
+  auto program = builder.Build();
+  auto target  = common::DefaultTarget();
+
+  size_t origin_size = program.size();
+  ProgramPass::Apply(&program, {relu_2->id, out->id}, target, {"CommonSubexpressionElimination"});
+  VLOG(1) << "Program after CommonSubexpressionElimination:\n" << program;
+
+  // relu_2 is fetched, so it can not be removed
+  ASSERT_EQ(origin_size, program.size());
+}
+
+}  // namespace cinn::frontend
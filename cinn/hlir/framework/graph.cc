@@ -15,6 +15,7 @@
 #include "cinn/hlir/framework/graph.h"
 
 #include <atomic>
+#include <mutex>
 
 #include "cinn/hlir/framework/visualize_helper.h"
 #include "cinn/utils/string.h"
@@ -89,6 +90,9 @@ void Graph::VisualizeGroupedGraph(const std::vector<std::vector<Node*>>& groups,
   if (FLAGS_cinn_fusion_groups_graphviz_dir.empty()) {
     return;
   }
+  // the graph may be compiled by multiple threads concurrently in auto-tune
+  static std::mutex viz_mutex;
+  std::lock_guard<std::mutex> lock(viz_mutex);
 
   viz_path_ = utils::StringFormat(
       "%s/fusion_groups_%d/", FLAGS_cinn_fusion_groups_graphviz_dir.c_str(), viz_count_.fetch_add(1));
@@ -19,6 +19,8 @@
 #include <memory>
 #include <unordered_set>
 
+#include "cinn/auto_schedule/auto_tuner.h"
+#include "cinn/auto_schedule/database/jsonfile_database.h"
 #include "cinn/backends/codegen_cuda_dev.h"
 #include "cinn/common/context.h"
 #include "cinn/hlir/framework/instruction.h"
@@ -28,6 +30,7 @@
 #include "cinn/lang/lower.h"
 #include "cinn/optim/transform_gpu_forloop.h"
 #include "cinn/poly/stage.h"
+#include "cinn/utils/profiler.h"
 DECLARE_bool(cinn_ir_schedule);
 namespace cinn {
 namespace hlir {
@@ -681,10 +684,47 @@ void GraphCompiler::CompileOptions::Apply(const auto_schedule::TuningResult& tun
   }
 }
 
+void GraphCompiler::CompileOptions::ApplyTuningRecords(const std::string& record_file_path,
+                                                       GraphCompiler* graph_compiler) {
+  auto_schedule::AutoTuner tuner(graph_compiler->GetTarget(), graph_compiler->GetGraph().get());
+  auto_schedule::AutoTuner::Config config;
+  // nothing is measured, so no cpu is bound
+  config.runner_cpu_id = -1;
+  tuner.Initialize(config, graph_compiler);
+  // only the best record of a task is replayed
+  auto_schedule::JSONFileDatabase database(1, record_file_path, false);
+  Apply(tuner.LoadFromDatabase(&database));
+}
+
 GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::CompileOptions& options,
                                                       std::unordered_set<std::string>&& fetch_var_ids,
                                                       void* stream) {
-  Context::Global().ResetNameId();
+  if (!utils::CompileProfiler::Global().enabled()) {
+    return BuildImpl(options, std::move(fetch_var_ids), stream);
+  }
+  // the builds may be nested or concurrent, such as the candidate builds of auto-tune, the last one to finish dumps
+  // the events of them all to a new file, and the dump clears the events so they don't accumulate across builds
+  static std::atomic<int> num_profiled_builds{0};
+  ++num_profiled_builds;
+  GraphCompiler::CompilationResult result;
+  {
+    // the event is recorded when it is destructed, so the events are dumped out of this scope
+    utils::RecordCompileEvent event("GraphCompiler::Build", "graph_compiler");
+    result = BuildImpl(options, std::move(fetch_var_ids), stream);
+    event.AddCounter("num_instructions", result.runtime_program->size());
+  }
+  if (--num_profiled_builds == 0) {
+    utils::CompileProfiler::Global().Dump();
+  }
+  return result;
+}
+
+GraphCompiler::CompilationResult GraphCompiler::BuildImpl(const GraphCompiler::CompileOptions& options,
+                                                          std::unordered_set<std::string>&& fetch_var_ids,
+                                                          void* stream) {
+  if (options.reset_name_id) {
+    Context::Global().ResetNameId();
+  }
   compile_options_ = options;
   fetch_var_ids_   = std::move(fetch_var_ids);
   auto topo_order  = graph_->topological_order();
@@ -742,12 +782,19 @@ GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::Compi
         auto& shape_dict = graph_->GetMutableAttrs<absl::flat_hash_map<std::string, shape_t>>("infershape");
         for (int i = 0; i < groups.size(); i++) {
           for (int j = 0; j < groups[i].size(); j++) {
+            utils::RecordCompileEvent event("GraphCompiler::GetOpFuncWithIRSchedule", "lowering");
+            if (event.enabled()) event.AddAttr("node_id", groups[i][j]->id());
             lowered_func = GetOpFuncWithIRSchedule(groups[i][j], dtype_dict, shape_dict);
             local_lowered_funcs.emplace_back(std::move(lowered_func));
           }
         }
       } else {
         for (int i = 0; i < groups.size(); i++) {
+          utils::RecordCompileEvent event("GraphCompiler::GetOpFunc", "lowering");
+          if (event.enabled()) {
+            event.AddAttr("node_id", groups[i][0]->id());
+            event.AddCounter("num_nodes", groups[i].size());
+          }
           if (groups[i].size() == 1) {
             lowered_func = GetOpFunc(groups[i][0]);
           } else {
@@ -774,15 +821,23 @@ GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::Compi
   auto build_module = m_builder_.Build();
   VLOG(3) << "End of m_builder_.Build()";
   if (this->target_.arch == Target::Arch::X86) {
+    utils::RecordCompileEvent event("CodeGenCX86", "codegen");
     CodeGenCX86 codegen(this->target_, CodeGenCX86::Feature::AVX512);
     codegen.SetInlineBuiltinCodes(false);
     auto out = codegen.Compile(build_module, CodeGenC::OutputKind::CImpl);
     VLOG(3) << "[X86] C Code is:\n" << out;
   }
 
-  compiler_->Build(build_module, options.attached_code);
+  {
+    utils::RecordCompileEvent event("Compiler::Build", "codegen");
+    compiler_->Build(build_module, options.attached_code);
+  }
   VLOG(3) << "End of compiler_->Build";
-  auto instructions = BuildInstructions(groups, graph_->fusion_groups);
+  std::vector<std::unique_ptr<Instruction>> instructions;
+  {
+    utils::RecordCompileEvent event("GraphCompiler::BuildInstructions", "graph_compiler");
+    instructions = BuildInstructions(groups, graph_->fusion_groups);
+  }
   VLOG(3) << "End of BuildInstructions";
   if (options.remove_unused_variables) {
     RemoveInvalidVariables(instructions);
@@ -98,6 +98,9 @@ class GraphCompiler final {
     bool with_instantiate_variables              = false;
     bool with_buffer_handle_instruction_inserted = false;
     bool remove_unused_variables                 = true;
+    // the global name ids are reset before compiling by default, disable it
+    // when multiple GraphCompilers build concurrently
+    bool reset_name_id = true;
     // nodes group, it may come from the result of op fusion or graph tuning.
     // nodes in a group will be built into an Instruction
     std::vector<std::vector<Node*>> groups;
@@ -105,8 +108,14 @@ class GraphCompiler final {
     // if it is empty then graph_compiler will generate for them
     std::vector<std::vector<ir::LoweredFunc>> lowered_funcs;
 
-    // apply results of auto-tune to compile
+    // apply results of auto-tune to compile, the results can also be restored
+    // from the tuning records by AutoTuner::LoadFromDatabase without tuning
     void Apply(const auto_schedule::TuningResult& tuning_result);
+
+    // restore the results of auto-tune from the tuning records saved in the json file
+    // record_file_path without tuning and apply them, which replays the best record of
+    // each task of the graph of graph_compiler by AutoTuner::LoadFromDatabase
+    void ApplyTuningRecords(const std::string& record_file_path, GraphCompiler* graph_compiler);
   };
 
   // Compile with a packing option and result, to be extended easily.
@@ -123,10 +132,19 @@ class GraphCompiler final {
 
   const std::shared_ptr<Scope>& GetScope() const { return scope_; }
 
+  const Target& GetTarget() const { return target_; }
+
+  const std::shared_ptr<Graph>& GetGraph() const { return graph_; }
+
   std::vector<std::vector<ir::LoweredFunc>> FusedGraphToLoweredFunc(
       const std::vector<std::vector<hlir::framework::Node*>>& graph);
 
  private:
+  // Build without recording the whole building as an event of the compile profiler
+  CompilationResult BuildImpl(const CompileOptions& options,
+                              std::unordered_set<std::string>&& fetch_var_ids,
+                              void* stream);
+
   std::vector<ir::LoweredFunc> NodeToLoweredFunc(const hlir::framework::Node& node);
 
   std::vector<ir::LoweredFunc> FusedNodeGroupToLoweredFunc(const std::vector<hlir::framework::Node*>& node_group);
@@ -15,6 +15,7 @@
 #include "cinn/hlir/framework/op_lowering.h"
 
 #include "cinn/optim/transform_gpu_forloop.h"
+#include "cinn/utils/profiler.h"
 
 DECLARE_bool(cinn_ir_schedule);
 
@@ -94,6 +95,11 @@ std::vector<ir::LoweredFunc> OpLowerer::LowerWithOutSchedule(GroupPtr& group) {
 
 std::vector<ir::LoweredFunc> OpLowerer::Lower(GroupPtr& group) {
   VLOG(3) << "Lowering Group : " << group->group_id << " , Op Pattern : " << group->op_pattern_kind;
+  utils::RecordCompileEvent event("OpLowerer::Lower", "lowering");
+  if (event.enabled()) {
+    event.AddAttr("group_id", group->group_id);
+    event.AddCounter("num_nodes", group->nodes.size());
+  }
   if (FLAGS_cinn_ir_schedule) {
     switch (group->op_pattern_kind) {
       case framework::kElemWise:
@@ -103,7 +109,10 @@ std::vector<ir::LoweredFunc> OpLowerer::Lower(GroupPtr& group) {
       case framework::kCommReduce:
         return IRLowerOp(&OpLowerer::IRReduceCompute, &OpLowerer::IRReduceSchedule, group);
       case framework::kOutEWiseFusable:
-        LOG(FATAL) << "Group Pattern Kind kOutEWiseFusable Is Not Implemented!";
+        // the op fusion pass keeps kOutEWiseFusable ops alone in IR schedule, so they are lowered as opaque ops.
+        CHECK(group->fused_sub_groups.empty() && group->nodes.size() == 1)
+            << "Group Pattern Kind kOutEWiseFusable With Fused Ops Is Not Implemented!";
+        return IRLowerOpaqueOp(group);
       case framework::kOpaque:
         return IRLowerOpaqueOp(group);
       default:
@@ -1945,6 +1954,10 @@ void OpLowerer::OutEWiseFusableCompute(poly::StageMap& stages,
       // update postfix
       postfix = "_" + std::to_string(idx);
     }
+    // insert the stages of the temporary tensors which are not outputs, such as the mean square of layer_norm.
+    for (auto& tmp_stage : tmp_stages) {
+      stages->InsertLazily(ir::Tensor(tmp_stage.second->tensor()), tmp_stage.second.get());
+    }
   }
 }
 
@@ -14,7 +14,9 @@
 
 #include "cinn/hlir/pe/nn.h"
 
+#include <algorithm>
 #include <functional>
+#include <numeric>
 
 #include "cinn/hlir/framework/node.h"
 #include "cinn/hlir/framework/op.h"
@@ -1936,6 +1938,267 @@ std::vector<std::vector<std::string>> InferLayoutForSoftmax(const std::vector<fr
   return {{input_layouts[0], input_layouts[0]}, input_layouts};
 }
 
+framework::CINNSchedule GetNormSchedule(const std::string &op_name, int begin_norm_axis, const Target &target) {
+  return framework::CINNSchedule([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input arguments of " << op_name << " schedule is empty! Please check.";
+    CINNValuePack arg_pack = args[0];
+    if (FLAGS_cinn_ir_schedule) {
+      std::vector<Expr> vec_ast;
+      for (int i = 0; i < arg_pack.size(); i++) {
+        if (arg_pack[i].is_expr()) {
+          Expr temp = arg_pack[i];
+          vec_ast.emplace_back(temp);
+        }
+      }
+      CHECK(!vec_ast.empty());
+      ir::ModuleExpr mod_expr(vec_ast);
+      ir::IRSchedule ir_sch(mod_expr);
+      pe::IRNormSchedule(ir_sch, begin_norm_axis, target);
+      std::vector<CINNValue> res{CINNValue(ir_sch.GetModule().GetExprs().at(0))};
+      *ret = CINNValuePack{res};
+    } else {
+      CHECK_GE(arg_pack.size(), 3UL) << "The input tensor's size of " << op_name << " schedule is " << arg_pack.size()
+                                     << " and it should be at least 3! Please check.";
+      Expr out              = arg_pack[0];
+      poly::StageMap stages = arg_pack.back();
+      CHECK(out.as_tensor());
+      std::vector<ir::Tensor> stats;
+      for (int i = 1; i < arg_pack.size() - 1; i++) {
+        Expr stat = arg_pack[i];
+        CHECK(stat.as_tensor());
+        stats.push_back(stat.as_tensor_ref());
+      }
+      pe::NormSchedule(stages, out.as_tensor_ref(), stats, begin_norm_axis, target);
+      *ret = arg_pack;
+    }
+  });
+}
+
+int GetBeginNormAxis(const framework::AttrMapType &attrs, int rank) {
+  int begin_norm_axis = 1;
+  if (attrs.count("begin_norm_axis")) {
+    begin_norm_axis = absl::get<int>(attrs.at("begin_norm_axis"));
+  }
+  if (begin_norm_axis < 0) {
+    begin_norm_axis += rank;
+  }
+  CHECK(begin_norm_axis > 0 && begin_norm_axis < rank)
+      << "The begin_norm_axis should be in [1, " << rank << "), but got " << begin_norm_axis;
+  return begin_norm_axis;
+}
+
+std::shared_ptr<OpStrategy> StrategyForLayerNorm(const framework::NodeAttr &attrs,
+                                                 const std::vector<ir::Tensor> &inputs,
+                                                 const std::vector<Type> &out_type,
+                                                 const std::vector<std::vector<int>> &output_shapes,
+                                                 const Target &target) {
+  CHECK(!output_shapes.empty()) << "The output shape of layer_norm is empty! Please check.";
+  int begin_norm_axis = GetBeginNormAxis(attrs.attr_store, output_shapes[0].size());
+  float epsilon       = 1e-5f;
+  if (attrs.attr_store.count("epsilon")) {
+    epsilon = absl::get<float>(attrs.attr_store.at("epsilon"));
+  }
+  framework::CINNCompute layer_norm_compute([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input arguments of layer_norm compute is empty! Please check.";
+    CINNValuePack pack_args = args[0];
+    CHECK_GE(pack_args.size(), 3U) << "The input tensors of layer_norm compute should be x, scale and bias.";
+    Expr x     = pack_args[0];
+    Expr scale = pack_args[1];
+    Expr bias  = pack_args[2];
+    CHECK(x.as_tensor() && scale.as_tensor() && bias.as_tensor());
+
+    std::string tensor_name = UniqName("LayerNorm_out");
+    if (FLAGS_cinn_ir_schedule) {
+      CHECK_EQ(pack_args.size(), 4U);
+      CHECK(pack_args[3].is_string());
+      tensor_name = pack_args[3].operator std::string();
+    }
+
+    auto out = pe::LayerNorm(
+        x.as_tensor_ref(), scale.as_tensor_ref(), bias.as_tensor_ref(), begin_norm_axis, epsilon, tensor_name);
+    CHECK_EQ(out.size(), 3U) << "The size of pe::LayerNorm's output should be 3.";
+    auto stages = CreateStages({x.as_tensor_ref(), scale.as_tensor_ref(), bias.as_tensor_ref()});
+    std::vector<CINNValue> res;
+    for (auto &t : out) {
+      stages->InsertLazily(t);
+      res.push_back(CINNValue(t));
+    }
+    res.push_back(CINNValue(stages));
+    *ret = CINNValuePack{res};
+  });
+
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  strategy->AddImpl(
+      layer_norm_compute, GetNormSchedule("layer_norm", begin_norm_axis, target), "strategy.layer_norm.x86", 1);
+  return strategy;
+}
+
+std::vector<framework::shape_t> InferShapeForLayerNorm(const std::vector<framework::shape_t> &inputs_shape,
+                                                       const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_shape.size(), 3U) << "The input's size of layer_norm is not 3! Please check again.";
+  const auto &x_shape = inputs_shape[0];
+  int begin_norm_axis = GetBeginNormAxis(attrs, x_shape.size());
+  int norm_size       = std::accumulate(x_shape.begin() + begin_norm_axis, x_shape.end(), 1, std::multiplies<int>());
+  CHECK(inputs_shape[1] == framework::shape_t{norm_size}) << "The scale's shape of layer_norm should be [" << norm_size
+                                                          << "]! Please check again.";
+  CHECK(inputs_shape[2] == framework::shape_t{norm_size}) << "The bias's shape of layer_norm should be [" << norm_size
+                                                          << "]! Please check again.";
+  framework::shape_t stat_shape(x_shape.begin(), x_shape.begin() + begin_norm_axis);
+  return {x_shape, stat_shape, stat_shape};
+}
+
+std::vector<Type> InferDtypeForLayerNorm(const std::vector<Type> &inputs_type, const framework::AttrMapType &attrs) {
+  CHECK(!inputs_type.empty()) << "The input's type size is 0! Please check again.";
+  return {inputs_type[0], inputs_type[0], inputs_type[0]};
+}
+
+std::shared_ptr<OpStrategy> StrategyForRMSNorm(const framework::NodeAttr &attrs,
+                                               const std::vector<ir::Tensor> &inputs,
+                                               const std::vector<Type> &out_type,
+                                               const std::vector<std::vector<int>> &output_shapes,
+                                               const Target &target) {
+  CHECK(!output_shapes.empty()) << "The output shape of rms_norm is empty! Please check.";
+  int begin_norm_axis = GetBeginNormAxis(attrs.attr_store, output_shapes[0].size());
+  float epsilon       = 1e-6f;
+  if (attrs.attr_store.count("epsilon")) {
+    epsilon = absl::get<float>(attrs.attr_store.at("epsilon"));
+  }
+  framework::CINNCompute rms_norm_compute([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input arguments of rms_norm compute is empty! Please check.";
+    CINNValuePack pack_args = args[0];
+    CHECK_GE(pack_args.size(), 2U) << "The input tensors of rms_norm compute should be x and scale.";
+    Expr x     = pack_args[0];
+    Expr scale = pack_args[1];
+    CHECK(x.as_tensor() && scale.as_tensor());
+
+    std::string tensor_name = UniqName("RMSNorm_out");
+    if (FLAGS_cinn_ir_schedule) {
+      CHECK_EQ(pack_args.size(), 3U);
+      CHECK(pack_args[2].is_string());
+      tensor_name = pack_args[2].operator std::string();
+    }
+
+    auto out = pe::RMSNorm(x.as_tensor_ref(), scale.as_tensor_ref(), begin_norm_axis, epsilon, tensor_name);
+    CHECK_EQ(out.size(), 2U) << "The size of pe::RMSNorm's output should be 2.";
+    auto stages = CreateStages({x.as_tensor_ref(), scale.as_tensor_ref()});
+    std::vector<CINNValue> res;
+    for (auto &t : out) {
+      stages->InsertLazily(t);
+      res.push_back(CINNValue(t));
+    }
+    res.push_back(CINNValue(stages));
+    *ret = CINNValuePack{res};
+  });
+
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  strategy->AddImpl(rms_norm_compute, GetNormSchedule("rms_norm", begin_norm_axis, target), "strategy.rms_norm.x86", 1);
+  return strategy;
+}
+
+std::vector<framework::shape_t> InferShapeForRMSNorm(const std::vector<framework::shape_t> &inputs_shape,
+                                                     const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_shape.size(), 2U) << "The input's size of rms_norm is not 2! Please check again.";
+  const auto &x_shape = inputs_shape[0];
+  int begin_norm_axis = GetBeginNormAxis(attrs, x_shape.size());
+  int norm_size       = std::accumulate(x_shape.begin() + begin_norm_axis, x_shape.end(), 1, std::multiplies<int>());
+  CHECK(inputs_shape[1] == framework::shape_t{norm_size}) << "The scale's shape of rms_norm should be [" << norm_size
+                                                          << "]! Please check again.";
+  return {x_shape, framework::shape_t(x_shape.begin(), x_shape.begin() + begin_norm_axis)};
+}
+
+std::vector<Type> InferDtypeForRMSNorm(const std::vector<Type> &inputs_type, const framework::AttrMapType &attrs) {
+  CHECK(!inputs_type.empty()) << "The input's type size is 0! Please check again.";
+  return {inputs_type[0], inputs_type[0]};
+}
+
+std::shared_ptr<OpStrategy> StrategyForAttention(const framework::NodeAttr &attrs,
+                                                 const std::vector<ir::Tensor> &inputs,
+                                                 const std::vector<Type> &out_type,
+                                                 const std::vector<std::vector<int>> &output_shapes,
+                                                 const Target &target) {
+  float scale = 1.0f;
+  bool causal = false;
+  if (attrs.attr_store.count("scale")) {
+    scale = absl::get<float>(attrs.attr_store.at("scale"));
+  }
+  if (attrs.attr_store.count("causal")) {
+    causal = absl::get<bool>(attrs.attr_store.at("causal"));
+  }
+  framework::CINNCompute attention_compute([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input arguments of attention compute is empty! Please check.";
+    CINNValuePack pack_args = args[0];
+    CHECK_GE(pack_args.size(), 3U) << "The input tensors of attention compute should be q, k, v and an optional mask.";
+    CHECK(target.arch == Target::Arch::X86) << "Attention only supports the x86 target now";
+    std::vector<ir::Tensor> tensors;
+    for (int i = 0; i < pack_args.size() && i < 4; ++i) {
+      if (!pack_args[i].is_tensor()) break;
+      Expr tensor = pack_args[i];
+      CHECK(tensor.as_tensor());
+      tensors.push_back(tensor.as_tensor_ref());
+    }
+    CHECK_GE(tensors.size(), 3U) << "The input tensors of attention compute should be q, k, v and an optional mask.";
+    ir::Tensor mask = tensors.size() > 3U ? tensors[3] : ir::Tensor();
+
+    auto out    = pe::AttentionCPU(tensors[0], tensors[1], tensors[2], mask, scale, causal, UniqName("Attention_out"));
+    auto stages = CreateStages(tensors);
+    std::vector<CINNValue> res;
+    for (auto &t : out) {
+      stages->InsertLazily(t);
+      res.push_back(CINNValue(t));
+    }
+    CHECK(!out_type.empty()) << "Output type of attention is empty! Please check.";
+    res.push_back(CINNValue(stages));
+    *ret = CINNValuePack{res};
+  });
+
+  framework::CINNSchedule attention_schedule([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input argument of attention schedule is empty! Please check.";
+    CINNValuePack arg_pack = args[0];
+    if (FLAGS_cinn_ir_schedule) {
+      CINN_NOT_IMPLEMENTED
+    }
+    *ret = arg_pack;
+  });
+
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  strategy->AddImpl(attention_compute, attention_schedule, "strategy.attention.x86", 1);
+  return strategy;
+}
+
+std::vector<framework::shape_t> InferShapeForAttention(const std::vector<framework::shape_t> &inputs_shape,
+                                                       const framework::AttrMapType &attrs) {
+  CHECK(inputs_shape.size() == 3U || inputs_shape.size() == 4U)
+      << "The input's size of attention should be 3 or 4! Please check again.";
+  const auto &q_shape = inputs_shape[0];
+  const auto &k_shape = inputs_shape[1];
+  const auto &v_shape = inputs_shape[2];
+  int rank            = q_shape.size();
+  CHECK(rank == 3 || rank == 4) << "The queries of attention should be 3-D or 4-D! Please check again.";
+  CHECK(k_shape.size() == rank && v_shape.size() == rank)
+      << "The queries, keys and values of attention should have the same rank! Please check again.";
+  CHECK(std::equal(q_shape.begin(), q_shape.end() - 2, k_shape.begin()) &&
+        std::equal(q_shape.begin(), q_shape.end() - 2, v_shape.begin()))
+      << "The leading dimensions of the queries, keys and values of attention should be the same! Please check again.";
+  CHECK_EQ(q_shape.back(), k_shape.back()) << "The head_dim of the queries and keys should be the same!";
+  CHECK_EQ(k_shape[rank - 2], v_shape[rank - 2]) << "The seq_k of the keys and values should be the same!";
+  if (inputs_shape.size() == 4U) {
+    const auto &mask_shape = inputs_shape[3];
+    CHECK(mask_shape.size() >= 2U && mask_shape.size() <= rank)
+        << "The mask of attention should be 2-D to " << rank << "-D! Please check again.";
+    CHECK_EQ(mask_shape.back(), k_shape[rank - 2]) << "The last dimension of the mask should be seq_k!";
+  }
+  framework::shape_t out_shape = q_shape;
+  out_shape.back()             = v_shape.back();
+  // the shape of the tuple output of the extern call
+  return {out_shape, {1}};
+}
+
+std::vector<Type> InferDtypeForAttention(const std::vector<Type> &inputs_type, const framework::AttrMapType &attrs) {
+  CHECK(!inputs_type.empty()) << "The input's type size is 0! Please check again.";
+  CHECK(inputs_type[0].is_float(32)) << "Attention only supports float32 now";
+  return {inputs_type[0], inputs_type[0]};
+}
+
 std::shared_ptr<OpStrategy> StrategyForDropoutInfer(const framework::NodeAttr &attrs,
                                                     const std::vector<ir::Tensor> &inputs,
                                                     const std::vector<Type> &out_type,
@@ -2159,6 +2422,25 @@ std::vector<Type> InferDtypeForBatchNormGrad(const std::vector<Type> &inputs_typ
   return {inputs_type[0], inputs_type[0], inputs_type[0]};
 }
 
+// layer norm grad
+std::vector<framework::shape_t> InferShapeForLayerNormGrad(const std::vector<framework::shape_t> &inputs_shape,
+                                                           const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_shape.size(), 5U) << "The input's size of layer_norm_grad is not 5! Please check again.";
+  CHECK(inputs_shape[0] == inputs_shape[1]) << "dy and x shape is not equal!";
+  const auto &x_shape = inputs_shape[1];
+  int begin_norm_axis = GetBeginNormAxis(attrs, x_shape.size());
+  framework::shape_t stat_shape(x_shape.begin(), x_shape.begin() + begin_norm_axis);
+  CHECK(inputs_shape[3] == stat_shape) << "x and mean shape is not matched!";
+  CHECK(inputs_shape[4] == stat_shape) << "x and variance shape is not matched!";
+  return {x_shape, inputs_shape[2], inputs_shape[2]};
+}
+
+std::vector<Type> InferDtypeForLayerNormGrad(const std::vector<Type> &inputs_type,
+                                             const framework::AttrMapType &attrs) {
+  CHECK(!inputs_type.empty()) << "The input's type size is 0! Please check again.";
+  return {inputs_type[0], inputs_type[0], inputs_type[0]};
+}
+
 // conv2d grad
 std::vector<framework::shape_t> InferShapeForConv2dGrad(const std::vector<framework::shape_t> &inputs_shape,
                                                         const framework::AttrMapType &attrs) {
@@ -2320,6 +2602,40 @@ CINN_REGISTER_HELPER(nn_ops) {
       .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kOpaque)
       .set_support_level(4);
 
+  CINN_REGISTER_OP(layer_norm)
+      .describe("This operator implements the layer normalization, outputs={y, mean, variance}.")
+      .set_num_inputs(3)
+      .set_num_outputs(3)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForLayerNorm)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForLayerNorm))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForLayerNorm))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern",
+                                                      cinn::hlir::framework::OpPatternKind::kOutEWiseFusable)
+      .set_support_level(4);
+
+  CINN_REGISTER_OP(rms_norm)
+      .describe("This operator implements the root mean square normalization, outputs={y, mean_square}.")
+      .set_num_inputs(2)
+      .set_num_outputs(2)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForRMSNorm)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForRMSNorm))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForRMSNorm))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern",
+                                                      cinn::hlir::framework::OpPatternKind::kOutEWiseFusable)
+      .set_support_level(4);
+
+  CINN_REGISTER_OP(attention)
+      .describe(
+          "This operator computes the scaled dot product attention softmax(scale * Q * K^T + mask) * V in one blocked "
+          "online-softmax kernel, the inputs are q, k, v and an optional additive mask.")
+      .set_num_inputs(4)
+      .set_num_outputs(2)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForAttention)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForAttention))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForAttention))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kOpaque)
+      .set_support_level(4);
+
   CINN_REGISTER_OP(dropout_infer)
       .describe("Downgrade the outcome at inference or keep the same.")
       .set_num_inputs(1)
@@ -2375,6 +2691,14 @@ CINN_REGISTER_HELPER(nn_grad_ops) {
       .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForBatchNormGrad))
       .set_support_level(4);
 
+  CINN_REGISTER_OP(layer_norm_grad)
+      .describe("This operator implements the layer normalization backward.")
+      .set_num_inputs(5)
+      .set_num_outputs(3)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForLayerNormGrad))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForLayerNormGrad))
+      .set_support_level(4);
+
   CINN_REGISTER_OP(conv2d_grad)
       .describe("This operator implements the convolution backward.")
       .set_num_inputs(3)
@@ -336,6 +336,121 @@ std::vector<std::vector<std::string>> InferLayoutForMatMul(const std::vector<fra
   return {{"", ""}, new_input_layouts};
 }
 
+std::shared_ptr<OpStrategy> StrategyForGroupedMatMul(const framework::NodeAttr &attrs,
+                                                     const std::vector<ir::Tensor> &inputs,
+                                                     const std::vector<Type> &out_type,
+                                                     const std::vector<std::vector<int>> &output_shapes,
+                                                     const Target &target) {
+  framework::CINNCompute grouped_matmul_compute([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input arguments of GroupedMatmul compute is empty! Please check.\n";
+    CINNValuePack pack_args = args[0];
+    CHECK_GE(pack_args.size(), 4U) << "at least 4 input tensors for GroupedMatmul compute\n";
+    CHECK(target.arch == Target::Arch::X86) << "GroupedMatmul only supports the x86 target now";
+    auto attr_store = attrs.attr_store;
+    bool trans_a    = false;
+    bool trans_b    = false;
+    float alpha     = 1;
+    if (attr_store.count("trans_a")) {
+      trans_a = absl::get<bool>(attr_store.at("trans_a"));
+    }
+    if (attr_store.count("trans_b")) {
+      trans_b = absl::get<bool>(attr_store.at("trans_b"));
+    }
+    if (attr_store.count("alpha")) {
+      alpha = absl::get<float>(attr_store.at("alpha"));
+    }
+
+    std::vector<ir::Tensor> tensor_A;
+    std::vector<ir::Tensor> tensor_B;
+    std::vector<ir::Tensor> placeholders;
+    for (int i = 0; i + 1 < pack_args.size(); i += 2) {
+      if (!pack_args[i].is_tensor()) break;
+      Expr A = pack_args[i];
+      Expr B = pack_args[i + 1];
+      CHECK(A.as_tensor());
+      CHECK(B.as_tensor());
+      tensor_A.push_back(A.as_tensor_ref());
+      tensor_B.push_back(B.as_tensor_ref());
+      placeholders.push_back(A.as_tensor_ref());
+      placeholders.push_back(B.as_tensor_ref());
+    }
+    auto stages = CreateStages(placeholders);
+    std::vector<ir::Tensor> out;
+#ifdef CINN_WITH_MKL_CBLAS
+    out = pe::GroupedMatmulMKL(
+        tensor_A, tensor_B, trans_a, trans_b, alpha, UniqName("GroupedMatmulMKL_output"), target);
+#else
+    // Without MKL every problem is computed separately, the last tensor is kept as a placeholder of the tuple output.
+    for (int i = 0; i < tensor_A.size(); ++i) {
+      out.push_back(pe::Matmul(tensor_A[i], tensor_B[i], trans_a, trans_b, alpha, UniqName("GroupedMatmul_output"))[0]);
+    }
+    out.push_back(pe::Identity(out.front(), UniqName("GroupedMatmul_tuple")).front());
+#endif
+    std::vector<CINNValue> res;
+    for (auto &t : out) {
+      stages->InsertLazily(t);
+      res.push_back(CINNValue(t));
+    }
+    CHECK(!out_type.empty()) << "Output type of GroupedMatmul is empty! Please check.\n";
+    res.push_back(CINNValue(stages));
+    *ret = CINNValuePack{res};
+  });
+
+  framework::CINNSchedule grouped_matmul_schedule([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input argument of GroupedMatmul schedule is empty! Please check.\n";
+    CINNValuePack arg_pack = args[0];
+    if (FLAGS_cinn_ir_schedule) {
+      CINN_NOT_IMPLEMENTED
+    }
+    *ret = arg_pack;
+  });
+
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  strategy->AddImpl(grouped_matmul_compute, grouped_matmul_schedule, "strategy.grouped_matmul.x86", 1);
+
+  return strategy;
+}
+
+std::vector<std::vector<int>> InferShapeForGroupedMatMul(const std::vector<std::vector<int>> &inputs_shape,
+                                                         const framework::AttrMapType &attrs) {
+  CHECK(inputs_shape.size() >= 4U && inputs_shape.size() % 2 == 0)
+      << "The input's shape size of GroupedMatmul should be an even number no less than 4! Please check again.";
+  bool trans_a = false;
+  bool trans_b = false;
+  if (attrs.count("trans_a")) {
+    trans_a = absl::get<bool>(attrs.at("trans_a"));
+  }
+  if (attrs.count("trans_b")) {
+    trans_b = absl::get<bool>(attrs.at("trans_b"));
+  }
+  std::vector<std::vector<int>> res;
+  for (int i = 0; i < inputs_shape.size(); i += 2) {
+    CHECK_EQ(inputs_shape[i].size(), 2U) << "GroupedMatmul only supports 2-D inputs";
+    CHECK_EQ(inputs_shape[i + 1].size(), 2U) << "GroupedMatmul only supports 2-D inputs";
+    std::vector<int> output_shape;
+    std::vector<int> new_shape_A = inputs_shape[i];
+    std::vector<int> new_shape_B = inputs_shape[i + 1];
+    GetMatmulNewShapes(
+        {inputs_shape[i], inputs_shape[i + 1]}, trans_a, trans_b, &new_shape_A, &new_shape_B, &output_shape);
+    res.push_back(output_shape);
+  }
+  // the shape of the tuple output of the extern call
+  res.push_back({1});
+  return res;
+}
+
+std::vector<Type> InferDtypeForGroupedMatMul(const std::vector<Type> &inputs_type,
+                                             const framework::AttrMapType &attrs) {
+  CHECK(!inputs_type.empty()) << "The input's type size is 0! Please check again.";
+  std::vector<Type> res;
+  for (int i = 0; i < inputs_type.size(); i += 2) {
+    CHECK_EQ(inputs_type[i], inputs_type[i + 1]) << "The inputs of GroupedMatmul should have the same dtype";
+    res.push_back(inputs_type[i]);
+  }
+  res.push_back(inputs_type[0]);
+  return res;
+}
+
 std::shared_ptr<OpStrategy> StrategyForReshape(const framework::NodeAttr &attrs,
                                                const std::vector<ir::Tensor> &inputs,
                                                const std::vector<Type> &out_type,
@@ -729,6 +844,18 @@ std::vector<std::vector<std::string>> InferLayoutForConcat(const std::vector<fra
                                                            const framework::NodeAttr &attrs,
                                                            const Target &target) {
   CHECK_GE(input_layouts.size(), 2U) << "The input's layout size is less than 2! Please check again.";
+  int axis = 0;
+  if (attrs.attr_store.count("axis")) {
+    axis = absl::get<int>(attrs.attr_store.at("axis"));
+  }
+  // concat on channel keeps the blocked layout NCHWxc, all the inputs should be transformed to it.
+  if (axis == 1) {
+    for (auto &layout : input_layouts) {
+      if (layout.size() > 4) {
+        return {{layout}, std::vector<std::string>(input_layouts.size(), layout)};
+      }
+    }
+  }
   return {{input_layouts[0]}, input_layouts};
 }
 
@@ -1981,6 +2108,18 @@ CINN_REGISTER_HELPER(transform_ops) {
       .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kOpaque)
       .set_support_level(4);
 
+  CINN_REGISTER_OP(grouped_matmul)
+      .describe(
+          "This operator is used to perform a group of independent 2-D matrix multiplications X_i * Y_i in a single "
+          "grouped GEMM, the inputs are ordered as X_0, Y_0, X_1, Y_1, ...")
+      .set_num_inputs(0)
+      .set_num_outputs(0)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForGroupedMatMul)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForGroupedMatMul))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForGroupedMatMul))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kOpaque)
+      .set_support_level(4);
+
   CINN_REGISTER_OP(reshape)
       .describe("This operator is used to reshape input tensor X.")
       .set_num_inputs(1)
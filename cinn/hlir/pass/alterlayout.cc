@@ -12,6 +12,11 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <unordered_set>
+
 #include "cinn/hlir/framework/graph.h"
 #include "cinn/hlir/framework/node.h"
 #include "cinn/hlir/framework/op.h"
@@ -124,6 +129,131 @@ std::vector<framework::shape_t> UpdateInferInfos(Node* node,
   return infershapes;
 }
 
+// ops through which the blocked NCHWxc layout can be propagated without layout_transform
+bool IsLayoutAgnosticOp(const Node* node) {
+  static const std::unordered_set<std::string> layout_agnostic_ops = {"pool2d", "batch_norm", "concat"};
+  auto& op_pattern_dict = Operator::GetAttrs<framework::OpPatternKind>("OpPattern");
+  if (layout_agnostic_ops.count(node->op()->name)) {
+    if (node->op()->name == "concat" && node->attrs.attr_store.count("axis")) {
+      // only concat on channel keeps the layout.
+      return absl::get<int>(node->attrs.attr_store.at("axis")) == 1;
+    }
+    return true;
+  }
+  if (!op_pattern_dict.Find(node->op()) || node->op()->name == "broadcast_to") {
+    return false;
+  }
+  auto kind = op_pattern_dict[node->op()];
+  return kind == framework::kElemWise || kind == framework::kBroadcast;
+}
+
+// Choose one channel block factor for each region of NCHW vars connected by layout-agnostic ops, so that a conv's
+// output layout can be consumed by the next conv directly and the layout_transform is only needed at the boundary of
+// the region. The candidate factors of a region come from the x86 schedule params of the convs reading or writing it.
+absl::flat_hash_map<std::string, int> AssignChannelBlockFactors(
+    Graph* graph,
+    const std::vector<GraphNode*>& store_nodes,
+    const absl::flat_hash_map<std::string, framework::shape_t>& shape_dict,
+    const absl::flat_hash_map<std::string, Type>& type_dict) {
+  // union-find on the 4-D vars
+  absl::flat_hash_map<std::string, std::string> parent;
+  std::function<std::string(const std::string&)> find_root = [&](const std::string& id) -> std::string {
+    if (!parent.count(id)) {
+      parent[id] = id;
+    }
+    if (parent[id] != id) {
+      parent[id] = find_root(parent[id]);
+    }
+    return parent[id];
+  };
+  auto is_nchw = [&](GraphNode* var) { return shape_dict.count(var->id()) && shape_dict.at(var->id()).size() == 4; };
+
+  for (auto* graph_node : store_nodes) {
+    auto node = graph_node->safe_as<Node>();
+    if (!node || !IsLayoutAgnosticOp(node)) {
+      continue;
+    }
+    auto outlinks = node->outlinks_in_order(true);
+    if (outlinks.empty() || !is_nchw(outlinks[0]->sink())) {
+      continue;
+    }
+    auto out_root = find_root(outlinks[0]->sink()->id());
+    for (auto& link : node->inlinks_in_order(true)) {
+      if (is_nchw(link->source())) {
+        parent[find_root(link->source()->id())] = out_root;
+      }
+    }
+  }
+
+  // collect the candidate factors voted by convs
+  absl::flat_hash_map<std::string, std::map<int, int>> votes;
+  std::string model_name = graph->HasAttr("model_name") ? graph->GetAttrs<std::string>("model_name") : "";
+  for (auto* graph_node : store_nodes) {
+    auto node = graph_node->safe_as<Node>();
+    if (!node || node->op()->name != "conv2d" || !node->attrs.attr_store.count("key")) {
+      continue;
+    }
+    auto inlinks  = node->inlinks_in_order(true);
+    auto outlinks = node->outlinks_in_order(true);
+    if (inlinks.size() != 2U || outlinks.empty() || !is_nchw(inlinks[0]->source()) || !is_nchw(inlinks[1]->source())) {
+      continue;
+    }
+    auto input_shape  = shape_dict.at(inlinks[0]->source()->id());
+    auto weight_shape = shape_dict.at(inlinks[1]->source()->id());
+    int ic = input_shape[1], oc = weight_shape[0], fc = weight_shape[1];
+    if (ic != fc) {
+      // group conv keeps its own factors.
+      continue;
+    }
+    absl::flat_hash_map<std::string, int> conv2d_factors;
+    pe::GetConv2dFactors(&conv2d_factors,
+                         oc,
+                         ic,
+                         fc,
+                         -1,
+                         -1,
+                         type_dict.at(inlinks[0]->source()->id()),
+                         graph->target_,
+                         absl::get<std::string>(node->attrs.attr_store.at("key")));
+    votes[find_root(inlinks[0]->source()->id())][conv2d_factors["ic_bn"]]++;
+    if (is_nchw(outlinks[0]->sink())) {
+      votes[find_root(outlinks[0]->sink()->id())][conv2d_factors["oc_bn"]]++;
+    }
+  }
+
+  // every var in a region should be divisible by the chosen factor.
+  absl::flat_hash_map<std::string, std::vector<std::string>> regions;
+  for (auto& item : parent) {
+    regions[find_root(item.first)].push_back(item.first);
+  }
+  absl::flat_hash_map<std::string, int> block_factors;
+  for (auto& vote : votes) {
+    std::vector<std::string> members = regions.count(vote.first) ? regions[vote.first] : std::vector<std::string>();
+    if (members.empty()) {
+      members.push_back(vote.first);
+    }
+    int best_factor = 0, best_vote = 0;
+    for (auto& candidate : vote.second) {
+      bool divisible = std::all_of(members.begin(), members.end(), [&](const std::string& id) {
+        return shape_dict.at(id)[1] % candidate.first == 0;
+      });
+      if (divisible && (candidate.second > best_vote || (candidate.second == best_vote && candidate.first > best_factor))) {
+        best_factor = candidate.first;
+        best_vote   = candidate.second;
+      }
+    }
+    if (!best_factor) {
+      continue;
+    }
+    VLOG(3) << "Choose channel block factor " << best_factor << " for " << members.size() << " vars with "
+            << vote.first;
+    for (auto& id : members) {
+      block_factors[id] = best_factor;
+    }
+  }
+  return block_factors;
+}
+
 void AlterLayoutPass(Graph* graph) {
   // alterlayout only in X86 for it's specific layout requirements
   if (graph->target_.arch == Target::Arch::X86) {
@@ -171,6 +301,9 @@ void AlterLayoutPass(Graph* graph) {
       }
     }
 
+    // choose the block factors of convs jointly, so the blocked layout can flow through layout-agnostic ops.
+    auto block_factors = AssignChannelBlockFactors(graph, store_nodes, shape_dict, type_dict);
+
     bool has_altered = false;
     for (int i = 0; i < store_nodes.size(); i++) {
       auto node = store_nodes[i]->safe_as<Node>();
@@ -249,6 +382,19 @@ void AlterLayoutPass(Graph* graph) {
           int oc_bn = conv2d_factors["oc_bn"];
           int ic_bn = conv2d_factors["ic_bn"];
           int fc_bn = conv2d_factors["fc_bn"];
+          if (ic == fc) {
+            // the input block factor is decided by the producer's layout or the region it belongs to.
+            if (input_shape.size() == 5) {
+              ic_bn = input_shape[4];
+            } else if (block_factors.count(input_node->id())) {
+              ic_bn = block_factors.at(input_node->id());
+            }
+            fc_bn = ic_bn;
+            auto* output_node = node->outlinks_in_order(true)[0]->sink();
+            if (block_factors.count(output_node->id())) {
+              oc_bn = block_factors.at(output_node->id());
+            }
+          }
           VLOG(3) << "oc_bn: " << oc_bn;
           VLOG(3) << "ic_bn: " << ic_bn;
           VLOG(3) << "fc_bn: " << fc_bn;
@@ -454,5 +454,59 @@ TEST(conv_mul_conv, conv_mul_conv) {
   runtime_program->Execute();
 }
 
+TEST(conv_residual_conv, conv_residual_conv) {
+  Placeholder A(Float(32), {1, 3, 56, 56}, "A");
+  Placeholder B(Float(32), {64, 3, 3, 3}, "B");
+  Placeholder D(Float(32), {64, 64, 3, 3}, "D");
+  Placeholder E(Float(32), {32, 64, 3, 3}, "E");
+
+  Program program;
+  absl::flat_hash_map<std::string, Program::attr_t> attrs;
+  attrs["stride"]        = std::vector<int>({1, 1});
+  attrs["dilation"]      = std::vector<int>({1, 1});
+  attrs["padding"]       = std::vector<int>({1, 1});
+  std::string src_layout = "NCHW";
+  attrs["data_format"]   = src_layout;
+
+  auto c = program.conv2d(A, B, attrs);
+  auto d = program.relu(c);
+  auto e = program.conv2d(d, D, attrs);
+  auto f = program.elementwise_add(e, c);
+  auto g = program.relu(f);
+  auto h = program.conv2d(g, E, attrs);
+
+  Target target = common::DefaultHostTarget();
+  program.SetInputs({A, B, D, E});
+  program.Validate();
+  LOG(INFO) << "Program:\n" << program;
+  auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+
+  hlir::framework::ApplyPass(graph.get(), "InferShape");
+  hlir::framework::ApplyPass(graph.get(), "AlterLayout");
+  LOG(INFO) << "graph:\n" << graph->Visualize();
+
+  // the blocked layout flows through relu and the residual add, so only the input, the weights of the three convs
+  // and the final output need layout_transform.
+  int num_layout_transforms = 0;
+  for (auto* graph_node : std::get<0>(graph->topological_order())) {
+    auto node = graph_node->safe_as<hlir::framework::Node>();
+    if (node && node->op()->name == "layout_transform") {
+      num_layout_transforms++;
+    }
+  }
+  ASSERT_EQ(num_layout_transforms, 5);
+
+  auto scope = BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+
+  for (auto& name : {"A", "B", "D", "E"}) {
+    scope->Var<hlir::framework::Tensor>(name);
+    SetRandData<float>(scope->GetTensor(name), target);
+  }
+
+  runtime_program->Execute();
+}
+
 }  // namespace frontend
 }  // namespace cinn
@@ -12,10 +12,17 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <gflags/gflags.h>
+
+#include <functional>
+#include <numeric>
 #include <queue>
+#include <thread>
 
 #include "cinn/hlir/pass/fusion_helper_base.h"
 
+DECLARE_bool(cinn_fusion_merge_use_cost_model);
+
 namespace cinn {
 namespace hlir {
 namespace pass {
@@ -44,8 +51,11 @@ using ConditionFunction = std::function<bool(const GroupPtr&, const GroupPtr&)>;
 // code generation.
 class FusionMergePassHelper : public FusionHelperBase {
  public:
-  FusionMergePassHelper(const Graph* graph) : FusionHelperBase(graph) {
-    fusion_groups_ = graph->fusion_groups;
+  FusionMergePassHelper(const Graph* graph)
+      : FusionHelperBase(graph),
+        type_dict_(graph->GetAttrs<absl::flat_hash_map<std::string, common::Type>>("inferdtype")) {
+    fusion_groups_  = graph->fusion_groups;
+    use_cost_model_ = FLAGS_cinn_fusion_merge_use_cost_model;
     // init fusion relation.
     InitFusionRelation();
     // init input to consumers.
@@ -417,6 +427,12 @@ class FusionMergePassHelper : public FusionHelperBase {
         continue;
       }
 
+      if (use_cost_model_ && VerticalFusionGain(producer, consumer) <= 0) {
+        VLOG(4) << "Fusing producer " << producer->group_id << " into consumer " << consumer->group_id
+                << " doesn't pay off!";
+        continue;
+      }
+
       fusionable_consumers.insert(consumer);
     }
 
@@ -635,11 +651,99 @@ class FusionMergePassHelper : public FusionHelperBase {
 
     if (fusionable_consumers.size() > 1) {
       auto first = *fusionable_consumers.begin();
+      // pick the consumer which saves the most memory traffic instead of the first one.
+      if (use_cost_model_) {
+        int64_t max_gain = VerticalFusionGain(producer, first);
+        for (auto& consumer : fusionable_consumers) {
+          auto gain = VerticalFusionGain(producer, consumer);
+          if (gain > max_gain) {
+            max_gain = gain;
+            first    = consumer;
+          }
+        }
+      }
       fusionable_consumers.clear();
       fusionable_consumers.insert(first);
     }
   }
 
+  int64_t GetNodeDataNumel(const Node* node) {
+    auto shape = this->GetNodeDataShape(node);
+    return std::accumulate(shape.begin(), shape.end(), static_cast<int64_t>(1), std::multiplies<int64_t>());
+  }
+
+  int64_t GetNodeDataBytes(const Node* node) {
+    auto node_data = GetNodeData(node);
+    int bytes      = type_dict_.count(node_data->id()) ? type_dict_.at(node_data->id()).bytes() : 4;
+    return GetNodeDataNumel(node) * std::max(bytes, 1);
+  }
+
+  int64_t GetGroupNumel(const GroupPtr& group) {
+    int64_t numel = 0;
+    for (auto* node : group->master_nodes) {
+      numel = std::max(numel, GetNodeDataNumel(node));
+    }
+    return numel;
+  }
+
+  // the bytes written by all ops in the group, which is used as the computation amount of the group.
+  int64_t GetGroupComputeBytes(const GroupPtr& group) {
+    int64_t bytes = 0;
+    for (auto* node : group->CollectNodes()) {
+      bytes += GetNodeDataBytes(node);
+    }
+    return bytes;
+  }
+
+  // Estimate the benefit of fusing producer into consumer, all terms are in bytes:
+  //   gain = global memory traffic saved - recomputation introduced - computation losing parallelism.
+  // A merge is only worth doing when the gain is positive.
+  int64_t VerticalFusionGain(const GroupPtr& producer, const GroupPtr& consumer) {
+    // 1.memory traffic saved: the consumer no longer reloads producer's outputs, and the store is also saved
+    // if no one else reads the output.
+    int64_t saved_bytes = 0;
+    for (auto* node : producer->output_nodes) {
+      if (!consumer->input_nodes.count(node)) {
+        continue;
+      }
+      bool only_used_by_consumer = !output_nodes_set_.count(node);
+      for (auto& other : producer->consumer_groups) {
+        if (other.get() != consumer.get() && other->input_nodes.count(node)) {
+          only_used_by_consumer = false;
+          break;
+        }
+      }
+      saved_bytes += (only_used_by_consumer ? 2 : 1) * GetNodeDataBytes(node);
+    }
+
+    // 2.recomputation: each element of producer is recomputed for every broadcasted element of consumer.
+    int64_t producer_numel = std::max(GetGroupNumel(producer), static_cast<int64_t>(1));
+    int64_t consumer_numel = GetGroupNumel(consumer);
+    int64_t compute_bytes  = GetGroupComputeBytes(producer);
+    int64_t recompute_bytes =
+        consumer_numel > producer_numel && consumer->op_pattern_kind != framework::kCommReduce
+            ? compute_bytes * (consumer_numel / producer_numel - 1)
+            : 0;
+
+    // 3.parallelism: after fusion, producer runs with the parallel degree of consumer.
+    int64_t parallel_lost_bytes = 0;
+    if (consumer->op_pattern_kind == framework::kCommReduce || producer->op_pattern_kind == framework::kCommReduce) {
+      int64_t num_cores = target_.arch == common::Target::Arch::NVGPU
+                              ? target_.max_num_threads()
+                              : std::max(static_cast<int64_t>(std::thread::hardware_concurrency()),
+                                         static_cast<int64_t>(1));
+      int64_t producer_degree = std::min(producer_numel, num_cores);
+      int64_t fused_degree    = std::min(std::min(consumer_numel, producer_numel), num_cores);
+      if (fused_degree < producer_degree) {
+        parallel_lost_bytes = compute_bytes * (producer_degree - fused_degree) / producer_degree;
+      }
+    }
+
+    VLOG(4) << "Fuse " << producer->group_id << " into " << consumer->group_id << " : saved bytes = " << saved_bytes
+            << ", recompute bytes = " << recompute_bytes << ", parallel lost bytes = " << parallel_lost_bytes;
+    return saved_bytes - recompute_bytes - parallel_lost_bytes;
+  }
+
   bool IsDependency(const GroupPtr& producer_g,
                     const GroupPtr& consumer,
                     const std::unordered_set<GroupPtr, Hasher, Comparator>& consumers) {
@@ -850,6 +954,34 @@ class FusionMergePassHelper : public FusionHelperBase {
       // TODO(sunli) : cost-model.
       return true;
     };
+    // injective ops (reshape/transpose...) change the shape but not the amount of data, so they can be
+    // inlined into its only consumer without recomputation, which is left to the cost model to decide.
+    auto injective_fuse_by_cost = [this, is_same_shape](const GroupPtr& first, const GroupPtr& second) -> bool {
+      if (is_same_shape(first, second)) {
+        return true;
+      }
+      if (!this->use_cost_model_) {
+        return false;
+      }
+      // the fused loops run over the output of second, an element of first is computed once only if the
+      // shape changes without changing the number of elements, unlike concat or broadcast_to
+      auto numel = [](const shape_t& shape) {
+        return std::accumulate(shape.begin(), shape.end(), 1LL, std::multiplies<int64_t>());
+      };
+      auto second_numel = numel(this->GetNodeDataShape(*second->master_nodes.begin()));
+      for (auto output : first->output_nodes) {
+        if (!second->input_nodes.count(output)) {
+          return false;
+        }
+        if (this->output_nodes_set_.count(output)) {
+          return false;
+        }
+        if (numel(this->GetNodeDataShape(output)) != second_numel) {
+          return false;
+        }
+      }
+      return true;
+    };
     auto elementwise_fuse_reduce = [this, is_same_shape](const GroupPtr& first, const GroupPtr& second) -> bool {
       if (this->target_ == common::DefaultHostTarget()) {
         return true;
@@ -1038,8 +1170,8 @@ class FusionMergePassHelper : public FusionHelperBase {
       relation.vertical_relation = {{OpPatternKind::kElemWise, is_same_shape},
                                     // element-wise and broadcast can be vertical/horizontal relation.
                                     {OpPatternKind::kBroadcast, elementwise_fuse_broadcast},
-                                    // element-wise and injective op must be horizontal relation.
-                                    {OpPatternKind::kInjective, is_same_shape},
+                                    // element-wise and injective op can be vertical relation with cost model.
+                                    {OpPatternKind::kInjective, injective_fuse_by_cost},
                                     // element-wise and reduce can be vertical/horizontal relation.
                                     {OpPatternKind::kCommReduce, elementwise_fuse_reduce}};
     }
@@ -1078,12 +1210,12 @@ class FusionMergePassHelper : public FusionHelperBase {
                                       // injective and reduce must be horizontal relation.
                                       {OpPatternKind::kCommReduce, is_same_shape}};
       // vertical
-      relation.vertical_relation = {// injective and element-wise op must be horizontal relation.
-                                    {OpPatternKind::kElemWise, is_same_shape},
+      relation.vertical_relation = {// injective and element-wise op can be vertical relation with cost model.
+                                    {OpPatternKind::kElemWise, injective_fuse_by_cost},
                                     // injective and broadcast op must be horizontal relation.
                                     {OpPatternKind::kBroadcast, is_same_shape},
-                                    // injective and injective op must be horizontal relation.
-                                    {OpPatternKind::kInjective, is_same_shape},
+                                    // injective and injective op can be vertical relation with cost model.
+                                    {OpPatternKind::kInjective, injective_fuse_by_cost},
                                     // injective and reduce can be horizontal/vertical relation.
                                     {OpPatternKind::kCommReduce, elementwise_fuse_reduce}};
     }
@@ -1120,6 +1252,11 @@ class FusionMergePassHelper : public FusionHelperBase {
     std::unordered_map<framework::OpPatternKind, ConditionFunction> horizontal_relation;
   };
   std::unordered_map<framework::OpPatternKind, Relation> fusion_relation_map_;
+
+  // dtype dict, used to compute the bytes of node data.
+  const absl::flat_hash_map<std::string, common::Type>& type_dict_;
+  // whether to score candidate merges with the analytic cost model.
+  bool use_cost_model_{false};
 };
 
 void FusionMergePassInternal(Graph* graph) {
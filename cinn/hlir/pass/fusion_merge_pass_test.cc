@@ -13,6 +13,9 @@
 // limitations under the License.
 
 #include "cinn/frontend/decomposer/test_helper.h"
+#include "cinn/utils/timer.h"
+
+DECLARE_bool(cinn_fusion_merge_use_cost_model);
 
 namespace cinn {
 namespace frontend {
@@ -481,5 +484,177 @@ TEST(FusionMergePass, Reduce_Test_5) {
   CHECK_EQ(graph->fusion_groups.size(), 1);
 }
 
+int RunFusionMergePass(NetBuilder& net_builder, bool use_cost_model) {
+  auto program = net_builder.Build();
+  auto target  = common::DefaultTarget();
+  RunDecomposer(&program, target);
+
+  FLAGS_cinn_fusion_merge_use_cost_model = use_cost_model;
+  auto graph                             = std::make_shared<hlir::framework::Graph>(program, target);
+  hlir::framework::ApplyPasses(graph.get(), {"OpFusionPass", "FusionMergePass"});
+  FLAGS_cinn_fusion_merge_use_cost_model = false;
+  return graph->fusion_groups.size();
+}
+
+// Build the program fused with or without the cost model, run it on the inputs and return the output `output_name`.
+// The inputs are generated randomly if `input_vecs` is empty. The average time of `repeat` more runs after the first
+// one is returned by `time_ms` if it is not nullptr.
+std::vector<float> RunFusedProgram(NetBuilder& net_builder,
+                                   bool use_cost_model,
+                                   const std::string& output_name,
+                                   std::vector<std::vector<float>>* input_vecs,
+                                   double* time_ms = nullptr,
+                                   int repeat      = 10) {
+  auto program = net_builder.Build();
+  auto target  = common::DefaultTarget();
+  RunDecomposer(&program, target);
+
+  FLAGS_cinn_fusion_merge_use_cost_model = use_cost_model;
+  auto graph                             = std::make_shared<hlir::framework::Graph>(program, target);
+  hlir::framework::ApplyPasses(graph.get(), {"OpFusionPass", "FusionMergePass"});
+  FLAGS_cinn_fusion_merge_use_cost_model = false;
+
+  auto scope = hlir::framework::BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+  auto inputs          = program.GetInputs();
+  for (int i = 0; i < inputs.size(); ++i) {
+    auto tensor = scope->GetTensor(inputs[i]->id);
+    if (input_vecs->size() <= i) {
+      std::vector<float> vec;
+      InitRandomVector<float>(&vec, tensor->shape().numel(), 0.0f, 1.0f);
+      input_vecs->push_back(vec);
+    }
+    CopyFromVector<float>(input_vecs->at(i), tensor, target);
+  }
+  runtime_program->Execute();
+  if (time_ms) {
+    utils::Timer timer;
+    timer.Start();
+    for (int i = 0; i < repeat; ++i) {
+      runtime_program->Execute();
+    }
+    *time_ms = timer.Stop() / repeat;
+  }
+
+  std::vector<float> output;
+  CopyToVector<float>(scope->GetTensor(output_name), &output);
+  return output;
+}
+
+TEST(FusionMergePass, CostModel_Broadcast_Recompute) {
+  int h = 32, w = 32;
+  NetBuilder net_builder("CostModel_Broadcast_Recompute");
+  // create model
+  {
+    auto A = net_builder.CreateInput(Float(32), {w}, "A");
+    auto B = net_builder.CreateInput(Float(32), {w}, "B");
+    auto C = net_builder.CreateInput(Float(32), {h * w, w}, "C");
+    auto D = net_builder.ElementwiseAdd(A, B);
+    auto E = net_builder.ElementwiseAdd(C, D);
+  }
+
+  // A + B is recomputed h * w times after fused into the broadcast, which costs more than the saved traffic.
+  CHECK_EQ(RunFusionMergePass(net_builder, false), 1);
+  CHECK_EQ(RunFusionMergePass(net_builder, true), 2);
+}
+
+TEST(FusionMergePass, CostModel_Injective_Chain) {
+  int h = 32, w = 32;
+  NetBuilder net_builder("CostModel_Injective_Chain");
+  std::string output_name;
+  // create model
+  {
+    auto A = net_builder.CreateInput(Float(32), {h, w}, "A");
+    auto B = net_builder.CreateInput(Float(32), {w, h}, "B");
+    auto C = net_builder.Transpose(A, {1, 0});
+    auto D = net_builder.ElementwiseAdd(B, C);
+    auto E = net_builder.Reshape(D, {h * w});
+    auto F = net_builder.Relu(E);
+
+    output_name = F->id;
+  }
+
+  CHECK_LE(RunFusionMergePass(net_builder, true), RunFusionMergePass(net_builder, false));
+
+  // the injective ops fused by the cost model compute the same result as the table-driven fusion
+  std::vector<std::vector<float>> input_vecs;
+  auto table_output = RunFusedProgram(net_builder, false, output_name, &input_vecs);
+  auto cost_output  = RunFusedProgram(net_builder, true, output_name, &input_vecs);
+  CheckOutput<float>(cost_output, table_output);
+}
+
+TEST(FusionMergePass, CostModel_Reduce_Chain) {
+  int n = 16, c = 32, hw = 64;
+  NetBuilder net_builder("CostModel_Reduce_Chain");
+  std::string output_name;
+  // create model
+  {
+    auto A = net_builder.CreateInput(Float(32), {c}, "A");
+    auto B = net_builder.CreateInput(Float(32), {c}, "B");
+    auto X = net_builder.CreateInput(Float(32), {n, hw, c}, "X");
+    auto Y = net_builder.CreateInput(Float(32), {n, c, hw}, "Y");
+    auto C = net_builder.ElementwiseAdd(A, B);
+    auto D = net_builder.ElementwiseAdd(X, C);
+    auto E = net_builder.Transpose(Y, {0, 2, 1});
+    auto F = net_builder.ElementwiseAdd(D, E);
+    auto G = net_builder.Reduce(F, ReduceKind::kSum, {1});
+
+    output_name = G->id;
+  }
+
+  std::vector<std::vector<float>> input_vecs;
+  auto table_output = RunFusedProgram(net_builder, false, output_name, &input_vecs);
+  auto cost_output  = RunFusedProgram(net_builder, true, output_name, &input_vecs);
+  CheckOutput<float>(cost_output, table_output, 1e-5, 1e-5);
+}
+
+TEST(FusionMergePass, CostModel_Injective_Numel) {
+  int h = 32, w = 32;
+  NetBuilder net_builder("CostModel_Injective_Numel");
+  // create model
+  {
+    auto A = net_builder.CreateInput(Float(32), {h, w}, "A");
+    auto B = net_builder.Relu(A);
+    auto C = net_builder.Concat({B, B}, 0);
+  }
+
+  // the concat reads every element of relu twice, which is recomputed if they are fused, so the shape change
+  // isn't fused by the cost model either
+  CHECK_EQ(RunFusionMergePass(net_builder, true), RunFusionMergePass(net_builder, false));
+}
+
+// Times the same model fused by the table-driven rules and by the cost model, the timings are logged rather than
+// checked because they depend on the host
+TEST(FusionMergePass, CostModel_AB_Benchmark) {
+  int n = 64, c = 128, hw = 256;
+  NetBuilder net_builder("CostModel_AB_Benchmark");
+  std::string output_name;
+  // create model
+  {
+    auto A = net_builder.CreateInput(Float(32), {c}, "A");
+    auto B = net_builder.CreateInput(Float(32), {c}, "B");
+    auto X = net_builder.CreateInput(Float(32), {n, hw, c}, "X");
+    auto Y = net_builder.CreateInput(Float(32), {n, c, hw}, "Y");
+    auto C = net_builder.ElementwiseAdd(A, B);
+    auto D = net_builder.ElementwiseAdd(X, C);
+    auto E = net_builder.Transpose(Y, {0, 2, 1});
+    auto F = net_builder.ElementwiseAdd(D, E);
+    auto G = net_builder.Reshape(F, {n, hw * c});
+    auto H = net_builder.Relu(G);
+
+    output_name = H->id;
+  }
+
+  std::vector<std::vector<float>> input_vecs;
+  double table_time = 0, cost_time = 0;
+  auto table_output = RunFusedProgram(net_builder, false, output_name, &input_vecs, &table_time);
+  auto cost_output  = RunFusedProgram(net_builder, true, output_name, &input_vecs, &cost_time);
+  LOG(INFO) << "FusionMergePass A/B: " << RunFusionMergePass(net_builder, false) << " groups " << table_time
+            << " ms by the table-driven rules, " << RunFusionMergePass(net_builder, true) << " groups " << cost_time
+            << " ms by the cost model";
+  CheckOutput<float>(cost_output, table_output, 1e-5, 1e-5);
+}
+
 }  // namespace frontend
 }  // namespace cinn
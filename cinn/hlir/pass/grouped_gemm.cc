@@ -0,0 +1,264 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <map>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "cinn/common/graph_utils.h"
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/pass/infershape.h"
+
+namespace cinn {
+namespace hlir {
+namespace pass {
+namespace {
+
+using common::GraphNode;
+using framework::Node;
+using framework::NodeData;
+
+using dtype_dict_t = absl::flat_hash_map<std::string, common::Type>;
+using shape_dict_t = absl::flat_hash_map<std::string, framework::shape_t>;
+
+// The grouped gemm kernels of the runtime are instantiated for 2 to 4 problems.
+constexpr int kMinGroupSize = 2;
+constexpr int kMaxGroupSize = 4;
+
+template <typename T>
+T get_attr(Node* instr, const std::string& attr, T def) {
+  if (!instr->attrs.attr_store.count(attr)) {
+    return def;
+  }
+  return absl::get<T>(instr->attrs.attr_store.at(attr));
+}
+
+NodeData* input_operand(Node* instr, int idx) { return instr->inlinks_in_order()[idx]->source()->safe_as<NodeData>(); }
+
+void remove_node(framework::Graph* graph, GraphNode* node) {
+  auto inlinks = node->inlinks();
+  for (auto& link : inlinks) {
+    link->source()->UnLinkSingleTo(link->sink());
+  }
+  auto outlinks = node->outlinks();
+  for (auto& link : outlinks) {
+    link->source()->UnLinkSingleTo(link->sink());
+  }
+  graph->DropNode(node);
+}
+
+/*
+ * Group the independent matrix multiplications into grouped gemm.
+ *
+ * Before:
+ * (m0, k0) * (k0, n0) -> (m0, n0)
+ * (m1, k1) * (k1, n1) -> (m1, n1)
+ *
+ * After:
+ * grouped_matmul((m0, k0), (k0, n0), (m1, k1), (k1, n1)) -> (m0, n0), (m1, n1)
+ *
+ * The matmuls at the same topological level (the length of the longest path from the graph inputs) can not depend
+ * on each other, so they are grouped by the level, the dtype and the attributes. The grouped gemm launches a single
+ * parallel region for the whole group and partitions the work by FLOPs, which keeps all the cores busy even when the
+ * problems are too small to be parallelized well one by one.
+ */
+class GroupedGemmPass {
+ public:
+  explicit GroupedGemmPass(framework::Graph* graph)
+      : graph_(graph),
+        dtype_dict_(graph->GetMutableAttrs<dtype_dict_t>("inferdtype")),
+        shape_dict_(graph->GetMutableAttrs<shape_dict_t>("infershape")) {}
+
+  int Apply() {
+    int cnt = 0;
+    for (auto& cluster : GetClusters()) {
+      for (auto& group : SplitCluster(cluster.second)) {
+        BuildGroupedGemm(group);
+        cnt++;
+      }
+    }
+    return cnt;
+  }
+
+ private:
+  // key: {level, trans_a, trans_b, alpha}
+  using ClusterKey = std::tuple<int, bool, bool, float>;
+
+  bool IsCandidate(Node* node) {
+    if (node->op()->name != "matmul" || node->inlinks().size() != 2U) {
+      return false;
+    }
+    if (get_attr<bool>(node, "trans_out", false)) {
+      return false;
+    }
+    if (input_operand(node, 0) == input_operand(node, 1)) {
+      return false;
+    }
+    for (int i = 0; i < 2; ++i) {
+      auto* in = input_operand(node, i);
+      if (shape_dict_.at(in->id()).size() != 2U || dtype_dict_.at(in->id()) != Float(32)) {
+        return false;
+      }
+    }
+    // Only the first output is the result, the others are the internal buffers which should not be used.
+    auto& graph_outs = graph_->outputs;
+    auto outlinks    = node->outlinks_in_order();
+    for (int i = 1; i < outlinks.size(); ++i) {
+      auto* out = outlinks[i]->sink()->safe_as<NodeData>();
+      if (!out->outlinks().empty() || std::find(graph_outs.begin(), graph_outs.end(), out) != graph_outs.end()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  std::map<ClusterKey, std::vector<Node*>> GetClusters() {
+    std::map<ClusterKey, std::vector<Node*>> clusters;
+    std::unordered_map<GraphNode*, int> levels;
+    auto nodes = std::get<0>(graph_->topological_order());
+    for (auto* n : nodes) {
+      auto* op_node = n->safe_as<Node>();
+      if (!op_node) {
+        continue;
+      }
+      int level = 0;
+      for (auto& in_edge : op_node->inlinks()) {
+        for (auto& producer_edge : in_edge->source()->inlinks()) {
+          auto* producer = producer_edge->source();
+          if (levels.count(producer)) {
+            level = std::max(level, levels.at(producer) + 1);
+          }
+        }
+      }
+      levels[op_node] = level;
+      if (IsCandidate(op_node)) {
+        ClusterKey key{level,
+                       get_attr<bool>(op_node, "trans_a", false),
+                       get_attr<bool>(op_node, "trans_b", false),
+                       get_attr<float>(op_node, "alpha", 1.f)};
+        clusters[key].push_back(op_node);
+      }
+    }
+    VLOG(3) << "clusters size = " << clusters.size();
+    return clusters;
+  }
+
+  // Split a cluster into the groups with [kMinGroupSize, kMaxGroupSize] matmuls. The matmuls in one group should not
+  // share any input, which is left to DotMerger.
+  std::vector<std::vector<Node*>> SplitCluster(const std::vector<Node*>& cluster) {
+    std::vector<std::vector<Node*>> groups;
+    std::vector<Node*> remains = cluster;
+    while (remains.size() >= kMinGroupSize) {
+      std::vector<Node*> group;
+      std::vector<Node*> rejected;
+      std::unordered_set<NodeData*> inputs;
+      // Balance the group sizes, e.g. 5 matmuls are split into 3 + 2 rather than 4 + 1.
+      int num_groups = (remains.size() + kMaxGroupSize - 1) / kMaxGroupSize;
+      int max_size   = (remains.size() + num_groups - 1) / num_groups;
+      for (auto* node : remains) {
+        auto* a = input_operand(node, 0);
+        auto* b = input_operand(node, 1);
+        if (group.size() < max_size && !inputs.count(a) && !inputs.count(b)) {
+          group.push_back(node);
+          inputs.insert(a);
+          inputs.insert(b);
+        } else {
+          rejected.push_back(node);
+        }
+      }
+      // The first matmul is always taken, so the loop makes progress even if nothing can be grouped with it.
+      if (group.size() >= kMinGroupSize) {
+        groups.push_back(group);
+      }
+      remains = rejected;
+    }
+    return groups;
+  }
+
+  void BuildGroupedGemm(const std::vector<Node*>& group) {
+    const std::string type{"grouped_matmul"};
+    auto instr = common::Shared<Node>(
+        new Node(framework::Operator::Get(type), type, type + "__grouped_gemm_" + std::to_string(idx_++)));
+    instr->attrs.attr_store["trans_a"] = get_attr<bool>(group.front(), "trans_a", false);
+    instr->attrs.attr_store["trans_b"] = get_attr<bool>(group.front(), "trans_b", false);
+    instr->attrs.attr_store["alpha"]   = get_attr<float>(group.front(), "alpha", 1.f);
+    graph_->RegisterNode(instr->id(), instr.get());
+
+    std::vector<NodeData*> outputs;
+    std::vector<GraphNode*> internal_vars;
+    for (auto* node : group) {
+      input_operand(node, 0)->LinkTo(instr.get());
+      input_operand(node, 1)->LinkTo(instr.get());
+      auto outlinks = node->outlinks_in_order();
+      outputs.push_back(outlinks[0]->sink()->safe_as<NodeData>());
+      for (int i = 1; i < outlinks.size(); ++i) {
+        internal_vars.push_back(outlinks[i]->sink());
+      }
+    }
+    for (auto* node : group) {
+      VLOG(3) << "Group matmul " << node->id() << " into " << instr->id();
+      remove_node(graph_, node);
+    }
+    for (auto* var : internal_vars) {
+      graph_->DropNode(var);
+    }
+    for (int i = 0; i < outputs.size(); ++i) {
+      instr->LinkTo(outputs[i]);
+      outputs[i]->source_node  = instr;
+      outputs[i]->output_index = i;
+    }
+    // the tuple output of the grouped gemm extern call
+    auto* tuple = new NodeData(instr, outputs.size(), 0, instr->id() + "_tuple", false);
+    graph_->RegisterNode(tuple->id(), tuple);
+    instr->LinkTo(tuple);
+    InferShape(instr.get(), dtype_dict_, shape_dict_);
+  }
+
+  static int idx_;
+  framework::Graph* graph_{};
+  dtype_dict_t& dtype_dict_;
+  shape_dict_t& shape_dict_;
+};
+
+int GroupedGemmPass::idx_ = 0;
+
+}  // namespace
+
+void GroupedGemmPassFunc(framework::Graph* graph) {
+  if (graph->target_.arch != Target::Arch::X86) {
+    VLOG(3) << "The grouped gemm is only supported on x86, skip.";
+    return;
+  }
+#ifdef CINN_WITH_MKL_CBLAS
+  int n = GroupedGemmPass(graph).Apply();
+  VLOG(3) << "The grouped gemm was built " << n << " times.";
+#endif
+}
+
+}  // namespace pass
+}  // namespace hlir
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(GroupedGemm) {
+  CINN_REGISTER_PASS(GroupedGemm)
+      .describe("This pass groups the independent matmuls at the same topological level into a grouped gemm.")
+      .set_change_structure(true)
+      .provide_graph_attr("infershape")
+      .provide_graph_attr("inferdtype")
+      .set_body(cinn::hlir::pass::GroupedGemmPassFunc);
+  return true;
+}
@@ -14,6 +14,9 @@
 
 #include "cinn/common/type.h"
 #include "cinn/hlir/pass/fusion_helper_base.h"
+
+DECLARE_bool(cinn_ir_schedule);
+
 namespace cinn {
 namespace hlir {
 namespace pass {
@@ -148,6 +151,11 @@ class OpFusionPassHelper : public FusionHelperBase {
         if (GetOpKind(producer) == framework::kOpaque) {
           continue;
         }
+        // the fused kOutEWiseFusable group is not lowered in IR schedule yet.
+        if (FLAGS_cinn_ir_schedule && (GetOpKind(producer) == framework::kOutEWiseFusable ||
+                                       GetOpKind(consumer) == framework::kOutEWiseFusable)) {
+          continue;
+        }
         VLOG(3) << "Producer Op: " << producer->id() << ", Op Pattern: " << GetOpKind(producer)
                 << " -> Consumer Op: " << consumer->id() << ", Op Pattern: " << GetOpKind(consumer);
         bool can_fuse = true;
@@ -232,5 +232,79 @@ TEST(OpFusionPass, Test_Insert_BroadcastTo) {
   CHECK_EQ(graph->fusion_groups.size(), 1);
 }
 
+TEST(OpFusionPass, LayerNorm_Epilogue) {
+  int h = 32, w = 32;
+  NetBuilder net_builder("LayerNorm_Epilogue");
+  // create model
+  {
+    auto A = net_builder.CreateInput(Float(32), {h, w}, "A");
+    auto B = net_builder.CreateInput(Float(32), {w}, "B");
+    auto C = net_builder.CreateInput(Float(32), {w}, "C");
+    auto D = net_builder.CreateInput(Float(32), {h, w}, "D");
+    auto E = net_builder.LayerNorm(A, B, C);
+    auto F = net_builder.ElementwiseAdd(E[0], D);
+    auto G = net_builder.Relu(F);
+  }
+
+  auto program = net_builder.Build();
+  auto target  = common::DefaultTarget();
+
+  auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+  hlir::framework::ApplyPass(graph.get(), "OpFusionPass");
+  // the residual add and relu are fused into layer_norm as its epilogue.
+  CHECK_EQ(graph->fusion_groups.size(), 1);
+}
+
+TEST(OpFusionPass, LayerNorm_Epilogue_Accuracy) {
+  int h = 32, w = 64;
+  NetBuilder net_builder("LayerNorm_Epilogue_Accuracy");
+  std::string output_name;
+  // create model
+  {
+    auto A      = net_builder.CreateInput(Float(32), {h, w}, "A");
+    auto B      = net_builder.CreateInput(Float(32), {w}, "B");
+    auto C      = net_builder.CreateInput(Float(32), {w}, "C");
+    auto D      = net_builder.CreateInput(Float(32), {h, w}, "D");
+    auto E      = net_builder.LayerNorm(A, B, C);
+    auto F      = net_builder.ElementwiseAdd(E[0], D);
+    auto G      = net_builder.Relu(F);
+    output_name = G->id;
+  }
+
+  auto program = net_builder.Build();
+  auto target  = common::DefaultTarget();
+
+  std::vector<std::pair<std::string, std::vector<float>>> inputs = {{"A", {}}, {"B", {}}, {"C", {}}, {"D", {}}};
+  InitRandomVector<float>(&inputs[0].second, h * w, -1.0f, 1.0f);
+  InitRandomVector<float>(&inputs[1].second, w, 0.0f, 1.0f);
+  InitRandomVector<float>(&inputs[2].second, w, 0.0f, 1.0f);
+  InitRandomVector<float>(&inputs[3].second, h * w, -1.0f, 1.0f);
+
+  auto run = [&](bool fuse) {
+    auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+    if (fuse) {
+      hlir::framework::ApplyPass(graph.get(), "OpFusionPass");
+      CHECK_EQ(graph->fusion_groups.size(), 1);
+    }
+    auto scope = BuildScope(target, graph);
+    hlir::framework::GraphCompiler gc(target, scope, graph);
+    auto run_program = gc.Build();
+    for (auto& input : inputs) {
+      scope->Var<hlir::framework::Tensor>(input.first);
+      CopyFromVector(input.second, scope->GetTensor(input.first), target);
+    }
+    run_program->Execute();
+
+    std::vector<float> output;
+    CopyToVector(scope->GetTensor(output_name), &output);
+    return output;
+  };
+
+  // the fused epilogue computes the same result as the separate layer_norm, add and relu kernels.
+  auto unfused = run(false);
+  auto fused   = run(true);
+  CheckOutput<float>(fused, unfused, 1e-6, 1e-5);
+}
+
 }  // namespace frontend
 }  // namespace cinn
@@ -0,0 +1,111 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cmath>
+
+#include "cinn/frontend/net_builder.h"
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pass/use_pass.h"
+#include "cinn/utils/data_util.h"
+
+namespace cinn {
+namespace frontend {
+
+int CountOps(hlir::framework::Graph* graph, const std::string& op_name) {
+  int count = 0;
+  for (auto* graph_node : std::get<0>(graph->topological_order())) {
+    auto node = graph_node->safe_as<hlir::framework::Node>();
+    if (node && node->op()->name == op_name) {
+      count++;
+    }
+  }
+  return count;
+}
+
+/*
+ * GroupedGemm Test
+ *
+ * Before:
+ * (m0, k0) * (k0, n0) -> (m0, n0)
+ * (m1, k1) * (k1, n1) -> (m1, n1)
+ * (m2, k2) * (k2, n2) -> (m2, n2)
+ *
+ * After:
+ * grouped_matmul -> (m0, n0), (m1, n1), (m2, n2)
+ */
+TEST(GroupedGemm, independent_matmuls) {
+  std::vector<std::array<int, 3>> problems{{32, 64, 128}, {8, 16, 32}, {128, 256, 16}};
+  NetBuilder builder("net_builder");
+  std::vector<std::string> input_names;
+  std::vector<std::string> output_names;
+  std::vector<Variable> outputs;
+  for (int i = 0; i < problems.size(); ++i) {
+    int m = problems[i][0], k = problems[i][1], n = problems[i][2];
+    auto a = builder.CreateInput(Float(32), {m, k}, "A" + std::to_string(i));
+    auto b = builder.CreateInput(Float(32), {k, n}, "B" + std::to_string(i));
+    auto c = builder.Matmul(a, b);
+    input_names.push_back(std::string(a.id()));
+    input_names.push_back(std::string(b.id()));
+    output_names.push_back(c->id);
+    outputs.push_back(c);
+  }
+  // The matmul at the next level depends on the first one, so it can not be grouped with the others.
+  auto d       = builder.CreateInput(Float(32), {128, 8}, "D");
+  auto e       = builder.Matmul(outputs[0], d);
+  auto program = builder.Build();
+
+  Target target = common::DefaultHostTarget();
+  auto graph    = std::make_shared<hlir::framework::Graph>(program, target);
+  hlir::framework::ApplyPass(graph.get(), "GroupedGemm");
+  LOG(INFO) << "graph:\n" << graph->Visualize();
+#ifdef CINN_WITH_MKL_CBLAS
+  ASSERT_EQ(CountOps(graph.get(), "grouped_matmul"), 1);
+  ASSERT_EQ(CountOps(graph.get(), "matmul"), 1);
+#else
+  ASSERT_EQ(CountOps(graph.get(), "matmul"), 4);
+#endif
+
+  auto scope = hlir::framework::BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+  for (auto& name : input_names) {
+    SetRandData<float>(scope->GetTensor(name), target);
+  }
+  runtime_program->Execute();
+
+  for (int p = 0; p < problems.size(); ++p) {
+    int m = problems[p][0], k = problems[p][1], n = problems[p][2];
+    auto A = GetTensorData<float>(scope->GetTensor(input_names[2 * p]), target);
+    auto B = GetTensorData<float>(scope->GetTensor(input_names[2 * p + 1]), target);
+    auto C = GetTensorData<float>(scope->GetTensor(output_names[p]), target);
+    for (int i = 0; i < m; ++i) {
+      for (int j = 0; j < n; ++j) {
+        float expect = 0.f;
+        for (int l = 0; l < k; ++l) {
+          expect += A[i * k + l] * B[l * n + j];
+        }
+        ASSERT_NEAR(C[i * n + j], expect, 1e-3 * std::max(1.f, std::abs(expect)));
+      }
+    }
+  }
+}
+
+}  // namespace frontend
+}  // namespace cinn
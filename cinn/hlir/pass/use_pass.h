@@ -25,3 +25,4 @@ CINN_USE_REGISTER(DotMerger)
 CINN_USE_REGISTER(OpFusionPass)
 CINN_USE_REGISTER(FusionMergePass)
 CINN_USE_REGISTER(CustomCallPass)
+CINN_USE_REGISTER(GroupedGemm)
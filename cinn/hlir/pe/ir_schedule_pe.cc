@@ -31,6 +31,7 @@
 #include "cinn/ir/ir_base.h"
 #include "cinn/optim/ir_simplify.h"
 #include "cinn/poly/isl_utils.h"
+#include "cinn/utils/string.h"
 
 namespace cinn {
 namespace hlir {
@@ -535,6 +536,42 @@ void IRSoftmaxScheduleCPU(ir::IRSchedule &ir_sch, int axis) {
   ir_sch.ComputeAt(all_blocks[1], loops[0]);
 }
 
+void IRNormSchedule(ir::IRSchedule &ir_sch, int begin_norm_axis, const common::Target &target) {
+  ir_sch.MergeExprs();
+  auto all_blocks = ir_sch.GetAllBlocks();
+  CHECK(!all_blocks.empty());
+  // the output is the last block, the others are the statistics and their initializations.
+  std::string output_name = GetTensor(all_blocks.back())->name;
+  Type output_type        = GetTensor(all_blocks.back())->type();
+  for (int i = 1; i < begin_norm_axis; ++i) {
+    auto loops = ir_sch.GetLoops(output_name);
+    ir_sch.Fuse({loops[0], loops[1]});
+  }
+  all_blocks = ir_sch.GetAllBlocks();
+  for (int i = all_blocks.size() - 2; i >= 0; --i) {
+    auto block      = ir_sch.GetAllBlocks()[i];
+    auto block_name = block.As<ir::ScheduleBlockRealize>()->schedule_block.As<ir::ScheduleBlock>()->name;
+    if (utils::Endswith(block_name, "__reduce_init")) {
+      continue;
+    }
+    auto loops = ir_sch.GetLoops(output_name);
+    ir_sch.ComputeAt(block, loops[0]);
+  }
+  auto loops = ir_sch.GetLoops(output_name);
+  if (target.arch == Target::Arch::NVGPU) {
+    ir_sch.Bind(loops[0], "blockIdx.x");
+    return;
+  }
+  // the rows are independent, and the normalization of a row is elementwise over its innermost axis
+  ir_sch.Parallel(loops[0]);
+  loops      = ir_sch.GetLoops(output_name);
+  int factor = GetVectorizeFactor(ir::GetLoopExtent(loops.back()), GetBasicFactor(output_type, target));
+  if (factor > 1) {
+    auto splited = ir_sch.Split(loops.back(), {-1, factor});
+    ir_sch.Vectorize(splited[1], factor);
+  }
+}
+
 void IRPoolScheduleGPU(ir::IRSchedule &ir_sch, const common::Target &target) {
   auto all_blocks = ir_sch.GetAllBlocks();
   CHECK_EQ(all_blocks.size(), 1U);
@@ -74,6 +74,8 @@ void IRCudaTwoStepReduceSchedule(ir::IRSchedule &ir_sch,
 
 void IRSoftmaxScheduleCPU(ir::IRSchedule &ir_sch, int axis = -1);
 
+void IRNormSchedule(ir::IRSchedule &ir_sch, int begin_norm_axis, const common::Target &target);
+
 void IRPoolScheduleGPU(ir::IRSchedule &ir_sch, const common::Target &target);
 
 void IRGlobalPoolScheduleGPU(ir::IRSchedule &ir_sch, const common::Target &target);
@@ -786,6 +786,186 @@ std::vector<ir::Tensor> SoftmaxMKLDNN(const ir::Tensor &A, int axis, const std::
 }
 #endif
 
+namespace {
+// The indices of the input tensor whose outer axes are `outer` and normalized axes are `inner`.
+std::vector<Expr> NormInputIndice(const std::vector<Expr> &outer, const std::vector<Var> &inner) {
+  std::vector<Expr> indice(outer.begin(), outer.end());
+  indice.insert(indice.end(), inner.begin(), inner.end());
+  return indice;
+}
+
+// The index of the flattened parameters, such as scale and bias, from the normalized axes of the input indices.
+Expr NormParamIndex(const ir::Tensor &x, const std::vector<Expr> &indice, int begin_norm_axis) {
+  Expr index = indice[begin_norm_axis];
+  for (int i = begin_norm_axis + 1; i < indice.size(); ++i) {
+    index = index * x->shape[i] + indice[i];
+  }
+  return common::AutoSimplify(index);
+}
+
+std::vector<Var> NormReduceAxes(const ir::Tensor &x, int begin_norm_axis) {
+  std::vector<Var> axes;
+  for (int i = begin_norm_axis; i < x->shape.size(); ++i) {
+    axes.emplace_back(x->shape[i], UniqName("norm_k"));
+  }
+  return axes;
+}
+
+int NormSize(const ir::Tensor &x, int begin_norm_axis) {
+  CHECK(begin_norm_axis > 0 && begin_norm_axis < x->shape.size())
+      << "The begin_norm_axis should be in [1, " << x->shape.size() << "), but got " << begin_norm_axis;
+  int size = 1;
+  for (int i = begin_norm_axis; i < x->shape.size(); ++i) {
+    CHECK(x->shape[i].is_constant()) << "The normalized axes should have constant extents.";
+    size *= x->shape[i].as_int32();
+  }
+  return size;
+}
+}  // namespace
+
+/**
+ * This operator implements the layer normalization. The statistics are reductions over the rows of the normalized
+ * axes, and they are scheduled into the outer loop of the output, so that each row is loaded from memory once and the
+ * statistics, normalization and affine transform are all done while the row is in cache. The variance is reduced over
+ * the centered row rather than derived as E(x^2) - E(x)^2, which loses most of its precision to cancellation when the
+ * mean is large relative to the deviation.
+ */
+std::vector<ir::Tensor> LayerNorm(const ir::Tensor &x,
+                                  const ir::Tensor &scale,
+                                  const ir::Tensor &bias,
+                                  int begin_norm_axis,
+                                  float epsilon,
+                                  const std::string &output_name) {
+  int norm_size = NormSize(x, begin_norm_axis);
+  CHECK_EQ(scale->shape.size(), 1U) << "Scale's dimension of LayerNorm op is not 1! Please check.";
+  CHECK_EQ(bias->shape.size(), 1U) << "Bias's dimension of LayerNorm op is not 1! Please check.";
+  std::vector<Expr> outer_shape(x->shape.begin(), x->shape.begin() + begin_norm_axis);
+  Expr inv_size = common::make_const(x->type(), 1.0 / norm_size);
+
+  auto mean_axes = NormReduceAxes(x, begin_norm_axis);
+  auto mean      = Compute(
+      outer_shape,
+      [=](const std::vector<Expr> &indice) {
+        return lang::ReduceSum(x(NormInputIndice(indice, mean_axes)) * inv_size, mean_axes);
+      },
+      output_name + "_mean");
+
+  auto variance_axes = NormReduceAxes(x, begin_norm_axis);
+  auto variance      = Compute(
+      outer_shape,
+      [=](const std::vector<Expr> &indice) {
+        Expr diff = x(NormInputIndice(indice, variance_axes)) - mean(indice);
+        return lang::ReduceSum(diff * diff * inv_size, variance_axes);
+      },
+      output_name + "_variance");
+
+  auto out = Compute(
+      x->shape,
+      [=](const std::vector<Expr> &indice) {
+        std::vector<Expr> outer(indice.begin(), indice.begin() + begin_norm_axis);
+        Expr param_index = NormParamIndex(x, indice, begin_norm_axis);
+        return (x(indice) - mean(outer)) * scale(param_index) /
+                   lang::Sqrt(variance(outer) + common::make_const(x->type(), epsilon)) +
+               bias(param_index);
+      },
+      output_name);
+  return {out, mean, variance};
+}
+
+/**
+ * This operator implements the root mean square normalization, the mean square is scheduled into the outer loop of
+ * the output as LayerNorm does.
+ */
+std::vector<ir::Tensor> RMSNorm(const ir::Tensor &x,
+                                const ir::Tensor &scale,
+                                int begin_norm_axis,
+                                float epsilon,
+                                const std::string &output_name) {
+  int norm_size = NormSize(x, begin_norm_axis);
+  CHECK_EQ(scale->shape.size(), 1U) << "Scale's dimension of RMSNorm op is not 1! Please check.";
+  std::vector<Expr> outer_shape(x->shape.begin(), x->shape.begin() + begin_norm_axis);
+  Expr inv_size = common::make_const(x->type(), 1.0 / norm_size);
+
+  auto axes        = NormReduceAxes(x, begin_norm_axis);
+  auto mean_square = Compute(
+      outer_shape,
+      [=](const std::vector<Expr> &indice) {
+        Expr val = x(NormInputIndice(indice, axes));
+        return lang::ReduceSum(val * val * inv_size, axes);
+      },
+      output_name + "_mean_square");
+
+  auto out = Compute(
+      x->shape,
+      [=](const std::vector<Expr> &indice) {
+        std::vector<Expr> outer(indice.begin(), indice.begin() + begin_norm_axis);
+        return x(indice) * scale(NormParamIndex(x, indice, begin_norm_axis)) /
+               lang::Sqrt(mean_square(outer) + common::make_const(x->type(), epsilon));
+      },
+      output_name);
+  return {out, mean_square};
+}
+
+std::vector<ir::Tensor> AttentionCPU(const ir::Tensor &q,
+                                     const ir::Tensor &k,
+                                     const ir::Tensor &v,
+                                     const ir::Tensor &mask,
+                                     float scale,
+                                     bool causal,
+                                     const std::string &output_name) {
+  int rank = q->shape.size();
+  CHECK(rank == 3 || rank == 4) << "The queries of attention should be 3-D or 4-D, but got " << rank << "-D";
+  CHECK_EQ(k->shape.size(), rank) << "The keys of attention should have the same rank as the queries";
+  CHECK_EQ(v->shape.size(), rank) << "The values of attention should have the same rank as the queries";
+  // [batch, heads, seq_q, seq_k, head_dim, value_dim], a 3-D input has only one head
+  std::vector<Expr> dims = {q->shape[0],
+                            rank == 4 ? q->shape[1] : Expr(1),
+                            q->shape[rank - 2],
+                            k->shape[rank - 2],
+                            q->shape[rank - 1],
+                            v->shape[rank - 1]};
+  std::vector<Expr> args(dims.begin(), dims.end());
+  args.push_back(Expr(scale));
+  args.push_back(common::make_bool(causal));
+
+  std::string extern_name = "cinn_cpu_attention_fp32";
+  if (mask.defined()) {
+    int mask_rank = mask->shape.size();
+    CHECK(mask_rank >= 2 && mask_rank <= rank) << "The mask of attention should be 2-D to " << rank << "-D";
+    CHECK(is_zero(mask->shape.back() - dims[3])) << "The last dimension of the mask should be seq_k";
+    // Right align the mask to [batch, heads, seq_q, seq_k], the broadcasted dimensions have a zero stride.
+    std::vector<Expr> aligned_shape(4 - mask_rank, Expr(1));
+    aligned_shape.insert(aligned_shape.end(), mask->shape.begin(), mask->shape.end());
+    if (rank == 3) {
+      // the mask of 3-D inputs is [batch, seq_q, seq_k], there is no head dimension
+      aligned_shape.erase(aligned_shape.begin());
+      aligned_shape.insert(aligned_shape.begin() + 1, Expr(1));
+    }
+    std::vector<Expr> strides(4);
+    Expr stride(1);
+    for (int i = 3; i >= 0; --i) {
+      strides[i] = is_zero(aligned_shape[i] - 1) ? Expr(0) : stride;
+      stride     = common::AutoSimplify(stride * aligned_shape[i]);
+    }
+    args.push_back(strides[0]);  // mask_batch_stride
+    args.push_back(strides[1]);  // mask_head_stride
+    args.push_back(strides[2]);  // mask_row_stride
+    extern_name = "cinn_cpu_masked_attention_fp32";
+  }
+  args.push_back(q);
+  args.push_back(k);
+  args.push_back(v);
+  if (mask.defined()) {
+    args.push_back(mask);
+  }
+
+  auto call = Compute(
+      {Expr(1)}, [=]() -> Expr { return lang::CallExtern(extern_name, args); }, output_name);
+  auto out = call->TupleGet(0);
+  out->WithBuffer(q->type());
+  return {out, call};
+}
+
 /**
  * @brief Perform padding operation.
  * @param tensor The input tensor.
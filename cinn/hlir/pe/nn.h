@@ -322,6 +322,65 @@ std::vector<ir::Tensor> SoftmaxMKLDNN(const ir::Tensor &A,
                                       const std::string &output_name = UniqName("T_softmax_out"));
 #endif
 
+/**
+ * @brief Perform layer normalization over the axes [begin_norm_axis, rank) of the input.
+ *        Math: Y = (X - mean) / sqrt(variance + epsilon) * scale + bias
+ * @param x The input tensor.
+ * @param scale The scale tensor, its shape is [prod(x.shape[begin_norm_axis:])].
+ * @param bias The bias tensor, its shape is [prod(x.shape[begin_norm_axis:])].
+ * @param begin_norm_axis The first axis to be normalized.
+ * @param epsilon The param epsilon is added to avoid divide zero.
+ * @param output_name The name of the output tensor.
+ *
+ * @return The output tensor and the statistics {Y, mean, variance}, the shape of the statistics is
+ * x.shape[:begin_norm_axis].
+ */
+std::vector<ir::Tensor> LayerNorm(const ir::Tensor &x,
+                                  const ir::Tensor &scale,
+                                  const ir::Tensor &bias,
+                                  int begin_norm_axis,
+                                  float epsilon,
+                                  const std::string &output_name = UniqName("T_layer_norm_out"));
+
+/**
+ * @brief Perform root mean square normalization over the axes [begin_norm_axis, rank) of the input.
+ *        Math: Y = X / sqrt(mean(X * X) + epsilon) * scale
+ * @param x The input tensor.
+ * @param scale The scale tensor, its shape is [prod(x.shape[begin_norm_axis:])].
+ * @param begin_norm_axis The first axis to be normalized.
+ * @param epsilon The param epsilon is added to avoid divide zero.
+ * @param output_name The name of the output tensor.
+ *
+ * @return The output tensor and the mean square {Y, mean_square}.
+ */
+std::vector<ir::Tensor> RMSNorm(const ir::Tensor &x,
+                                const ir::Tensor &scale,
+                                int begin_norm_axis,
+                                float epsilon,
+                                const std::string &output_name = UniqName("T_rms_norm_out"));
+
+/**
+ * @brief Perform the fused scaled dot product attention on CPU by calling the extern blocked online-softmax kernel.
+ *        Math: Y = softmax(scale * Q * K^T + mask) * V
+ * @param q The queries with shape [batch, seq_q, head_dim] or [batch, heads, seq_q, head_dim].
+ * @param k The keys with shape [..., seq_k, head_dim], the leading dimensions are the same as q's.
+ * @param v The values with shape [..., seq_k, value_dim], the leading dimensions are the same as q's.
+ * @param mask The optional additive mask, an undefined tensor means no mask. Its shape is broadcastable to
+ * [..., seq_q, seq_k] except that the last dimension must be seq_k.
+ * @param scale The scaling factor of the scores.
+ * @param causal Whether the query i only attends to the keys j <= i + seq_k - seq_q.
+ * @param output_name The name of the output tensor.
+ *
+ * @return The output tensor with shape [..., seq_q, value_dim] and the tuple tensor of the extern call.
+ */
+std::vector<ir::Tensor> AttentionCPU(const ir::Tensor &q,
+                                     const ir::Tensor &k,
+                                     const ir::Tensor &v,
+                                     const ir::Tensor &mask,
+                                     float scale,
+                                     bool causal,
+                                     const std::string &output_name = UniqName("T_attention_out"));
+
 /**
  * @brief Perform pooling on the width dimension of the tensor.
  *        Width axis is determined by the data_format string in which 'W' means width. Only support NCW and NWC
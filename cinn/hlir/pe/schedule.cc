@@ -566,6 +566,34 @@ void SoftmaxScheduleCPU(poly::StageMap stage, const ir::Tensor &output, const ir
   stage[temp]->ComputeAt(stage[output], 0);
 }
 
+void NormSchedule(poly::StageMap stages,
+                  const ir::Tensor &output,
+                  const std::vector<ir::Tensor> &stats,
+                  int begin_norm_axis,
+                  const common::Target &target) {
+  for (int i = 1; i < begin_norm_axis; i++) {
+    stages[output]->Fuse(0, 1);
+  }
+  CHECK_GT(stages[output]->n_out_dims(), 1);
+  for (auto &stat : stats) {
+    stages[stat]->ComputeAt(stages[output], 0);
+  }
+  if (target.arch == Target::Arch::NVGPU) {
+    stages[output]->Bind(0, "blockIdx.x");
+    return;
+  }
+  stages[output]->Parallel(0);
+  int dims       = stages[output]->n_out_dims();
+  int last_shape = stages[output]->GetDimRange(dims - 1);
+  int factor     = GetVectorizeFactor(last_shape, GetBasicFactor(output->type(), target));
+  if (factor > 1) {
+    poly::Iterator lo;
+    poly::Iterator li;
+    std::tie(lo, li) = stages[output]->Split(stages[output]->axis(dims - 1), factor);
+    stages[output]->Vectorize(li, factor);
+  }
+}
+
 void GlobalPoolScheduleGPU(poly::StageMap stages, const std::vector<ir::Tensor> &output, const common::Target &target) {
   auto &out    = output[0];
   auto &reduce = output[1];
@@ -87,6 +87,17 @@ void MulScheduleCPU(poly::StageMap stage,
 
 void SoftmaxScheduleCPU(poly::StageMap stage, const ir::Tensor &output, const ir::Tensor &temp, int axis = -1);
 
+/**
+ * Schedule the normalization ops such as layer_norm and rms_norm. The axes before begin_norm_axis are fused into one
+ * outer loop, and the statistics in `stats`, along with the temporary reductions they depend on, are computed at the
+ * outer loop of the output.
+ */
+void NormSchedule(poly::StageMap stages,
+                  const ir::Tensor &output,
+                  const std::vector<ir::Tensor> &stats,
+                  int begin_norm_axis,
+                  const common::Target &target);
+
 void GetConv2dFactors(absl::flat_hash_map<std::string, int> *factors,
                       int oc,
                       int ic,
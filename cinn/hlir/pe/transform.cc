@@ -405,6 +405,49 @@ std::vector<Tensor> MatmulMKL(const Tensor& A,
   return {out, call};
 }
 
+std::vector<Tensor> GroupedMatmulMKL(const std::vector<Tensor>& A,
+                                     const std::vector<Tensor>& B,
+                                     bool trans_a,
+                                     bool trans_b,
+                                     float alpha,
+                                     const std::string& name,
+                                     const common::Target& target) {
+  CHECK(target.arch == Target::Arch::X86) << "mkl should be used in the cpu environment";
+  CHECK_EQ(A.size(), B.size()) << "The number of tensor_A and tensor_B should be same";
+  int group_size = A.size();
+  CHECK(group_size >= 2 && group_size <= 4) << "The grouped gemm only supports 2 to 4 problems, but got " << group_size;
+
+  std::vector<Expr> args{Expr(alpha), common::make_bool(trans_a), common::make_bool(trans_b)};
+  for (int i = 0; i < group_size; ++i) {
+    std::vector<Expr> shape_A = A[i]->shape;
+    std::vector<Expr> shape_B = B[i]->shape;
+    CHECK_EQ(shape_A.size(), 2U) << "tensor_A's dim should be 2 while current dim is " << shape_A.size();
+    CHECK_EQ(shape_B.size(), 2U) << "tensor_B's dim should be 2 while current dim is " << shape_B.size();
+    Expr x_width  = trans_a ? shape_A[0] : shape_A[1];
+    Expr y_height = trans_b ? shape_B[1] : shape_B[0];
+    CHECK(is_zero(x_width - y_height)) << "matrix multiplication requires x_width to be same with y_height";
+    args.push_back(trans_a ? shape_A[1] : shape_A[0]);  // M
+    args.push_back(trans_b ? shape_B[0] : shape_B[1]);  // N
+    args.push_back(x_width);                            // K
+  }
+  for (int i = 0; i < group_size; ++i) {
+    args.push_back(A[i]);
+    args.push_back(B[i]);
+  }
+
+  std::string extern_name = "cinn_cpu_mkl_gemm_grouped" + std::to_string(group_size) + "_fp32";
+  ir::Tensor call = Compute(
+      {Expr(1)}, [=]() -> Expr { return lang::CallExtern(extern_name, args); }, name);
+  std::vector<Tensor> res;
+  for (int i = 0; i < group_size; ++i) {
+    auto out = call->TupleGet(i);
+    out->WithBuffer(A[i]->type());
+    res.push_back(out);
+  }
+  res.push_back(call);
+  return res;
+}
+
 int GetMulFactor(int shape, const Type& type, const common::Target& target) {
   int split_base   = GetBasicFactor(type, target);
   int split_factor = 1;
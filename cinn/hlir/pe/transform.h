@@ -81,6 +81,26 @@ std::vector<ir::Tensor> MatmulMKL(const ir::Tensor& A,
                                   const std::string& name      = UniqName("T_Transform_MatmulMKL_out"),
                                   const common::Target& target = common::DefaultHostTarget());
 
+/**
+ * @brief Compute a group of independent 2-D matrix multiplications with one grouped GEMM extern call, the group
+ * size should be in [2, 4].
+ *
+ * @param A The first operands of the matrix multiplications
+ * @param B The second operands of the matrix multiplications
+ * @param trans_a Whether to transpose the operands in A
+ * @param trans_b Whether to transpose the operands in B
+ * @param alpha The scaling factor shared by the group
+ *
+ * @return The outputs of the matrix multiplications followed by the tuple tensor of the extern call
+ */
+std::vector<ir::Tensor> GroupedMatmulMKL(const std::vector<ir::Tensor>& A,
+                                         const std::vector<ir::Tensor>& B,
+                                         bool trans_a                 = false,
+                                         bool trans_b                 = false,
+                                         float alpha                  = 1,
+                                         const std::string& name      = UniqName("T_Transform_GroupedMatmulMKL_out"),
+                                         const common::Target& target = common::DefaultHostTarget());
+
 int GetMulFactor(int shape, const Type& type, const common::Target& target);
 
 /**
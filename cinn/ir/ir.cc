@@ -349,12 +349,14 @@ IfThenElse::IfThenElse(Expr condition, Expr true_case, Expr false_case)
 std::vector<Expr *> IfThenElse::expr_fields() { return {&condition, &true_case, &false_case}; }
 std::vector<const Expr *> IfThenElse::expr_fields() const { return {&condition, &true_case, &false_case}; }
 
-Expr Store::Make(Expr tensor, Expr value, const std::vector<Expr> &indices) {
+Expr Store::Make(Expr tensor, Expr value, const std::vector<Expr> &indices, bool flattened, bool nontemporal) {
   CHECK(tensor.As<_Tensor_>()) << "tensor should be _Tensor_ type";
-  auto node     = make_shared<Store>();
-  node->tensor  = tensor;
-  node->value   = value;
-  node->indices = indices;
+  auto node         = make_shared<Store>();
+  node->tensor      = tensor;
+  node->value       = value;
+  node->indices     = indices;
+  node->flattened   = flattened;
+  node->nontemporal = nontemporal;
 
   if (tensor->type() != Void()) {
     node->set_type(tensor->type().ElementOf().with_lanes(node->index().type().lanes()));
@@ -365,6 +367,12 @@ Expr Store::Make(Expr tensor, Expr value, const std::vector<Expr> &indices) {
 Expr Store::index() const {
   auto *tensor_n = tensor.As<ir::_Tensor_>();
   CHECK(tensor_n);
+  if (flattened) {
+    CHECK_EQ(indices.size(), 1UL) << "The flattened store to " << tensor_n->name << " should have one offset";
+    return indices[0];
+  }
+  CHECK_EQ(indices.size(), tensor_n->shape.size())
+      << "The indices of the store to " << tensor_n->name << " mismatch the tensor's shape";
   VLOG(3) << "Begin Store::index IndiceToAbsOffset";
   Expr res = common::IndiceToAbsOffset(tensor_n->shape, indices);
   VLOG(3) << "Begin Store::index Simplify";
@@ -539,13 +547,14 @@ Var &Var::operator=(const _Var_ *x) {
   return *this;
 }
 
-Expr Load::Make(Expr tensor, const std::vector<Expr> &indices) {
+Expr Load::Make(Expr tensor, const std::vector<Expr> &indices, bool flattened) {
   CHECK(tensor->type().valid());
   CHECK(!indices.empty());
   for (auto &idx : indices) CHECK_EQ(idx.type().ElementOf(), Int(32));
-  auto node     = make_shared<Load>();
-  node->tensor  = tensor;
-  node->indices = indices;
+  auto node       = make_shared<Load>();
+  node->tensor    = tensor;
+  node->indices   = indices;
+  node->flattened = flattened;
   node->set_type(node->type());
   return Expr(node);
 }
@@ -577,6 +586,12 @@ Expr Load::index() const {
   if (is_addr_tensor()) {
     auto *tensor_n = tensor.As<_Tensor_>();
     CHECK(tensor_n);
+    if (flattened) {
+      CHECK_EQ(indices.size(), 1UL) << "The flattened load from " << tensor_n->name << " should have one offset";
+      return indices[0];
+    }
+    CHECK_EQ(indices.size(), tensor_n->shape.size())
+        << "The indices of the load from " << tensor_n->name << " mismatch the tensor's shape";
     VLOG(3) << "Begin Load::index IndiceToAbsOffset";
     Expr res = common::IndiceToAbsOffset(tensor_n->shape, indices);
     VLOG(3) << "Begin Load::index Simplify";
@@ -490,6 +490,8 @@ struct Select : public ExprNode<Select> {
 
 struct LoadStoreAddrMnger {
   Expr tensor;  // Should be a tensor or a scalar.
+  //! The indices have been flattened into one offset of the buffer, e.g. by LoopInvariantCodeMotion.
+  bool flattened{false};
   //! Tell whether the address is a tensor.
   bool is_addr_tensor() const;
   //! Tell whether the address is a scalar.
@@ -504,7 +506,7 @@ struct Load : public ExprNode<Load>, public LoadStoreAddrMnger {
   //! The abstract offset.
   Expr index() const;
 
-  static Expr Make(Expr tensor, const std::vector<Expr>& indices);
+  static Expr Make(Expr tensor, const std::vector<Expr>& indices, bool flattened = false);
 
   std::vector<Expr*> expr_fields() override;
   std::vector<const Expr*> expr_fields() const override;
@@ -524,8 +526,11 @@ struct Load : public ExprNode<Load>, public LoadStoreAddrMnger {
 struct Store : public ExprNode<Store>, public LoadStoreAddrMnger {
   Expr value;
   std::vector<Expr> indices;
+  // hint the backend to write around the caches, which is set on the outputs streamed once
+  bool nontemporal{false};
 
-  static Expr Make(Expr tensor, Expr value, const std::vector<Expr>& indices);
+  static Expr Make(
+      Expr tensor, Expr value, const std::vector<Expr>& indices, bool flattened = false, bool nontemporal = false);
 
   std::vector<Expr*> expr_fields() override;
   std::vector<const Expr*> expr_fields() const override;
@@ -996,6 +1001,12 @@ namespace attr {
 
 // max permitted steps for auto_unroll, used in unroll_loop pass
 constexpr const char* auto_unroll_max_step = "auto_unroll_max_step";
+// number of the innermost loop iterations to prefetch the loaded data ahead, 0 disables the prefetch,
+// used in prefetch_and_nontemporal_store pass
+constexpr const char* prefetch_distance = "prefetch_distance";
+// whether to write the stored data with non-temporal stores, decided by the buffer size if not set,
+// used in prefetch_and_nontemporal_store pass
+constexpr const char* nontemporal_store = "nontemporal_store";
 
 }  // namespace attr
 
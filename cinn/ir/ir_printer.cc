@@ -231,6 +231,9 @@ void IrPrinter::Visit(const Load *x) {
   os_ << "]";
 }
 void IrPrinter::Visit(const Store *x) {
+  if (x->nontemporal) {
+    os_ << "nontemporal ";
+  }
   if (x->is_addr_tensor()) {
     auto *tensor_node = x->tensor.As<ir::_Tensor_>();
     CHECK(tensor_node);
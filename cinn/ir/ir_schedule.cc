@@ -43,6 +43,7 @@ namespace cinn {
 namespace ir {
 
 std::vector<Expr> IRSchedule::Split(const Expr& loop, const std::vector<int>& factors) {
+  RecordGuard guard(this, "Split", {loop}, {{"factors", factors}});
   CHECK(loop.As<ir::For>()) << "Expr param of Split must be For node! Please check.";
   auto* for_node = loop.As<ir::For>();
   CHECK(common::is_zero(for_node->min)) << "The For node must start with 0! Please check.";
@@ -85,6 +86,7 @@ std::vector<Expr> IRSchedule::Split(const std::string& block_name, int loop_inde
 }
 
 Expr IRSchedule::Fuse(const std::vector<Expr>& loops) {
+  RecordGuard guard(this, "Fuse", loops);
   VLOG(3) << "Tring to fuse : ";
   for (auto& i : loops) VLOG(3) << i;
   std::vector<const ir::For*> for_nodes;
@@ -166,6 +168,7 @@ Expr IRSchedule::Fuse(const Expr& block, const std::vector<int>& loops_index) {
 }
 
 void IRSchedule::MutateForType(const Expr& loop, ForType for_type, int factor) {
+  RecordGuard guard(this, "MutateForType", {loop}, {{"for_type", static_cast<int>(for_type)}, {"factor", factor}});
   auto* for_node = loop.As<ir::For>();
   CHECK(for_node) << "loop param must be For node! Please check.";
   CHECK(for_node->is_serial()) << "loop is not serial, current forloop type is "
@@ -517,6 +520,7 @@ struct RfCreater : public ir::IRMutator<> {
 };
 
 Expr IRSchedule::Rfactor(const Expr& rf_loop, int rf_axis) {
+  RecordGuard guard(this, "Rfactor", {rf_loop}, {{"rf_axis", rf_axis}});
   CHECKRfactorValidation(rf_loop, rf_axis);
   // get root ScheduleBlockRealize
   Expr root = GetRootBlock(rf_loop);
@@ -592,17 +596,24 @@ struct CacheWriteRewriter : public ir::IRMutator<> {
   }
 
   void Visit(const ir::ScheduleBlock* expr, Expr* op) override {
+    bool is_write_block = false;
     if (op->As<ScheduleBlock>()->name == info_->write_tensor->name) {
       op->As<ScheduleBlock>()->name = info_->read_tensor->name;
+      is_write_block                = !mutate_cache_block;
     } else if (op->As<ScheduleBlock>()->name == info_->read_tensor->name) {
       op->As<ScheduleBlock>()->name = info_->write_tensor->name;
+    } else if (op->As<ScheduleBlock>()->name == GenReduceInitTensorNameOf(info_->write_tensor->name)) {
+      op->As<ScheduleBlock>()->name = GenReduceInitTensorNameOf(info_->read_tensor->name);
     }
+    in_write_block = is_write_block;
     IRMutator::Visit(expr, op);
+    in_write_block = false;
   }
 
   void Visit(const ir::Load* expr, Expr* op) override {
     IRMutator::Visit(expr, op);
-    if (op->As<Load>()->tensor == Expr(info_->write_tensor) && mutate_cache_block) {
+    // a block accumulating on its output, such as a reduction, reads the cache as well
+    if (op->As<Load>()->tensor == Expr(info_->write_tensor) && (mutate_cache_block || in_write_block)) {
       op->As<Load>()->tensor = Expr(info_->read_tensor);
     } else if (op->As<Load>()->tensor == Expr(info_->read_tensor) && mutate_cache_block) {
       op->As<Load>()->tensor = Expr(info_->write_tensor);
@@ -611,10 +622,21 @@ struct CacheWriteRewriter : public ir::IRMutator<> {
 
   void Visit(const ir::Store* expr, Expr* op) override {
     IRMutator::Visit(expr, op);
+    Tensor tensor = op->As<Store>()->tensor.as_tensor_ref();
     if (op->As<Store>()->tensor == Expr(info_->write_tensor)) {
       op->As<Store>()->tensor = Expr(info_->read_tensor);
     } else if (op->As<Store>()->tensor == Expr(info_->read_tensor) && mutate_cache_block) {
       op->As<Store>()->tensor = Expr(info_->write_tensor);
+    } else if (!mutate_cache_block && tensor->name == GenReduceInitTensorNameOf(info_->write_tensor->name)) {
+      // the reduction is initialized on the cache, by a tensor sharing its buffer
+      if (!cache_init_tensor.defined()) {
+        cache_init_tensor = lang::Compute(
+            tensor->shape,
+            [=](const std::vector<Expr>& dims) { return tensor(dims); },
+            GenReduceInitTensorNameOf(info_->read_tensor->name));
+        cache_init_tensor->Bind(info_->read_tensor->buffer);
+      }
+      op->As<Store>()->tensor = Expr(cache_init_tensor);
     }
   }
 
@@ -625,6 +647,10 @@ struct CacheWriteRewriter : public ir::IRMutator<> {
   CacheBlockInfo* info_;
   /*! \brief Are we mutating the cache tensor's block */
   bool mutate_cache_block{true};
+  /*! \brief Are we mutating the block writing the original tensor */
+  bool in_write_block{false};
+  /*! \brief The tensor to initialize the cache if the written tensor is a reduction */
+  Tensor cache_init_tensor;
 };
 
 //! Visit all ScheduleBlock and change its body to ir::Block if it is not.
@@ -655,6 +681,8 @@ DeviceAPI IRSchedule::GetDeviceAPI() const {
 }
 
 Expr IRSchedule::CacheRead(const Expr& block, int read_tensor_index, const std::string& memory_type) {
+  RecordGuard guard(
+      this, "CacheRead", {block}, {{"read_buffer_index", read_tensor_index}, {"memory_type", memory_type}});
   CHECK(block.As<ScheduleBlockRealize>());
   auto root = GetRootBlock(block);
   ChangeBodyToBlock::Change(&root);
@@ -676,6 +704,8 @@ Expr IRSchedule::CacheRead(const Expr& block, int read_tensor_index, const std::
 }
 
 Expr IRSchedule::CacheWrite(const Expr& block, int write_buffer_index, const std::string& memory_type) {
+  RecordGuard guard(
+      this, "CacheWrite", {block}, {{"write_buffer_index", write_buffer_index}, {"memory_type", memory_type}});
   CHECK(block.As<ScheduleBlockRealize>());
   auto root = GetRootBlock(block);
   ChangeBodyToBlock::Change(&root);
@@ -753,6 +783,7 @@ struct InsertExpr : public ir::IRMutator<> {
 };
 
 void IRSchedule::SyncThreads(const Expr& ir_node, bool after_node) {
+  RecordGuard guard(this, "SyncThreads", {ir_node}, {{"after_node", after_node}});
   CHECK(ir_node.As<ScheduleBlockRealize>() || ir_node.As<ir::For>());
   auto root = GetRootBlock(ir_node);
   ChangeBodyToBlock::Change(&root);
@@ -761,11 +792,36 @@ void IRSchedule::SyncThreads(const Expr& ir_node, bool after_node) {
   return;
 }
 
+void IRSchedule::Prefetch(const Expr& block, int distance) {
+  RecordGuard guard(this, "Prefetch", {block}, {{"distance", distance}});
+  CHECK(block.As<ir::ScheduleBlockRealize>()) << "Expr param(block) is not a ScheduleBlockRealize!";
+  CHECK_GE(distance, 0) << "The prefetch distance should be non-negative";
+  Expr schedule_block = block.As<ir::ScheduleBlockRealize>()->schedule_block;
+  schedule_block.As<ir::ScheduleBlock>()->attrs[attr::prefetch_distance] = distance;
+}
+
+void IRSchedule::NonTemporalStore(const Expr& block, bool enable) {
+  RecordGuard guard(this, "NonTemporalStore", {block}, {{"enable", enable}});
+  CHECK(block.As<ir::ScheduleBlockRealize>()) << "Expr param(block) is not a ScheduleBlockRealize!";
+  Expr schedule_block = block.As<ir::ScheduleBlockRealize>()->schedule_block;
+  schedule_block.As<ir::ScheduleBlock>()->attrs[attr::nontemporal_store] = enable;
+}
+
 IRSchedule::IRSchedule(const ModuleExpr& module_expr, bool debug_flag) {
   ScheduleHelper sch_helper(module_expr, debug_flag);
   helper_ = sch_helper;
 }
 
+IRSchedule::RecordGuard::RecordGuard(IRSchedule* schedule,
+                                     const std::string& type,
+                                     const std::vector<Expr>& inputs,
+                                     const std::map<std::string, utils::Attribute>& attrs)
+    : schedule_(schedule) {
+  if (schedule_->record_depth_++ == 0) {
+    schedule_->trace_.Append(*schedule_, type, inputs, attrs);
+  }
+}
+
 /**
  * Replace a For node to another For node.
  * @param src_sref The For node to be changed.
@@ -819,6 +875,7 @@ void ScheduleHelper::Replace(const Expr& src_sref, const Expr& tgt_stmt) {
 }
 
 void IRSchedule::Reorder(const std::vector<Expr>& loops) {
+  RecordGuard guard(this, "Reorder", loops);
   if (loops.size() <= 1) return;
   std::set<Expr, CompExpr> loop_set = CollectLoopsToSet(loops);
   auto boundary                     = GetBoundaryOfReorderRange(loop_set);
@@ -964,6 +1021,7 @@ struct FixLocalBufferSize : public ir::IRMutator<> {
 };
 
 void IRSchedule::SetBuffer(Expr& block, const std::string& memory_type, bool fixed) {
+  RecordGuard guard(this, "SetBuffer", {block}, {{"memory_type", memory_type}, {"fixed", fixed}});
   CHECK(block.As<ir::ScheduleBlockRealize>());
   auto find_tensor = ir::CollectIRNodesWithoutTensor(
       block, [&](const Expr* x) { return x->As<ir::Store>(); }, true);
@@ -990,6 +1048,7 @@ void IRSchedule::SetBuffer(Expr& block, const std::string& memory_type, bool fix
 }
 
 void IRSchedule::MergeExprs() {
+  RecordGuard guard(this, "MergeExprs", {});
   auto exprs = this->GetModule().GetExprs();
   if (exprs.size() == 1U) return;
   CHECK(exprs[0].As<ir::Block>());
@@ -1025,6 +1084,7 @@ void IRSchedule::MergeExprs() {
 }
 
 void IRSchedule::ComputeAt(const Expr& block, const Expr& loop) {
+  RecordGuard guard(this, "ComputeAt", {block, loop});
   CHECK(block.As<ir::ScheduleBlockRealize>());
   CHECK(loop.As<ir::For>());
   Expr root      = this->GetRootBlock(block);
@@ -1043,6 +1103,7 @@ void IRSchedule::ComputeAt(const Expr& block, const Expr& loop) {
 }
 
 void IRSchedule::SimpleComputeAt(const Expr& block, const Expr& loop) {
+  RecordGuard guard(this, "SimpleComputeAt", {block, loop});
   VLOG(3) << "Begin SimpleComputeAt of block:\n" << block << " and loop:\n" << loop;
   CHECK(block.As<ir::ScheduleBlockRealize>());
   CHECK(loop.As<ir::For>());
@@ -1197,6 +1258,7 @@ Expr ComputeInliner::ReplaceInlinedTensor(Expr* load) {
 }
 
 void IRSchedule::ComputeInline(const Expr& schedule_block) {
+  RecordGuard guard(this, "ComputeInline", {schedule_block});
   CHECK(schedule_block.As<ir::ScheduleBlockRealize>());
   Expr root  = this->GetRootBlock(schedule_block);
   Expr store = CheckComputeInlineValidationAndGetStore(schedule_block, root);
@@ -1275,6 +1337,7 @@ void IRSchedule::CopyTransformAndLoopInfo(const std::string& block_name, const s
 }
 
 void IRSchedule::CopyTransformAndLoopInfo(const Expr& block, const Expr& block_target) {
+  RecordGuard guard(this, "CopyTransformAndLoopInfo", {block, block_target});
   CHECK(block.As<ir::ScheduleBlockRealize>());
   CHECK(block_target.As<ir::ScheduleBlockRealize>());
   auto exprs = this->GetModule().GetExprs();
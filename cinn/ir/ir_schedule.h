@@ -21,7 +21,9 @@
 #include "cinn/ir/ir.h"
 #include "cinn/ir/ir_base.h"
 #include "cinn/ir/ir_mutator.h"
+#include "cinn/ir/schedule_trace.h"
 #include "cinn/ir/tensor.h"
+#include "cinn/utils/type_defs.h"
 
 namespace cinn {
 namespace ir {
@@ -292,6 +294,20 @@ class IRSchedule {
    */
   void Bind(const Expr& loop, const std::string& thread_axis);
 
+  /**
+   * \brief Prefetch the data loaded in the block some iterations of the innermost loop ahead on CPU.
+   * @param block the ScheduleBlockRealize loading the data.
+   * @param distance the number of the innermost loop iterations to prefetch ahead, 0 disables the prefetch.
+   */
+  void Prefetch(const Expr& block, int distance);
+
+  /**
+   * \brief Set whether the block writes its output with non-temporal stores on CPU, which bypass the caches.
+   * @param block the ScheduleBlockRealize storing the output.
+   * @param enable whether to use the non-temporal stores.
+   */
+  void NonTemporalStore(const Expr& block, bool enable = true);
+
   //! Copy another block's schedule transform.
   void CopyTransformAndLoopInfo(const Expr& block, const Expr& block_target);
 
@@ -339,8 +355,29 @@ class IRSchedule {
 
   void MergeExprs();
 
+  //! Get the trace of the schedule primitives applied on this IRSchedule.
+  const ScheduleTrace& GetTrace() const { return trace_; }
+
  private:
+  /**
+   * Record a primitive into trace_ if it is not applied inside another primitive. The inputs are referred to when the
+   * guard is constructed, that is before the primitive modifies the ModuleExpr.
+   */
+  class RecordGuard {
+   public:
+    RecordGuard(IRSchedule* schedule,
+                const std::string& type,
+                const std::vector<Expr>& inputs,
+                const std::map<std::string, utils::Attribute>& attrs = {});
+    ~RecordGuard() { --schedule_->record_depth_; }
+
+   private:
+    IRSchedule* schedule_;
+  };
+
   ScheduleHelper helper_;
+  ScheduleTrace trace_;
+  int record_depth_{0};
 };
 
 /*!
@@ -0,0 +1,243 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/ir/schedule_trace.h"
+
+#include <glog/logging.h>
+
+#include <string>
+#include <vector>
+
+#include "cinn/common/ir_util.h"
+#include "cinn/ir/ir_printer.h"
+#include "cinn/ir/ir_schedule.h"
+#include "cinn/ir/ir_schedule_util.h"
+
+namespace cinn {
+namespace ir {
+
+namespace {
+
+template <typename T>
+T GetStepAttr(const ScheduleTrace::Step& step, const std::string& key) {
+  auto it = step.attrs.find(key);
+  CHECK(it != step.attrs.end()) << "Attribute " << key << " of step " << step.type << " is not found";
+  CHECK(absl::holds_alternative<T>(it->second)) << "Attribute " << key << " of step " << step.type << " has wrong type";
+  return absl::get<T>(it->second);
+}
+
+// Find all the schedule blocks named block_name in the ModuleExpr of schedule
+std::vector<Expr> FindBlocksByName(const IRSchedule& schedule, const std::string& block_name) {
+  std::vector<Expr> result;
+  for (auto& it_expr : schedule.GetModule().GetExprs()) {
+    FindBlocksVisitor visitor;
+    for (auto& block : visitor(&it_expr)) {
+      if (GetTensor(block)->name == block_name) {
+        result.emplace_back(block);
+      }
+    }
+  }
+  return result;
+}
+
+// Whether Split can apply the factors on the loop without failing its checks, the factors recorded on a task
+// may not fit the extent of a related task with another shape
+bool FactorsFitLoop(const std::vector<int>& factors, const Expr& loop) {
+  const ir::For* for_node = loop.As<ir::For>();
+  if (!for_node || !common::is_zero(for_node->min) || !for_node->extent.is_constant() || factors.empty()) {
+    return false;
+  }
+  int product       = 1;
+  int num_minus_one = 0;
+  for (int factor : factors) {
+    if (factor == -1) {
+      ++num_minus_one;
+    } else if (factor <= 0) {
+      return false;
+    } else {
+      product *= factor;
+    }
+  }
+  int extent = for_node->extent.get_constant();
+  return num_minus_one == 0 ? product == extent : num_minus_one == 1 && product <= extent;
+}
+
+}  // namespace
+
+bool ScheduleTrace::MakeRef(const IRSchedule& schedule, const Expr& expr, ExprRef* ref) {
+  if (expr.As<ir::ScheduleBlockRealize>()) {
+    if (expr.As<ir::ScheduleBlockRealize>()->iter_values.empty()) {
+      // root block can't be found by name
+      return false;
+    }
+    if (FindBlocksByName(schedule, GetTensor(expr)->name).size() != 1) {
+      // the block can't be found by an ambiguous name
+      return false;
+    }
+    ref->block_name = GetTensor(expr)->name;
+    ref->loop_index = -1;
+    return true;
+  }
+  if (!expr.As<ir::For>()) {
+    return false;
+  }
+  // refer to the loop by the first schedule block in its body
+  FindBlocksVisitor visitor;
+  auto blocks = visitor(&expr);
+  if (blocks.empty()) {
+    return false;
+  }
+  if (FindBlocksByName(schedule, GetTensor(blocks[0])->name).size() != 1) {
+    return false;
+  }
+  auto loops = schedule.GetLoops(blocks[0]);
+  for (int i = 0; i < loops.size(); ++i) {
+    if (loops[i] == expr) {
+      ref->block_name = GetTensor(blocks[0])->name;
+      ref->loop_index = i;
+      return true;
+    }
+  }
+  return false;
+}
+
+Expr ScheduleTrace::Resolve(const IRSchedule& schedule, const ExprRef& ref) {
+  auto blocks = FindBlocksByName(schedule, ref.block_name);
+  if (blocks.size() > 1) {
+    LOG(WARNING) << "The name of block " << ref.block_name << " is ambiguous, " << blocks.size()
+                 << " blocks are found";
+    return Expr();
+  }
+  Expr block = blocks.empty() ? Expr() : blocks[0];
+  if (!block.defined() || ref.loop_index < 0) {
+    return block;
+  }
+  auto loops = schedule.GetLoops(block);
+  return ref.loop_index < loops.size() ? loops[ref.loop_index] : Expr();
+}
+
+void ScheduleTrace::Append(const IRSchedule& schedule,
+                           const std::string& type,
+                           const std::vector<Expr>& inputs,
+                           const std::map<std::string, utils::Attribute>& attrs) {
+  Step step;
+  step.type  = type;
+  step.attrs = attrs;
+  step.inputs.resize(inputs.size());
+  for (int i = 0; i < inputs.size(); ++i) {
+    if (!MakeRef(schedule, inputs[i], &step.inputs[i])) {
+      VLOG(3) << "Input " << i << " of " << type << " can't be referred to, the trace becomes unreplayable";
+      replayable_ = false;
+    }
+  }
+  steps_.emplace_back(std::move(step));
+}
+
+void ScheduleTrace::Append(const ScheduleTrace& other) {
+  steps_.insert(steps_.end(), other.steps_.begin(), other.steps_.end());
+  replayable_ = replayable_ && other.replayable_;
+}
+
+bool ScheduleTrace::RenameBlocks(const std::vector<std::string>& names, const std::vector<std::string>& new_names) {
+  if (names.size() != new_names.size()) {
+    return false;
+  }
+  std::map<std::string, std::string> name_map;
+  for (size_t i = 0; i < names.size(); ++i) {
+    name_map[names[i]] = new_names[i];
+  }
+  for (auto& step : steps_) {
+    for (auto& ref : step.inputs) {
+      // the prefixes of block_name sort before it and the longer ones after the shorter ones, so the first prefix
+      // found backwards is the longest
+      auto it = name_map.upper_bound(ref.block_name);
+      while (it != name_map.begin()) {
+        --it;
+        if (ref.block_name.compare(0, it->first.size(), it->first) == 0) {
+          ref.block_name = it->second + ref.block_name.substr(it->first.size());
+          break;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+bool ScheduleTrace::Replay(IRSchedule* schedule) const {
+  if (!replayable_) {
+    return false;
+  }
+  for (auto& step : steps_) {
+    std::vector<Expr> inputs;
+    for (auto& ref : step.inputs) {
+      inputs.push_back(Resolve(*schedule, ref));
+      if (!inputs.back().defined()) {
+        LOG(WARNING) << "Can't find the loop " << ref.loop_index << " of block " << ref.block_name << " when replaying "
+                     << step.type;
+        return false;
+      }
+    }
+    VLOG(4) << "Replay " << step.type << " with " << inputs.size() << " inputs";
+    if (step.type == "Split") {
+      auto factors = GetStepAttr<std::vector<int>>(step, "factors");
+      if (!FactorsFitLoop(factors, inputs[0])) {
+        LOG(WARNING) << "The factors of Split don't fit the loop of block " << step.inputs[0].block_name;
+        return false;
+      }
+      schedule->Split(inputs[0], factors);
+    } else if (step.type == "Fuse") {
+      schedule->Fuse(inputs);
+    } else if (step.type == "ComputeAt") {
+      schedule->ComputeAt(inputs[0], inputs[1]);
+    } else if (step.type == "SimpleComputeAt") {
+      schedule->SimpleComputeAt(inputs[0], inputs[1]);
+    } else if (step.type == "CacheRead") {
+      schedule->CacheRead(inputs[0],
+                          GetStepAttr<int>(step, "read_buffer_index"),
+                          GetStepAttr<std::string>(step, "memory_type"));
+    } else if (step.type == "CacheWrite") {
+      schedule->CacheWrite(inputs[0],
+                           GetStepAttr<int>(step, "write_buffer_index"),
+                           GetStepAttr<std::string>(step, "memory_type"));
+    } else if (step.type == "SyncThreads") {
+      schedule->SyncThreads(inputs[0], GetStepAttr<bool>(step, "after_node"));
+    } else if (step.type == "SetBuffer") {
+      schedule->SetBuffer(inputs[0], GetStepAttr<std::string>(step, "memory_type"), GetStepAttr<bool>(step, "fixed"));
+    } else if (step.type == "Reorder") {
+      schedule->Reorder(inputs);
+    } else if (step.type == "MutateForType") {
+      schedule->MutateForType(
+          inputs[0], static_cast<ForType>(GetStepAttr<int>(step, "for_type")), GetStepAttr<int>(step, "factor"));
+    } else if (step.type == "ComputeInline") {
+      schedule->ComputeInline(inputs[0]);
+    } else if (step.type == "CopyTransformAndLoopInfo") {
+      schedule->CopyTransformAndLoopInfo(inputs[0], inputs[1]);
+    } else if (step.type == "Rfactor") {
+      schedule->Rfactor(inputs[0], GetStepAttr<int>(step, "rf_axis"));
+    } else if (step.type == "Prefetch") {
+      schedule->Prefetch(inputs[0], GetStepAttr<int>(step, "distance"));
+    } else if (step.type == "NonTemporalStore") {
+      schedule->NonTemporalStore(inputs[0], GetStepAttr<bool>(step, "enable"));
+    } else if (step.type == "MergeExprs") {
+      schedule->MergeExprs();
+    } else {
+      LOG(WARNING) << "Unknown schedule primitive " << step.type << " in the trace";
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace ir
+}  // namespace cinn
@@ -0,0 +1,113 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <map>
+#include <string>
+#include <vector>
+
+#include "cinn/ir/ir.h"
+#include "cinn/utils/type_defs.h"
+
+namespace cinn {
+namespace ir {
+
+class IRSchedule;
+
+/**
+ * The sequence of schedule primitives applied by an IRSchedule. The Expr arguments of a primitive are recorded by the
+ * name of a schedule block and the index of a loop in the loops of that block, so a trace recorded on one ModuleExpr
+ * can be replayed on another ModuleExpr lowered from the same computation.
+ */
+class ScheduleTrace {
+ public:
+  //! Refer to a ScheduleBlockRealize when loop_index < 0, otherwise refer to the loop_index-th loop of the block.
+  struct ExprRef {
+    std::string block_name;
+    int loop_index{-1};
+  };
+
+  //! A schedule primitive with its arguments.
+  struct Step {
+    std::string type;
+    std::vector<ExprRef> inputs;
+    std::map<std::string, utils::Attribute> attrs;
+  };
+
+  ScheduleTrace() = default;
+
+  /**
+   * \brief Get the reference of a ScheduleBlockRealize or a For node in the ModuleExpr of schedule.
+   * @param schedule The schedule containing the expr.
+   * @param expr The ScheduleBlockRealize or For node.
+   * @param ref The output reference.
+   * @return Whether the expr can be referred to, a loop without any schedule block in it or a block whose name is
+   * shared by other blocks can't be referred to.
+   */
+  static bool MakeRef(const IRSchedule& schedule, const Expr& expr, ExprRef* ref);
+
+  /**
+   * \brief Find the Expr referred to by ref in the ModuleExpr of schedule.
+   * @return The Expr, or an undefined Expr if it is not found or more than one block is named ref.block_name.
+   */
+  static Expr Resolve(const IRSchedule& schedule, const ExprRef& ref);
+
+  //! Append a step, the trace becomes unreplayable if one of the inputs can't be referred to.
+  void Append(const IRSchedule& schedule,
+              const std::string& type,
+              const std::vector<Expr>& inputs,
+              const std::map<std::string, utils::Attribute>& attrs);
+
+  void Append(const Step& step) { steps_.push_back(step); }
+
+  //! Append all the steps of other, which should be recorded on the ModuleExpr this trace results in.
+  void Append(const ScheduleTrace& other);
+
+  /**
+   * \brief Re-apply the steps on the schedule.
+   * @param schedule The schedule on a ModuleExpr lowered from the computation this trace is recorded on.
+   * @return Whether all the steps are applied, false if the trace is unreplayable or an Expr is not found.
+   */
+  bool Replay(IRSchedule* schedule) const;
+
+  /**
+   * \brief Rename the blocks referred to by the steps, so the trace can be replayed on a ModuleExpr lowered from an
+   * identical computation with different tensor names.
+   * @param names The names of the blocks of the ModuleExpr the trace is recorded on, in order.
+   * @param new_names The names of the corresponding blocks of the ModuleExpr to replay on. The name of a block created
+   * by a step, such as a cache block, is renamed by the longest name in names it starts with.
+   * @return Whether the blocks are renamed, false if the numbers of the names differ.
+   */
+  bool RenameBlocks(const std::vector<std::string>& names, const std::vector<std::string>& new_names);
+
+  const std::vector<Step>& GetSteps() const { return steps_; }
+
+  //! Whether the schedule can be restored from the steps, which is false if the ModuleExpr is modified without
+  //! IRSchedule.
+  bool IsReplayable() const { return replayable_; }
+
+  void SetUnreplayable() { replayable_ = false; }
+
+  void Clear() {
+    steps_.clear();
+    replayable_ = true;
+  }
+
+ private:
+  std::vector<Step> steps_;
+  bool replayable_{true};
+};
+
+}  // namespace ir
+}  // namespace cinn
@@ -113,9 +113,11 @@ void fn(void* _args, int32_t num_args)
   const float* A_reshape = ((const float*)(_A->memory));
   float* B = ((float*)(_B->memory));
   for (int32_t i = 0; i < 10; i += 1) {
+    int32_t offset_1 = (1000 * i);
     for (int32_t j = 0; j < 10; j += 1) {
+      int32_t offset_0 = (offset_1 + (100 * j));
       for (int32_t k = 0; k < 100; k += 1) {
-        B[((1000 * i) + ((100 * j) + k))] = (2 * A_reshape[((1000 * i) + ((100 * j) + k))]);
+        B[(offset_0 + k)] = (2 * A_reshape[(offset_0 + k)]);
       };
     };
   };
@@ -164,14 +166,17 @@ void fn(void* _args, int32_t num_args)
   const float* A_copied_reshape = ((const float*)(_A_copied_reshape->memory));
   float* B = ((float*)(_B->memory));
   for (int32_t i = 0; i < 100; i += 1) {
+    int32_t offset_0 = (100 * i);
     for (int32_t j = 0; j < 100; j += 1) {
-      A_copied[((100 * i) + j)] = A[((100 * i) + j)];
+      A_copied[(offset_0 + j)] = A[(offset_0 + j)];
     };
   };
   for (int32_t i = 0; i < 10; i += 1) {
+    int32_t offset_2 = (1000 * i);
     for (int32_t j = 0; j < 10; j += 1) {
+      int32_t offset_1 = (offset_2 + (100 * j));
       for (int32_t k = 0; k < 100; k += 1) {
-        B[((1000 * i) + ((100 * j) + k))] = (2 * A_copied_reshape[((1000 * i) + ((100 * j) + k))]);
+        B[(offset_1 + k)] = (2 * A_copied_reshape[(offset_1 + k)]);
       };
     };
   };
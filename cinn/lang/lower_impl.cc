@@ -88,9 +88,7 @@ Expr LowerGroup(const poly::ScheduleGroup& group,
   // get isl generated expression
   isl::set context(Context::isl_ctx(), "{:}");
   poly::AstGen gen(context, stages, group);
-  isl::ast_node ast = gen.Build();
-  ir::Expr e;
-  poly::IslAstNodeToCinnExpr(ast, &e);
+  ir::Expr e = gen.BuildExpr();
   // now we get a workable expression, but the statement are something like `B(((16 * po0) + po1), po2)`, we need to
   // transform this to some realworld statement in CINN.
 
@@ -637,7 +635,12 @@ std::vector<ir::LoweredFunc> LowerImpl::operator()() {
     // some necessary modification.
     optim::ComputeInlineExpand(&func->body, stages_, &all_tensor_map);
 
-    auto res = optim::Optimize(func, target_, FLAGS_cinn_runtime_display_debug_info);
+    // drop the other references to the body, so that only the nodes shared with the stages are copied
+    Expr res      = func;
+    func          = ir::LoweredFunc();
+    func_iterator = Expr();
+    store_exprs.clear();
+    optim::OptimizeInPlace(&res, target_, FLAGS_cinn_runtime_display_debug_info);
 
     if (cuda_axis_info_.size() > num_func && cuda_axis_info_[num_func].valid()) {
       auto* res_func           = res.as_lowered_func();
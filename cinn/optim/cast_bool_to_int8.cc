@@ -31,7 +31,7 @@ struct Mutator : public ir::IRMutator<> {
     auto value = node->value;
     if (op->type().is_bool() && op->value->type().is_bool()) {
       value = ir::Cast::Make(Int(8), value);
-      *expr = ir::Store::Make(node->tensor, value, node->indices);
+      *expr = ir::Store::Make(node->tensor, value, node->indices, node->flattened, node->nontemporal);
     }
   }
 };
@@ -252,7 +252,7 @@ struct InsertDebugLogCalleeMutator : public ir::IRMutator<> {
 
     std::vector<Expr> val_reprs;
     for (auto &index : node->indices) val_reprs.push_back(index);
-    val_reprs.push_back(ir::Load::Make(node->tensor, node->indices));
+    val_reprs.push_back(ir::Load::Make(node->tensor, node->indices, node->flattened));
 
     return std::make_tuple(format_ss.str(), val_reprs);
   }
@@ -101,7 +101,7 @@ struct IRCopyVisitor : public ir::IRVisitorBase<Expr> {
     for (auto& idx : op->indices) {
       indices.push_back(Visit(&idx));
     }
-    return Load::Make(tensor, indices);
+    return Load::Make(tensor, indices, op->flattened);
   }
 
   Expr Visit(const Store* op) override {
@@ -110,7 +110,7 @@ struct IRCopyVisitor : public ir::IRVisitorBase<Expr> {
     std::vector<Expr> indices;
     for (auto& idx : op->indices) indices.push_back(Visit(&idx));
 
-    return Store::Make(tensor, value, indices);
+    return Store::Make(tensor, value, indices, op->flattened, op->nontemporal);
   }
 
   Expr Visit(const Alloc* op) override {
@@ -241,10 +241,21 @@ struct IRCopyVisitor : public ir::IRVisitorBase<Expr> {
   Expr Visit(const _LoweredFunc_* op) override {
     auto func = make_shared<_LoweredFunc_>();
 
-    func->name      = op->name;
-    func->args      = op->args;
-    func->body      = Visit(&op->body);
-    func->temp_bufs = op->temp_bufs;
+    func->name = op->name;
+    func->body = Visit(&op->body);
+    // the buffers of the arguments are shared with the copied body
+    for (const ir::Argument& arg : op->args) {
+      if (arg.is_buffer()) {
+        Expr buffer = arg.buffer_arg();
+        func->args.emplace_back(Visit(&buffer).as_buffer_ref(), arg.io);
+      } else {
+        func->args.push_back(arg);
+      }
+    }
+    for (const ir::Buffer& temp_buf : op->temp_bufs) {
+      Expr buffer = temp_buf;
+      func->temp_bufs.push_back(Visit(&buffer).as_buffer_ref());
+    }
 
     func->device_api = op->device_api;
 
@@ -453,6 +464,79 @@ Expr IRCopyVisitor::Visit(const ir::intrinsics::BuiltinIntrin* op) {
   return intrinsics::BuiltinIntrin::Make(op->name, op->args, op->id, op->arg_nums, op->type());
 }
 
+// Keep the nodes that only their parents refer to and copy the shared ones, the statements and the arithmetic are
+// kept in place, while the tensors, buffers, vars and the other nodes are always copied as IRCopy does.
+struct IRCopyOnWriteMutator : public ir::IRMutator<Expr*> {
+  void operator()(Expr* x) { ir::IRMutator<Expr*>::Visit(x, x); }
+
+ private:
+#define __(op__) \
+  void Visit(const op__* op, Expr* expr) override { KeepOrCopy(op, expr); }
+  NODETY_FORALL(__)
+#undef __
+
+  bool IsShared(const Expr& x) { return common::ref_count(x.get()).val() > 1; }
+
+  template <typename T>
+  void KeepOrCopy(const T* op, Expr* expr) {
+    *expr = copier_.Visit(expr);
+  }
+
+#define KEEP_IF_UNIQUE(op__)                          \
+  void KeepOrCopy(const op__* op, Expr* expr) {       \
+    if (IsShared(*expr)) {                            \
+      *expr = copier_.Visit(expr);                    \
+      return;                                         \
+    }                                                 \
+    ir::IRMutator<Expr*>::Visit(op, expr);            \
+  }
+  NODETY_BINARY_OP_FOR_EACH(KEEP_IF_UNIQUE)
+  NODETY_UNARY_OP_FOR_EACH(KEEP_IF_UNIQUE)
+  KEEP_IF_UNIQUE(Cast)
+  KEEP_IF_UNIQUE(Select)
+  KEEP_IF_UNIQUE(IfThenElse)
+  KEEP_IF_UNIQUE(Block)
+  KEEP_IF_UNIQUE(For)
+  KEEP_IF_UNIQUE(PolyFor)
+  KEEP_IF_UNIQUE(Load)
+  KEEP_IF_UNIQUE(Store)
+  KEEP_IF_UNIQUE(Let)
+  KEEP_IF_UNIQUE(Ramp)
+  KEEP_IF_UNIQUE(Broadcast)
+#undef KEEP_IF_UNIQUE
+
+  void KeepOrCopy(const _LoweredFunc_* op, Expr* expr) {
+    if (IsShared(*expr)) {
+      *expr = copier_.Visit(expr);
+      return;
+    }
+    auto* node = expr->As<_LoweredFunc_>();
+    ir::IRMutator<Expr*>::Visit(&node->body, &node->body);
+    // the buffers of the arguments are shared with the copied tensors of the body
+    for (auto& arg : node->args) {
+      if (arg.is_buffer()) {
+        Expr buffer = arg.buffer_arg();
+        arg         = ir::Argument(copier_.Visit(&buffer).as_buffer_ref(), arg.io);
+      }
+    }
+    for (auto& temp_buf : node->temp_bufs) {
+      Expr buffer = temp_buf;
+      temp_buf    = copier_.Visit(&buffer).as_buffer_ref();
+    }
+    for (auto* field : {&node->alloc_output_buffer_exprs,
+                        &node->dealloc_output_buffer_exprs,
+                        &node->buffer_data_cast_exprs,
+                        &node->argument_prepare_exprs}) {
+      for (auto& e : *field) {
+        e = copier_.Visit(&e);
+      }
+    }
+  }
+
+  // shared by all the copied nodes to unify the copied tensors and buffers
+  IRCopyVisitor copier_;
+};
+
 Expr IRCopy(Expr x) {
   IRCopyVisitor visitor;
   auto copied = visitor.Visit(&x);
@@ -467,6 +551,11 @@ std::vector<Expr> IRCopy(const std::vector<Expr>& x) {
   return res;
 }
 
+void IRCopyOnWrite(Expr* x) {
+  CHECK(x->defined());
+  IRCopyOnWriteMutator()(x);
+}
+
 ir::ModuleExpr IRCopy(const ir::ModuleExpr& x) { return ir::ModuleExpr(IRCopy(x.GetExprs())); }
 
 ir::LoweredFunc IRCopy(const ir::LoweredFunc& x) {
@@ -29,6 +29,13 @@ Expr IRCopy(Expr x);
 
 std::vector<Expr> IRCopy(const std::vector<Expr>& x);
 
+/**
+ * Copy the nodes of \p x that are shared with other owners and keep the nodes only \p x refers to, so that \p x can
+ * be mutated in place without affecting the other owners. It copies nothing more than IRCopy does, and nothing at all
+ * for the statements of an expression no one else refers to.
+ */
+void IRCopyOnWrite(Expr* x);
+
 ir::ModuleExpr IRCopy(const ir::ModuleExpr& x);
 
 ir::LoweredFunc IRCopy(const ir::LoweredFunc& x);
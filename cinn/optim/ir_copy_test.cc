@@ -16,6 +16,7 @@
 
 #include <gtest/gtest.h>
 
+#include "cinn/cinn.h"
 #include "cinn/ir/ir_printer.h"
 
 namespace cinn {
@@ -27,5 +28,38 @@ TEST(IrCopy, basic) {
   LOG(INFO) << "aa " << aa;
 }
 
+TEST(IRCopyOnWrite, basic) {
+  Placeholder<float> A("A", {Expr(16)});
+  Expr shared_value = ir::Add::Make(Expr(1.f), Expr(2.f));
+  Expr owned_value  = ir::Mul::Make(Expr(3.f), Expr(4.f));
+  Expr body         = ir::Block::Make(
+      {ir::Store::Make(A.tensor(), shared_value, {Expr(0)}), ir::Store::Make(A.tensor(), owned_value, {Expr(1)})});
+  owned_value = Expr();
+
+  const ir::IrNode* block      = body.get();
+  const ir::IrNode* owned      = body.As<ir::Block>()->stmts[1].As<ir::Store>()->value.get();
+  const ir::IrNode* owned_root = body.As<ir::Block>()->stmts[1].get();
+  IRCopyOnWrite(&body);
+  // the nodes only the body refers to are kept
+  ASSERT_EQ(body.get(), block);
+  auto* store_0 = body.As<ir::Block>()->stmts[0].As<ir::Store>();
+  auto* store_1 = body.As<ir::Block>()->stmts[1].As<ir::Store>();
+  EXPECT_EQ(body.As<ir::Block>()->stmts[1].get(), owned_root);
+  EXPECT_EQ(store_1->value.get(), owned);
+  // the shared value and the tensor are copied, and the copied tensor is unified
+  EXPECT_NE(store_0->value.get(), shared_value.get());
+  EXPECT_NE(store_0->tensor.get(), A.tensor().get());
+  EXPECT_EQ(store_0->tensor.get(), store_1->tensor.get());
+
+  store_0->value.As<ir::Add>()->a() = Expr(5.f);
+  EXPECT_EQ(shared_value.As<ir::Add>()->a().as_float(), 1.f);
+
+  // a body referred to by others is copied as a whole
+  Expr other = body;
+  IRCopyOnWrite(&body);
+  EXPECT_NE(body.get(), other.get());
+  EXPECT_EQ(utils::GetStreamCnt(body), utils::GetStreamCnt(other));
+}
+
 }  // namespace optim
 }  // namespace cinn
@@ -0,0 +1,270 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/optim/loop_invariant_code_motion.h"
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "cinn/common/common.h"
+#include "cinn/common/ir_util.h"
+#include "cinn/ir/collect_ir_nodes.h"
+#include "cinn/ir/ir_mutator.h"
+#include "cinn/ir/ir_printer.h"
+#include "cinn/utils/string.h"
+
+namespace cinn {
+namespace optim {
+
+namespace {
+
+// Split an offset into the terms it sums up, the constant factors are
+// distributed over the sums, e.g. (i * 8 + j) * 4 - k => {32 * i, 4 * j, -1 * k}
+void SplitTerms(const Expr& e, int64_t factor, std::vector<Expr>* terms) {
+  if (factor == 0) return;
+  if (auto* add = e.As<ir::Add>()) {
+    SplitTerms(add->a(), factor, terms);
+    SplitTerms(add->b(), factor, terms);
+    return;
+  }
+  if (auto* sub = e.As<ir::Sub>()) {
+    SplitTerms(sub->a(), factor, terms);
+    SplitTerms(sub->b(), -factor, terms);
+    return;
+  }
+  if (auto* mul = e.As<ir::Mul>()) {
+    if (mul->b().As<ir::IntImm>()) {
+      SplitTerms(mul->a(), factor * mul->b().As<ir::IntImm>()->value, terms);
+      return;
+    }
+    if (mul->a().As<ir::IntImm>()) {
+      SplitTerms(mul->b(), factor * mul->a().As<ir::IntImm>()->value, terms);
+      return;
+    }
+  }
+  if (factor == 1) {
+    terms->push_back(e);
+  } else if (e.As<ir::IntImm>()) {
+    terms->push_back(common::make_const(e.type(), e.As<ir::IntImm>()->value * factor));
+  } else {
+    terms->push_back(ir::Mul::Make(common::make_const(e.type(), factor), e));
+  }
+}
+
+Expr Sum(const std::vector<Expr>& terms) {
+  CHECK(!terms.empty());
+  Expr res = terms[0];
+  for (size_t i = 1; i < terms.size(); ++i) {
+    res = ir::Add::Make(res, terms[i]);
+  }
+  return res;
+}
+
+// Whether the term is integer arithmetic without side effects and doesn't
+// depend on the variables defined in the loop.
+bool IsLoopInvariant(const Expr& term, const std::set<std::string>& loop_defined_vars) {
+  auto variant_nodes = ir::CollectIRNodesWithoutTensor(
+      term,
+      [&](const Expr* x) {
+        switch ((*x)->node_type()) {
+          case ir::IrNodeTy::IntImm:
+          case ir::IrNodeTy::Add:
+          case ir::IrNodeTy::Sub:
+          case ir::IrNodeTy::Mul:
+          case ir::IrNodeTy::Min:
+          case ir::IrNodeTy::Max:
+            return false;
+          case ir::IrNodeTy::_Var_:
+            return loop_defined_vars.count(x->As<ir::_Var_>()->name) > 0;
+          case ir::IrNodeTy::Div:
+            // a division by zero must not be evaluated ahead of its guard
+            return !x->As<ir::Div>()->b().As<ir::IntImm>() || x->As<ir::Div>()->b().As<ir::IntImm>()->value == 0;
+          case ir::IrNodeTy::Mod:
+            return !x->As<ir::Mod>()->b().As<ir::IntImm>() || x->As<ir::Mod>()->b().As<ir::IntImm>()->value == 0;
+          default:
+            return true;
+        }
+      },
+      true);
+  return variant_nodes.empty();
+}
+
+// Rewrite the offsets of the Loads and Stores in a loop body, and collect the
+// Lets defining the hoisted parts.
+struct OffsetHoister : public ir::IRMutator<Expr*> {
+  OffsetHoister(const std::set<std::string>& loop_defined_vars,
+                std::unordered_set<std::string>* offset_vars,
+                int* num_offsets)
+      : loop_defined_vars_(loop_defined_vars), offset_vars_(offset_vars), num_offsets_(num_offsets) {}
+
+  void operator()(Expr* expr) { ir::IRMutator<>::Visit(expr, expr); }
+
+  std::vector<Expr> lets;
+
+ private:
+  void Visit(const ir::Load* op, Expr* expr) override {
+    ir::IRMutator<>::Visit(op, expr);
+    auto* node = expr->As<ir::Load>();
+    if (node->is_addr_tensor() && !node->flattened) {
+      node->indices   = {node->index()};
+      node->flattened = true;
+    }
+    if (node->indices.size() == 1) {
+      node->indices[0] = Hoist(node->indices[0]);
+    }
+  }
+
+  void Visit(const ir::Store* op, Expr* expr) override {
+    ir::IRMutator<>::Visit(op, expr);
+    auto* node = expr->As<ir::Store>();
+    if (!node->flattened) {
+      node->indices   = {node->index()};
+      node->flattened = true;
+    }
+    node->indices[0] = Hoist(node->indices[0]);
+  }
+
+  void Visit(const ir::Let* op, Expr* expr) override {
+    ir::IRMutator<>::Visit(op, expr);
+    auto* node = expr->As<ir::Let>();
+    if (!node->body.defined() || !offset_vars_->count(node->symbol.as_var_ref()->name)) return;
+    if (IsLoopInvariant(node->body, loop_defined_vars_)) {
+      // the whole offset hoisted from an inner loop is invariant, move its Let out of this loop
+      hoisted_.emplace(utils::GetStreamCnt(node->body), node->symbol.as_var_ref());
+      lets.push_back(*expr);
+      moved_lets_.insert(node);
+    } else {
+      // the offsets hoisted from the inner loops are split again
+      node->body = Hoist(node->body);
+    }
+  }
+
+  void Visit(const ir::Block* op, Expr* expr) override {
+    ir::IRMutator<>::Visit(op, expr);
+    auto& stmts = expr->As<ir::Block>()->stmts;
+    auto it     = std::remove_if(
+        stmts.begin(), stmts.end(), [&](const Expr& stmt) { return moved_lets_.count(stmt.As<ir::Let>()); });
+    stmts.erase(it, stmts.end());
+  }
+
+  // Returns the offset whose loop invariant terms are replaced by a variable.
+  Expr Hoist(const Expr& offset) {
+    if (auto* ramp = offset.As<ir::Ramp>()) {
+      Expr base = Hoist(ramp->base);
+      return base.same_as(ramp->base) ? offset : ir::Ramp::Make(base, ramp->stride, ramp->lanes);
+    }
+    if (!offset.type().is_int() || offset.type().lanes() != 1) return offset;
+
+    std::vector<Expr> terms;
+    SplitTerms(offset, 1, &terms);
+    std::vector<Expr> invariant_terms, variant_terms;
+    for (auto& term : terms) {
+      if (term.type() != offset.type()) return offset;
+      // the constants are left to share the hoisted variable among the neighbour accesses
+      if (!term.is_constant() && IsLoopInvariant(term, loop_defined_vars_)) {
+        invariant_terms.push_back(term);
+      } else {
+        variant_terms.push_back(term);
+      }
+    }
+    if (invariant_terms.empty() || (invariant_terms.size() == 1 && invariant_terms[0].As<ir::_Var_>())) {
+      return offset;
+    }
+
+    Expr invariant = Sum(invariant_terms);
+    auto key       = utils::GetStreamCnt(invariant);
+    auto it        = hoisted_.find(key);
+    if (it == hoisted_.end()) {
+      // the names are numbered per pass to keep the generated code stable
+      Var var("offset_" + std::to_string((*num_offsets_)++), offset.type());
+      lets.push_back(ir::Let::Make(var, invariant));
+      offset_vars_->insert(var->name);
+      it = hoisted_.emplace(key, var).first;
+    }
+    variant_terms.insert(variant_terms.begin(), Expr(it->second));
+    return Sum(variant_terms);
+  }
+
+  const std::set<std::string>& loop_defined_vars_;
+  std::unordered_set<std::string>* offset_vars_;
+  int* num_offsets_;
+  // the hoisted variables of this loop keyed by the expressions they hold
+  std::map<std::string, Var> hoisted_;
+  std::unordered_set<const ir::Let*> moved_lets_;
+};
+
+struct LoopInvariantCodeMotionMutator : public ir::IRMutator<Expr*> {
+  void operator()(Expr* expr) { ir::IRMutator<>::Visit(expr, expr); }
+
+ private:
+  void Visit(const ir::For* op, Expr* expr) override {
+    // the inner loops are processed first, whose hoisted offsets are split again here
+    ir::IRMutator<>::Visit(op, expr);
+    auto* node = expr->As<ir::For>();
+    if (node->is_binded()) return;
+
+    std::set<std::string> loop_defined_vars = {node->loop_var->name};
+    auto defs =
+        ir::CollectIRNodesWithoutTensor(node->body, [](const Expr* x) { return x->As<ir::For>() || x->As<ir::Let>(); });
+    for (auto& def : defs) {
+      if (def.As<ir::For>()) {
+        loop_defined_vars.insert(def.As<ir::For>()->loop_var->name);
+      } else {
+        loop_defined_vars.insert(def.As<ir::Let>()->symbol.as_var_ref()->name);
+      }
+    }
+
+    OffsetHoister hoister(loop_defined_vars, &offset_vars_, &num_offsets_);
+    hoister(&node->body);
+    if (hoister.lets.empty()) return;
+
+    std::vector<Expr> stmts = hoister.lets;
+    stmts.push_back(*expr);
+    *expr = ir::Block::Make(stmts);
+    hoisted_blocks_.insert(expr->As<ir::Block>());
+  }
+
+  void Visit(const ir::Block* op, Expr* expr) override {
+    ir::IRMutator<>::Visit(op, expr);
+    auto* node = expr->As<ir::Block>();
+    // splice the Lets hoisted from the loops of this block
+    std::vector<Expr> stmts;
+    bool changed = false;
+    for (auto& stmt : node->stmts) {
+      auto* block = stmt.As<ir::Block>();
+      if (block && hoisted_blocks_.count(block)) {
+        stmts.insert(stmts.end(), block->stmts.begin(), block->stmts.end());
+        changed = true;
+      } else {
+        stmts.push_back(stmt);
+      }
+    }
+    if (changed) node->stmts = std::move(stmts);
+  }
+
+  std::unordered_set<std::string> offset_vars_;
+  int num_offsets_{0};
+  std::unordered_set<const ir::Block*> hoisted_blocks_;
+};
+
+}  // namespace
+
+void LoopInvariantCodeMotion(Expr* e) { LoopInvariantCodeMotionMutator()(e); }
+
+}  // namespace optim
+}  // namespace cinn
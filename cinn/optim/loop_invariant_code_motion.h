@@ -0,0 +1,58 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include "cinn/ir/ir.h"
+
+namespace cinn {
+namespace optim {
+
+/**
+ * Hoist the loop invariant parts of the buffer offsets out of the loops.
+ *
+ * The indices of a Load or Store inside a loop are flattened into an offset,
+ * and the terms of the offset not depending on the loop are summed up into a
+ * variable defined by a Let before the loop, e.g.
+ *
+ * \code
+ * for (i, 0, 32) {
+ *   for (j, 0, 64) {
+ *     B[i, j] = A[i, j] + 1
+ *   }
+ * }
+ * \endcode
+ *
+ * becomes
+ *
+ * \code
+ * for (i, 0, 32) {
+ *   int32 offset_0 = (64 * i)
+ *   for (j, 0, 64) {
+ *     B[offset_0 + j] = A[offset_0 + j] + 1
+ *   }
+ * }
+ * \endcode
+ *
+ * The offset variables of the inner loops are split again by the outer loops,
+ * so each loop level only adds one multiplication, and an offset that does not
+ * depend on the outer loop at all is moved out of it as a whole. The offsets
+ * are numbered per call to keep the generated code stable. The multiplications
+ * left are affine in their loop, and LLVM reduces them to increments of the
+ * induction variable (see the LoopInvariantCodeMotion test of codegen_x86_test).
+ * The flattened Loads and Stores are marked by their `flattened` field.
+ */
+void LoopInvariantCodeMotion(Expr* e);
+
+}  // namespace optim
+}  // namespace cinn
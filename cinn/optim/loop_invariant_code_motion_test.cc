@@ -0,0 +1,106 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/optim/loop_invariant_code_motion.h"
+
+#include <gtest/gtest.h>
+
+#include <set>
+#include <string>
+
+#include "cinn/cinn.h"
+#include "cinn/ir/collect_ir_nodes.h"
+#include "cinn/ir/ir_printer.h"
+#include "cinn/optim/ir_copy.h"
+#include "cinn/utils/string.h"
+
+namespace cinn {
+namespace optim {
+
+TEST(LoopInvariantCodeMotion, elementwise) {
+  Expr M(100), N(4), O(5);
+  Placeholder<float> A("A", {M, N, O});
+  auto B = Compute(
+      {M, N, O}, [&](Var i, Var j, Var k) { return A(i, j, k) + A(i, j, k + 1); }, "B");
+
+  auto stages = CreateStages({B});
+  auto func   = Lower("fn_elementwise", stages, {A, B});
+  Expr body   = func->body;
+  LoopInvariantCodeMotion(&body);
+  LOG(INFO) << "After LoopInvariantCodeMotion:\n" << body;
+
+  // one offset before the loop k and another one before the loop j
+  auto lets = ir::CollectIRNodes(body, [](const Expr* x) { return x->As<ir::Let>(); });
+  ASSERT_EQ(lets.size(), 2UL);
+
+  // the accesses share the offset hoisted out of the loop k
+  auto stores = ir::CollectIRNodes(body, [](const Expr* x) { return x->As<ir::Store>(); });
+  auto loads  = ir::CollectIRNodes(body, [](const Expr* x) { return x->As<ir::Load>(); });
+  ASSERT_EQ(stores.size(), 1UL);
+  ASSERT_EQ(loads.size(), 2UL);
+  std::set<std::string> offset_vars;
+  auto collect_offset_var = [&](const std::vector<Expr>& indices) {
+    ASSERT_EQ(indices.size(), 1UL);
+    auto vars = ir::CollectIRNodes(
+        indices[0], [](const Expr* x) { return x->As<ir::_Var_>() && x->As<ir::_Var_>()->name != "k"; });
+    ASSERT_EQ(vars.size(), 1UL);
+    offset_vars.insert(vars.begin()->As<ir::_Var_>()->name);
+    // no multiplication is left in the loop k
+    EXPECT_TRUE(ir::CollectIRNodes(indices[0], [](const Expr* x) { return x->As<ir::Mul>(); }).empty());
+  };
+  collect_offset_var(stores.begin()->As<ir::Store>()->indices);
+  for (auto& load : loads) {
+    collect_offset_var(load.As<ir::Load>()->indices);
+  }
+  EXPECT_EQ(offset_vars.size(), 1UL);
+
+  // the accesses are marked flattened, which is kept by the copies
+  auto* store = stores.begin()->As<ir::Store>();
+  EXPECT_TRUE(store->flattened);
+  for (auto& load : loads) {
+    EXPECT_TRUE(load.As<ir::Load>()->flattened);
+  }
+  auto copied_stores = ir::CollectIRNodes(IRCopy(body), [](const Expr* x) { return x->As<ir::Store>(); });
+  ASSERT_EQ(copied_stores.size(), 1UL);
+  auto* copied_store = copied_stores.begin()->As<ir::Store>();
+  EXPECT_TRUE(copied_store->flattened);
+  EXPECT_EQ(utils::GetStreamCnt(copied_store->index()), utils::GetStreamCnt(store->index()));
+}
+
+TEST(LoopInvariantCodeMotion, vectorized) {
+  Expr M(100), N(64);
+  Placeholder<float> A("A", {M, N});
+  auto B = Compute(
+      {M, N}, [&](Var i, Var j) { return A(i, j) * 2.f; }, "B");
+
+  auto stages = CreateStages({B});
+  stages[B]->Vectorize(1, 16);
+  auto func = Lower("fn_vectorized", stages, {A, B});
+  Expr body = func->body;
+  LoopInvariantCodeMotion(&body);
+  LOG(INFO) << "After LoopInvariantCodeMotion:\n" << body;
+
+  // the base of the ramp is rewritten to add the offset hoisted out of the loop j
+  auto stores = ir::CollectIRNodes(body, [](const Expr* x) { return x->As<ir::Store>(); });
+  ASSERT_EQ(stores.size(), 1UL);
+  auto* ramp = stores.begin()->As<ir::Store>()->indices[0].As<ir::Ramp>();
+  ASSERT_TRUE(ramp);
+  auto* base = ramp->base.As<ir::Add>();
+  ASSERT_TRUE(base);
+  EXPECT_TRUE(base->a().As<ir::_Var_>());
+  EXPECT_EQ(ir::CollectIRNodes(body, [](const Expr* x) { return x->As<ir::Let>(); }).size(), 1UL);
+}
+
+}  // namespace optim
+}  // namespace cinn
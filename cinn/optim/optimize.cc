@@ -14,6 +14,7 @@
 
 #include "cinn/optim/optimize.h"
 
+#include "cinn/ir/collect_ir_nodes.h"
 #include "cinn/ir/ir_printer.h"
 #include "cinn/ir/ir_schedule_util.h"
 #include "cinn/optim/call_arg_list_to_pod_value.h"
@@ -27,8 +28,10 @@
 #include "cinn/optim/ir_copy.h"
 #include "cinn/optim/ir_simplify.h"
 #include "cinn/optim/lower_function_call_bind_vars.h"
+#include "cinn/optim/loop_invariant_code_motion.h"
 #include "cinn/optim/lower_intrin.h"
 #include "cinn/optim/map_extern_call.h"
+#include "cinn/optim/prefetch_and_nontemporal_store.h"
 #include "cinn/optim/remove_nested_block.h"
 #include "cinn/optim/remove_schedule_block.h"
 #include "cinn/optim/replace_const_param_to_integer.h"
@@ -36,58 +39,95 @@
 #include "cinn/optim/transform_polyfor_to_for.h"
 #include "cinn/optim/unroll_loops.h"
 #include "cinn/optim/vectorize_loops.h"
+#include "cinn/utils/profiler.h"
 
 DECLARE_bool(cinn_ir_schedule);
+DECLARE_bool(cinn_loop_invariant_code_motion);
 
 namespace cinn {
 namespace optim {
 
+namespace {
+
+int64_t CountIRNodes(Expr e) {
+  return ir::CollectIRNodes(e, [](const Expr*) { return true; }).size();
+}
+
+}  // namespace
+
+// Run a pass on `copied` as an event of the compile profiler, which records the number of IR nodes before and after
+// the pass if the profiler is enabled.
+#define CINN_RUN_PASS(pass__, ...)                                                            \
+  {                                                                                           \
+    utils::RecordCompileEvent pass_event(#pass__, "optim");                                   \
+    if (pass_event.enabled()) pass_event.AddCounter("ir_nodes_before", CountIRNodes(copied)); \
+    pass__(&copied, ##__VA_ARGS__);                                                           \
+    if (pass_event.enabled()) pass_event.AddCounter("ir_nodes_after", CountIRNodes(copied));  \
+  }
+
 Expr Optimize(Expr e, Target target, bool runtime_debug_info) {
-  CHECK(e.defined());
-  auto copied = IRCopy(e);
-
-  FoldCINNCallArguments(&copied);
-  TransformPolyForToFor(&copied);
-  ReplaceConstParamToInteger(&copied);
-  CastSimplify(&copied);
-  Simplify(&copied);
-  UnrollLoop(&copied);
-  VectorizeLoops(&copied, target);
+  // e is also referred to by the caller, so it is copied as a whole
+  OptimizeInPlace(&e, target, runtime_debug_info);
+  return e;
+}
+
+void OptimizeInPlace(Expr* e, Target target, bool runtime_debug_info) {
+  CHECK(e->defined());
+  utils::RecordCompileEvent event("optim::Optimize", "optim");
+  IRCopyOnWrite(e);
+  Expr& copied = *e;
+
+  CINN_RUN_PASS(FoldCINNCallArguments);
+  CINN_RUN_PASS(TransformPolyForToFor);
+  CINN_RUN_PASS(ReplaceConstParamToInteger);
+  CINN_RUN_PASS(CastSimplify);
+  CINN_RUN_PASS(Simplify);
+  CINN_RUN_PASS(UnrollLoop);
+  CINN_RUN_PASS(VectorizeLoops, target);
 #ifdef CINN_WITH_CUDA
   if (FLAGS_cinn_ir_schedule) ir::SetCudaAxisInfo(&copied);
-  RemoveGpuForloopsAxis(&copied);
-  CudaSyncThreadsDropIfThenElse(&copied);
+  CINN_RUN_PASS(RemoveGpuForloopsAxis);
+  CINN_RUN_PASS(CudaSyncThreadsDropIfThenElse);
 #endif
 
-  RemoveNestedBlock(&copied);
+  CINN_RUN_PASS(RemoveNestedBlock);
 
-  MapExternCall(&copied, target);
-  ExternCallMultiOutputShallowStore(&copied);
+  CINN_RUN_PASS(MapExternCall, target);
+  CINN_RUN_PASS(ExternCallMultiOutputShallowStore);
 
-  CastSimplify(&copied);
-  Simplify(&copied);
-  IfSimplify(&copied);
+  CINN_RUN_PASS(CastSimplify);
+  CINN_RUN_PASS(Simplify);
+  CINN_RUN_PASS(IfSimplify);
 
   if (runtime_debug_info) {
     LOG(WARNING) << "Turn on runtime debug information output";
     InsertDebugLogCallee(&copied);
   }
-  return copied;
 }
 
 ir::Module Optimize(const ir::Module& module, const Target& target) {
+  utils::RecordCompileEvent event("optim::Optimize(Module)", "optim");
   auto copied = IRCopy(Expr(module));
   if (FLAGS_cinn_ir_schedule) {
-    UnrollLoop(&copied);
-    VectorizeLoops(&copied, Target());
+    CINN_RUN_PASS(UnrollLoop);
+    CINN_RUN_PASS(VectorizeLoops, Target());
+  }
+  if (target.arch == Target::Arch::X86) {
+    CINN_RUN_PASS(PrefetchAndNonTemporalStore, target);
+  }
+  CINN_RUN_PASS(RemoveScheduleBlock);
+  CINN_RUN_PASS(LowerFunctionCallBindVars);
+  CINN_RUN_PASS(CallArgListToPodValue);
+  CINN_RUN_PASS(LowerIntrin, target);
+  // nvcc hoists the offsets of the CUDA kernels by itself
+  if (FLAGS_cinn_loop_invariant_code_motion && target.arch == Target::Arch::X86) {
+    CINN_RUN_PASS(LoopInvariantCodeMotion);
   }
-  RemoveScheduleBlock(&copied);
-  LowerFunctionCallBindVars(&copied);
-  CallArgListToPodValue(&copied);
-  LowerIntrin(&copied, target);
 
   return copied.as_module_ref();
 }
 
+#undef CINN_RUN_PASS
+
 }  // namespace optim
 }  // namespace cinn
@@ -27,6 +27,12 @@ namespace optim {
  */
 Expr Optimize(Expr e, Target target, bool runtime_debug_info = false);
 
+/**
+ * Optimize the expression in place. The nodes shared with other owners are copied before the passes mutate them, so a
+ * caller that holds the only reference to the expression saves copying it.
+ */
+void OptimizeInPlace(Expr* e, Target target, bool runtime_debug_info = false);
+
 /**
  * Optimize a Module.
  */
@@ -0,0 +1,334 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/optim/prefetch_and_nontemporal_store.h"
+
+#include <cstdlib>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "cinn/common/cas.h"
+#include "cinn/ir/collect_ir_nodes.h"
+#include "cinn/ir/intrinsic_ops.h"
+#include "cinn/ir/ir_mutator.h"
+#include "cinn/ir/ir_operators.h"
+#include "cinn/ir/ir_printer.h"
+#include "cinn/optim/ir_copy.h"
+#include "cinn/optim/replace_var_with_expr.h"
+#include "cinn/utils/string.h"
+
+namespace cinn {
+namespace optim {
+
+namespace {
+
+// The bytes of a cache line of the X86 CPUs
+constexpr int64_t kCacheLineBytes = 64;
+
+bool UsesVar(const Expr& expr, const std::string& var_name) {
+  std::set<Expr> vars = ir::CollectIRNodesWithoutTensor(
+      expr, [&](const Expr* x) { return x->as_var() && x->as_var()->name == var_name; }, true);
+  return !vars.empty();
+}
+
+bool IsGlobalTensor(const ir::_Tensor_* tensor) {
+  return !tensor->buffer.defined() || tensor->buffer->memory_type == ir::MemoryType::Heap;
+}
+
+Expr StoreFence() {
+  return ir::intrinsics::BuiltinIntrin::Make("store_fence", {}, -1, 0, Void());
+}
+
+// Returns the number of the consecutive iterations of a loop whose prefetches fall in the same cache line, 1 if the
+// indices move along an outer dimension or by a non-constant stride.
+int64_t IterationsPerCacheLine(const std::vector<Expr>& indices, const Var& loop_var, int64_t element_bytes) {
+  int64_t stride = 0;
+  for (size_t i = 0; i < indices.size(); ++i) {
+    Expr next = IRCopy(indices[i]);
+    ReplaceVarWithExpr(&next, loop_var, Expr(loop_var) + 1);
+    Expr diff = common::AutoSimplify(next - indices[i]);
+    if (!diff.is_constant()) {
+      return 1;
+    }
+    auto step = static_cast<int64_t>(diff.get_constant());
+    if (i + 1 < indices.size()) {
+      if (step != 0) {
+        return 1;
+      }
+    } else {
+      stride = std::abs(step);
+    }
+  }
+  int64_t bytes = stride * element_bytes;
+  if (bytes <= 0 || bytes >= kCacheLineBytes) {
+    return 1;
+  }
+  return kCacheLineBytes / bytes;
+}
+
+// Replace the vectors in an index with their first lanes, so it indexes the first element accessed.
+struct VectorToFirstLane : public ir::IRMutator<> {
+  void operator()(Expr* expr) { IRMutator::Visit(expr, expr); }
+
+  void Visit(const ir::Ramp* op, Expr* expr) override {
+    *expr = op->base;
+    IRMutator::Visit(expr, expr);
+  }
+
+  void Visit(const ir::Broadcast* op, Expr* expr) override {
+    *expr = op->value;
+    IRMutator::Visit(expr, expr);
+  }
+};
+
+class PrefetchAndNonTemporalStoreMutator : public ir::IRMutator<> {
+ public:
+  PrefetchAndNonTemporalStoreMutator(const Target& target, std::unordered_set<std::string> loaded_tensors)
+      : llc_bytes_(target.cache_sizes()[2]), loaded_tensors_(std::move(loaded_tensors)) {}
+
+  void operator()(Expr* expr) { IRMutator::Visit(expr, expr); }
+
+ private:
+  void Visit(const ir::For* op, Expr* expr) override {
+    loops_.push_back(op);
+    IRMutator::Visit(op, expr);
+    loops_.pop_back();
+    if (fence_loops_.erase(op) == 0) {
+      return;
+    }
+    auto* node = expr->As<ir::For>();
+    if (node->is_parallel()) {
+      // fence the stores of each thread before the parallel loop joins
+      node->body = ir::Block::Make({node->body, StoreFence()});
+    } else {
+      *expr = ir::Block::Make({*expr, StoreFence()});
+    }
+  }
+
+  void Visit(const ir::ScheduleBlockRealize* op, Expr* expr) override {
+    ++block_depth_;
+    IRMutator::Visit(op, expr);
+    --block_depth_;
+    auto* realize        = expr->As<ir::ScheduleBlockRealize>();
+    auto* schedule_block = realize->schedule_block.As<ir::ScheduleBlock>();
+    CHECK(schedule_block);
+    // the attributes on the blocks with nested blocks are not supported
+    std::set<Expr> nested_blocks = ir::CollectIRNodesWithoutTensor(
+        schedule_block->body, [](const Expr* x) { return x->As<ir::ScheduleBlockRealize>() != nullptr; }, true);
+    if (!nested_blocks.empty()) {
+      return;
+    }
+
+    auto distance_it = schedule_block->attrs.find(ir::attr::prefetch_distance);
+    if (distance_it != schedule_block->attrs.end()) {
+      const int* distance = absl::get_if<int>(&distance_it->second);
+      CHECK(distance) << "The attribute " << ir::attr::prefetch_distance << " should be an int";
+      InsertPrefetches(realize, schedule_block, *distance);
+    }
+
+    if (MarkNonTemporalStores(schedule_block)) {
+      FenceStores(&schedule_block->body);
+    }
+  }
+
+  // The stores out of the schedule blocks, such as the ones lowered without FLAGS_cinn_ir_schedule, are streamed
+  // by the default rule of MarkNonTemporalStores.
+  void Visit(const ir::Store* op, Expr* expr) override {
+    IRMutator::Visit(op, expr);
+    if (block_depth_ > 0) {
+      return;
+    }
+    auto* store                = expr->As<ir::Store>();
+    const ir::_Tensor_* tensor = store->tensor.As<ir::_Tensor_>();
+    if (tensor == nullptr || !IsGlobalTensor(tensor) || !StreamByDefault(tensor)) {
+      return;
+    }
+    store->nontemporal = true;
+    FenceStores(expr);
+  }
+
+  // Fence the non-temporal stores after the outermost enclosing loop, or at the end of each iteration of the
+  // outermost parallel one, or right after the statement if it isn't in a loop.
+  void FenceStores(Expr* stmt) {
+    const ir::For* fence_loop = nullptr;
+    for (const ir::For* loop : loops_) {
+      if (loop->is_parallel()) {
+        fence_loop = loop;
+        break;
+      }
+    }
+    if (fence_loop == nullptr && !loops_.empty()) {
+      fence_loop = loops_.front();
+    }
+    if (fence_loop != nullptr) {
+      fence_loops_.insert(fence_loop);
+    } else {
+      *stmt = ir::Block::Make({*stmt, StoreFence()});
+    }
+  }
+
+  // Insert the prefetches of the loaded data before the body of the block. A cache line is prefetched once, so
+  // if it holds the data of several iterations, the prefetch is guarded to run in every that many iterations.
+  void InsertPrefetches(const ir::ScheduleBlockRealize* realize, ir::ScheduleBlock* schedule_block, int distance) {
+    if (distance <= 0 || loops_.empty()) {
+      return;
+    }
+    const ir::For* loop = loops_.back();
+    const Var& loop_var = loop->loop_var;
+    Expr shifted_loop_var = Expr(loop_var) + distance;
+    const std::vector<Var>& iter_vars = schedule_block->iter_vars;
+    CHECK_EQ(iter_vars.size(), realize->iter_values.size());
+    std::vector<Expr> shifted_iter_values;
+    for (const Expr& value : realize->iter_values) {
+      Expr shifted = IRCopy(value);
+      ReplaceVarWithExpr(&shifted, loop_var, shifted_loop_var);
+      shifted_iter_values.push_back(shifted);
+    }
+
+    // the prefetches grouped by the number of the iterations sharing a cache line
+    std::map<int64_t, std::vector<Expr>> period_to_prefetches;
+    std::set<std::string> prefetched;
+    auto loads = ir::CollectIRNodesWithoutTensor(schedule_block->body,
+                                                 [](const Expr* x) { return x->As<ir::Load>() != nullptr; });
+    for (const Expr& load_expr : loads) {
+      const ir::Load* load       = load_expr.As<ir::Load>();
+      const ir::_Tensor_* tensor = load->tensor.As<ir::_Tensor_>();
+      if (tensor == nullptr || !IsGlobalTensor(tensor)) {
+        continue;
+      }
+      bool moving = false;
+      std::vector<Expr> indices;
+      for (const Expr& index : load->indices) {
+        Expr shifted = IRCopy(index);
+        moving       = moving || UsesVar(index, loop_var->name);
+        ReplaceVarWithExpr(&shifted, loop_var, shifted_loop_var);
+        for (size_t i = 0; i < iter_vars.size(); ++i) {
+          moving = moving || (UsesVar(index, iter_vars[i]->name) && UsesVar(realize->iter_values[i], loop_var->name));
+          ReplaceVarWithExpr(&shifted, iter_vars[i], shifted_iter_values[i]);
+        }
+        VectorToFirstLane()(&shifted);
+        indices.push_back(common::AutoSimplify(shifted));
+      }
+      // the data loaded at the same address in all iterations stays in the cache
+      if (!moving) {
+        continue;
+      }
+      Expr prefetch_load = ir::Load::Make(load->tensor, indices, load->flattened);
+      if (!prefetched.insert(utils::GetStreamCnt(prefetch_load)).second) {
+        continue;
+      }
+      int64_t period = IterationsPerCacheLine(indices, loop_var, tensor->type().bytes());
+      period_to_prefetches[period].push_back(
+          ir::intrinsics::BuiltinIntrin::Make("prefetch", {prefetch_load}, -1, 1, Void()));
+    }
+    if (period_to_prefetches.empty()) {
+      return;
+    }
+
+    std::vector<Expr> stmts;
+    Expr iteration = loop->min.is_constant() && loop->min.get_constant() == 0 ? Expr(loop_var) : loop_var - loop->min;
+    for (auto& item : period_to_prefetches) {
+      VLOG(6) << "Insert " << item.second.size() << " prefetches in every " << item.first
+              << " iterations into the block " << schedule_block->name;
+      if (item.first == 1) {
+        stmts.insert(stmts.end(), item.second.begin(), item.second.end());
+      } else {
+        Expr first_of_line = ir::EQ::Make(ir::Mod::Make(iteration, Expr(static_cast<int>(item.first))), Expr(0));
+        stmts.push_back(ir::IfThenElse::Make(first_of_line, ir::Block::Make(item.second)));
+      }
+    }
+    stmts.push_back(schedule_block->body);
+    schedule_block->body = ir::Block::Make(stmts);
+  }
+
+  // Mark the stores of the block non-temporal, returns whether any store is marked.
+  bool MarkNonTemporalStores(ir::ScheduleBlock* schedule_block) {
+    auto it     = schedule_block->attrs.find(ir::attr::nontemporal_store);
+    bool is_set = it != schedule_block->attrs.end();
+    if (is_set) {
+      const bool* enable = absl::get_if<bool>(&it->second);
+      CHECK(enable) << "The attribute " << ir::attr::nontemporal_store << " should be a bool";
+      if (!*enable) {
+        return false;
+      }
+    }
+
+    bool marked = false;
+    auto stores = ir::CollectIRNodesWithoutTensor(schedule_block->body,
+                                                  [](const Expr* x) { return x->As<ir::Store>() != nullptr; });
+    for (Expr store_expr : stores) {
+      auto* store                = store_expr.As<ir::Store>();
+      const ir::_Tensor_* tensor = store->tensor.As<ir::_Tensor_>();
+      if (tensor == nullptr || !IsGlobalTensor(tensor)) {
+        continue;
+      }
+      if (!is_set && !StreamByDefault(tensor)) {
+        continue;
+      }
+      store->nontemporal = true;
+      marked             = true;
+    }
+    return marked;
+  }
+
+  // By default, only the outputs which can't stay in the cache and are not read again are streamed.
+  bool StreamByDefault(const ir::_Tensor_* tensor) const {
+    int64_t bytes = TensorBytes(tensor);
+    return bytes >= 0 && bytes > llc_bytes_ && !loaded_tensors_.count(tensor->name);
+  }
+
+  int64_t llc_bytes_;
+  // the tensors read in the module
+  std::unordered_set<std::string> loaded_tensors_;
+  // the loops enclosing the visiting node, from the outermost one
+  std::vector<const ir::For*> loops_;
+  // the loops to insert a store fence after, or at the end of the body of the parallel ones
+  std::set<const ir::For*> fence_loops_;
+  // the number of the schedule blocks enclosing the visiting node
+  int block_depth_ = 0;
+};
+
+}  // namespace
+
+int64_t TensorBytes(const ir::_Tensor_* tensor) {
+  int64_t bytes = tensor->type().bytes();
+  for (const Expr& dim : tensor->shape) {
+    if (!dim.is_constant()) {
+      return -1;
+    }
+    bytes *= dim.as_int64();
+  }
+  return bytes;
+}
+
+void PrefetchAndNonTemporalStore(Expr* e, const Target& target) {
+  std::unordered_set<std::string> loaded_tensors;
+  ir::CollectIRNodesWithoutTensor(*e, [&](const Expr* x) {
+    if (auto* load = x->As<ir::Load>()) {
+      if (auto* tensor = load->tensor.As<ir::_Tensor_>()) {
+        loaded_tensors.insert(tensor->name);
+      }
+    }
+    return false;
+  });
+  PrefetchAndNonTemporalStoreMutator mutator(target, std::move(loaded_tensors));
+  mutator(e);
+}
+
+}  // namespace optim
+}  // namespace cinn
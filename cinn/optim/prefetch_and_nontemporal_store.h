@@ -0,0 +1,72 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <cstdint>
+
+#include "cinn/common/target.h"
+#include "cinn/ir/ir.h"
+
+namespace cinn {
+namespace optim {
+
+/**
+ * Insert software prefetches and use non-temporal stores for the bandwidth-bound
+ * loop nests on CPU, according to the attributes of the schedule blocks:
+ *
+ * - ir::attr::prefetch_distance: the data loaded from the global buffers is
+ *   prefetched the given number of the innermost loop iterations ahead, once
+ *   per cache line, e.g.
+ *
+ * \code
+ * for (i, 0, 1024) {
+ *   for (j, 0, 1024) {
+ *     B[j, i] = A[i, j]
+ *   }
+ * }
+ * \endcode
+ *
+ * becomes with a distance of 8, as a cache line holds 16 floats of A
+ *
+ * \code
+ * for (i, 0, 1024) {
+ *   for (j, 0, 1024) {
+ *     if (((j % 16) == 0)) {
+ *       prefetch(A[i, (j + 8)])
+ *     }
+ *     B[j, i] = A[i, j]
+ *   }
+ * }
+ * \endcode
+ *
+ * - ir::attr::nontemporal_store: the stores to the global buffers are marked
+ *   non-temporal, so they are written around the caches instead of evicting the
+ *   data still to be used. If the attribute isn't set, the stores are marked if
+ *   the written buffer is larger than the last level cache of the target and no
+ *   function of the module reads it. A store fence is inserted after the loop
+ *   nest, or at the end of each iteration of its outermost parallel loop, as the
+ *   non-temporal stores are weakly ordered.
+ *
+ * The attributes work on the blocks without nested blocks, so it should run
+ * before the schedule blocks are removed. The stores out of the schedule
+ * blocks, such as the ones lowered without FLAGS_cinn_ir_schedule, are marked
+ * non-temporal by the default rule above.
+ */
+void PrefetchAndNonTemporalStore(Expr* e, const Target& target);
+
+//! Get the size in bytes of a tensor, -1 if its shape isn't constant.
+int64_t TensorBytes(const ir::_Tensor_* tensor);
+
+}  // namespace optim
+}  // namespace cinn
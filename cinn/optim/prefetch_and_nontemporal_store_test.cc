@@ -0,0 +1,196 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/optim/prefetch_and_nontemporal_store.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "cinn/cinn.h"
+#include "cinn/ir/collect_ir_nodes.h"
+#include "cinn/ir/ir_schedule.h"
+#include "cinn/lang/lower.h"
+#include "cinn/optim/ir_copy.h"
+#include "cinn/optim/transform_polyfor_to_for.h"
+#include "cinn/optim/vectorize_loops.h"
+#include "cinn/utils/string.h"
+
+namespace cinn {
+namespace optim {
+
+namespace {
+
+std::vector<const ir::intrinsics::BuiltinIntrin*> CollectBuiltinIntrins(const Expr& e, const std::string& name) {
+  std::vector<const ir::intrinsics::BuiltinIntrin*> res;
+  ir::CollectIRNodesWithoutTensor(e, [&](const Expr* x) {
+    if (auto* op = x->As<ir::IntrinsicOp>()) {
+      auto* intrin = llvm::dyn_cast<ir::intrinsics::BuiltinIntrin>(op);
+      if (intrin && intrin->name == name) {
+        res.push_back(intrin);
+      }
+    }
+    return false;
+  });
+  return res;
+}
+
+const ir::Store* GetStore(const Expr& e, const std::string& tensor_name) {
+  auto stores = ir::CollectIRNodesWithoutTensor(e, [&](const Expr* x) {
+    return x->As<ir::Store>() && x->As<ir::Store>()->tensor.as_tensor()->name == tensor_name;
+  });
+  CHECK_EQ(stores.size(), 1U);
+  return stores.begin()->As<ir::Store>();
+}
+
+}  // namespace
+
+TEST(PrefetchAndNonTemporalStore, prefetch) {
+  using namespace ir;
+
+  Expr M(64);
+  Expr N(32);
+  Placeholder<float> A("A", {N, M});
+  Placeholder<float> Bias("Bias", {M});
+  // transpose A, the bias is loaded at the same address in the innermost loop
+  Tensor C = Compute(
+      {M, N}, [&](Var i, Var j) { return A(j, i) + Bias(i); }, "C");
+
+  auto stages   = CreateStages({C});
+  Target target = common::DefaultHostTarget();
+  auto func     = cinn::lang::LowerVec("test_prefetch", stages, {A, Bias, C}, {}, {}, nullptr, target, true);
+  auto ast_expr = func[0]->body;
+
+  ir::ModuleExpr mod_expr({ast_expr});
+  ir::IRSchedule ir_sch(mod_expr);
+  PrefetchAndNonTemporalStore(&ast_expr, target);
+  EXPECT_TRUE(CollectBuiltinIntrins(ast_expr, "prefetch").empty());
+
+  ir_sch.Prefetch(ir_sch.GetBlock("C"), 8);
+  PrefetchAndNonTemporalStore(&ast_expr, target);
+  VLOG(6) << "After PrefetchAndNonTemporalStore:\n" << ast_expr;
+  auto prefetches = CollectBuiltinIntrins(ast_expr, "prefetch");
+  ASSERT_EQ(prefetches.size(), 1U);
+  auto* load = prefetches[0]->args[0].As<ir::Load>();
+  ASSERT_NE(load, nullptr);
+  EXPECT_EQ(load->tensor.as_tensor()->name, "A");
+  EXPECT_EQ(load->indices.size(), 2U);
+  // the output is small, so it is stored as usual
+  EXPECT_FALSE(GetStore(ast_expr, "C")->nontemporal);
+  EXPECT_TRUE(CollectBuiltinIntrins(ast_expr, "store_fence").empty());
+}
+
+TEST(PrefetchAndNonTemporalStore, prefetch_once_per_cache_line) {
+  using namespace ir;
+
+  Expr M(64);
+  Expr N(256);
+  Placeholder<float> A("A", {M, N});
+  Tensor B = Compute(
+      {M, N}, [&](Var i, Var j) { return A(i, j) * 2.f; }, "B");
+
+  auto stages   = CreateStages({B});
+  Target target = common::DefaultHostTarget();
+  auto func     = cinn::lang::LowerVec("test_prefetch_line", stages, {A, B}, {}, {}, nullptr, target, true);
+  auto ast_expr = func[0]->body;
+
+  ir::ModuleExpr mod_expr({ast_expr});
+  ir::IRSchedule ir_sch(mod_expr);
+  ir_sch.Prefetch(ir_sch.GetBlock("B"), 8);
+  PrefetchAndNonTemporalStore(&ast_expr, target);
+  VLOG(6) << "After PrefetchAndNonTemporalStore:\n" << ast_expr;
+
+  // A is read contiguously, so a cache line holds the floats of 16 iterations
+  ASSERT_EQ(CollectBuiltinIntrins(ast_expr, "prefetch").size(), 1U);
+  auto guards = ir::CollectIRNodesWithoutTensor(ast_expr, [](const Expr* x) { return x->As<ir::IfThenElse>(); });
+  ASSERT_EQ(guards.size(), 1U);
+  auto* guard = guards.begin()->As<ir::IfThenElse>();
+  EXPECT_EQ(CollectBuiltinIntrins(guard->true_case, "prefetch").size(), 1U);
+  EXPECT_NE(utils::GetStreamCnt(guard->condition).find("% 16"), std::string::npos);
+}
+
+TEST(PrefetchAndNonTemporalStore, nontemporal_store) {
+  using namespace ir;
+
+  // the buffers are much larger than the last level cache
+  Expr M(16384);
+  Expr N(16384);
+  Placeholder<float> A("A", {M, N});
+  Tensor B = Compute(
+      {M, N}, [&](Var i, Var j) { return A(i, j) * 2.f; }, "B");
+  Tensor C = Compute(
+      {M, N}, [&](Var i, Var j) { return B(i, j) + 1.f; }, "C");
+
+  auto stages   = CreateStages({B, C});
+  Target target = common::DefaultHostTarget();
+  auto func     = cinn::lang::LowerVec("test_nontemporal_store", stages, {A, B, C}, {}, {}, nullptr, target, true);
+  auto ast_expr = func[0]->body;
+
+  // B is read by C, so only C is streamed by default
+  Expr copied = optim::IRCopy(ast_expr);
+  PrefetchAndNonTemporalStore(&copied, target);
+  EXPECT_FALSE(GetStore(copied, "B")->nontemporal);
+  EXPECT_TRUE(GetStore(copied, "C")->nontemporal);
+  EXPECT_NE(utils::GetStreamCnt(copied).find("nontemporal C["), std::string::npos);
+  EXPECT_EQ(CollectBuiltinIntrins(copied, "store_fence").size(), 1U);
+
+  ir::ModuleExpr mod_expr({ast_expr});
+  ir::IRSchedule ir_sch(mod_expr);
+  ir_sch.NonTemporalStore(ir_sch.GetBlock("B"));
+  ir_sch.NonTemporalStore(ir_sch.GetBlock("C"), false);
+  auto loops = ir_sch.GetLoops("B");
+  ir_sch.Parallel(loops[0]);
+  PrefetchAndNonTemporalStore(&ast_expr, target);
+  VLOG(6) << "After PrefetchAndNonTemporalStore:\n" << ast_expr;
+  EXPECT_TRUE(GetStore(ast_expr, "B")->nontemporal);
+  EXPECT_FALSE(GetStore(ast_expr, "C")->nontemporal);
+
+  // the stores are fenced by each thread at the end of the parallel loop
+  loops = ir_sch.GetLoops("B");
+  ASSERT_EQ(loops.size(), 2U);
+  auto* body = loops[0].As<ir::For>()->body.As<ir::Block>();
+  ASSERT_NE(body, nullptr);
+  ASSERT_EQ(CollectBuiltinIntrins(ast_expr, "store_fence").size(), 1U);
+  EXPECT_EQ(CollectBuiltinIntrins(body->stmts.back(), "store_fence").size(), 1U);
+
+  // the hint is kept by the passes rebuilding the stores
+  ir_sch.Vectorize(loops[1], 8);
+  optim::VectorizeLoops(&ast_expr, target);
+  EXPECT_TRUE(GetStore(ast_expr, "B")->nontemporal);
+  EXPECT_TRUE(GetStore(optim::IRCopy(ast_expr), "B")->nontemporal);
+}
+
+TEST(PrefetchAndNonTemporalStore, nontemporal_store_without_schedule_block) {
+  using namespace ir;
+
+  Expr M(16384);
+  Expr N(16384);
+  Placeholder<float> A("A", {M, N});
+  Tensor B = Compute(
+      {M, N}, [&](Var i, Var j) { return A(i, j) * 2.f; }, "B");
+
+  // lowered without the schedule blocks, the large output is streamed by default
+  auto stages   = CreateStages({B});
+  Target target = common::DefaultHostTarget();
+  auto func     = cinn::lang::Lower("test_nontemporal_store_default", stages, {A, B});
+  auto ast_expr = func->body;
+  TransformPolyForToFor(&ast_expr);
+  PrefetchAndNonTemporalStore(&ast_expr, target);
+  VLOG(6) << "After PrefetchAndNonTemporalStore:\n" << ast_expr;
+  EXPECT_TRUE(GetStore(ast_expr, "B")->nontemporal);
+  EXPECT_EQ(CollectBuiltinIntrins(ast_expr, "store_fence").size(), 1U);
+}
+
+}  // namespace optim
+}  // namespace cinn
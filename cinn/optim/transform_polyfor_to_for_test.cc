@@ -87,12 +87,20 @@ void matmul(void* _args, int32_t num_args)
   float* C = ((float*)(_C->memory));
   float* C__reduce_init = ((float*)(_C->memory));
   for (int32_t i_outer = 0; i_outer < 64; i_outer += 1) {
+    int32_t offset_6 = (4000 * i_outer);
+    int32_t offset_7 = (1600 * i_outer);
     for (int32_t i_inner = 0; i_inner < 8; i_inner += 1) {
+      int32_t offset_5 = (offset_6 + (500 * i_inner));
+      int32_t offset_0 = (offset_7 + (200 * i_inner));
       for (int32_t j_outer = 0; j_outer < 63; j_outer += 1) {
+        int32_t offset_3 = (offset_5 + (8 * j_outer));
+        int32_t offset_4 = (8 * j_outer);
         for (int32_t j_inner = 0; j_inner < cinn_min(8, (500 + (-8 * j_outer))); j_inner += 1) {
-          C__reduce_init[((500 * i_inner) + ((4000 * i_outer) + ((8 * j_outer) + j_inner)))] = 0;
+          C__reduce_init[(offset_3 + j_inner)] = 0;
+          int32_t offset_1 = (offset_4 + j_inner);
+          int32_t offset_2 = (offset_3 + j_inner);
           for (int32_t k0 = 0; k0 < 200; k0 += 1) {
-            C[((500 * i_inner) + ((4000 * i_outer) + ((8 * j_outer) + j_inner)))] = fma(A[((200 * i_inner) + ((1600 * i_outer) + k0))], B[((8 * j_outer) + ((500 * k0) + j_inner))], C[((500 * i_inner) + ((4000 * i_outer) + ((8 * j_outer) + j_inner)))]);
+            C[offset_2] = fma(A[(offset_0 + k0)], B[(offset_1 + (500 * k0))], C[offset_2]);
           };
         };
       };
@@ -381,7 +381,7 @@ class Vectorizer : public IRMutator<Expr *> {
     for (auto &idx : node->indices) {
       new_indices.push_back(Widen(idx, lanes));
     }
-    *expr = Load::Make(node->tensor, new_indices);
+    *expr = Load::Make(node->tensor, new_indices, node->flattened);
   }
 
   void Visit(const Store *op, Expr *expr) override {
@@ -413,7 +413,7 @@ class Vectorizer : public IRMutator<Expr *> {
     for (auto &idx : node->indices) {
       new_indices.push_back(Widen(idx, lanes));
     }
-    *expr = Store::Make(node->tensor, node->value, new_indices);
+    *expr = Store::Make(node->tensor, node->value, new_indices, node->flattened, node->nontemporal);
   }
 
   void Visit(const Call *op, Expr *expr) override {
@@ -587,7 +587,7 @@ struct VectorizeLoops_ : public IRMutator<Expr *> {
     }
     if (!is_changed) return;
 
-    *expr = Load::Make(node->tensor, node->indices);
+    *expr = Load::Make(node->tensor, node->indices, node->flattened);
   }
 
   void Visit(const Store *op, Expr *expr) override {
@@ -607,7 +607,7 @@ struct VectorizeLoops_ : public IRMutator<Expr *> {
     }
     if (!is_changed) return;
 
-    *expr = Store::Make(node->tensor, node->value, node->indices);
+    *expr = Store::Make(node->tensor, node->value, node->indices, node->flattened, node->nontemporal);
   }
 
   void Visit(const Call *op, Expr *expr) override {
@@ -618,6 +618,11 @@ struct VectorizeLoops_ : public IRMutator<Expr *> {
   }
 
   void Visit(const For *forloop, Expr *expr) {
+    if (forloop->is_vectorized() && target != common::DefaultNVGPUTarget() && PeelVectorizeTail(expr)) {
+      // visit the vectorized main loop and the scalar tail loop
+      IRMutator::Visit(expr, expr);
+      return;
+    }
     auto *node        = expr->As<For>();
     auto loopvar_name = forloop->loop_var->name;
     if (forloop->extent.As<IntImm>()) {
@@ -781,6 +786,57 @@ struct VectorizeLoops_ : public IRMutator<Expr *> {
     return false;
   }
 
+  //! Peel the iterations of a vectorized forloop off a multiple of the factor
+  //! into a scalar forloop after it, so the extent of the vectorized one is
+  //! divisible by the factor. A forloop shorter than the factor is vectorized
+  //! with the largest power of two lanes not greater than its extent.
+  //! @return Whether the forloop is peeled, \p expr is replaced with a block of
+  //! the two forloops if so.
+  bool PeelVectorizeTail(Expr *expr) {
+    auto *node = expr->As<For>();
+    CHECK(node);
+    if (!is_zero(node->min)) return false;
+    Expr for_extent = common::AutoSimplify(node->extent);
+    auto *extent_i  = for_extent.As<IntImm>();
+    int factor      = node->vectorize_info().factor;
+    if (!extent_i || factor <= 1 || extent_i->value % factor == 0) return false;
+
+    int extent = extent_i->value;
+    int lanes  = factor;
+    if (lanes > extent) {
+      lanes = 1;
+      while (lanes * 2 <= extent) lanes *= 2;
+    }
+    if (lanes < 2) {
+      VLOG(3) << "The forloop over " << node->loop_var << " is too short to vectorize";
+      node->reset_vectorize_info();
+      return false;
+    }
+    int main_extent = extent / lanes * lanes;
+    if (main_extent == extent) {
+      node->extent = for_extent;
+      node->set_vectorize_info(VectorizeInfo(node->vectorize_info().level, lanes));
+      return false;
+    }
+
+    Var tail_iterator(common::UniqName(node->loop_var->name + "_tail"));
+    Expr tail_body = IRCopy(node->body);
+    optim::IrReplace(&tail_body, node->loop_var, Expr(main_extent) + Expr(tail_iterator));
+    Expr tail_forloop = For::Make(tail_iterator,
+                                  common::make_const(node->extent->type(), 0),
+                                  common::make_const(node->extent->type(), extent - main_extent),
+                                  ForType::Serial,
+                                  node->device_api,
+                                  tail_body);
+    VLOG(2) << "Peel " << extent - main_extent << " iterations of the forloop over " << node->loop_var
+            << " off the vectorized ones with " << lanes << " lanes";
+
+    node->extent = common::make_const(node->extent->type(), main_extent);
+    node->set_vectorize_info(VectorizeInfo(node->vectorize_info().level, lanes));
+    *expr = Block::Make({*expr, tail_forloop});
+    return true;
+  }
+
   //! Split the forloop with size \p factor.
   //! @return The new forloop.
   Expr SplitForLoop(For *forloop, int factor) {
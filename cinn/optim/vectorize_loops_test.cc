@@ -21,6 +21,7 @@
 #include "cinn/cinn.h"
 #include "cinn/common/common.h"
 #include "cinn/common/ir_util.h"
+#include "cinn/ir/collect_ir_nodes.h"
 #include "cinn/ir/ir_operators.h"
 #include "cinn/optim/ir_simplify.h"
 #include "cinn/optim/optimize.h"
@@ -79,8 +80,9 @@ void matmul(void* _args, int32_t num_args)
   const float* B = ((const float*)(_B->memory));
   float* C = ((float*)(_C->memory));
   for (int32_t i = 0; i < 100; i += 1) {
+    int32_t offset_0 = (500 * i);
     for (int32_t j = 0; j < 32; j += 1) {
-      C[StackVec<16,int32_t>::Ramp(((500 * i) + (16 * j)), 1, 16)] = (StackedVec<float,16>::Load(A,((500 * i) + (16 * j))) * StackedVec<float,16>::Load(B,((500 * i) + (16 * j))));
+      C[StackVec<16,int32_t>::Ramp((offset_0 + (16 * j)), 1, 16)] = (StackedVec<float,16>::Load(A,(offset_0 + (16 * j))) * StackedVec<float,16>::Load(B,(offset_0 + (16 * j))));
     };
   };
   cinn_buffer_free((void*)(0), _C);
@@ -232,6 +234,54 @@ TEST(Vectorize, single_for) {
   LOG(INFO) << "Forloop\n" << forloop;
 }
 
+TEST(Vectorize, tail_for) {
+  struct Case {
+    int extent;
+    int factor;
+    int lanes;
+    int tail;
+  };
+  // prime, odd and shorter than factor extents
+  for (auto& c : std::vector<Case>{{7, 4, 4, 3}, {13, 8, 8, 5}, {97, 16, 16, 1}, {3, 16, 2, 1}, {12, 16, 8, 4}}) {
+    Placeholder<float> A("A", std::vector<int>{{c.extent}});
+    Placeholder<float> B("B", std::vector<int>{{c.extent}});
+    Placeholder<float> C("C", std::vector<int>{{c.extent}});
+
+    Var loop_var("k0");
+    Expr body = Store::Make(ir::Tensor(C),
+                            ir::Add::Make(  //
+                                ir::Load::Make(ir::Tensor(A), {Expr(loop_var)}),
+                                ir::Load::Make(ir::Tensor(B), {Expr(loop_var)})),
+                            {Expr(loop_var)});
+    body      = ir::Block::Make({body});
+
+    auto forloop = ir::For::Make(loop_var,
+                                 common::make_const(0),
+                                 common::make_const(c.extent),
+                                 ir::ForType::Vectorized,
+                                 ir::DeviceAPI::UNK,
+                                 body,
+                                 VectorizeInfo(0, c.factor));
+    VectorizeLoops(&forloop, common::DefaultHostTarget());
+    LOG(INFO) << "Vectorize the forloop of extent " << c.extent << " by factor " << c.factor << ":\n" << forloop;
+
+    auto stores = ir::CollectIRNodes(forloop, [](const Expr* x) { return x->As<ir::Store>(); });
+    ASSERT_EQ(stores.size(), 2UL);
+    int vectorized_lanes = 0;
+    for (auto& store : stores) {
+      vectorized_lanes = std::max(vectorized_lanes, store.As<ir::Store>()->indices[0].type().lanes());
+    }
+    EXPECT_EQ(vectorized_lanes, c.lanes);
+
+    auto tail_loops = ir::CollectIRNodes(forloop, [&](const Expr* x) {
+      return x->As<ir::For>() && !x->As<ir::For>()->is_vectorized() && x->As<ir::For>()->extent.is_constant() &&
+             x->As<ir::For>()->extent.as_int32() == c.tail &&
+             x->As<ir::For>()->loop_var->name != loop_var->name;
+    });
+    EXPECT_EQ(tail_loops.size(), 1UL);
+  }
+}
+
 TEST(Vectorize, cuda_vectorize) {
   Expr M(100);
   Expr N(500);
@@ -14,16 +14,137 @@
 
 #include "cinn/poly/ast_gen.h"
 
+#include <gflags/gflags.h>
 #include <llvm/Support/FormatVariadic.h>
 
+#include <mutex>  //NOLINT
+#include <sstream>
+#include <unordered_map>
 #include <utility>
 
 #include "cinn/common/common.h"
 #include "cinn/ir/ir.h"
+#include "cinn/ir/ir_mutator.h"
+#include "cinn/optim/ir_copy.h"
+#include "cinn/utils/profiler.h"
+
+DECLARE_int32(cinn_ast_gen_cache_capacity);
 
 namespace cinn {
 namespace poly {
 
+namespace {
+
+// The prefix of the names of the statements in the AstGen cache, followed by their positions.
+constexpr char kCachedStatementPrefix[] = "__ast_gen_stmt_";
+
+struct AstGenCacheEntry {
+  // the AST whose statements are named by kCachedStatementPrefix
+  ir::Expr expr;
+  // statement name -> { axis -> transformed index }
+  std::map<std::string, std::map<std::string, ir::Expr>> axis2expr;
+};
+
+// The ASTs keyed by the signatures of AstGen, the entries are immutable and copied out.
+class AstGenCache {
+ public:
+  static AstGenCache& Global() {
+    static AstGenCache cache;
+    return cache;
+  }
+
+  bool Find(const std::string& signature, AstGenCacheEntry* entry) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(signature);
+    if (it == entries_.end()) return false;
+    *entry = it->second;
+    return true;
+  }
+
+  void Insert(const std::string& signature, AstGenCacheEntry&& entry) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (entries_.size() >= static_cast<size_t>(FLAGS_cinn_ast_gen_cache_capacity)) {
+      entries_.clear();
+    }
+    entries_.emplace(signature, std::move(entry));
+  }
+
+  void Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+  }
+
+ private:
+  std::mutex mutex_;
+  std::unordered_map<std::string, AstGenCacheEntry> entries_;
+};
+
+// Rename the statements, which are the ISL Call nodes, of an AST.
+struct IslCallRenamer : public ir::IRMutator<> {
+  explicit IslCallRenamer(const std::map<std::string, std::string>& names) : names_(names) {}
+
+  void operator()(Expr* expr) { ir::IRMutator<>::Visit(expr, expr); }
+
+  void Visit(const ir::Call* op, Expr* expr) override {
+    ir::IRMutator<>::Visit(op, expr);
+    auto it = names_.find(op->name);
+    if (op->is_isl_call() && it != names_.end()) {
+      expr->As<ir::Call>()->name = it->second;
+    }
+  }
+
+ private:
+  const std::map<std::string, std::string>& names_;
+};
+
+Expr CopyAndRenameStatements(const Expr& expr, const std::map<std::string, std::string>& names) {
+  Expr res = optim::IRCopy(expr);
+  IslCallRenamer renamer(names);
+  renamer(&res);
+  return res;
+}
+
+std::map<std::string, std::map<std::string, ir::Expr>> CopyAndRenameAxis2Expr(
+    const std::map<std::string, std::map<std::string, ir::Expr>>& axis2expr,
+    const std::map<std::string, std::string>& names) {
+  std::map<std::string, std::map<std::string, ir::Expr>> res;
+  for (auto& statement : axis2expr) {
+    auto it = names.find(statement.first);
+    CHECK(it != names.end()) << "statement " << statement.first << " is not a stage";
+    auto& axis_map = res[it->second];
+    for (auto& item : statement.second) {
+      axis_map[item.first] = optim::IRCopy(item.second);
+    }
+  }
+  return res;
+}
+
+template <typename T>
+std::string IslToString(const T& obj) {
+  std::stringstream ss;
+  ss << obj;
+  return ss.str();
+}
+
+isl::set RenameTuple(isl::set set, const std::map<std::string, std::string>& names) {
+  const char* name = isl_set_get_tuple_name(set.get());
+  if (!name || !names.count(name)) return set;
+  const std::string& new_name = names.at(name);
+  return isl::manage(isl_set_set_tuple_name(set.release(), new_name.c_str()));
+}
+
+isl::map RenameTuple(isl::map map, const std::map<std::string, std::string>& names) {
+  for (auto dim_type : {isl_dim_in, isl_dim_out}) {
+    const char* name = isl_map_get_tuple_name(map.get(), dim_type);
+    if (!name || !names.count(name)) continue;
+    const std::string& new_name = names.at(name);
+    map                         = isl::manage(isl_map_set_tuple_name(map.release(), dim_type, new_name.c_str()));
+  }
+  return map;
+}
+
+}  // namespace
+
 struct AstGen::Impl {
   Impl(const isl::set& context, const poly::ScheduleGroup& schedule_group)
       : context_(context), schedule_group_(schedule_group) {}
@@ -49,6 +170,15 @@ struct AstGen::Impl {
   //! Get the polyhedral stages.
   const std::vector<Shared<Stage>>& stages() const { return stages_; }
 
+  //! Get the schedule of each stage, collected from the schedule group once.
+  const std::map<std::string, isl::map>& schedule_map();
+
+  /**
+   * Return the signature of the AST generation, in which the stage names are replaced with the values of
+   * `canonical_names`.
+   */
+  std::string Signature(const std::map<std::string, std::string>& canonical_names);
+
  private:
   isl::set context_;
   std::vector<Shared<Stage>> stages_;
@@ -56,6 +186,9 @@ struct AstGen::Impl {
   std::vector<std::string> iterator_names_;
   //! tuple name -> { axis -> isl_ast }
   std::map<std::string, std::map<std::string, isl::ast_expr>> transformed_indice_map_;
+  //! tuple name -> { axis -> Expr }, it is set by BuildExpr
+  std::map<std::string, std::map<std::string, ir::Expr>> axis_expr_map_;
+  std::map<std::string, isl::map> schedule_map_;
   isl::union_map build_options_;
 
   friend class AstGen;
@@ -132,9 +265,73 @@ isl::union_set TransIdentityExtentToContextId(isl::union_set set) {
   return isl_union_set_from_sets(sets);
 }
 
+const std::map<std::string, isl::map>& AstGen::Impl::schedule_map() {
+  if (schedule_map_.empty()) {
+    schedule_map_ = CollectScheduleMapFromGroup(schedule_group_);
+  }
+  return schedule_map_;
+}
+
+std::string AstGen::Impl::Signature(const std::map<std::string, std::string>& canonical_names) {
+  std::stringstream ss;
+  ss << IslToString(context_) << ";";
+  if (!build_options_.is_null()) ss << IslToString(build_options_);
+  ss << ";" << utils::Join(iterator_names_.empty() ? schedule_group_.dimension_names : iterator_names_, ",");
+  for (auto& stage : stages_) {
+    auto it = schedule_map().find(stage->id());
+    CHECK(it != schedule_map().end()) << "stage " << stage->id() << " not found in the map";
+    ss << ";" << IslToString(RenameTuple(stage->domain(), canonical_names)) << "|"
+       << IslToString(RenameTuple(stage->transform(), canonical_names)) << "|"
+       << IslToString(RenameTuple(it->second, canonical_names));
+  }
+  return ss.str();
+}
+
+void ClearAstGenCache() { AstGenCache::Global().Clear(); }
+
+ir::Expr AstGen::BuildExpr() {
+  utils::RecordCompileEvent event("poly::AstGen", "poly");
+  // stage name <-> the name in the cache
+  std::map<std::string, std::string> canonical_names, stage_names;
+  for (int i = 0; i < impl_->stages_.size(); i++) {
+    std::string canonical_name = kCachedStatementPrefix + std::to_string(i);
+    canonical_names[impl_->stages_[i]->id()] = canonical_name;
+    stage_names[canonical_name]              = impl_->stages_[i]->id();
+  }
+
+  std::string signature;
+  if (FLAGS_cinn_ast_gen_cache_capacity > 0) {
+    signature = impl_->Signature(canonical_names);
+    AstGenCacheEntry entry;
+    if (AstGenCache::Global().Find(signature, &entry)) {
+      VLOG(3) << "Reuse the cached AST for " << impl_->stages_.size() << " stages";
+      if (event.enabled()) event.AddCounter("cache_hits", 1);
+      impl_->axis_expr_map_ = CopyAndRenameAxis2Expr(entry.axis2expr, stage_names);
+      return CopyAndRenameStatements(entry.expr, stage_names);
+    }
+  }
+
+  isl::ast_node ast = Build();
+  ir::Expr expr;
+  IslAstNodeToCinnExpr(ast, &expr);
+  impl_->axis_expr_map_.clear();
+  for (auto& item : impl_->transformed_indice_map_) {
+    auto axis_map                     = axis2expr(item.first);
+    impl_->axis_expr_map_[item.first] = std::move(axis_map);
+  }
+
+  if (!signature.empty()) {
+    AstGenCacheEntry entry;
+    entry.expr      = CopyAndRenameStatements(expr, canonical_names);
+    entry.axis2expr = CopyAndRenameAxis2Expr(impl_->axis_expr_map_, canonical_names);
+    AstGenCache::Global().Insert(signature, std::move(entry));
+  }
+  return expr;
+}
+
 isl::ast_node AstGen::Build() {
   // Collect schedule from scheduler.
-  auto schedule_map = CollectScheduleMapFromGroup(impl_->schedule_group_);
+  auto& schedule_map = impl_->schedule_map();
   std::vector<isl::map> maps;
   for (auto& stage : impl_->stages_) {
     auto it = schedule_map.find(stage->id());
@@ -225,8 +422,15 @@ const std::map<std::string, isl::ast_expr>& AstGen::axis2ast(const std::string&
 }
 
 const std::map<std::string, Expr> AstGen::axis2expr(const std::string& tuple_name) const {
-  const auto& axis_to_ast = axis2ast(tuple_name);
   std::map<std::string, Expr> res;
+  auto it = impl_->axis_expr_map_.find(tuple_name);
+  if (it != impl_->axis_expr_map_.end()) {
+    for (auto& item : it->second) {
+      res[item.first] = optim::IRCopy(item.second);
+    }
+    return res;
+  }
+  const auto& axis_to_ast = axis2ast(tuple_name);
   for (auto item : axis_to_ast) {
     Expr expr;
     IslAstExprToCinnExpr(item.second, &expr);
@@ -526,7 +730,9 @@ AstGen::AstGen(const isl::set& context, const std::vector<Stage*>& stages, const
   impl_->InitIslAstConfig();
 }
 void AstGen::SetBuildOptions(const isl::union_map& options) { impl_->build_options_ = options; }
-bool AstGen::ContainsStatement(const std::string& name) const { return impl_->transformed_indice_map_.count(name); }
+bool AstGen::ContainsStatement(const std::string& name) const {
+  return impl_->transformed_indice_map_.count(name) || impl_->axis_expr_map_.count(name);
+}
 
 AstGen::~AstGen() {}
 
@@ -54,6 +54,16 @@ class AstGen {
 
   isl::ast_node Build();
 
+  /**
+   * Build the AST and transform it to Expr.
+   *
+   * The Expr and the transformed indices of the statements are cached by a signature of the context, the iterator
+   * names and the domains, transforms and schedules of the stages, in which the stage names are replaced by their
+   * positions. So the stages of repeated layers, which have the same structures but different names, reuse the AST
+   * with the statements renamed. The cache is shared by all the threads, see FLAGS_cinn_ast_gen_cache_capacity.
+   */
+  ir::Expr BuildExpr();
+
   //! Get the map from original CINN iterators to the transformed actual ISL ast nodes.
   const std::map<std::string, isl::ast_expr>& axis2ast(const std::string& tuple_name) const;
 
@@ -68,6 +78,9 @@ class AstGen {
   std::unique_ptr<Impl> impl_;
 };
 
+//! Clear the cache of AstGen::BuildExpr.
+void ClearAstGenCache();
+
 /**
  * Transform the isl ast to Expr.
  */
@@ -14,10 +14,17 @@
 
 #include "cinn/poly/ast_gen.h"
 
+#include <gflags/gflags.h>
 #include <gtest/gtest.h>
 
+#include <string>
+
+#include "cinn/cinn.h"
 #include "cinn/ir/ir.h"
 #include "cinn/ir/ir_printer.h"
+#include "cinn/utils/string.h"
+
+DECLARE_int32(cinn_ast_gen_cache_capacity);
 
 namespace cinn {
 namespace poly {
@@ -40,5 +47,34 @@ TEST(TransIdentityExtentToContextId, basic1) {
   LOG(INFO) << new_set;
 }
 
+TEST(AstGen, cache) {
+  auto lower = [](const std::string& prefix) {
+    Expr M(100), N(30);
+    Placeholder<float> A(prefix + "A", {M, N});
+    auto B = Compute(
+        {M, N}, [&](Expr i, Expr j) { return A(i, j) + 1.f; }, prefix + "B");
+    auto stages = CreateStages({B});
+    stages[B]->Split(1, 8);
+    auto fn = Lower("fn_" + prefix, stages, {A, B});
+    return utils::GetStreamCnt(fn);
+  };
+
+  int old_capacity                  = FLAGS_cinn_ast_gen_cache_capacity;
+  FLAGS_cinn_ast_gen_cache_capacity = 0;
+  std::string expected              = lower("first_");
+  LOG(INFO) << "expected:\n" << expected;
+
+  FLAGS_cinn_ast_gen_cache_capacity = 1024;
+  ClearAstGenCache();
+  ASSERT_EQ(lower("first_"), expected);
+  // the stage of the same structure reuses the cached AST with its name
+  std::string second = lower("second_");
+  utils::Replace(&second, "second_", "first_");
+  ASSERT_EQ(second, expected);
+
+  FLAGS_cinn_ast_gen_cache_capacity = old_capacity;
+  ClearAstGenCache();
+}
+
 }  // namespace poly
 }  // namespace cinn
@@ -517,6 +517,29 @@ void BindFrontend(pybind11::module *m) {
            py::arg("save_variance"),
            py::arg("epsilon")     = 1e-5,
            py::arg("data_layout") = "NCHW")
+      .def("layer_norm",
+           &NetBuilder::LayerNorm,
+           py::arg("x"),
+           py::arg("scale"),
+           py::arg("bias"),
+           py::arg("epsilon")         = 1e-5f,
+           py::arg("begin_norm_axis") = 1)
+      .def("layer_norm_grad",
+           &NetBuilder::LayerNormGrad,
+           py::arg("dy"),
+           py::arg("x"),
+           py::arg("scale"),
+           py::arg("mean"),
+           py::arg("variance"),
+           py::arg("epsilon")         = 1e-5f,
+           py::arg("begin_norm_axis") = 1)
+      .def("rms_norm",
+           &NetBuilder::RMSNorm,
+           py::arg("x"),
+           py::arg("scale"),
+           py::arg("epsilon")         = 1e-6f,
+           py::arg("begin_norm_axis") = -1)
+      .def("attention", &NetBuilder::Attention, py::arg("inputs"), py::arg("scale"), py::arg("causal") = false)
       .def("scale",
            &NetBuilder::Scale,
            py::arg("a"),
@@ -330,7 +330,7 @@ void BindIrIr(py::module *m) {
   py::class_<ir::Load, ExprNode<ir::Load>, ir::LoadStoreAddrMnger> load(*m, "Load");
   load.def_readwrite("indices", &ir::Load::indices)
       .def("index", &ir::Load::index)
-      .def_static("make", &ir::Load::Make)
+      .def_static("make", &ir::Load::Make, arg("tensor"), arg("indices"), arg("flattened") = false)
       .def("expr_fields_mutable", py::overload_cast<>(&ir::Load::expr_fields))
       .def("expr_fields_const", py::overload_cast<>(&ir::Load::expr_fields, py::const_))
       .def("name", &ir::Load::name)
@@ -341,7 +341,13 @@ void BindIrIr(py::module *m) {
   py::class_<ir::Store, ExprNode<ir::Store>, ir::LoadStoreAddrMnger> store(*m, "Store");
   store.def_readwrite("value", &ir::Store::value)
       .def_readwrite("indices", &ir::Store::indices)
-      .def_static("make", &ir::Store::Make)
+      .def_static("make",
+                  &ir::Store::Make,
+                  arg("tensor"),
+                  arg("value"),
+                  arg("indices"),
+                  arg("flattened")   = false,
+                  arg("nontemporal") = false)
       .def("expr_fields_mutable", py::overload_cast<>(&ir::Store::expr_fields))
       .def("expr_fields_const", py::overload_cast<>(&ir::Store::expr_fields, py::const_))
       .def("type", &ir::Store::type)
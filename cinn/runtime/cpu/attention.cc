@@ -0,0 +1,298 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/runtime/cpu/attention.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "cinn/backends/extern_func_jit_register.h"
+#include "cinn/common/cas.h"
+#include "cinn/runtime/cpu/thread_backend.h"
+
+namespace {
+
+// The queries of one task are processed in blocks of kBlockQ rows, and the keys are visited in blocks of kBlockK
+// rows, so the working set of a block is about (kBlockQ + kBlockK) * head_dim + kBlockQ * (kBlockK + value_dim)
+// floats and stays in L2 for the usual head sizes.
+constexpr int kBlockQ = 32;
+constexpr int kBlockK = 128;
+
+struct AttentionProblem {
+  int batch;
+  int heads;
+  int seq_q;
+  int seq_k;
+  int head_dim;
+  int value_dim;
+  float scale;
+  bool causal;
+  int mask_batch_stride;
+  int mask_head_stride;
+  int mask_row_stride;
+  const float* q;
+  const float* k;
+  const float* v;
+  const float* mask;  // nullptr if there is no additive mask
+  float* out;
+};
+
+inline int NumQueryBlocks(const AttentionProblem& p) { return (p.seq_q + kBlockQ - 1) / kBlockQ; }
+
+// Compute the rows [q_begin, q_end) of the output of the head `bh`. The softmax is normalized online: row_max and
+// row_sum hold the running maximum and the running sum of exp(score - row_max) of each row, and the accumulated
+// output is rescaled whenever the maximum grows.
+void AttentionBlock(const AttentionProblem& p, int bh, int q_begin, int q_end, std::vector<float>* buffer) {
+  const int rows = q_end - q_begin;
+  const int dk   = p.head_dim;
+  const int dv   = p.value_dim;
+  buffer->resize(kBlockQ * kBlockK + kBlockQ * dv + 2 * kBlockQ);
+  float* scores  = buffer->data();
+  float* acc     = scores + kBlockQ * kBlockK;
+  float* row_max = acc + kBlockQ * dv;
+  float* row_sum = row_max + kBlockQ;
+
+  const float* q = p.q + (static_cast<int64_t>(bh) * p.seq_q + q_begin) * dk;
+  const float* k = p.k + static_cast<int64_t>(bh) * p.seq_k * dk;
+  const float* v = p.v + static_cast<int64_t>(bh) * p.seq_k * dv;
+  float* out     = p.out + (static_cast<int64_t>(bh) * p.seq_q + q_begin) * dv;
+
+  const float* mask = nullptr;
+  if (p.mask) {
+    mask = p.mask + static_cast<int64_t>(bh / p.heads) * p.mask_batch_stride +
+           static_cast<int64_t>(bh % p.heads) * p.mask_head_stride + static_cast<int64_t>(q_begin) * p.mask_row_stride;
+  }
+
+  const float neg_inf = -std::numeric_limits<float>::infinity();
+  std::fill(row_max, row_max + rows, neg_inf);
+  std::fill(row_sum, row_sum + rows, 0.f);
+  std::fill(acc, acc + rows * dv, 0.f);
+
+  // With the causal mask the query i attends to the keys j <= i + offset, the keys after the last query of the block
+  // are skipped entirely.
+  const int offset = p.seq_k - p.seq_q;
+  const int k_end  = p.causal ? std::max(std::min(p.seq_k, q_end + offset), 0) : p.seq_k;
+  for (int kb = 0; kb < k_end; kb += kBlockK) {
+    const int cols = std::min(kBlockK, k_end - kb);
+    // scores = scale * Q * K^T (+ mask)
+    for (int r = 0; r < rows; ++r) {
+      const float* q_row = q + r * dk;
+      float* s_row       = scores + r * kBlockK;
+      for (int c = 0; c < cols; ++c) {
+        const float* k_row = k + static_cast<int64_t>(kb + c) * dk;
+        float dot          = 0.f;
+        for (int d = 0; d < dk; ++d) {
+          dot += q_row[d] * k_row[d];
+        }
+        s_row[c] = dot * p.scale;
+      }
+      if (mask) {
+        const float* m_row = mask + static_cast<int64_t>(r) * p.mask_row_stride + kb;
+        for (int c = 0; c < cols; ++c) {
+          s_row[c] += m_row[c];
+        }
+      }
+      if (p.causal) {
+        for (int c = std::max(q_begin + r + offset + 1 - kb, 0); c < cols; ++c) {
+          s_row[c] = neg_inf;
+        }
+      }
+    }
+    // online softmax, then acc += P * V
+    for (int r = 0; r < rows; ++r) {
+      float* s_row   = scores + r * kBlockK;
+      float* acc_row = acc + r * dv;
+      float new_max  = row_max[r];
+      for (int c = 0; c < cols; ++c) {
+        new_max = std::max(new_max, s_row[c]);
+      }
+      if (new_max == neg_inf) {
+        // all the keys seen so far are masked out
+        continue;
+      }
+      float correction = std::exp(row_max[r] - new_max);
+      row_max[r]       = new_max;
+      row_sum[r] *= correction;
+      for (int d = 0; d < dv; ++d) {
+        acc_row[d] *= correction;
+      }
+      for (int c = 0; c < cols; ++c) {
+        float prob = std::exp(s_row[c] - new_max);
+        row_sum[r] += prob;
+        if (prob == 0.f) continue;
+        const float* v_row = v + static_cast<int64_t>(kb + c) * dv;
+        for (int d = 0; d < dv; ++d) {
+          acc_row[d] += prob * v_row[d];
+        }
+      }
+    }
+  }
+
+  for (int r = 0; r < rows; ++r) {
+    // a fully masked row has no valid key, its output is zero
+    float inv = row_sum[r] > 0.f ? 1.f / row_sum[r] : 0.f;
+    for (int d = 0; d < dv; ++d) {
+      out[r * dv + d] = acc[r * dv + d] * inv;
+    }
+  }
+}
+
+int AttentionTask(int task_id, int num_task, void* datas) {
+  auto& p        = *reinterpret_cast<AttentionProblem*>(datas);
+  int num_blocks = NumQueryBlocks(p);
+  int num_work   = p.batch * p.heads * num_blocks;
+  std::vector<float> buffer;
+  // The blocks are dealt round-robin, so that the cheap leading blocks and the expensive trailing blocks of the causal
+  // attention are spread over all the tasks.
+  for (int work = task_id; work < num_work; work += num_task) {
+    int bh      = work / num_blocks;
+    int q_begin = (work % num_blocks) * kBlockQ;
+    AttentionBlock(p, bh, q_begin, std::min(q_begin + kBlockQ, p.seq_q), &buffer);
+  }
+  return 0;
+}
+
+void Attention(AttentionProblem problem) {
+  int num_work = problem.batch * problem.heads * NumQueryBlocks(problem);
+  if (num_work <= 0) return;
+  int num_task = std::max(std::min(max_concurrency(), num_work), 1);
+  cinn_backend_parallel_launch(&AttentionTask, &problem, num_task);
+}
+
+}  // namespace
+
+void cinn_cpu_attention_fp32(int batch,
+                             int heads,
+                             int seq_q,
+                             int seq_k,
+                             int head_dim,
+                             int value_dim,
+                             float scale,
+                             bool causal,
+                             cinn_buffer_t* q,
+                             cinn_buffer_t* k,
+                             cinn_buffer_t* v,
+                             cinn_buffer_t* out) {
+  Attention({batch,
+             heads,
+             seq_q,
+             seq_k,
+             head_dim,
+             value_dim,
+             scale,
+             causal,
+             0,
+             0,
+             0,
+             reinterpret_cast<const float*>(q->memory),
+             reinterpret_cast<const float*>(k->memory),
+             reinterpret_cast<const float*>(v->memory),
+             nullptr,
+             reinterpret_cast<float*>(out->memory)});
+}
+
+void cinn_cpu_masked_attention_fp32(int batch,
+                                    int heads,
+                                    int seq_q,
+                                    int seq_k,
+                                    int head_dim,
+                                    int value_dim,
+                                    float scale,
+                                    bool causal,
+                                    int mask_batch_stride,
+                                    int mask_head_stride,
+                                    int mask_row_stride,
+                                    cinn_buffer_t* q,
+                                    cinn_buffer_t* k,
+                                    cinn_buffer_t* v,
+                                    cinn_buffer_t* mask,
+                                    cinn_buffer_t* out) {
+  Attention({batch,
+             heads,
+             seq_q,
+             seq_k,
+             head_dim,
+             value_dim,
+             scale,
+             causal,
+             mask_batch_stride,
+             mask_head_stride,
+             mask_row_stride,
+             reinterpret_cast<const float*>(q->memory),
+             reinterpret_cast<const float*>(k->memory),
+             reinterpret_cast<const float*>(v->memory),
+             reinterpret_cast<const float*>(mask->memory),
+             reinterpret_cast<float*>(out->memory)});
+}
+
+CINN_REGISTER_HELPER(cinn_cpu_attention) {
+  using namespace cinn;  // NOLINT
+  using backends::FunctionProto;
+  auto host_target = common::DefaultHostTarget();
+
+  // The output has the shape of the queries with the last dimension replaced by value_dim.
+  auto make_inference_shape = [](size_t num_args, int q_index) -> FunctionProto::shape_inference_t {
+    return [=](const std::vector<Expr>& args, int offset) {
+      CHECK_EQ(offset, 0UL) << "Only one output";
+      CHECK_EQ(args.size(), num_args) << "Wrong number of arguments passed in";
+      auto* q_tensor = args[q_index].as_tensor();
+      CHECK(q_tensor);
+      std::vector<Expr> shape(q_tensor->shape.begin(), q_tensor->shape.end() - 1);
+      shape.push_back(common::AutoSimplify(args[5]));
+      return shape;
+    };
+  };
+
+  REGISTER_EXTERN_FUNC_HELPER(cinn_cpu_attention_fp32, host_target)
+      .SetRetType<void>()
+      .AddInputType<int>()              // batch
+      .AddInputType<int>()              // heads
+      .AddInputType<int>()              // seq_q
+      .AddInputType<int>()              // seq_k
+      .AddInputType<int>()              // head_dim
+      .AddInputType<int>()              // value_dim
+      .AddInputType<float>()            // scale
+      .AddInputType<bool>()             // causal
+      .AddInputType<cinn_buffer_t*>()   // q
+      .AddInputType<cinn_buffer_t*>()   // k
+      .AddInputType<cinn_buffer_t*>()   // v
+      .AddOutputType<cinn_buffer_t*>()  // out
+      .SetShapeInference(make_inference_shape(11, 8))
+      .End();
+
+  REGISTER_EXTERN_FUNC_HELPER(cinn_cpu_masked_attention_fp32, host_target)
+      .SetRetType<void>()
+      .AddInputType<int>()              // batch
+      .AddInputType<int>()              // heads
+      .AddInputType<int>()              // seq_q
+      .AddInputType<int>()              // seq_k
+      .AddInputType<int>()              // head_dim
+      .AddInputType<int>()              // value_dim
+      .AddInputType<float>()            // scale
+      .AddInputType<bool>()             // causal
+      .AddInputType<int>()              // mask_batch_stride
+      .AddInputType<int>()              // mask_head_stride
+      .AddInputType<int>()              // mask_row_stride
+      .AddInputType<cinn_buffer_t*>()   // q
+      .AddInputType<cinn_buffer_t*>()   // k
+      .AddInputType<cinn_buffer_t*>()   // v
+      .AddInputType<cinn_buffer_t*>()   // mask
+      .AddOutputType<cinn_buffer_t*>()  // out
+      .SetShapeInference(make_inference_shape(15, 11))
+      .End();
+
+  return true;
+}
@@ -0,0 +1,77 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+//! \file This file defines the C APIs of the fused scaled-dot-product attention on CPU.
+#include "cinn/runtime/cinn_runtime.h"
+
+// define some C APIs
+extern "C" {
+
+/**
+ * \brief Compute out = softmax(scale * Q * K^T) * V without materializing the [seq_q, seq_k] score matrix. The keys
+ * are visited block by block and the softmax is normalized online, so only a [block_q, block_k] tile of scores is
+ * kept in the cache.
+ * @param batch The number of batches
+ * @param heads The number of heads
+ * @param seq_q The sequence length of the queries
+ * @param seq_k The sequence length of the keys and values
+ * @param head_dim The hidden size of the queries and keys
+ * @param value_dim The hidden size of the values
+ * @param scale The scaling factor of the scores
+ * @param causal Whether the query i only attends to the keys j <= i + seq_k - seq_q
+ * @param q The queries with shape [batch, heads, seq_q, head_dim]
+ * @param k The keys with shape [batch, heads, seq_k, head_dim]
+ * @param v The values with shape [batch, heads, seq_k, value_dim]
+ * @param out The output with shape [batch, heads, seq_q, value_dim]
+ */
+void cinn_cpu_attention_fp32(int batch,
+                             int heads,
+                             int seq_q,
+                             int seq_k,
+                             int head_dim,
+                             int value_dim,
+                             float scale,
+                             bool causal,
+                             cinn_buffer_t* q,
+                             cinn_buffer_t* k,
+                             cinn_buffer_t* v,
+                             cinn_buffer_t* out);
+
+/**
+ * \brief The same as cinn_cpu_attention_fp32, and an additive mask is added to the scaled scores. The mask of each
+ * batch and head is a [seq_q, seq_k] matrix, a zero stride broadcasts it along the corresponding dimension.
+ * @param mask_batch_stride The stride of the mask between batches, 0 if the mask is broadcasted along the batches
+ * @param mask_head_stride The stride of the mask between heads, 0 if the mask is broadcasted along the heads
+ * @param mask_row_stride The stride of the mask between queries, 0 if the mask is broadcasted along the queries
+ * @param mask The additive mask
+ */
+void cinn_cpu_masked_attention_fp32(int batch,
+                                    int heads,
+                                    int seq_q,
+                                    int seq_k,
+                                    int head_dim,
+                                    int value_dim,
+                                    float scale,
+                                    bool causal,
+                                    int mask_batch_stride,
+                                    int mask_head_stride,
+                                    int mask_row_stride,
+                                    cinn_buffer_t* q,
+                                    cinn_buffer_t* k,
+                                    cinn_buffer_t* v,
+                                    cinn_buffer_t* mask,
+                                    cinn_buffer_t* out);
+
+}  // extern "C"
@@ -0,0 +1,120 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/runtime/cpu/attention.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "cinn/common/test_helper.h"
+
+namespace cinn {
+namespace runtime {
+namespace cpu {
+
+// The naive attention which materializes the whole score matrix, the mask is broadcasted along the heads.
+std::vector<float> AttentionRef(int batch,
+                                int heads,
+                                int seq_q,
+                                int seq_k,
+                                int head_dim,
+                                int value_dim,
+                                float scale,
+                                bool causal,
+                                const float* q,
+                                const float* k,
+                                const float* v,
+                                const float* mask) {
+  std::vector<float> out(batch * heads * seq_q * value_dim);
+  std::vector<double> scores(seq_k);
+  for (int bh = 0; bh < batch * heads; ++bh) {
+    for (int i = 0; i < seq_q; ++i) {
+      double max_score = -1e30;
+      for (int j = 0; j < seq_k; ++j) {
+        double dot = 0.0;
+        for (int d = 0; d < head_dim; ++d) {
+          dot += q[(bh * seq_q + i) * head_dim + d] * k[(bh * seq_k + j) * head_dim + d];
+        }
+        scores[j] = dot * scale;
+        if (mask) scores[j] += mask[((bh / heads) * seq_q + i) * seq_k + j];
+        if (causal && j > i + seq_k - seq_q) scores[j] = -1e30;
+        max_score = std::max(max_score, scores[j]);
+      }
+      double sum = 0.0;
+      for (int j = 0; j < seq_k; ++j) {
+        scores[j] = std::exp(scores[j] - max_score);
+        sum += scores[j];
+      }
+      for (int d = 0; d < value_dim; ++d) {
+        double acc = 0.0;
+        for (int j = 0; j < seq_k; ++j) {
+          acc += scores[j] * v[(bh * seq_k + j) * value_dim + d];
+        }
+        out[(bh * seq_q + i) * value_dim + d] = acc / sum;
+      }
+    }
+  }
+  return out;
+}
+
+void TestAttention(bool causal, bool masked) {
+  // seq_q and seq_k are not multiples of the block sizes, and seq_k spans several key blocks
+  int batch = 2, heads = 3, seq_q = 70, seq_k = 200, head_dim = 16, value_dim = 24;
+  float scale = 1.f / std::sqrt(static_cast<float>(head_dim));
+
+  auto* q    = common::BufferBuilder(Float(32), {batch, heads, seq_q, head_dim}).set_random().Build();
+  auto* k    = common::BufferBuilder(Float(32), {batch, heads, seq_k, head_dim}).set_random().Build();
+  auto* v    = common::BufferBuilder(Float(32), {batch, heads, seq_k, value_dim}).set_random().Build();
+  auto* mask = common::BufferBuilder(Float(32), {batch, 1, seq_q, seq_k}).set_random().Build();
+  auto* out  = common::BufferBuilder(Float(32), {batch, heads, seq_q, value_dim}).set_zero().Build();
+
+  if (masked) {
+    cinn_cpu_masked_attention_fp32(
+        batch, heads, seq_q, seq_k, head_dim, value_dim, scale, causal, seq_q * seq_k, 0, seq_k, q, k, v, mask, out);
+  } else {
+    cinn_cpu_attention_fp32(batch, heads, seq_q, seq_k, head_dim, value_dim, scale, causal, q, k, v, out);
+  }
+
+  auto expected = AttentionRef(batch,
+                               heads,
+                               seq_q,
+                               seq_k,
+                               head_dim,
+                               value_dim,
+                               scale,
+                               causal,
+                               reinterpret_cast<float*>(q->memory),
+                               reinterpret_cast<float*>(k->memory),
+                               reinterpret_cast<float*>(v->memory),
+                               masked ? reinterpret_cast<float*>(mask->memory) : nullptr);
+  auto* out_data = reinterpret_cast<float*>(out->memory);
+  for (int i = 0; i < expected.size(); ++i) {
+    ASSERT_NEAR(out_data[i], expected[i], 1e-4) << "i=" << i;
+  }
+}
+
+TEST(cinn_cpu_attention_fp32, basic) { TestAttention(false, false); }
+
+TEST(cinn_cpu_attention_fp32, causal) { TestAttention(true, false); }
+
+TEST(cinn_cpu_masked_attention_fp32, basic) { TestAttention(false, true); }
+
+TEST(cinn_cpu_masked_attention_fp32, causal) { TestAttention(true, true); }
+
+}  // namespace cpu
+}  // namespace runtime
+}  // namespace cinn
@@ -14,15 +14,125 @@
 
 #include "cinn/runtime/cpu/cblas.h"
 
+#include <algorithm>
+#include <cmath>
+#include <string>
 #include <vector>
 
 #include "cinn/backends/extern_func_jit_register.h"
 #include "cinn/common/cas.h"
+#include "cinn/runtime/cpu/thread_backend.h"
 
 namespace {
 
 inline CBLAS_TRANSPOSE ToCblasTranspose(bool trans) { return trans ? CblasTrans : CblasNoTrans; }
 
+struct GemmProblem {
+  int M;
+  int N;
+  int K;
+  const float* A;
+  const float* B;
+  float* C;
+};
+
+// A panel is the rows [row_begin, row_end) of the output of one problem.
+struct GemmPanel {
+  int problem;
+  int row_begin;
+  int row_end;
+};
+
+struct GroupedGemmClosure {
+  float alpha;
+  bool ta;
+  bool tb;
+  const std::vector<GemmProblem>* problems;
+  const std::vector<std::vector<GemmPanel>>* panels;
+};
+
+// Split the rows of all the problems into `num_task` contiguous chunks of nearly equal FLOPs. A task may cover the
+// tail of one problem and the head of the next one, and a large problem is shared by several tasks.
+std::vector<std::vector<GemmPanel>> PartitionByFlops(const std::vector<GemmProblem>& problems, int num_task) {
+  double total_flops = 0;
+  for (auto& p : problems) {
+    total_flops += 2.0 * p.M * p.N * p.K;
+  }
+  std::vector<std::vector<GemmPanel>> panels(num_task);
+  double budget = total_flops / num_task;
+  double filled = 0;
+  int task      = 0;
+  for (int i = 0; i < problems.size(); ++i) {
+    double row_flops = 2.0 * problems[i].N * problems[i].K;
+    int row          = 0;
+    while (row < problems[i].M) {
+      int rows = problems[i].M - row;
+      if (task < num_task - 1 && row_flops > 0) {
+        int fit = static_cast<int>(std::ceil((budget - filled) / row_flops));
+        rows    = std::min(rows, std::max(fit, 1));
+      }
+      panels[task].push_back({i, row, row + rows});
+      filled += rows * row_flops;
+      row += rows;
+      if (task < num_task - 1 && filled >= budget) {
+        // carry the overshoot so that the error does not accumulate over the tasks
+        filled -= budget;
+        ++task;
+      }
+    }
+  }
+  return panels;
+}
+
+int GroupedGemmTask(int task_id, int num_task, void* datas) {
+  auto* closure      = reinterpret_cast<GroupedGemmClosure*>(datas);
+  auto& problems     = *closure->problems;
+  CBLAS_TRANSPOSE ta = ToCblasTranspose(closure->ta);
+  CBLAS_TRANSPOSE tb = ToCblasTranspose(closure->tb);
+  for (auto& panel : (*closure->panels)[task_id]) {
+    auto& p        = problems[panel.problem];
+    int lda        = closure->ta ? p.M : p.K;
+    int ldb        = closure->tb ? p.K : p.N;
+    const float* A = closure->ta ? p.A + panel.row_begin : p.A + panel.row_begin * lda;
+    cblas_sgemm(CblasRowMajor,
+                ta,
+                tb,
+                panel.row_end - panel.row_begin,
+                p.N,
+                p.K,
+                closure->alpha,
+                A,
+                lda,
+                p.B,
+                ldb,
+                0.f,
+                p.C + panel.row_begin * p.N,
+                p.N);
+  }
+  return 0;
+}
+
+void GroupedGemm(float alpha, bool ta, bool tb, const std::vector<GemmProblem>& problems) {
+  int total_rows = 0;
+  for (auto& p : problems) {
+    total_rows += p.M;
+  }
+  int num_task = std::max(std::min(max_concurrency(), total_rows), 1);
+  auto panels  = PartitionByFlops(problems, num_task);
+  GroupedGemmClosure closure{alpha, ta, tb, &problems, &panels};
+  // The cblas calls run inside one parallel region, MKL falls back to its sequential kernels there.
+  cinn_backend_parallel_launch(&GroupedGemmTask, &closure, num_task);
+}
+
+inline GemmProblem MakeGemmProblem(int M, int N, int K, cinn_buffer_t* A, cinn_buffer_t* B, cinn_buffer_t* C) {
+  return {M,
+          N,
+          K,
+          reinterpret_cast<const float*>(A->memory),
+          reinterpret_cast<const float*>(B->memory),
+          reinterpret_cast<float*>(C->memory)};
+}
+
 }  // namespace
 
 void cinn_cpu_mkl_gemm_fp32(float alpha,
@@ -100,6 +210,89 @@ void cinn_cpu_mkl_gemm_batch_fp32(float alpha,
                     &batch_size);
 }
 
+void cinn_cpu_mkl_gemm_grouped2_fp32(float alpha,
+                                     bool ta,
+                                     bool tb,
+                                     int M0,
+                                     int N0,
+                                     int K0,
+                                     int M1,
+                                     int N1,
+                                     int K1,
+                                     cinn_buffer_t* A0,
+                                     cinn_buffer_t* B0,
+                                     cinn_buffer_t* A1,
+                                     cinn_buffer_t* B1,
+                                     cinn_buffer_t* C0,
+                                     cinn_buffer_t* C1) {
+  GroupedGemm(alpha, ta, tb, {MakeGemmProblem(M0, N0, K0, A0, B0, C0), MakeGemmProblem(M1, N1, K1, A1, B1, C1)});
+}
+
+void cinn_cpu_mkl_gemm_grouped3_fp32(float alpha,
+                                     bool ta,
+                                     bool tb,
+                                     int M0,
+                                     int N0,
+                                     int K0,
+                                     int M1,
+                                     int N1,
+                                     int K1,
+                                     int M2,
+                                     int N2,
+                                     int K2,
+                                     cinn_buffer_t* A0,
+                                     cinn_buffer_t* B0,
+                                     cinn_buffer_t* A1,
+                                     cinn_buffer_t* B1,
+                                     cinn_buffer_t* A2,
+                                     cinn_buffer_t* B2,
+                                     cinn_buffer_t* C0,
+                                     cinn_buffer_t* C1,
+                                     cinn_buffer_t* C2) {
+  GroupedGemm(alpha,
+              ta,
+              tb,
+              {MakeGemmProblem(M0, N0, K0, A0, B0, C0),
+               MakeGemmProblem(M1, N1, K1, A1, B1, C1),
+               MakeGemmProblem(M2, N2, K2, A2, B2, C2)});
+}
+
+void cinn_cpu_mkl_gemm_grouped4_fp32(float alpha,
+                                     bool ta,
+                                     bool tb,
+                                     int M0,
+                                     int N0,
+                                     int K0,
+                                     int M1,
+                                     int N1,
+                                     int K1,
+                                     int M2,
+                                     int N2,
+                                     int K2,
+                                     int M3,
+                                     int N3,
+                                     int K3,
+                                     cinn_buffer_t* A0,
+                                     cinn_buffer_t* B0,
+                                     cinn_buffer_t* A1,
+                                     cinn_buffer_t* B1,
+                                     cinn_buffer_t* A2,
+                                     cinn_buffer_t* B2,
+                                     cinn_buffer_t* A3,
+                                     cinn_buffer_t* B3,
+                                     cinn_buffer_t* C0,
+                                     cinn_buffer_t* C1,
+                                     cinn_buffer_t* C2,
+                                     cinn_buffer_t* C3) {
+  GroupedGemm(alpha,
+              ta,
+              tb,
+              {MakeGemmProblem(M0, N0, K0, A0, B0, C0),
+               MakeGemmProblem(M1, N1, K1, A1, B1, C1),
+               MakeGemmProblem(M2, N2, K2, A2, B2, C2),
+               MakeGemmProblem(M3, N3, K3, A3, B3, C3)});
+}
+
 CINN_REGISTER_HELPER(cinn_cpu_mkl) {
   using namespace cinn;  // NOLINT
   using backends::FunctionProto;
@@ -143,6 +336,19 @@ CINN_REGISTER_HELPER(cinn_cpu_mkl) {
     return shape;
   };
 
+  // args: alpha, ta, tb, {M_i, N_i, K_i}..., {A_i, B_i}...
+  FunctionProto::shape_inference_t inference_shape_gemm_grouped = [](const std::vector<Expr>& args, int offset) {
+    CHECK_EQ((args.size() - 3) % 5, 0UL) << "Wrong number of arguments passed in";
+    int group_size = (args.size() - 3) / 5;
+    CHECK_LT(offset, group_size) << "The output offset is out of the group";
+    auto M = common::AutoSimplify(args[3 + offset * 3]);
+    auto N = common::AutoSimplify(args[4 + offset * 3]);
+    std::vector<Expr> shape;
+    shape.push_back(M);
+    shape.push_back(N);
+    return shape;
+  };
+
   REGISTER_EXTERN_FUNC_HELPER(cinn_cpu_mkl_gemm_fp32, host_target)
       .SetRetType<void>()
       .AddInputType<float>()            // alpha
@@ -183,5 +389,83 @@ CINN_REGISTER_HELPER(cinn_cpu_mkl) {
       .SetShapeInference(inference_shape_gemm_batch)
       .End();
 
+  REGISTER_EXTERN_FUNC_HELPER(cinn_cpu_mkl_gemm_grouped2_fp32, host_target)
+      .SetRetType<void>()
+      .AddInputType<float>()            // alpha
+      .AddInputType<bool>()             // ta
+      .AddInputType<bool>()             // tb
+      .AddInputType<int>()              // M0
+      .AddInputType<int>()              // N0
+      .AddInputType<int>()              // K0
+      .AddInputType<int>()              // M1
+      .AddInputType<int>()              // N1
+      .AddInputType<int>()              // K1
+      .AddInputType<cinn_buffer_t*>()   // A0
+      .AddInputType<cinn_buffer_t*>()   // B0
+      .AddInputType<cinn_buffer_t*>()   // A1
+      .AddInputType<cinn_buffer_t*>()   // B1
+      .AddOutputType<cinn_buffer_t*>()  // C0
+      .AddOutputType<cinn_buffer_t*>()  // C1
+      .SetShapeInference(inference_shape_gemm_grouped)
+      .End();
+
+  REGISTER_EXTERN_FUNC_HELPER(cinn_cpu_mkl_gemm_grouped3_fp32, host_target)
+      .SetRetType<void>()
+      .AddInputType<float>()            // alpha
+      .AddInputType<bool>()             // ta
+      .AddInputType<bool>()             // tb
+      .AddInputType<int>()              // M0
+      .AddInputType<int>()              // N0
+      .AddInputType<int>()              // K0
+      .AddInputType<int>()              // M1
+      .AddInputType<int>()              // N1
+      .AddInputType<int>()              // K1
+      .AddInputType<int>()              // M2
+      .AddInputType<int>()              // N2
+      .AddInputType<int>()              // K2
+      .AddInputType<cinn_buffer_t*>()   // A0
+      .AddInputType<cinn_buffer_t*>()   // B0
+      .AddInputType<cinn_buffer_t*>()   // A1
+      .AddInputType<cinn_buffer_t*>()   // B1
+      .AddInputType<cinn_buffer_t*>()   // A2
+      .AddInputType<cinn_buffer_t*>()   // B2
+      .AddOutputType<cinn_buffer_t*>()  // C0
+      .AddOutputType<cinn_buffer_t*>()  // C1
+      .AddOutputType<cinn_buffer_t*>()  // C2
+      .SetShapeInference(inference_shape_gemm_grouped)
+      .End();
+
+  REGISTER_EXTERN_FUNC_HELPER(cinn_cpu_mkl_gemm_grouped4_fp32, host_target)
+      .SetRetType<void>()
+      .AddInputType<float>()            // alpha
+      .AddInputType<bool>()             // ta
+      .AddInputType<bool>()             // tb
+      .AddInputType<int>()              // M0
+      .AddInputType<int>()              // N0
+      .AddInputType<int>()              // K0
+      .AddInputType<int>()              // M1
+      .AddInputType<int>()              // N1
+      .AddInputType<int>()              // K1
+      .AddInputType<int>()              // M2
+      .AddInputType<int>()              // N2
+      .AddInputType<int>()              // K2
+      .AddInputType<int>()              // M3
+      .AddInputType<int>()              // N3
+      .AddInputType<int>()              // K3
+      .AddInputType<cinn_buffer_t*>()   // A0
+      .AddInputType<cinn_buffer_t*>()   // B0
+      .AddInputType<cinn_buffer_t*>()   // A1
+      .AddInputType<cinn_buffer_t*>()   // B1
+      .AddInputType<cinn_buffer_t*>()   // A2
+      .AddInputType<cinn_buffer_t*>()   // B2
+      .AddInputType<cinn_buffer_t*>()   // A3
+      .AddInputType<cinn_buffer_t*>()   // B3
+      .AddOutputType<cinn_buffer_t*>()  // C0
+      .AddOutputType<cinn_buffer_t*>()  // C1
+      .AddOutputType<cinn_buffer_t*>()  // C2
+      .AddOutputType<cinn_buffer_t*>()  // C3
+      .SetShapeInference(inference_shape_gemm_grouped)
+      .End();
+
   return true;
 }
@@ -96,4 +96,86 @@ void cinn_cpu_mkl_gemm_batch_fp32(float alpha,
                                   cinn_buffer_t* A,
                                   cinn_buffer_t* B,
                                   cinn_buffer_t* C);
+
+/**
+ * \brief Do a group of independent GEMMs C_i = alpha * op(A_i) * op(B_i) in a single parallel region.
+ * The rows of all the problems are split into panels and distributed over the worker threads in proportion to the
+ * FLOPs of each problem, so a large GEMM is not serialized behind the small ones. All the problems share the same
+ * \param alpha, \param ta and \param tb, and the matrices are densely stored, so the leading dimensions are derived
+ * from M, N and K.
+ * @param alpha The scaling factor of the product of A_i and B_i
+ * @param ta whether to transpose A_i
+ * @param tb whether to transpose B_i
+ * @param Mi Number of the rows of A_i
+ * @param Ni the number of the columns in both B_i and C_i
+ * @param Ki the number of columns of A_i
+ * @param Ai The matrix A_i
+ * @param Bi The matrix B_i
+ * @param Ci The output matrix C_i
+ */
+void cinn_cpu_mkl_gemm_grouped2_fp32(float alpha,
+                                     bool ta,
+                                     bool tb,
+                                     int M0,
+                                     int N0,
+                                     int K0,
+                                     int M1,
+                                     int N1,
+                                     int K1,
+                                     cinn_buffer_t* A0,
+                                     cinn_buffer_t* B0,
+                                     cinn_buffer_t* A1,
+                                     cinn_buffer_t* B1,
+                                     cinn_buffer_t* C0,
+                                     cinn_buffer_t* C1);
+
+void cinn_cpu_mkl_gemm_grouped3_fp32(float alpha,
+                                     bool ta,
+                                     bool tb,
+                                     int M0,
+                                     int N0,
+                                     int K0,
+                                     int M1,
+                                     int N1,
+                                     int K1,
+                                     int M2,
+                                     int N2,
+                                     int K2,
+                                     cinn_buffer_t* A0,
+                                     cinn_buffer_t* B0,
+                                     cinn_buffer_t* A1,
+                                     cinn_buffer_t* B1,
+                                     cinn_buffer_t* A2,
+                                     cinn_buffer_t* B2,
+                                     cinn_buffer_t* C0,
+                                     cinn_buffer_t* C1,
+                                     cinn_buffer_t* C2);
+
+void cinn_cpu_mkl_gemm_grouped4_fp32(float alpha,
+                                     bool ta,
+                                     bool tb,
+                                     int M0,
+                                     int N0,
+                                     int K0,
+                                     int M1,
+                                     int N1,
+                                     int K1,
+                                     int M2,
+                                     int N2,
+                                     int K2,
+                                     int M3,
+                                     int N3,
+                                     int K3,
+                                     cinn_buffer_t* A0,
+                                     cinn_buffer_t* B0,
+                                     cinn_buffer_t* A1,
+                                     cinn_buffer_t* B1,
+                                     cinn_buffer_t* A2,
+                                     cinn_buffer_t* B2,
+                                     cinn_buffer_t* A3,
+                                     cinn_buffer_t* B3,
+                                     cinn_buffer_t* C0,
+                                     cinn_buffer_t* C1,
+                                     cinn_buffer_t* C2,
+                                     cinn_buffer_t* C3);
 }  // extern "C"
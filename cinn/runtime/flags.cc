@@ -26,6 +26,7 @@ DEFINE_bool(cinn_cudnn_deterministic,
 #endif
 
 using ::GFLAGS_NAMESPACE::BoolFromEnv;
+using ::GFLAGS_NAMESPACE::Int32FromEnv;
 using ::GFLAGS_NAMESPACE::StringFromEnv;
 
 DEFINE_bool(cinn_open_fusion_optimize,
@@ -37,6 +38,11 @@ DEFINE_bool(cinn_use_new_fusion_pass,
             BoolFromEnv("FLAGS_cinn_use_new_fusion_pass", false),
             "Whether use the new op_fusion and fusion_merge pass.");
 
+DEFINE_bool(cinn_fusion_merge_use_cost_model,
+            BoolFromEnv("FLAGS_cinn_fusion_merge_use_cost_model", false),
+            "Whether FusionMergePass scores candidate merges with an analytic cost model (memory traffic saved "
+            "versus recomputation and parallelism lost) on top of the fusion relation table.");
+
 DEFINE_bool(cinn_use_fill_constant_folding,
             BoolFromEnv("FLAGS_cinn_use_fill_constant_folding", false),
             "Whether use the FillConstantFolding pass.");
@@ -49,6 +55,26 @@ DEFINE_bool(cinn_ir_schedule,
             BoolFromEnv("FLAGS_cinn_ir_schedule", false),
             "Whether use reconstructed schedule primitives.");
 
+DEFINE_bool(cinn_loop_invariant_code_motion,
+            BoolFromEnv("FLAGS_cinn_loop_invariant_code_motion", true),
+            "Whether hoist the loop invariant parts of the buffer offsets out of the loops of the X86 modules.");
+
+// FLAGS to bound the cost of simplifying expressions
+DEFINE_int32(cinn_cas_simplify_memo_capacity,
+             Int32FromEnv("FLAGS_cinn_cas_simplify_memo_capacity", 8192),
+             "The max number of simplified index expressions memoized by CasSimplify in a thread, the memo is "
+             "cleared once it is full, 0 disables the memo.");
+
+DEFINE_int32(cinn_cas_simplify_budget,
+             Int32FromEnv("FLAGS_cinn_cas_simplify_budget", 1000000),
+             "The max number of rewrite steps of a CasSimplify call, the expression is returned unsimplified once "
+             "the budget runs out, 0 means unlimited.");
+
+DEFINE_int32(cinn_ast_gen_cache_capacity,
+             Int32FromEnv("FLAGS_cinn_ast_gen_cache_capacity", 1024),
+             "The max number of ASTs cached by AstGen for the stages of the same structures, the cache is cleared "
+             "once it is full, 0 disables the cache.");
+
 // FLAGS for performance analysis and accuracy debug
 DEFINE_bool(cinn_sync_run,
             BoolFromEnv("FLAGS_cinn_sync_run", false),
@@ -66,6 +92,13 @@ DEFINE_string(cinn_source_code_save_path,
               StringFromEnv("FLAGS_cinn_source_code_save_path", ""),
               "Specify the directory path of generated source code, which is used for debug.");
 
+DEFINE_string(cinn_compile_profile_path,
+              StringFromEnv("FLAGS_cinn_compile_profile_path", ""),
+              "Specify the file path to dump the Chrome trace of the compilation stages after each "
+              "GraphCompiler::Build, the nested or concurrent builds are dumped together when the last one finishes, "
+              "and the later dumps are numbered before the extension, such as profile.1.json, which is used for "
+              "compile time analysis. Empty means the compile profiler is disabled.");
+
 DEFINE_bool(auto_schedule_use_cost_model,
             BoolFromEnv("FLAGS_auto_schedule_use_cost_model", false),
             "Whether to use cost model in auto schedule, this is an on-developing flag and it will be removed when "
@@ -14,6 +14,17 @@
 
 #include "cinn/utils/profiler.h"
 
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <sstream>
+
 #ifdef CINN_WITH_NVTX
 #include <nvToolsExt.h>
 #endif
@@ -24,9 +35,210 @@
 #include "cinn/backends/cuda_util.h"
 #endif
 
+DECLARE_string(cinn_compile_profile_path);
+
 namespace cinn {
 namespace utils {
 
+namespace {
+
+// The names of the living RecordCompileEvents in this thread, from the outermost one.
+thread_local std::vector<std::string> compile_event_stack;
+
+// Number the threads sequentially, which are shown as the tracks of a Chrome trace.
+uint64_t CompileThreadId() {
+  static std::atomic<uint64_t> thread_num{0};
+  thread_local const uint64_t thread_id = thread_num++;
+  return thread_id;
+}
+
+std::string EscapeJson(const std::string& str) {
+  std::string res;
+  for (char c : str) {
+    switch (c) {
+      case '"':
+        res += "\\\"";
+        break;
+      case '\\':
+        res += "\\\\";
+        break;
+      case '\n':
+        res += "\\n";
+        break;
+      default:
+        res += c;
+    }
+  }
+  return res;
+}
+
+// A node of the tree aggregating the events with the same path.
+struct SummaryNode {
+  std::string name;
+  int64_t count       = 0;
+  int64_t duration_ns = 0;
+  std::map<std::string, int64_t> counters;
+  std::vector<std::unique_ptr<SummaryNode>> children;
+
+  SummaryNode* Child(const std::string& child_name) {
+    for (auto& child : children) {
+      if (child->name == child_name) return child.get();
+    }
+    children.emplace_back(new SummaryNode);
+    children.back()->name = child_name;
+    return children.back().get();
+  }
+
+  void Print(int depth, std::ostream& os) const {
+    os << std::string(depth * 2, ' ') << std::left << std::setw(std::max(48 - depth * 2, 8)) << name << std::right
+       << std::setw(12) << std::fixed << std::setprecision(3) << duration_ns / 1e6 << " ms" << std::setw(8) << count
+       << " calls";
+    for (auto& counter : counters) {
+      os << "  " << counter.first << "=" << counter.second;
+    }
+    os << "\n";
+    for (auto& child : children) {
+      child->Print(depth + 1, os);
+    }
+  }
+};
+
+std::string EventsToChromeTrace(const std::vector<HostEvent>& events) {
+  std::stringstream ss;
+  ss << "{\"traceEvents\":[";
+  bool first = true;
+  for (auto& event : events) {
+    if (!first) ss << ",";
+    first = false;
+    // the complete event, whose timestamps are in microseconds
+    ss << "\n{\"name\":\"" << EscapeJson(event.name) << "\",\"cat\":\"" << EscapeJson(event.category)
+       << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << event.thread_id << ",\"ts\":" << std::fixed
+       << std::setprecision(3) << event.start_ns / 1e3 << ",\"dur\":" << event.duration_ns / 1e3 << ",\"args\":{";
+    bool first_arg = true;
+    for (auto& attr : event.attrs) {
+      if (!first_arg) ss << ",";
+      first_arg = false;
+      ss << "\"" << EscapeJson(attr.first) << "\":\"" << EscapeJson(attr.second) << "\"";
+    }
+    for (auto& counter : event.counters) {
+      if (!first_arg) ss << ",";
+      first_arg = false;
+      ss << "\"" << EscapeJson(counter.first) << "\":" << counter.second;
+    }
+    ss << "}}";
+  }
+  ss << "\n],\"displayTimeUnit\":\"ms\"}\n";
+  return ss.str();
+}
+
+std::string SummarizeEvents(const std::vector<HostEvent>& events) {
+  SummaryNode root;
+  for (auto& event : events) {
+    SummaryNode* node = &root;
+    for (auto& name : event.path) {
+      node = node->Child(name);
+    }
+    node->count++;
+    node->duration_ns += event.duration_ns;
+    for (auto& counter : event.counters) {
+      node->counters[counter.first] += counter.second;
+    }
+  }
+  std::stringstream ss;
+  for (auto& child : root.children) {
+    child->Print(0, ss);
+  }
+  return ss.str();
+}
+
+}  // namespace
+
+CompileProfiler& CompileProfiler::Global() {
+  static CompileProfiler profiler;
+  return profiler;
+}
+
+bool CompileProfiler::enabled() const { return !FLAGS_cinn_compile_profile_path.empty(); }
+
+void CompileProfiler::AddEvent(HostEvent&& event) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  events_.emplace_back(std::move(event));
+}
+
+void CompileProfiler::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  events_.clear();
+  num_dumps_ = 0;
+}
+
+std::vector<HostEvent> CompileProfiler::events() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return events_;
+}
+
+int64_t CompileProfiler::Now() const {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin_).count();
+}
+
+std::string CompileProfiler::ToChromeTrace() const { return EventsToChromeTrace(events()); }
+
+std::string CompileProfiler::Summary() const { return SummarizeEvents(events()); }
+
+void CompileProfiler::Dump() {
+  std::vector<HostEvent> events;
+  std::string path;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    events.swap(events_);
+    path = DumpPath(num_dumps_++);
+  }
+  std::ofstream of(path, std::ofstream::out | std::ofstream::trunc);
+  CHECK(of.is_open()) << "Failed to open " << path;
+  of << EventsToChromeTrace(events);
+  of.close();
+  LOG(INFO) << "Write the compile profile to " << path << ", the summary is:\n" << SummarizeEvents(events);
+}
+
+std::string CompileProfiler::DumpPath(int index) {
+  const std::string& path = FLAGS_cinn_compile_profile_path;
+  if (index == 0) {
+    return path;
+  }
+  // the extension is after the last dot of the file name, not of a directory
+  size_t dot   = path.rfind('.');
+  size_t slash = path.rfind('/');
+  if (dot == std::string::npos || dot == 0 || (slash != std::string::npos && dot < slash + 2)) {
+    return path + "." + std::to_string(index);
+  }
+  return path.substr(0, dot) + "." + std::to_string(index) + path.substr(dot);
+}
+
+RecordCompileEvent::RecordCompileEvent(const std::string& name, const std::string& category)
+    : enabled_(CompileProfiler::Global().enabled()) {
+  if (!enabled_) return;
+  compile_event_stack.push_back(name);
+  event_.name      = name;
+  event_.category  = category;
+  event_.path      = compile_event_stack;
+  event_.thread_id = CompileThreadId();
+  event_.start_ns  = CompileProfiler::Global().Now();
+}
+
+RecordCompileEvent::~RecordCompileEvent() {
+  if (!enabled_) return;
+  event_.duration_ns = CompileProfiler::Global().Now() - event_.start_ns;
+  compile_event_stack.pop_back();
+  CompileProfiler::Global().AddEvent(std::move(event_));
+}
+
+void RecordCompileEvent::AddAttr(const std::string& key, const std::string& value) {
+  if (enabled_) event_.attrs.emplace_back(key, value);
+}
+
+void RecordCompileEvent::AddCounter(const std::string& key, int64_t value) {
+  if (enabled_) event_.counters.emplace_back(key, value);
+}
+
 void SynchronizeAllDevice() {
 #ifdef CINN_WITH_CUDA
   int current_device_id;
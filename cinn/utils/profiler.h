@@ -14,7 +14,12 @@
 
 #pragma once
 
+#include <chrono>  //NOLINT
+#include <cstdint>
+#include <mutex>  //NOLINT
 #include <string>
+#include <utility>
+#include <vector>
 
 #ifdef CINN_WITH_NVTX
 #include <nvToolsExt.h>
@@ -37,6 +42,87 @@ class RecordEvent {
   }
 };
 
+/**
+ * A host event recorded by the CompileProfiler.
+ */
+struct HostEvent {
+  std::string name;
+  std::string category;
+  // the names of the enclosing events in the same thread from the outermost one, ended with this event's name
+  std::vector<std::string> path;
+  // the offset to the creation of the profiler, unit: ns
+  int64_t start_ns    = 0;
+  int64_t duration_ns = 0;
+  uint64_t thread_id  = 0;
+  // descriptive attributes, such as the name of the lowered fusion group
+  std::vector<std::pair<std::string, std::string>> attrs;
+  // numeric attributes, such as the number of IR nodes before and after a pass
+  std::vector<std::pair<std::string, int64_t>> counters;
+};
+
+/**
+ * The CompileProfiler collects the time ranges of the compilation stages, such as lowering of each fusion group,
+ * the optimization passes, the code generation and the JIT. It is enabled when FLAGS_cinn_compile_profile_path
+ * is set, and each top-level GraphCompiler::Build dumps the events collected so far to a new file in the Chrome
+ * trace format, which can be loaded by chrome://tracing or Perfetto.
+ */
+class CompileProfiler {
+ public:
+  static CompileProfiler& Global();
+
+  bool enabled() const;
+
+  void AddEvent(HostEvent&& event);
+
+  // Clear the events and restart the numbering of the dumped files
+  void Clear();
+
+  std::vector<HostEvent> events() const;
+
+  // The offset of now to the creation of the profiler, unit: ns
+  int64_t Now() const;
+
+  std::string ToChromeTrace() const;
+
+  // Returns a table of the events aggregated along their paths, the children of an event are indented under it.
+  std::string Summary() const;
+
+  // Write the Chrome trace to DumpPath() of this dump, and log the summary. The dumped events are cleared, so that
+  // a dump only holds the events recorded since the previous one.
+  void Dump();
+
+  // The file of the index-th dump, the first one is FLAGS_cinn_compile_profile_path, and the index is inserted
+  // before the extension for the others, such as profile.1.json, so that a dump doesn't overwrite the previous ones.
+  static std::string DumpPath(int index);
+
+ private:
+  CompileProfiler() : origin_(std::chrono::steady_clock::now()) {}
+
+  const std::chrono::steady_clock::time_point origin_;
+  mutable std::mutex mutex_;
+  std::vector<HostEvent> events_;
+  int num_dumps_ = 0;
+};
+
+/**
+ * Record the lifetime of this object as an event of the CompileProfiler, the events created in its lifetime in
+ * the same thread are nested in it. It does nothing if the profiler is disabled.
+ */
+class RecordCompileEvent {
+ public:
+  explicit RecordCompileEvent(const std::string& name, const std::string& category = "compile");
+  ~RecordCompileEvent();
+
+  bool enabled() const { return enabled_; }
+
+  void AddAttr(const std::string& key, const std::string& value);
+  void AddCounter(const std::string& key, int64_t value);
+
+ private:
+  bool enabled_;
+  HostEvent event_;
+};
+
 void SynchronizeAllDevice();
 
 void ProfilerStart();
@@ -0,0 +1,100 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/utils/profiler.h"
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>  //NOLINT
+
+DECLARE_string(cinn_compile_profile_path);
+
+namespace cinn {
+namespace utils {
+
+TEST(CompileProfiler, Disabled) {
+  FLAGS_cinn_compile_profile_path = "";
+  CompileProfiler::Global().Clear();
+  {
+    RecordCompileEvent event("disabled");
+    ASSERT_FALSE(event.enabled());
+  }
+  ASSERT_TRUE(CompileProfiler::Global().events().empty());
+}
+
+TEST(CompileProfiler, NestedEvents) {
+  FLAGS_cinn_compile_profile_path = "./test_compile_profile.json";
+  CompileProfiler::Global().Clear();
+  {
+    RecordCompileEvent build("build", "graph_compiler");
+    for (int i = 0; i < 2; i++) {
+      RecordCompileEvent pass("pass", "optim");
+      pass.AddAttr("group_id", "fn_" + std::to_string(i));
+      pass.AddCounter("ir_nodes", 10);
+    }
+    // the events of another thread are not nested in the events of this thread
+    std::thread([] { RecordCompileEvent other("other"); }).join();
+  }
+
+  // the events are added when they end
+  auto events = CompileProfiler::Global().events();
+  ASSERT_EQ(events.size(), 4UL);
+  EXPECT_EQ(events[0].path, std::vector<std::string>({"build", "pass"}));
+  EXPECT_EQ(events[2].path, std::vector<std::string>({"other"}));
+  EXPECT_NE(events[2].thread_id, events[3].thread_id);
+  EXPECT_EQ(events[3].name, "build");
+  EXPECT_LE(events[3].start_ns, events[0].start_ns);
+  EXPECT_GE(events[3].start_ns + events[3].duration_ns, events[1].start_ns + events[1].duration_ns);
+
+  std::string summary = CompileProfiler::Global().Summary();
+  LOG(INFO) << "summary:\n" << summary;
+  EXPECT_NE(summary.find("  pass"), std::string::npos);
+  EXPECT_NE(summary.find("ir_nodes=20"), std::string::npos);
+
+  std::string trace = CompileProfiler::Global().ToChromeTrace();
+  EXPECT_NE(trace.find("\"name\":\"pass\",\"cat\":\"optim\",\"ph\":\"X\""), std::string::npos);
+  EXPECT_NE(trace.find("\"group_id\":\"fn_1\",\"ir_nodes\":10"), std::string::npos);
+
+  CompileProfiler::Global().Dump();
+  std::ifstream ifs(FLAGS_cinn_compile_profile_path);
+  std::stringstream ss;
+  ss << ifs.rdbuf();
+  EXPECT_EQ(ss.str(), trace);
+  // the dumped events are cleared, so they don't accumulate across dumps
+  EXPECT_TRUE(CompileProfiler::Global().events().empty());
+
+  // the next dump goes to a numbered file, and doesn't overwrite the previous one
+  { RecordCompileEvent build("rebuild", "graph_compiler"); }
+  CompileProfiler::Global().Dump();
+  std::ifstream next_ifs("./test_compile_profile.1.json");
+  std::stringstream next_ss;
+  next_ss << next_ifs.rdbuf();
+  EXPECT_NE(next_ss.str().find("\"name\":\"rebuild\""), std::string::npos);
+  std::ifstream first_ifs(FLAGS_cinn_compile_profile_path);
+  std::stringstream first_ss;
+  first_ss << first_ifs.rdbuf();
+  EXPECT_EQ(first_ss.str(), trace);
+  EXPECT_EQ(CompileProfiler::DumpPath(2), "./test_compile_profile.2.json");
+
+  FLAGS_cinn_compile_profile_path = "";
+  CompileProfiler::Global().Clear();
+}
+
+}  // namespace utils
+}  // namespace cinn
@@ -0,0 +1,212 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+#include <sys/resource.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/common/cas.h"
+#include "cinn/common/context.h"
+#include "cinn/common/target.h"
+#include "cinn/frontend/net_builder.h"
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/node.h"
+#include "cinn/poly/ast_gen.h"
+#include "cinn/utils/string.h"
+#include "cinn/utils/timer.h"
+
+DECLARE_int32(cinn_cas_simplify_memo_capacity);
+DECLARE_int32(cinn_ast_gen_cache_capacity);
+
+namespace cinn {
+namespace tests {
+
+using hlir::framework::Graph;
+using hlir::framework::GraphCompiler;
+using hlir::framework::Node;
+
+// A chain of elementwise and broadcast ops, which are fused into a large group.
+frontend::Program CreateLargeFusedProgram(int num_layers) {
+  frontend::NetBuilder builder("large_fused_group");
+  auto x = builder.CreateInput(Float(32), {16, 64, 28, 28}, "X");
+  auto y = builder.CreateInput(Float(32), {16, 64, 28, 28}, "Y");
+  auto b = builder.CreateInput(Float(32), {64}, "B");
+  auto s = builder.CreateInput(Float(32), {28}, "S");
+  frontend::Variable h = x;
+  for (int i = 0; i < num_layers; ++i) {
+    h = builder.ElementwiseAdd(h, b, 1);
+    h = builder.ElementwiseMul(h, s, 3);
+    h = builder.Relu(h);
+    h = builder.ElementwiseAdd(h, y);
+    h = builder.Scale(h, 0.5f, 0.1f);
+  }
+  return builder.Build();
+}
+
+// Lower all the op nodes as a group and return the lowered functions in
+// string, the time cost is saved into cost_ms.
+std::string LowerAsOneGroup(GraphCompiler* graph_compiler, Graph* graph, float* cost_ms) {
+  std::vector<Node*> group;
+  auto topo_order = graph->topological_order();
+  for (auto* n : std::get<0>(topo_order)) {
+    Node* op_node = n->safe_as<Node>();
+    if (op_node) {
+      group.push_back(op_node);
+    }
+  }
+
+  common::Context::Global().ResetNameId();
+  utils::Timer timer;
+  timer.Start();
+  auto lowered_funcs = graph_compiler->FusedGraphToLoweredFunc({group});
+  *cost_ms           = timer.Stop();
+  return utils::GetStreamCnt(lowered_funcs[0][0]);
+}
+
+TEST(CompileTime, LargeFusedGroup) {
+  // each layer has 5 ops
+  constexpr int kNumLayers = 8;
+  Target target            = common::DefaultHostTarget();
+  auto graph               = std::make_shared<Graph>(CreateLargeFusedProgram(kNumLayers), target);
+  auto scope               = hlir::framework::BuildScope(target, graph);
+  GraphCompiler graph_compiler(target, scope, graph);
+
+  int old_capacity = FLAGS_cinn_cas_simplify_memo_capacity;
+  float no_memo_ms = 0.f, cold_memo_ms = 0.f, warm_memo_ms = 0.f;
+
+  FLAGS_cinn_cas_simplify_memo_capacity = 0;
+  std::string expected                  = LowerAsOneGroup(&graph_compiler, graph.get(), &no_memo_ms);
+
+  FLAGS_cinn_cas_simplify_memo_capacity = 8192;
+  common::ClearCasSimplifyMemo();
+  std::string cold = LowerAsOneGroup(&graph_compiler, graph.get(), &cold_memo_ms);
+  std::string warm = LowerAsOneGroup(&graph_compiler, graph.get(), &warm_memo_ms);
+  FLAGS_cinn_cas_simplify_memo_capacity = old_capacity;
+
+  LOG(INFO) << "Lowering a group of " << kNumLayers * 5 << " ops costs " << no_memo_ms << "ms without memo, "
+            << cold_memo_ms << "ms with a cold memo and " << warm_memo_ms << "ms with a warm memo";
+  // the memo doesn't change the generated code
+  EXPECT_EQ(cold, expected);
+  EXPECT_EQ(warm, expected);
+
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  LOG(INFO) << "Peak RSS: " << usage.ru_maxrss / 1024 << "MB";
+}
+
+// A convolution followed by an inference batch norm and an optional relu.
+frontend::Variable ConvBN(frontend::NetBuilder* builder,
+                          const frontend::Variable& x,
+                          int in_channels,
+                          int out_channels,
+                          int kernel_size,
+                          int stride,
+                          bool with_relu) {
+  auto w     = builder->CreateInput(Float(32), {out_channels, in_channels, kernel_size, kernel_size});
+  auto scale = builder->CreateInput(Float(32), {out_channels});
+  auto bias  = builder->CreateInput(Float(32), {out_channels});
+  auto mean  = builder->CreateInput(Float(32), {out_channels});
+  auto var   = builder->CreateInput(Float(32), {out_channels});
+  auto h     = builder->Conv2d(x, w, {stride, stride}, {kernel_size / 2, kernel_size / 2});
+  h          = builder->BatchNorm(h, scale, bias, mean, var, 1e-5f, 0.9f, "NCHW", true)[0];
+  return with_relu ? builder->Relu(h) : h;
+}
+
+// The inference network of ResNet-50, whose bottleneck blocks repeat the same layers.
+frontend::Program CreateResNet50Program(int batch_size) {
+  frontend::NetBuilder builder("resnet50");
+  auto x = builder.CreateInput(Float(32), {batch_size, 3, 224, 224}, "X");
+  auto h = ConvBN(&builder, x, 3, 64, 7, 2, true);
+  h      = builder.Pool2d(h, "max", {3, 3}, {2, 2}, {1, 1});
+
+  const std::vector<int> num_blocks   = {3, 4, 6, 3};
+  const std::vector<int> mid_channels = {64, 128, 256, 512};
+  int in_channels                     = 64;
+  for (int i = 0; i < num_blocks.size(); ++i) {
+    int out_channels = mid_channels[i] * 4;
+    for (int j = 0; j < num_blocks[i]; ++j) {
+      int stride    = (i > 0 && j == 0) ? 2 : 1;
+      auto shortcut = j == 0 ? ConvBN(&builder, h, in_channels, out_channels, 1, stride, false) : h;
+      auto y        = ConvBN(&builder, h, in_channels, mid_channels[i], 1, 1, true);
+      y             = ConvBN(&builder, y, mid_channels[i], mid_channels[i], 3, stride, true);
+      y             = ConvBN(&builder, y, mid_channels[i], out_channels, 1, 1, false);
+      h             = builder.Relu(builder.ElementwiseAdd(y, shortcut));
+      in_channels   = out_channels;
+    }
+  }
+  h       = builder.Pool2d(h, "avg", {7, 7}, {1, 1}, {0, 0}, false, true, true);
+  h       = builder.Reshape(h, {batch_size, in_channels});
+  auto fc = builder.CreateInput(Float(32), {in_channels, 1000});
+  builder.Matmul(h, fc);
+  return builder.Build();
+}
+
+// Lower each op node as a group and return the lowered functions in string,
+// the time cost is saved into cost_ms.
+std::string LowerEachNode(GraphCompiler* graph_compiler, Graph* graph, float* cost_ms) {
+  std::vector<std::vector<Node*>> groups;
+  auto topo_order = graph->topological_order();
+  for (auto* n : std::get<0>(topo_order)) {
+    Node* op_node = n->safe_as<Node>();
+    if (op_node) {
+      groups.push_back({op_node});
+    }
+  }
+
+  common::Context::Global().ResetNameId();
+  utils::Timer timer;
+  timer.Start();
+  auto lowered_funcs = graph_compiler->FusedGraphToLoweredFunc(groups);
+  *cost_ms           = timer.Stop();
+  std::string res;
+  for (auto& funcs : lowered_funcs) {
+    for (auto& func : funcs) {
+      res += utils::GetStreamCnt(func);
+    }
+  }
+  return res;
+}
+
+TEST(CompileTime, ResNet50) {
+  Target target = common::DefaultHostTarget();
+  auto graph    = std::make_shared<Graph>(CreateResNet50Program(1), target);
+  auto scope    = hlir::framework::BuildScope(target, graph);
+  GraphCompiler graph_compiler(target, scope, graph);
+
+  int old_capacity  = FLAGS_cinn_ast_gen_cache_capacity;
+  float no_cache_ms = 0.f, cold_cache_ms = 0.f, warm_cache_ms = 0.f;
+
+  FLAGS_cinn_ast_gen_cache_capacity = 0;
+  std::string expected              = LowerEachNode(&graph_compiler, graph.get(), &no_cache_ms);
+
+  FLAGS_cinn_ast_gen_cache_capacity = 1024;
+  poly::ClearAstGenCache();
+  std::string cold = LowerEachNode(&graph_compiler, graph.get(), &cold_cache_ms);
+  std::string warm = LowerEachNode(&graph_compiler, graph.get(), &warm_cache_ms);
+  FLAGS_cinn_ast_gen_cache_capacity = old_capacity;
+
+  LOG(INFO) << "Lowering ResNet-50 costs " << no_cache_ms << "ms without the AstGen cache, " << cold_cache_ms
+            << "ms with a cold cache and " << warm_cache_ms << "ms with a warm cache";
+  // the cache doesn't change the generated code
+  EXPECT_EQ(cold, expected);
+  EXPECT_EQ(warm, expected);
+}
+
+}  // namespace tests
+}  // namespace cinn
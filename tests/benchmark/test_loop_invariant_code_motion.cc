@@ -0,0 +1,73 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "cinn/cinn.h"
+#include "cinn/hlir/framework/node.h"
+#include "tests/benchmark/test_elementwise.h"
+#include "tests/benchmark/test_utils.h"
+
+DECLARE_bool(cinn_loop_invariant_code_motion);
+
+namespace cinn {
+namespace tests {
+
+// Run the kernels built without and with LoopInvariantCodeMotion, the run time
+// of both are logged by TestOp.
+TEST(LoopInvariantCodeMotion, elementwise_add) {
+  std::vector<std::vector<int>> input_shapes{{32, 64, 56, 56}, {32, 64, 56, 56}};
+  std::vector<Type> input_types{Float(32), Float(32)};
+  std::vector<Type> output_types{Float(32)};
+  hlir::framework::NodeAttr attrs;
+  bool origin = FLAGS_cinn_loop_invariant_code_motion;
+  for (bool enabled : {false, true}) {
+    FLAGS_cinn_loop_invariant_code_motion = enabled;
+    ElementwiseAddTester tester("elementwise_add", input_shapes);
+    auto input_tensors = tester.CreateInputTensors<float>();
+    tester.TestOp(enabled ? "elementwise_add_with_licm" : "elementwise_add_without_licm",
+                  input_tensors,
+                  attrs,
+                  input_types,
+                  output_types);
+    tester.Compare<float>();
+  }
+  FLAGS_cinn_loop_invariant_code_motion = origin;
+}
+
+TEST(LoopInvariantCodeMotion, conv2d) {
+  std::vector<std::vector<int>> input_shapes{{1, 64, 56, 56}, {64, 64, 3, 3}};
+  std::vector<Type> input_types{Float(32), Float(32)};
+  std::vector<Type> output_types{Float(32), Float(32), Float(32)};
+  hlir::framework::NodeAttr attrs;
+  attrs.attr_store = {{"padding", std::vector<int>({1, 1})},
+                      {"stride", std::vector<int>({1, 1})},
+                      {"dilation", std::vector<int>({1, 1})}};
+  bool origin = FLAGS_cinn_loop_invariant_code_motion;
+  for (bool enabled : {false, true}) {
+    FLAGS_cinn_loop_invariant_code_motion = enabled;
+    OpBenchmarkTester tester("conv2d", input_shapes);
+    auto input_tensors = tester.CreateInputTensors<float>();
+    tester.TestOp(
+        enabled ? "conv2d_with_licm" : "conv2d_without_licm", input_tensors, attrs, input_types, output_types);
+  }
+  FLAGS_cinn_loop_invariant_code_motion = origin;
+}
+
+}  // namespace tests
+}  // namespace cinn